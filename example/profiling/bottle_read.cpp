@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Vocab.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace yarp::os;
+
+// Bottle read micro benchmark.
+// Count the memory allocations and measure the time needed to read a message
+// made of nested lists, numbers and strings (like a configuration or an RPC
+// reply), either in a new Bottle for each message, or always in the same
+// Bottle (as BufferedPort does), e.g.
+//
+//   bottle_read --items 1000 --reads 10000
+
+// Parameters:
+// --items: number of groups in the message (default 100)
+// --reads: number of messages read (default 10000)
+
+namespace {
+std::atomic<size_t> allocations {0};
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    allocations++;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+struct Result
+{
+    double duration {0.0};
+    size_t allocations {0};
+    size_t steadyAllocations {0};
+};
+
+Result run(DummyConnector& con, int reads, bool reuse)
+{
+    Result result;
+    Bottle reused;
+    for (int i = 0; i < reads; i++) {
+        // the reader allocates its own buffers, do not count them
+        ConnectionReader& reader = con.getReader();
+        size_t before = allocations.load();
+        double start = SystemClock::nowSystem();
+        if (reuse) {
+            reused.read(reader);
+        } else {
+            Bottle bot;
+            bot.read(reader);
+        }
+        result.duration += SystemClock::nowSystem() - start;
+        size_t count = allocations.load() - before;
+        result.allocations += count;
+        if (i > 1) {
+            // the first two reads fill the buffers of a reused bottle
+            result.steadyAllocations += count;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    int items = p.check("items", Value(100)).asInt32();
+    int reads = p.check("reads", Value(10000)).asInt32();
+
+    Bottle msg;
+    for (int i = 0; i < items; i++) {
+        Bottle& group = msg.addList();
+        group.addString("joint_" + std::to_string(i));
+        Bottle& values = group.addList();
+        values.addFloat64(0.1 * i);
+        values.addFloat64(0.2 * i);
+        values.addFloat64(0.3 * i);
+        group.addInt32(i);
+        group.addVocab(yarp::os::createVocab('o', 'k'));
+        group.addString("a longer string that does not fit small buffers");
+    }
+    DummyConnector con;
+    msg.write(con.getWriter());
+
+    printf("%d groups, %d reads\n", items, reads);
+    printf("%-12s %14s %16s %14s\n", "bottle", "allocs/read", "steady allocs", "time [us]");
+    for (bool reuse : {false, true}) {
+        Result r = run(con, reads, reuse);
+        printf("%-12s %14.1f %16zu %14.2f\n",
+               reuse ? "reused" : "new",
+               static_cast<double>(r.allocations) / reads,
+               r.steadyAllocations,
+               r.duration / reads * 1e6);
+    }
+
+    return 0;
+}
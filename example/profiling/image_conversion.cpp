@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Image conversion micro benchmark.
+// Measure the throughput of Image::copy() between the most common pixel
+// formats.  The optimized conversions use the best instruction set available
+// (AVX2, SSE4.1, NEON), run the benchmark again with YARP_SIG_SIMD=none to
+// compare them with the generic conversion, e.g.
+//
+//   image_conversion --width 1920 --height 1080
+//   YARP_SIG_SIMD=none image_conversion --width 1920 --height 1080
+
+// Parameters:
+// --width: width of the images (default 1920)
+// --height: height of the images (default 1080)
+// --copies: number of copies for each conversion (default 200)
+
+namespace {
+
+template <typename T1, typename T2>
+void run(const char* name, size_t width, size_t height, int copies)
+{
+    ImageOf<T1> src;
+    ImageOf<T2> dest;
+    src.resize(width, height);
+    unsigned char* data = src.getRawImage();
+    for (size_t i = 0; i < src.getRawImageSize(); i++) {
+        data[i] = static_cast<unsigned char>(std::rand());
+    }
+    dest.copy(src); // allocate the destination
+
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < copies; i++) {
+        dest.copy(src);
+    }
+    double duration = SystemClock::nowSystem() - start;
+    printf("%-16s %12.1f %12.3f\n",
+           name,
+           static_cast<double>(width * height) * copies / duration * 1e-6,
+           duration / copies * 1e3);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    auto width = static_cast<size_t>(p.check("width", Value(1920)).asInt32());
+    auto height = static_cast<size_t>(p.check("height", Value(1080)).asInt32());
+    int copies = p.check("copies", Value(200)).asInt32();
+
+    const char* simd = std::getenv("YARP_SIG_SIMD");
+    printf("%zux%zu images, %d copies, YARP_SIG_SIMD=%s\n", width, height, copies, simd ? simd : "");
+    printf("%-16s %12s %12s\n", "conversion", "MPixel/s", "time [ms]");
+    run<PixelRgb, PixelBgr>("rgb -> bgr", width, height, copies);
+    run<PixelRgba, PixelBgra>("rgba -> bgra", width, height, copies);
+    run<PixelRgb, PixelMono>("rgb -> mono", width, height, copies);
+    run<PixelBgr, PixelMono>("bgr -> mono", width, height, copies);
+    run<PixelMono16, PixelFloat>("mono16 -> float", width, height, copies);
+    run<PixelRgb, PixelHsv>("rgb -> hsv", width, height, copies);
+
+    return 0;
+}
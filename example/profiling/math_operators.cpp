@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/math/FixedMatrix.h>
+#include <yarp/math/Math.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+
+// yarp::math micro benchmark.
+// Compare the operators of yarp::sig::Vector and yarp::sig::Matrix, that
+// return a new object for each result, with the in-place functions (axpy,
+// gemv, gemm) and the fixed size types (FixedVector, FixedMatrix), measuring
+// the time and the number of memory allocations of each operation, e.g.
+//
+//   math_operators --size 30 --iterations 1000000
+
+// Parameters:
+// --size: size of the vectors and matrices of the dynamic operations (default 30)
+// --iterations: number of iterations of each operation (default 1000000)
+
+namespace {
+std::atomic<size_t> allocations {0};
+} // namespace
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* p = std::malloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+// keeps the results alive, not to let the compiler remove the loops
+volatile double sink = 0.0;
+
+template <typename F>
+void run(const char* name, int iterations, F&& f)
+{
+    f(); // warm up, and allocate the results
+    size_t allocationsStart = allocations;
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < iterations; i++) {
+        f();
+    }
+    double duration = SystemClock::nowSystem() - start;
+    printf("%-28s %12.1f %12.2f\n",
+           name,
+           duration / iterations * 1e9,
+           static_cast<double>(allocations - allocationsStart) / iterations);
+}
+
+Vector randomVector(size_t n)
+{
+    Vector v(n);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = static_cast<double>(std::rand()) / RAND_MAX;
+    }
+    return v;
+}
+
+Matrix randomMatrix(size_t r, size_t c)
+{
+    Matrix m(r, c);
+    for (size_t i = 0; i < r; i++) {
+        for (size_t j = 0; j < c; j++) {
+            m(i, j) = static_cast<double>(std::rand()) / RAND_MAX;
+        }
+    }
+    return m;
+}
+
+Matrix randomTransform()
+{
+    Vector axis = randomVector(3);
+    axis /= yarp::math::norm(axis);
+    axis.push_back(static_cast<double>(std::rand()) / RAND_MAX);
+    Matrix H = axis2dcm(axis);
+    H(0, 3) = 0.1;
+    H(1, 3) = 0.2;
+    H(2, 3) = 0.3;
+    return H;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    auto n = static_cast<size_t>(p.check("size", Value(30)).asInt32());
+    int iterations = p.check("iterations", Value(1000000)).asInt32();
+
+    Vector x = randomVector(n);
+    Vector y = randomVector(n);
+    Matrix A = randomMatrix(n, n);
+    Matrix B = randomMatrix(n, n);
+    Vector v;
+    Matrix C;
+    double alpha = 1e-6;
+
+    printf("size %zu, %d iterations\n", n, iterations);
+    printf("%-28s %12s %12s\n", "operation", "time [ns]", "allocations");
+
+    run("y = y + alpha*x", iterations, [&]() { y = y + alpha * x; sink = y[0]; });
+    run("axpy(alpha, x, y)", iterations, [&]() { axpy(alpha, x, y); sink = y[0]; });
+    run("v = A*x + y", iterations, [&]() { v = A * x + y; sink = v[0]; });
+    run("gemv(1, A, x, 1, v)", iterations, [&]() { v = y; gemv(1.0, A, x, 1.0, v); sink = v[0]; });
+    run("C = A*B", iterations / static_cast<int>(n), [&]() { C = A * B; sink = C(0, 0); });
+    run("gemm(1, A, B, 0, C)", iterations / static_cast<int>(n), [&]() { gemm(1.0, A, B, 0.0, C); sink = C(0, 0); });
+
+    Matrix H1 = randomTransform();
+    Matrix H2 = randomTransform();
+    Matrix H3 = randomTransform();
+    Matrix H;
+    FixedMatrix4x4 fH1(H1);
+    FixedMatrix4x4 fH2(H2);
+    FixedMatrix4x4 fH3(H3);
+    FixedMatrix4x4 fH;
+    Vector pt {0.1, 0.2, 0.3, 1.0};
+    FixedVector4 fpt {0.1, 0.2, 0.3, 1.0};
+    Vector q;
+    FixedVector4 fq;
+
+    run("H = H1*H2*H3 (Matrix)", iterations, [&]() { H = H1 * H2 * H3; sink = H(0, 3); });
+    run("H = H1*H2*H3 (Fixed)", iterations, [&]() { fH = fH1 * fH2 * fH3; sink = fH(0, 3); });
+    run("H = SE3inv(H1) (Matrix)", iterations, [&]() { H = SE3inv(H1); sink = H(0, 3); });
+    run("H = SE3inv(H1) (Fixed)", iterations, [&]() { fH = SE3inv(fH1); sink = fH(0, 3); });
+    run("q = H1*p (Matrix)", iterations, [&]() { q = H1 * pt; sink = q[0]; });
+    run("q = H1*p (Fixed)", iterations, [&]() { fq = fH1 * fpt; sink = fq[0]; });
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#    include <sys/resource.h>
+#endif
+
+using namespace yarp::os;
+
+// Connection engine benchmark.
+// Measure the number of threads, the CPU usage, and the latency of a
+// port receiving data from a large number of connections.
+//
+// Run the server first, then the client, on the same machine (latency
+// is computed using the timestamps written by the client):
+//
+//   port_reactor --server [--duration 10]
+//   port_reactor --client [--connections 1000] [--period 0.01]
+//
+// Run the server with and without the event-driven engine, e.g.
+//
+//   YARP_PORT_REACTOR=4 port_reactor --server
+//
+// to compare the two implementations.  Note that the client opens one
+// port per connection, therefore it will always use at least one thread
+// per connection.
+
+// Parameters:
+// --server: receive data and print statistics
+// --client: send data
+// --name: the name of the receiving port (default /profiling/reactor)
+// --connections: number of connections opened by the client
+// --period: period of the messages sent on each connection [s]
+// --duration: how long the server collects statistics [s]
+
+namespace {
+
+int countThreads()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+#endif
+    return -1;
+}
+
+double cpuTime()
+{
+#if defined(__linux__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#else
+    return 0.0;
+#endif
+}
+
+class Reader : public BufferedPort<Bottle>
+{
+public:
+    std::mutex mutex;
+    std::vector<double> latencies;
+    bool collecting {false};
+
+    using BufferedPort<Bottle>::onRead;
+    void onRead(Bottle& datum) override
+    {
+        double dT = (Time::now() - datum.get(0).asFloat64()) * 1000;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (collecting) {
+            latencies.push_back(dT);
+        }
+    }
+};
+
+int server(Property& p)
+{
+    std::string name = p.check("name", Value("/profiling/reactor")).asString();
+    double duration = p.check("duration", Value(10.0)).asFloat64();
+
+    Reader port;
+    port.useCallback();
+    if (!port.open(name)) {
+        return 1;
+    }
+
+    int idleThreads = countThreads();
+    printf("Waiting for connections to %s (threads: %d)\n", name.c_str(), idleThreads);
+    int connections = 0;
+    while (connections == 0 || port.getInputCount() != connections) {
+        connections = port.getInputCount();
+        Time::delay(1.0);
+    }
+
+    printf("Collecting statistics from %d connections for %.1f seconds\n", connections, duration);
+    port.mutex.lock();
+    port.collecting = true;
+    port.mutex.unlock();
+    double t0 = Time::now();
+    double c0 = cpuTime();
+    Time::delay(duration);
+    double c1 = cpuTime();
+    double t1 = Time::now();
+    int threads = countThreads();
+
+    port.mutex.lock();
+    port.collecting = false;
+    std::vector<double> latencies = port.latencies;
+    port.mutex.unlock();
+
+    double sum = 0;
+    double sumSq = 0;
+    double max = 0;
+    for (double dT : latencies) {
+        sum += dT;
+        sumSq += dT * dT;
+        max = (dT > max) ? dT : max;
+    }
+    size_t n = latencies.size();
+    double avg = (n > 0) ? sum / n : 0;
+    double std = (n > 1) ? sqrt((sumSq - n * avg * avg) / (n - 1)) : 0;
+
+    printf("connections:        %d\n", connections);
+    printf("threads:            %d (%d before connecting)\n", threads, idleThreads);
+    printf("messages:           %zu (%.1f msg/s)\n", n, n / (t1 - t0));
+    printf("cpu usage:          %.1f%%\n", 100.0 * (c1 - c0) / (t1 - t0));
+    printf("latency [ms]:       avg %.3f, std %.3f, max %.3f\n", avg, std, max);
+
+    port.close();
+    return 0;
+}
+
+int client(Property& p)
+{
+    std::string name = p.check("name", Value("/profiling/reactor")).asString();
+    int connections = p.check("connections", Value(1000)).asInt32();
+    double period = p.check("period", Value(0.01)).asFloat64();
+
+    std::vector<std::unique_ptr<BufferedPort<Bottle>>> ports;
+    for (int i = 0; i < connections; ++i) {
+        ports.emplace_back(new BufferedPort<Bottle>);
+        std::string portName = name + "/client/" + std::to_string(i) + ":o";
+        if (!ports.back()->open(portName) || !Network::connect(portName, name)) {
+            printf("Cannot connect %s to %s\n", portName.c_str(), name.c_str());
+            return 1;
+        }
+    }
+    printf("Sending data on %d connections, press ctrl+c to quit\n", connections);
+
+    while (true) {
+        double start = Time::now();
+        for (auto& port : ports) {
+            Bottle& b = port->prepare();
+            b.clear();
+            b.addFloat64(Time::now());
+            port->write();
+        }
+        double elapsed = Time::now() - start;
+        if (elapsed < period) {
+            Time::delay(period - elapsed);
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    if (p.check("server")) {
+        return server(p);
+    }
+    if (p.check("client")) {
+        return client(p);
+    }
+
+    printf("Usage: %s --server|--client [options]\n", argv[0]);
+    return 1;
+}
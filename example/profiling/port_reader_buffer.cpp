@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/PortReaderBuffer.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace yarp::os;
+
+// PortReaderBuffer micro benchmark.
+// Compare the default and the lock-free implementations of the buffer,
+// passing objects from one or more writer threads (as the connections of
+// a port would do) to a reader thread, e.g.
+//
+//   port_reader_buffer --writers 4 --messages 100000 --strict
+//   port_reader_buffer --period 0.00025
+//
+// The objects are passed by pointer (as the local carrier does), so that
+// only the cost of the buffer is measured.
+
+// Parameters:
+// --writers: number of writer threads (default 1)
+// --messages: number of messages sent by each writer (default 100000)
+// --period: period of the messages of each writer [s] (default 0, as fast as possible)
+// --capacity: maximum number of buffers (default 128)
+// --strict: do not drop messages
+
+namespace {
+
+class Sample : public PortReader
+{
+public:
+    double time {0.0};
+
+    bool read(ConnectionReader& connection) override
+    {
+        YARP_UNUSED(connection);
+        return false;
+    }
+};
+
+struct Result
+{
+    size_t received {0};
+    double duration {0.0};
+    double avgLatency {0.0};
+    double maxLatency {0.0};
+};
+
+Result run(bool lockFree, int writers, int messages, double period, unsigned int capacity, bool strict)
+{
+    PortReaderBuffer<Sample> buffer(capacity);
+    buffer.setLockFree(lockFree);
+    buffer.setStrict(strict);
+
+    // each writer cycles on its own samples, there are enough of them to be
+    // sure that a sample is not reused while the reader still holds it
+    std::vector<std::vector<Sample>> samples(writers, std::vector<Sample>(4 * capacity + 2));
+    std::atomic<int> running {writers};
+
+    Result result;
+    double start = SystemClock::nowSystem();
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w]() {
+            std::vector<Sample>& pool = samples[w];
+            double next = SystemClock::nowSystem();
+            for (int i = 0; i < messages; i++) {
+                if (period > 0) {
+                    next += period;
+                    double wait = next - SystemClock::nowSystem();
+                    if (wait > 0) {
+                        SystemClock::delaySystem(wait);
+                    }
+                }
+                Sample& sample = pool[i % pool.size()];
+                sample.time = SystemClock::nowSystem();
+                buffer.acceptObject(&sample, nullptr);
+            }
+            if (--running == 0) {
+                buffer.interrupt();
+            }
+        });
+    }
+
+    double sum = 0;
+    while (true) {
+        Sample* sample = buffer.read();
+        if (sample == nullptr) {
+            if (running.load() == 0 && buffer.getPendingReads() == 0) {
+                break;
+            }
+            continue;
+        }
+        double latency = SystemClock::nowSystem() - sample->time;
+        sum += latency;
+        result.maxLatency = (latency > result.maxLatency) ? latency : result.maxLatency;
+        result.received++;
+    }
+    result.duration = SystemClock::nowSystem() - start;
+    result.avgLatency = (result.received > 0) ? sum / result.received : 0;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    int writers = p.check("writers", Value(1)).asInt32();
+    int messages = p.check("messages", Value(100000)).asInt32();
+    double period = p.check("period", Value(0.0)).asFloat64();
+    unsigned int capacity = p.check("capacity", Value(128)).asInt32();
+    bool strict = p.check("strict");
+
+    printf("%d writers, %d messages each, period %g s, capacity %u, %s\n",
+           writers,
+           messages,
+           period,
+           capacity,
+           strict ? "strict" : "not strict");
+    printf("%-12s %12s %12s %14s %14s\n", "buffer", "received", "msg/s", "avg lat [us]", "max lat [us]");
+    for (bool lockFree : {false, true}) {
+        Result r = run(lockFree, writers, messages, period, capacity, strict);
+        printf("%-12s %12zu %12.0f %14.2f %14.2f\n",
+               lockFree ? "lock-free" : "default",
+               r.received,
+               r.received / r.duration,
+               r.avgLatency * 1e6,
+               r.maxLatency * 1e6);
+    }
+
+    return 0;
+}
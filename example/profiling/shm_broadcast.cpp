@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <yarp/sig/Image.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Local broadcast benchmark.
+// Send images from one port to several readers on the same machine, and
+// measure how the cost of publishing an image grows with the number of
+// readers, e.g.
+//
+//   shm_broadcast --readers "(1 2 4 8)"
+//   shm_broadcast --carriers "(tcp shm shm+broadcast.1)"
+//
+// The publishing time is the time spent in write() and waitForWrite(),
+// i.e. until the image has been handed over to all the connections.
+
+// Parameters:
+// --width, --height: size of the RGB images (default 640x480)
+// --messages: number of images sent for each test (default 200)
+// --readers: list of numbers of readers (default (1 2 4 8))
+// --carriers: list of carriers to compare (default (tcp shm shm+broadcast.1))
+
+namespace {
+
+class Reader : public BufferedPort<ImageOf<PixelRgb>>
+{
+public:
+    std::atomic<int> received {0};
+    std::atomic<int> errors {0};
+
+    using BufferedPort<ImageOf<PixelRgb>>::onRead;
+    void onRead(ImageOf<PixelRgb>& img) override
+    {
+        // Each image is filled with the index of the message
+        const unsigned char* data = img.getRawImage();
+        if (img.getRawImageSize() == 0 || data[0] != data[img.getRawImageSize() - 1]) {
+            errors++;
+        }
+        received++;
+    }
+};
+
+struct Result
+{
+    bool ok {false};
+    double publish {0.0};
+    int errors {0};
+};
+
+Result run(const std::string& carrier, int readers, int width, int height, int messages)
+{
+    Result result;
+
+    BufferedPort<ImageOf<PixelRgb>> sender;
+    if (!sender.open("/profiling/broadcast:o")) {
+        return result;
+    }
+    std::vector<std::unique_ptr<Reader>> ports;
+    for (int i = 0; i < readers; i++) {
+        ports.emplace_back(new Reader);
+        ports.back()->setStrict();
+        ports.back()->useCallback();
+        std::string name = "/profiling/broadcast/" + std::to_string(i) + ":i";
+        if (!ports.back()->open(name) || !Network::connect(sender.getName(), name, carrier)) {
+            printf("Cannot connect using %s\n", carrier.c_str());
+            return result;
+        }
+    }
+
+    double sum = 0;
+    for (int i = 0; i < messages; i++) {
+        double start = SystemClock::nowSystem();
+        ImageOf<PixelRgb>& img = sender.prepare();
+        img.resize(width, height);
+        memset(img.getRawImage(), i & 0xff, img.getRawImageSize());
+        double filled = SystemClock::nowSystem();
+        sender.write();
+        sender.waitForWrite();
+        sum += SystemClock::nowSystem() - filled;
+        // give the readers the time to keep up, without counting it
+        for (auto& port : ports) {
+            while (port->received.load() <= i && SystemClock::nowSystem() - start < 1.0) {
+                SystemClock::delaySystem(0.0001);
+            }
+        }
+    }
+    result.publish = sum / messages;
+
+    sender.close();
+    for (auto& port : ports) {
+        port->close();
+        result.errors += port->errors.load() + (messages - port->received.load());
+    }
+    result.ok = true;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    int width = p.check("width", Value(640)).asInt32();
+    int height = p.check("height", Value(480)).asInt32();
+    int messages = p.check("messages", Value(200)).asInt32();
+    Bottle* readers = p.find("readers").asList();
+    Bottle defaultReaders("1 2 4 8");
+    if (readers == nullptr) {
+        readers = &defaultReaders;
+    }
+    Bottle* carriers = p.find("carriers").asList();
+    Bottle defaultCarriers("tcp shm shm+broadcast.1");
+    if (carriers == nullptr) {
+        carriers = &defaultCarriers;
+    }
+
+    printf("%d images of %dx%d pixels (%.1f MB)\n", messages, width, height, width * height * 3 / 1e6);
+    printf("%-36s %8s %14s %8s\n", "carrier", "readers", "publish [us]", "errors");
+    for (size_t i = 0; i < carriers->size(); i++) {
+        std::string carrier = carriers->get(i).asString();
+        for (size_t j = 0; j < readers->size(); j++) {
+            int n = readers->get(j).asInt32();
+            Result r = run(carrier, n, width, height, messages);
+            if (!r.ok) {
+                continue;
+            }
+            printf("%-36s %8d %14.1f %8d\n", carrier.c_str(), n, r.publish * 1e6, r.errors);
+        }
+    }
+
+    return 0;
+}
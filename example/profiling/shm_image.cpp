@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/SystemClock.h>
+
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Image transport benchmark.
+// Send images between two ports on the same machine, using different
+// carriers, and measure the latency and the throughput, e.g.
+//
+//   shm_image --width 1920 --height 1080 --messages 500
+//   shm_image --carriers "(tcp shm+slots.4+slot_size.8388608)"
+//
+// The latency is measured sending one image at a time and waiting for
+// it to be received, the throughput sending the images as fast as
+// possible (without dropping any of them).
+
+// Parameters:
+// --width, --height: size of the RGB images (default 640x480)
+// --messages: number of images sent for each test (default 1000)
+// --carriers: list of carriers to compare (default (tcp fast_tcp shm))
+
+namespace {
+
+struct Result
+{
+    bool ok {false};
+    double avgLatency {0.0};
+    double maxLatency {0.0};
+    double rate {0.0};
+};
+
+Result run(const std::string& carrier, int width, int height, int messages)
+{
+    Result result;
+
+    BufferedPort<ImageOf<PixelRgb>> sender;
+    BufferedPort<ImageOf<PixelRgb>> receiver;
+    receiver.setStrict();
+    if (!sender.open("/profiling/image:o") || !receiver.open("/profiling/image:i")) {
+        return result;
+    }
+    if (!Network::connect(sender.getName(), receiver.getName(), carrier)) {
+        printf("Cannot connect using %s\n", carrier.c_str());
+        return result;
+    }
+
+    auto send = [&](int i) {
+        ImageOf<PixelRgb>& img = sender.prepare();
+        img.resize(width, height);
+        memset(img.getRawImage(), i & 0xff, img.getRawImageSize());
+        Stamp stamp(i, SystemClock::nowSystem());
+        sender.setEnvelope(stamp);
+        sender.writeStrict();
+    };
+
+    // latency: one image at a time
+    double sum = 0;
+    for (int i = 0; i < messages; i++) {
+        send(i);
+        ImageOf<PixelRgb>* img = receiver.read();
+        if (img == nullptr) {
+            return result;
+        }
+        Stamp stamp;
+        receiver.getEnvelope(stamp);
+        double latency = SystemClock::nowSystem() - stamp.getTime();
+        sum += latency;
+        result.maxLatency = (latency > result.maxLatency) ? latency : result.maxLatency;
+    }
+    result.avgLatency = sum / messages;
+
+    // throughput: as fast as possible
+    double start = SystemClock::nowSystem();
+    std::thread reader([&]() {
+        for (int i = 0; i < messages; i++) {
+            if (receiver.read() == nullptr) {
+                return;
+            }
+        }
+    });
+    for (int i = 0; i < messages; i++) {
+        send(i);
+    }
+    reader.join();
+    result.rate = messages / (SystemClock::nowSystem() - start);
+    result.ok = true;
+
+    sender.close();
+    receiver.close();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    int width = p.check("width", Value(640)).asInt32();
+    int height = p.check("height", Value(480)).asInt32();
+    int messages = p.check("messages", Value(1000)).asInt32();
+    Bottle* carriers = p.find("carriers").asList();
+    Bottle defaultCarriers("tcp fast_tcp shm");
+    if (carriers == nullptr) {
+        carriers = &defaultCarriers;
+    }
+
+    printf("%d images of %dx%d pixels (%.1f MB)\n", messages, width, height, width * height * 3 / 1e6);
+    printf("%-36s %14s %14s %12s %12s\n", "carrier", "avg lat [us]", "max lat [us]", "img/s", "MB/s");
+    for (size_t i = 0; i < carriers->size(); i++) {
+        std::string carrier = carriers->get(i).asString();
+        Result r = run(carrier, width, height, messages);
+        if (!r.ok) {
+            continue;
+        }
+        printf("%-36s %14.1f %14.1f %12.1f %12.1f\n",
+               carrier.c_str(),
+               r.avgLatency * 1e6,
+               r.maxLatency * 1e6,
+               r.rate,
+               r.rate * width * height * 3 / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Portable.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Vector.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Vector read micro benchmark.
+// Count the memory allocations and measure the time needed to read the state
+// of the encoders of a part (positions, velocities, accelerations, torques
+// and control modes, as in the stateExt:o port of a control board), either in
+// new vectors for each message, or always in the same vectors.  Vectors of
+// up to VectorOf<T>::inlineCapacity elements do not allocate memory, e.g.
+//
+//   vector_read --joints 7 --reads 100000
+//   vector_read --joints 40 --reads 100000
+
+// Parameters:
+// --joints: number of joints (default 16)
+// --reads: number of messages read (default 100000)
+
+namespace {
+std::atomic<size_t> allocations {0};
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    allocations++;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+class EncoderState : public Portable
+{
+public:
+    Vector position;
+    Vector velocity;
+    Vector acceleration;
+    Vector torque;
+    VectorOf<int> controlMode;
+
+    bool read(ConnectionReader& connection) override
+    {
+        return position.read(connection) && velocity.read(connection) && acceleration.read(connection) && torque.read(connection) && controlMode.read(connection);
+    }
+
+    bool write(ConnectionWriter& connection) const override
+    {
+        return position.write(connection) && velocity.write(connection) && acceleration.write(connection) && torque.write(connection) && controlMode.write(connection);
+    }
+};
+
+struct Result
+{
+    double duration {0.0};
+    size_t allocations {0};
+    size_t steadyAllocations {0};
+};
+
+Result run(DummyConnector& con, int reads, bool reuse)
+{
+    Result result;
+    EncoderState reused;
+    for (int i = 0; i < reads; i++) {
+        // the reader allocates its own buffers, do not count them
+        ConnectionReader& reader = con.getReader();
+        size_t before = allocations.load();
+        double start = SystemClock::nowSystem();
+        if (reuse) {
+            reused.read(reader);
+        } else {
+            EncoderState state;
+            state.read(reader);
+        }
+        result.duration += SystemClock::nowSystem() - start;
+        size_t count = allocations.load() - before;
+        result.allocations += count;
+        if (i > 0) {
+            // the first read sizes the reused vectors
+            result.steadyAllocations += count;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Network yarp;
+
+    Property p;
+    p.fromCommand(argc, argv);
+
+    auto joints = static_cast<size_t>(p.check("joints", Value(16)).asInt32());
+    int reads = p.check("reads", Value(100000)).asInt32();
+
+    EncoderState msg;
+    msg.position.resize(joints, 0.1);
+    msg.velocity.resize(joints, 0.2);
+    msg.acceleration.resize(joints, 0.3);
+    msg.torque.resize(joints, 0.4);
+    msg.controlMode.resize(joints, 1);
+    DummyConnector con;
+    msg.write(con.getWriter());
+
+    printf("%zu joints (%zu stored in the vector), %d reads\n", joints, Vector::inlineCapacity, reads);
+    printf("%-12s %14s %16s %14s\n", "vectors", "allocs/read", "steady allocs", "time [us]");
+    for (bool reuse : {false, true}) {
+        Result r = run(con, reads, reuse);
+        printf("%-12s %14.1f %16zu %14.2f\n",
+               reuse ? "reused" : "new",
+               static_cast<double>(r.allocations) / reads,
+               r.steadyAllocations,
+               r.duration / reads * 1e6);
+    }
+
+    return 0;
+}
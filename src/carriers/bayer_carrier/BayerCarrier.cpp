@@ -117,11 +117,14 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
                 half = true;
             }
         }
+        use_dc1394 = false;
+        demosaic_method = yarp::sig::utils::DemosaicMethod::Bilinear;
         if (config.check("method")) {
             std::string method = config.find("method").asString();
             bayer_method_set = true;
             if (method=="ahd") {
                 m = DC1394_BAYER_METHOD_AHD;
+                use_dc1394 = true;
             } else if (method=="bilinear") {
                 m = DC1394_BAYER_METHOD_BILINEAR;
             } else if (method=="downsample") {
@@ -129,14 +132,20 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
                 half = true;
             } else if (method=="edgesense") {
                 m = DC1394_BAYER_METHOD_EDGESENSE;
+                use_dc1394 = true;
             } else if (method=="hqlinear") {
+                // same filters of the dc1394 hqlinear method
                 m = DC1394_BAYER_METHOD_HQLINEAR;
+                demosaic_method = yarp::sig::utils::DemosaicMethod::MalvarHeCutler;
             } else if (method=="nearest") {
                 m = DC1394_BAYER_METHOD_NEAREST;
+                use_dc1394 = true;
             } else if (method=="simple") {
                 m = DC1394_BAYER_METHOD_SIMPLE;
+                use_dc1394 = true;
             } else if (method=="vng") {
                 m = DC1394_BAYER_METHOD_VNG;
+                use_dc1394 = true;
             } else {
                 yCWarning/*Once*/(BAYERCARRIER, "bayer method %s not recognized, try: ahd bilinear downsample edgesense hqlinear nearest simple vng", method.c_str());
                 happy = false;
@@ -144,6 +153,12 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
                 return *local;
             }
         }
+        int nThreads = config.check("threads", Value(1)).asInt32();
+        if (nThreads < 0) {
+            yCWarning(BAYERCARRIER, "threads should be a non negative integer, got %d, using 1 thread", nThreads);
+            nThreads = 1;
+        }
+        threads = static_cast<size_t>(nThreads);
 
         setFormat(config.check("order",Value("grbg")).asString().c_str());
         header_in.setFromImage(in);
@@ -203,6 +218,10 @@ bool BayerCarrier::debayerHalf(yarp::sig::ImageOf<PixelMono>& src,
 
 bool BayerCarrier::debayerFull(yarp::sig::ImageOf<PixelMono>& src,
                                yarp::sig::ImageOf<PixelRgb>& dest) {
+    if (!use_dc1394) {
+        return yarp::sig::utils::deBayer(src, bayer_code, dest, demosaic_method, threads);
+    }
+
     // dc1394 doesn't seem safe for arbitrary data widths
     if (src.width()%8==0) {
         dc1394video_frame_t dc_src;
@@ -214,91 +233,8 @@ bool BayerCarrier::debayerFull(yarp::sig::ImageOf<PixelMono>& src,
         return true;
     }
 
-    if (bayer_method_set) {
-        yCWarning/*Once*/(BAYERCARRIER, "Not using dc1394 debayer methods (image width not a multiple of 8)");
-    }
-    int w = dest.width();
-    int h = dest.height();
-    int goff1 = 1-goff;
-    int roffx = roff?goff:goff1;
-    int boff = 1-roff;
-    int boffx = boff?goff:goff1;
-    for (int y=0; y<h; y++) {
-        for (int x=0; x<w; x++) {
-            PixelRgb& po = dest.pixel(x,y);
-
-            // G
-            if ((x+y)%2==goff) {
-                po.g = src.pixel(x,y);
-            } else {
-                float g = 0;
-                int ct = 0;
-                if (x>0) { g += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { g += src.pixel(x+1,y); ct++; }
-                if (y>0) { g += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { g += src.pixel(x,y+1); ct++; }
-                if (ct>0) { g /= ct; }
-                po.g = static_cast<int>(g);
-            }
-
-            // B
-            if (y%2==boff && x%2==boffx) {
-                po.b = src.pixel(x,y);
-            } else if (y%2==boff) {
-                float b = 0;
-                int ct = 0;
-                if (x>0) { b += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { b += src.pixel(x+1,y); ct++; }
-                if (ct>0) { b /= ct; }
-                po.b = static_cast<int>(b);
-            } else if (x%2==boffx) {
-                float b = 0;
-                int ct = 0;
-                if (y>0) { b += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { b += src.pixel(x,y+1); ct++; }
-                if (ct>0) { b /= ct; }
-                po.b = static_cast<int>(b);
-            } else {
-                float b = 0;
-                int ct = 0;
-                if (x>0&&y>0) { b += src.pixel(x-1,y-1); ct++; }
-                if (x>0&&y<h-1) { b += src.pixel(x-1,y+1); ct++; }
-                if (x<w-1&&y>0) { b += src.pixel(x+1,y-1); ct++; }
-                if (x<w-1&&y<h-1) { b += src.pixel(x+1,y+1); ct++; }
-                if (ct>0) { b /= ct; }
-                po.b = static_cast<int>(b);
-            }
-
-            // R
-            if (y%2==roff && x%2==roffx) {
-                po.r = src.pixel(x,y);
-            } else if (y%2==roff) {
-                float r = 0;
-                int ct = 0;
-                if (x>0) { r += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { r += src.pixel(x+1,y); ct++; }
-                if (ct>0) { r /= ct; }
-                po.r = static_cast<int>(r);
-            } else if (x%2==roffx) {
-                float r = 0;
-                int ct = 0;
-                if (y>0) { r += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { r += src.pixel(x,y+1); ct++; }
-                if (ct>0) { r /= ct; }
-                po.r = static_cast<int>(r);
-            } else {
-                float r = 0;
-                int ct = 0;
-                if (x>0&&y>0) { r += src.pixel(x-1,y-1); ct++; }
-                if (x>0&&y<h-1) { r += src.pixel(x-1,y+1); ct++; }
-                if (x<w-1&&y>0) { r += src.pixel(x+1,y-1); ct++; }
-                if (x<w-1&&y<h-1) { r += src.pixel(x+1,y+1); ct++; }
-                if (ct>0) { r /= ct; }
-                po.r = static_cast<int>(r);
-            }
-        }
-    }
-    return true;
+    yCWarning/*Once*/(BAYERCARRIER, "Not using dc1394 debayer methods (image width not a multiple of 8)");
+    return yarp::sig::utils::deBayer(src, bayer_code, dest, yarp::sig::utils::DemosaicMethod::Bilinear, threads);
 }
 
 bool BayerCarrier::processBuffered() const {
@@ -375,6 +311,7 @@ yarp::conf::ssize_t BayerCarrier::read(yarp::os::Bytes& b) {
 
 bool BayerCarrier::setFormat(const char *fmt) {
     dcformat = DC1394_COLOR_FILTER_GRBG;
+    bayer_code = VOCAB_PIXEL_ENCODING_BAYER_GRBG8;
     std::string f(fmt);
     if (f.length()<2) {
         return false;
@@ -383,12 +320,16 @@ bool BayerCarrier::setFormat(const char *fmt) {
     roff = (f[0]=='r'||f[0]=='R'||f[1]=='r'||f[1]=='R')?0:1;
     if (goff==0&&roff==0) {
         dcformat = DC1394_COLOR_FILTER_GRBG;
+        bayer_code = VOCAB_PIXEL_ENCODING_BAYER_GRBG8;
     } else if (goff==0&&roff==1) {
         dcformat = DC1394_COLOR_FILTER_GBRG;
+        bayer_code = VOCAB_PIXEL_ENCODING_BAYER_GBRG8;
     } else if (goff==1&&roff==0) {
         dcformat = DC1394_COLOR_FILTER_RGGB;
+        bayer_code = VOCAB_PIXEL_ENCODING_BAYER_RGGB8;
     } else if (goff==1&&roff==1) {
         dcformat = DC1394_COLOR_FILTER_BGGR;
+        bayer_code = VOCAB_PIXEL_ENCODING_BAYER_BGGR8;
     }
     return true;
 }
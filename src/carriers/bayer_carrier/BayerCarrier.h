@@ -13,6 +13,7 @@
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/ImageNetworkHeader.h>
+#include <yarp/sig/ImageUtils.h>
 #include <yarp/os/DummyConnector.h>
 
 /**
@@ -22,6 +23,7 @@
  *   tcp+recv.bayer
  *   tcp+recv.bayer+size.half
  *   tcp+recv.bayer+size.half+order.bggr
+ *   tcp+recv.bayer+method.hqlinear+threads.4
  *
  */
 class BayerCarrier :
@@ -47,11 +49,15 @@ private:
     bool bayer_method_set;
 
     int bayer_method;
+    bool use_dc1394;
+    yarp::sig::utils::DemosaicMethod demosaic_method;
+    size_t threads;
 
     // format offsets
     int goff; // x offset to green on even rows
     int roff; // y offset to red on even columns
     int dcformat;
+    int bayer_code; // VOCAB_PIXEL_ENCODING_BAYER_*
 
     bool setFormat(const char *fmt);
 public:
@@ -71,9 +77,13 @@ public:
         half(false),
         bayer_method_set(false),
         bayer_method(-1),
+        use_dc1394(false),
+        demosaic_method(yarp::sig::utils::DemosaicMethod::Bilinear),
+        threads(1),
         goff(0),
         roff(1),
-        dcformat(-1)
+        dcformat(-1),
+        bayer_code(VOCAB_PIXEL_ENCODING_BAYER_GRBG8)
     {}
 
     ~BayerCarrier() {
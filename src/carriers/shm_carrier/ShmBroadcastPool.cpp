@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmBroadcastPool.h"
+
+#include <yarp/os/LogStream.h>
+
+#include "ShmLogComponent.h"
+
+#include <cstring>
+#include <map>
+#include <new>
+
+namespace {
+
+constexpr uint64_t cacheLineSize = 64;
+
+uint64_t alignToCacheLine(uint64_t size)
+{
+    return (size + cacheLineSize - 1) / cacheLineSize * cacheLineSize;
+}
+
+uint64_t slotStride(uint64_t slotSize)
+{
+    return alignToCacheLine(sizeof(ShmPoolSlot) + slotSize);
+}
+
+uint64_t slotsOffset()
+{
+    return alignToCacheLine(sizeof(ShmPoolHeader));
+}
+
+// The pools of the output ports of this process
+std::mutex poolsMutex;
+std::map<std::string, std::weak_ptr<ShmBroadcastPool>> pools;
+
+} // namespace
+
+
+std::shared_ptr<ShmBroadcastPool> ShmBroadcastPool::getPool(const std::string& port,
+                                                            uint32_t slotCount,
+                                                            uint64_t slotSize)
+{
+    std::lock_guard<std::mutex> lock(poolsMutex);
+    std::shared_ptr<ShmBroadcastPool> pool = pools[port].lock();
+    if (!pool) {
+        pool = std::make_shared<ShmBroadcastPool>();
+        if (!pool->create(slotCount, slotSize)) {
+            pools.erase(port);
+            return nullptr;
+        }
+        pools[port] = pool;
+    }
+    return pool;
+}
+
+
+bool ShmBroadcastPool::create(uint32_t slotCount, uint64_t slotSize)
+{
+    if (slotCount == 0 || slotSize == 0) {
+        yCError(SHMCARRIER, "Invalid pool size (%u slots of %llu bytes)", slotCount, static_cast<unsigned long long>(slotSize));
+        return false;
+    }
+    uint64_t size = slotsOffset() + slotCount * slotStride(slotSize);
+    if (!memory.create("/yarp-shm-pool-", size)) {
+        return false;
+    }
+
+    // The memory is zero filled, the atomic fields are already initialized
+    hdr = new (memory.getAddress()) ShmPoolHeader;
+    hdr->version = ShmPoolHeader::currentVersion;
+    hdr->size = size;
+    hdr->slotCount = slotCount;
+    hdr->slotSize = slotSize;
+    hdr->magic.store(ShmPoolHeader::magicNumber, std::memory_order_release);
+
+    yCDebug(SHMCARRIER, "Created pool %s (%llu bytes)", getName().c_str(), static_cast<unsigned long long>(size));
+    return true;
+}
+
+
+bool ShmBroadcastPool::open(const std::string& name)
+{
+    if (!memory.open(name)) {
+        return false;
+    }
+    auto* h = reinterpret_cast<ShmPoolHeader*>(memory.getAddress());
+    if (memory.getSize() < sizeof(ShmPoolHeader)
+        || h->magic.load(std::memory_order_acquire) != ShmPoolHeader::magicNumber
+        || h->version != ShmPoolHeader::currentVersion
+        || h->size != memory.getSize()
+        || slotsOffset() + h->slotCount * slotStride(h->slotSize) > memory.getSize()) {
+        yCError(SHMCARRIER, "Pool %s is not valid", name.c_str());
+        return false;
+    }
+    hdr = h;
+
+    yCDebug(SHMCARRIER, "Opened pool %s (%zu bytes)", name.c_str(), memory.getSize());
+    return true;
+}
+
+
+ShmPoolSlot& ShmBroadcastPool::slot(int index) const
+{
+    return *reinterpret_cast<ShmPoolSlot*>(memory.getAddress() + slotsOffset() + index * slotStride(hdr->slotSize));
+}
+
+
+const char* ShmBroadcastPool::data(int index) const
+{
+    return reinterpret_cast<const char*>(&slot(index)) + sizeof(ShmPoolSlot);
+}
+
+
+int ShmBroadcastPool::acquire(uint64_t messageId, yarp::os::SizedWriter& writer, size_t length)
+{
+    if (length > hdr->slotSize) {
+        return -1;
+    }
+
+    // Slots are reused only here, while holding the mutex: a slot
+    // containing the message cannot be overwritten while it is being
+    // looked up
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint32_t i = 0; i < hdr->slotCount; i++) {
+        ShmPoolSlot& s = slot(i);
+        if (s.messageId.load(std::memory_order_relaxed) == messageId && s.length == length) {
+            s.refs.fetch_add(1);
+            return static_cast<int>(i);
+        }
+    }
+
+    for (uint32_t n = 0; n < hdr->slotCount; n++) {
+        uint32_t i = (next + n) % hdr->slotCount;
+        ShmPoolSlot& s = slot(i);
+        if (s.refs.load(std::memory_order_acquire) != 0) {
+            continue;
+        }
+        s.messageId.store(0, std::memory_order_relaxed);
+        char* dest = const_cast<char*>(data(i));
+        for (size_t j = 0; j < writer.length(); j++) {
+            memcpy(dest, writer.data(j), writer.length(j));
+            dest += writer.length(j);
+        }
+        s.length = length;
+        s.messageId.store(messageId, std::memory_order_relaxed);
+        s.refs.store(1, std::memory_order_relaxed);
+        next = (i + 1) % hdr->slotCount;
+        return static_cast<int>(i);
+    }
+
+    // All the slots are still used by some reader
+    return -1;
+}
+
+
+void ShmBroadcastPool::release(int index)
+{
+    slot(index).refs.fetch_sub(1, std::memory_order_release);
+}
+
+
+bool ShmBroadcastPool::contains(int index, uint64_t messageId, uint64_t length) const
+{
+    if (hdr == nullptr || index < 0 || static_cast<uint32_t>(index) >= hdr->slotCount) {
+        return false;
+    }
+    const ShmPoolSlot& s = slot(index);
+    return s.messageId.load(std::memory_order_relaxed) == messageId && s.length == length;
+}
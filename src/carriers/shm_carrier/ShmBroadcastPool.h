@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHM_SHMBROADCASTPOOL_H
+#define YARP_SHM_SHMBROADCASTPOOL_H
+
+#include <yarp/os/SizedWriter.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "ShmMemory.h"
+
+/**
+ * The header of a slot of the broadcast pool.
+ *
+ * `refs` counts the connections that still have to read the slot; the
+ * slot can be reused by the sender when it drops to zero.
+ */
+struct ShmPoolSlot
+{
+    std::atomic<uint32_t> refs;
+    uint32_t reserved;
+    std::atomic<uint64_t> messageId;
+    uint64_t length;
+};
+
+/**
+ * The header of the broadcast pool.
+ */
+struct ShmPoolHeader
+{
+    static constexpr uint32_t magicNumber = 0x5952504c; // "YRPL"
+    static constexpr uint32_t currentVersion = 1;
+
+    std::atomic<uint32_t> magic; // written last by the creator
+    uint32_t version;
+    uint64_t size;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotSize;
+};
+
+/**
+ * A pool of reference counted slots in shared memory, shared by all the
+ * shm connections of an output port using the broadcast mode.
+ *
+ * A message sent on several connections is copied once in a slot, and
+ * each connection sends only a reference to the slot to its reader,
+ * that reads the message directly from the pool.
+ */
+class ShmBroadcastPool
+{
+public:
+    ShmBroadcastPool() = default;
+    ShmBroadcastPool(const ShmBroadcastPool&) = delete;
+    ShmBroadcastPool(ShmBroadcastPool&&) = delete;
+    ShmBroadcastPool& operator=(const ShmBroadcastPool&) = delete;
+    ShmBroadcastPool& operator=(ShmBroadcastPool&&) = delete;
+
+    ~ShmBroadcastPool() = default;
+
+    /**
+     * Get the pool of an output port, creating it if necessary (sender
+     * side).  The pool is destroyed when the last connection releases it.
+     *
+     * @param port the name of the output port
+     * @param slotCount the number of slots, if the pool is created
+     * @param slotSize the size of the slots, if the pool is created
+     * @return the pool, or nullptr on failure
+     */
+    static std::shared_ptr<ShmBroadcastPool> getPool(const std::string& port,
+                                                     uint32_t slotCount,
+                                                     uint64_t slotSize);
+
+    /**
+     * Open the pool created by the sender (receiver side).
+     *
+     * @param name the name of the pool
+     * @return true on success
+     */
+    bool open(const std::string& name);
+
+    const std::string& getName() const { return memory.getName(); }
+
+    /**
+     * Get a slot containing a message, copying the message in a free slot
+     * unless it is already in the pool (sender side).  The reference count
+     * of the slot is incremented.
+     *
+     * @param messageId the identifier of the message
+     * @param writer the message
+     * @param length the total length of the message
+     * @return the index of the slot, or -1 if the message does not fit in
+     *         a slot or no slot is free
+     */
+    int acquire(uint64_t messageId, yarp::os::SizedWriter& writer, size_t length);
+
+    /**
+     * Decrement the reference count of a slot.
+     */
+    void release(int index);
+
+    /**
+     * @return true if the slot contains the message
+     */
+    bool contains(int index, uint64_t messageId, uint64_t length) const;
+
+    /**
+     * @return the content of a slot
+     */
+    const char* data(int index) const;
+
+private:
+    bool create(uint32_t slotCount, uint64_t slotSize);
+    ShmPoolSlot& slot(int index) const;
+
+    ShmMemory memory;
+    ShmPoolHeader* hdr {nullptr};
+    std::mutex mutex;
+    uint32_t next {0};
+};
+
+#endif // YARP_SHM_SHMBROADCASTPOOL_H
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmCarrier.h"
+
+#include <yarp/os/Bytes.h>
+#include <yarp/os/ConnectionState.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Name.h>
+#include <yarp/os/Route.h>
+#include <yarp/os/Value.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
+
+#include "ShmLogComponent.h"
+#include "ShmTwoWayStream.h"
+
+#include <memory>
+
+using namespace yarp::os;
+
+namespace {
+
+bool isSameHost(ConnectionState& proto)
+{
+    const Contact& remote = proto.getStreams().getRemoteAddress();
+    const Contact& local = proto.getStreams().getLocalAddress();
+
+    if (remote.getHost() != local.getHost()) {
+        yCDebug(SHMCARRIER, "The ports are on different machines, using tcp");
+        return false;
+    }
+    return true;
+}
+
+uint64_t getModifier(Name& n, const char* mod, uint64_t defaultValue)
+{
+    bool hasField = false;
+    std::string str = n.getCarrierModifier(mod, &hasField);
+    if (!hasField) {
+        return defaultValue;
+    }
+    Value v;
+    v.fromString(str.c_str());
+    if (!v.isInt32() && !v.isInt64()) {
+        yCWarning(SHMCARRIER, "Invalid value for %s: %s", mod, str.c_str());
+        return defaultValue;
+    }
+    return static_cast<uint64_t>(v.asInt64());
+}
+
+void sendName(ConnectionState& proto, const std::string& name)
+{
+    char len = static_cast<char>(name.length());
+    proto.os().write(Bytes(&len, 1));
+    if (!name.empty()) {
+        proto.os().write(Bytes(const_cast<char*>(name.c_str()), name.length()));
+    }
+}
+
+bool receiveName(ConnectionState& proto, std::string& name)
+{
+    char len = 0;
+    Bytes lenBytes(&len, 1);
+    if (proto.is().readFull(lenBytes) != 1) {
+        return false;
+    }
+    name.assign(static_cast<size_t>(static_cast<unsigned char>(len)), '\0');
+    if (name.empty()) {
+        return true;
+    }
+    Bytes nameBytes(&name[0], name.length());
+    return proto.is().readFull(nameBytes) == static_cast<yarp::conf::ssize_t>(name.length());
+}
+
+} // namespace
+
+
+Carrier* ShmCarrier::create() const
+{
+    return new ShmCarrier();
+}
+
+
+std::string ShmCarrier::getName() const
+{
+    return name;
+}
+
+
+bool ShmCarrier::requireAck() const
+{
+    return false;
+}
+
+
+bool ShmCarrier::isConnectionless() const
+{
+    return false;
+}
+
+
+bool ShmCarrier::checkHeader(const Bytes& header)
+{
+    if (header.length() != headerSize) {
+        return false;
+    }
+    for (size_t i = 0; i < headerSize; i++) {
+        if (header.get()[i] != headerCode[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void ShmCarrier::getHeader(Bytes& header) const
+{
+    for (size_t i = 0; i < headerSize && i < header.length(); i++) {
+        header.get()[i] = headerCode[i];
+    }
+}
+
+
+bool ShmCarrier::expectReplyToHeader(ConnectionState& proto)
+{
+    // I am the sender: create the segment and send its name to the receiver
+    if (!isSameHost(proto)) {
+        // Keep using tcp
+        return true;
+    }
+
+    Name n(proto.getRoute().getCarrierName() + "://test");
+    uint64_t slotCount = getModifier(n, "slots", defaultSlotCount);
+    uint64_t slotSize = getModifier(n, "slot_size", defaultSlotSize);
+    if (slotCount == 0 || slotCount > UINT32_MAX || slotSize == 0) {
+        yCError(SHMCARRIER, "Invalid ring size (%llu slots of %llu bytes)", static_cast<unsigned long long>(slotCount), static_cast<unsigned long long>(slotSize));
+        return false;
+    }
+
+    std::unique_ptr<ShmTwoWayStream> shmStream(new ShmTwoWayStream);
+    if (!shmStream->create(static_cast<uint32_t>(slotCount), slotSize)) {
+        return false;
+    }
+    shmStream->setLocalAddress(proto.getStreams().getLocalAddress());
+    shmStream->setRemoteAddress(proto.getStreams().getRemoteAddress());
+
+    std::string poolName;
+    if (getModifier(n, "broadcast", 0) != 0) {
+        // The pool is shared by all the connections of the port, the
+        // first connection decides its size
+        uint64_t poolSlotCount = getModifier(n, "pool_slots", defaultPoolSlotCount);
+        uint64_t poolSlotSize = getModifier(n, "pool_slot_size", defaultPoolSlotSize);
+        if (poolSlotCount == 0 || poolSlotCount > UINT32_MAX) {
+            yCError(SHMCARRIER, "Invalid number of pool slots %llu", static_cast<unsigned long long>(poolSlotCount));
+            return false;
+        }
+        auto pool = ShmBroadcastPool::getPool(proto.getRoute().getFromName(), static_cast<uint32_t>(poolSlotCount), poolSlotSize);
+        if (!pool) {
+            return false;
+        }
+        poolName = pool->getName();
+        shmStream->setPool(pool);
+    }
+
+    const std::string& segmentName = shmStream->getSegment().getName();
+    sendName(proto, segmentName);
+    sendName(proto, poolName);
+    proto.os().flush();
+
+    // Wait until the receiver opened the segment, then remove its name
+    char ack = 0;
+    Bytes ackBytes(&ack, 1);
+    yarp::conf::ssize_t r = proto.is().readFull(ackBytes);
+    shmStream->getSegment().unlink();
+    if (r != 1 || ack != 1) {
+        yCError(SHMCARRIER, "The receiver could not open the segment %s", segmentName.c_str());
+        return false;
+    }
+
+    stream = shmStream.get();
+    proto.takeStreams(nullptr); // free up port from tcp
+    proto.takeStreams(shmStream.release());
+
+    yCDebug(SHMCARRIER, "Connected on segment %s as sender", segmentName.c_str());
+    return true;
+}
+
+
+bool ShmCarrier::respondToHeader(ConnectionState& proto)
+{
+    // I am the receiver: open the segment created by the sender
+    if (!isSameHost(proto)) {
+        // Keep using tcp
+        return true;
+    }
+
+    std::string segmentName;
+    std::string poolName;
+    if (!receiveName(proto, segmentName) || segmentName.empty() || !receiveName(proto, poolName)) {
+        return false;
+    }
+
+    std::unique_ptr<ShmTwoWayStream> shmStream(new ShmTwoWayStream);
+    bool ok = shmStream->open(segmentName, poolName);
+
+    char ack = ok ? 1 : 0;
+    proto.os().write(Bytes(&ack, 1));
+    proto.os().flush();
+    if (!ok) {
+        return false;
+    }
+    shmStream->setLocalAddress(proto.getStreams().getLocalAddress());
+    shmStream->setRemoteAddress(proto.getStreams().getRemoteAddress());
+
+    stream = shmStream.get();
+    proto.takeStreams(nullptr); // free up port from tcp
+    proto.takeStreams(shmStream.release());
+
+    yCDebug(SHMCARRIER, "Connected on segment %s as receiver", segmentName.c_str());
+    return true;
+}
+
+
+bool ShmCarrier::write(ConnectionState& proto, SizedWriter& writer)
+{
+    auto* buf = dynamic_cast<yarp::os::impl::BufferedConnectionWriter*>(&writer);
+    if (stream == nullptr || stream->getPool() == nullptr || buf == nullptr || buf->getMessageId() == 0) {
+        return AbstractCarrier::write(proto, writer);
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < writer.length(); i++) {
+        length += writer.length(i);
+    }
+    if (length < broadcastThreshold) {
+        return AbstractCarrier::write(proto, writer);
+    }
+
+    if (!sendIndex(proto, writer)) {
+        return false;
+    }
+    if (!stream->writeShared(buf->getMessageId(), writer, length)) {
+        // The pool is full, copy the message in the ring
+        writer.write(proto.os());
+    }
+    proto.os().flush();
+    return proto.os().isOk();
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHM_SHMCARRIER_H
+#define YARP_SHM_SHMCARRIER_H
+
+#include <yarp/os/AbstractCarrier.h>
+
+class ShmTwoWayStream;
+
+/**
+ * Communicating between two ports on the same machine using a POSIX
+ * shared memory segment.
+ *
+ * The segment is created by the sender, and its name is sent to the
+ * receiver on the initial tcp connection, that is closed afterwards.
+ * The segment contains a ring of slots for each direction, and the
+ * threads waiting for data or for free slots are woken up using futexes.
+ *
+ * The size of the ring used for sending data can be set using the
+ * carrier modifiers, for example:
+ *
+ *   yarp connect /out /in shm+slots.4+slot_size.4194304
+ *
+ * The default is 8 slots of 1 MiB.  Messages larger than a slot are
+ * split over several slots.
+ *
+ * When an output port has several local readers, the broadcast mode
+ * writes each large message once in a pool of reference counted slots
+ * shared by all the connections of the port, and the readers read it from
+ * there.  The cost of publishing a message does not depend on the number
+ * of readers:
+ *
+ *   yarp connect /out /in shm+broadcast.1+pool_slots.4+pool_slot_size.8388608
+ *
+ * The size of the pool is decided by the first connection of the port.
+ * The default is 4 slots of 8 MiB.  If no slot is free, or if the message
+ * is too large, the message is sent on the ring of the connection.
+ * A slot being read by a reader that dies is released when the sender
+ * notices it, and closes the connection.
+ *
+ * If the ports are not on the same machine, the carrier keeps using the
+ * tcp connection.
+ */
+class ShmCarrier :
+        public yarp::os::AbstractCarrier
+{
+public:
+    ShmCarrier() = default;
+    ShmCarrier(const ShmCarrier&) = delete;
+    ShmCarrier(ShmCarrier&&) = delete;
+    ShmCarrier& operator=(const ShmCarrier&) = delete;
+    ShmCarrier& operator=(ShmCarrier&&) = delete;
+
+    ~ShmCarrier() override = default;
+
+    yarp::os::Carrier* create() const override;
+
+    std::string getName() const override;
+
+    bool requireAck() const override;
+    bool isConnectionless() const override;
+
+    bool checkHeader(const yarp::os::Bytes& header) override;
+    void getHeader(yarp::os::Bytes& header) const override;
+
+    bool respondToHeader(yarp::os::ConnectionState& proto) override;
+    bool expectReplyToHeader(yarp::os::ConnectionState& proto) override;
+
+    bool write(yarp::os::ConnectionState& proto, yarp::os::SizedWriter& writer) override;
+
+private:
+    static constexpr const char* name = "shm";
+    static constexpr const char* headerCode = "SHM_RING";
+    static constexpr size_t headerSize = 8;
+
+    static constexpr uint32_t defaultSlotCount = 8;
+    static constexpr uint64_t defaultSlotSize = 1024 * 1024;
+    static constexpr uint32_t defaultPoolSlotCount = 4;
+    static constexpr uint64_t defaultPoolSlotSize = 8 * 1024 * 1024;
+
+    // Smaller messages are always copied in the ring of the connection
+    static constexpr size_t broadcastThreshold = 16 * 1024;
+
+    ShmTwoWayStream* stream {nullptr};
+};
+
+#endif // YARP_SHM_SHMCARRIER_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmMemory.h"
+
+#include <yarp/os/LogStream.h>
+
+#include "ShmLogComponent.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+std::atomic<unsigned int> objectCounter {0};
+} // namespace
+
+
+ShmMemory::~ShmMemory()
+{
+    unlink();
+    if (address != nullptr) {
+        ::munmap(address, size);
+        address = nullptr;
+    }
+}
+
+
+bool ShmMemory::create(const std::string& prefix, size_t objectSize)
+{
+    int fd = -1;
+    while (fd < 0) {
+        name = prefix + std::to_string(::getpid()) + "-" + std::to_string(objectCounter++);
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (fd < 0 && errno != EEXIST) {
+            yCError(SHMCARRIER, "shm_open(%s) failed: %s", name.c_str(), strerror(errno));
+            return false;
+        }
+    }
+    creator = true;
+    linked = true;
+
+    if (::ftruncate(fd, static_cast<off_t>(objectSize)) != 0) {
+        yCError(SHMCARRIER, "Cannot resize %s to %zu bytes: %s", name.c_str(), objectSize, strerror(errno));
+        ::close(fd);
+        unlink();
+        return false;
+    }
+    if (!map(fd, objectSize)) {
+        unlink();
+        return false;
+    }
+    return true;
+}
+
+
+bool ShmMemory::open(const std::string& objectName)
+{
+    name = objectName;
+    creator = false;
+
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        yCError(SHMCARRIER, "shm_open(%s) failed: %s", name.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        yCError(SHMCARRIER, "Cannot get the size of %s", name.c_str());
+        ::close(fd);
+        return false;
+    }
+    return map(fd, static_cast<size_t>(st.st_size));
+}
+
+
+bool ShmMemory::map(int fd, size_t objectSize)
+{
+    void* addr = ::mmap(nullptr, objectSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        yCError(SHMCARRIER, "Cannot map %s: %s", name.c_str(), strerror(errno));
+        return false;
+    }
+    address = static_cast<char*>(addr);
+    size = objectSize;
+    return true;
+}
+
+
+void ShmMemory::unlink()
+{
+    if (creator && linked) {
+        ::shm_unlink(name.c_str());
+        linked = false;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHM_SHMMEMORY_H
+#define YARP_SHM_SHMMEMORY_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A POSIX shared memory object, mapped in the address space of the
+ * process.
+ */
+class ShmMemory
+{
+public:
+    ShmMemory() = default;
+    ShmMemory(const ShmMemory&) = delete;
+    ShmMemory(ShmMemory&&) = delete;
+    ShmMemory& operator=(const ShmMemory&) = delete;
+    ShmMemory& operator=(ShmMemory&&) = delete;
+
+    /**
+     * Destructor.  Unmap the memory, and remove its name if it was created
+     * by this object.
+     */
+    ~ShmMemory();
+
+    /**
+     * Create a new object, with a unique name, filled with zeros.
+     *
+     * @param prefix the prefix of the name
+     * @param size the size of the object
+     * @return true on success
+     */
+    bool create(const std::string& prefix, size_t size);
+
+    /**
+     * Open an existing object.
+     *
+     * @param name the name of the object
+     * @return true on success
+     */
+    bool open(const std::string& name);
+
+    /**
+     * Remove the name of the object, if it was created by this object.
+     * The memory is released when it is unmapped by all the processes.
+     */
+    void unlink();
+
+    const std::string& getName() const { return name; }
+    char* getAddress() const { return address; }
+    size_t getSize() const { return size; }
+    bool isCreator() const { return creator; }
+
+private:
+    bool map(int fd, size_t size);
+
+    std::string name;
+    char* address {nullptr};
+    size_t size {0};
+    bool creator {false};
+    bool linked {false};
+};
+
+#endif // YARP_SHM_SHMMEMORY_H
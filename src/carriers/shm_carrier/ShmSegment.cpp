@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmSegment.h"
+
+#include <yarp/os/LogStream.h>
+
+#include "ShmLogComponent.h"
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <ctime>
+#include <new>
+
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "std::atomic<uint32_t> cannot be used as a futex");
+
+namespace {
+constexpr size_t slotLengthSize = sizeof(uint64_t);
+
+uint64_t alignToCacheLine(uint64_t size)
+{
+    constexpr uint64_t align = ShmRingHeader::cacheLineSize;
+    return (size + align - 1) / align * align;
+}
+} // namespace
+
+
+uint64_t ShmSegment::slotStride(uint64_t slotSize)
+{
+    return alignToCacheLine(slotLengthSize + slotSize);
+}
+
+
+bool ShmSegment::create(const uint32_t slotCount[2], const uint64_t slotSize[2])
+{
+    uint64_t offsets[2];
+    uint64_t size = alignToCacheLine(sizeof(ShmSegmentHeader));
+    for (int i = 0; i < 2; i++) {
+        if (slotCount[i] == 0 || slotSize[i] == 0) {
+            yCError(SHMCARRIER, "Invalid ring size (%u slots of %llu bytes)", slotCount[i], static_cast<unsigned long long>(slotSize[i]));
+            return false;
+        }
+        offsets[i] = size;
+        size += slotCount[i] * slotStride(slotSize[i]);
+    }
+
+    if (!memory.create("/yarp-shm-", size)) {
+        return false;
+    }
+    // The memory is zero filled, the atomic fields are already initialized
+    hdr = new (memory.getAddress()) ShmSegmentHeader;
+    hdr->version = ShmSegmentHeader::currentVersion;
+    hdr->size = size;
+    hdr->creatorPid = ::getpid();
+    for (int i = 0; i < 2; i++) {
+        ShmRingHeader& r = hdr->rings[i];
+        r.slotCount = slotCount[i];
+        r.slotSize = slotSize[i];
+        r.offset = offsets[i];
+    }
+    hdr->magic.store(ShmSegmentHeader::magicNumber, std::memory_order_release);
+
+    yCDebug(SHMCARRIER, "Created segment %s (%llu bytes)", getName().c_str(), static_cast<unsigned long long>(size));
+    return true;
+}
+
+
+bool ShmSegment::open(const std::string& name)
+{
+    if (!memory.open(name)) {
+        return false;
+    }
+    if (memory.getSize() < sizeof(ShmSegmentHeader)) {
+        yCError(SHMCARRIER, "Segment %s is too small", name.c_str());
+        return false;
+    }
+    auto* h = reinterpret_cast<ShmSegmentHeader*>(memory.getAddress());
+
+    if (h->magic.load(std::memory_order_acquire) != ShmSegmentHeader::magicNumber
+        || h->version != ShmSegmentHeader::currentVersion
+        || h->size != memory.getSize()) {
+        yCError(SHMCARRIER, "Segment %s is not valid", name.c_str());
+        return false;
+    }
+    for (const auto& r : h->rings) {
+        if (r.offset + r.slotCount * slotStride(r.slotSize) > memory.getSize()) {
+            yCError(SHMCARRIER, "Segment %s is not valid", name.c_str());
+            return false;
+        }
+    }
+    hdr = h;
+    hdr->openerPid.store(::getpid());
+
+    yCDebug(SHMCARRIER, "Opened segment %s (%zu bytes)", name.c_str(), memory.getSize());
+    return true;
+}
+
+
+void ShmSegment::unlink()
+{
+    memory.unlink();
+}
+
+
+void ShmSegment::close()
+{
+    if (hdr == nullptr) {
+        return;
+    }
+    hdr->closed.store(1);
+    for (auto& r : hdr->rings) {
+        r.headFutex.fetch_add(1);
+        futexWake(r.headFutex);
+        r.tailFutex.fetch_add(1);
+        futexWake(r.tailFutex);
+    }
+}
+
+
+bool ShmSegment::isClosed() const
+{
+    if (hdr == nullptr || hdr->closed.load() != 0) {
+        return true;
+    }
+    return !isPeerAlive();
+}
+
+
+bool ShmSegment::isPeerAlive() const
+{
+    int32_t peer = memory.isCreator() ? hdr->openerPid.load() : hdr->creatorPid;
+    return (peer == 0 || ::kill(peer, 0) == 0 || errno != ESRCH);
+}
+
+
+char* ShmSegment::slot(int index, uint64_t seq) const
+{
+    const ShmRingHeader& r = hdr->rings[index];
+    return reinterpret_cast<char*>(hdr) + r.offset + (seq % r.slotCount) * slotStride(r.slotSize);
+}
+
+
+void ShmSegment::notify(std::atomic<uint32_t>& futex, std::atomic<uint32_t>& waiting)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load() == 0) {
+        // Nobody is waiting, no system call
+        return;
+    }
+    futex.fetch_add(1);
+    futexWake(futex);
+}
+
+
+void ShmSegment::futexWait(std::atomic<uint32_t>& futex, uint32_t value, double timeout)
+{
+    struct timespec ts;
+    double sec = std::floor(timeout);
+    ts.tv_sec = static_cast<time_t>(sec);
+    ts.tv_nsec = static_cast<long>((timeout - sec) * 1e9);
+    // The segment is shared between processes, FUTEX_WAIT_PRIVATE cannot be used
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAIT, value, &ts, nullptr, 0);
+}
+
+
+void ShmSegment::futexWake(std::atomic<uint32_t>& futex)
+{
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHM_SHMSEGMENT_H
+#define YARP_SHM_SHMSEGMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ShmMemory.h"
+
+/**
+ * The header of a ring of slots in the shared memory segment.
+ *
+ * The ring has a single writer and a single reader.  `head` counts the
+ * slots published by the writer, `tail` counts the slots released by the
+ * reader.  The futex words are bumped (and the futex woken up) only when
+ * the other side declared that it is waiting.
+ */
+struct ShmRingHeader
+{
+    static constexpr size_t cacheLineSize = 64;
+
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotSize;
+    uint64_t offset;
+    char pad0[cacheLineSize];
+    std::atomic<uint64_t> head;
+    std::atomic<uint32_t> headFutex;
+    std::atomic<uint32_t> readerWaiting;
+    char pad1[cacheLineSize];
+    std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> tailFutex;
+    std::atomic<uint32_t> writerWaiting;
+    char pad2[cacheLineSize];
+};
+
+/**
+ * The header of the shared memory segment.
+ */
+struct ShmSegmentHeader
+{
+    static constexpr uint32_t magicNumber = 0x5952504d; // "YRPM"
+    static constexpr uint32_t currentVersion = 1;
+
+    std::atomic<uint32_t> magic; // written last by the creator
+    uint32_t version;
+    uint64_t size;
+    int32_t creatorPid;
+    std::atomic<int32_t> openerPid;
+    std::atomic<uint32_t> closed;
+    std::atomic<uint32_t> poolSlot; // slot of the pool being read + 1, or 0
+    ShmRingHeader rings[2];
+};
+
+/**
+ * A POSIX shared memory segment containing two rings of slots, one for
+ * each direction of a connection.
+ *
+ * Each slot starts with the length of its content, followed by up to
+ * slotSize bytes of data.
+ */
+class ShmSegment
+{
+public:
+    ShmSegment() = default;
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment(ShmSegment&&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+    ShmSegment& operator=(ShmSegment&&) = delete;
+
+    ~ShmSegment() = default;
+
+    /**
+     * Create a new segment, with a unique name.
+     *
+     * @param slotCount the number of slots of each ring
+     * @param slotSize the size of the slots of each ring
+     * @return true on success
+     */
+    bool create(const uint32_t slotCount[2], const uint64_t slotSize[2]);
+
+    /**
+     * Open an existing segment.
+     *
+     * @param name the name of the segment
+     * @return true on success
+     */
+    bool open(const std::string& name);
+
+    /**
+     * Remove the name of the segment.  The segment is destroyed when it is
+     * unmapped by both the sides of the connection.
+     */
+    void unlink();
+
+    /**
+     * Mark the segment as closed and wake up all the waiting threads.
+     */
+    void close();
+
+    /**
+     * @return true if the segment was closed, or if the process on the
+     *         other side of the connection died
+     */
+    bool isClosed() const;
+
+    /**
+     * @return false if the process on the other side of the connection died
+     */
+    bool isPeerAlive() const;
+
+    const std::string& getName() const { return memory.getName(); }
+    ShmSegmentHeader* header() const { return hdr; }
+    ShmRingHeader& ring(int index) const { return hdr->rings[index]; }
+
+    /**
+     * @return the address of a slot.  The first 8 bytes of the slot
+     *         contain the length of its content.
+     */
+    char* slot(int index, uint64_t seq) const;
+
+    /**
+     * Wait until ready() returns true, or the segment is closed.
+     *
+     * @param futex the futex word bumped by the other side
+     * @param waiting the counter of waiting threads read by the other side
+     * @param ready the condition
+     * @return false if the segment was closed
+     */
+    template <typename F>
+    bool wait(std::atomic<uint32_t>& futex, std::atomic<uint32_t>& waiting, F ready) const;
+
+    /**
+     * Wake up the other side if it is waiting.
+     */
+    static void notify(std::atomic<uint32_t>& futex, std::atomic<uint32_t>& waiting);
+
+private:
+    static void futexWait(std::atomic<uint32_t>& futex, uint32_t value, double timeout);
+    static void futexWake(std::atomic<uint32_t>& futex);
+    static uint64_t slotStride(uint64_t slotSize);
+
+    ShmMemory memory;
+    ShmSegmentHeader* hdr {nullptr};
+
+    // The wait is periodically interrupted to check if the process on the
+    // other side is still alive
+    static constexpr double livenessPeriod = 0.1;
+};
+
+
+template <typename F>
+bool ShmSegment::wait(std::atomic<uint32_t>& futex, std::atomic<uint32_t>& waiting, F ready) const
+{
+    if (ready()) {
+        return true;
+    }
+
+    // The counter of waiters is incremented before checking the condition
+    // for the last time, and notify() reads the counter after changing the
+    // state: either the waiter sees the change, or the notifier sees the
+    // waiter.
+    waiting.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t seq = futex.load();
+    bool ok = true;
+    while (!ready()) {
+        if (isClosed()) {
+            ok = false;
+            break;
+        }
+        futexWait(futex, seq, livenessPeriod);
+        seq = futex.load();
+    }
+    waiting.fetch_sub(1);
+    return ok;
+}
+
+#endif // YARP_SHM_SHMSEGMENT_H
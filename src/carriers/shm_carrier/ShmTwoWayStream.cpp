@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmTwoWayStream.h"
+
+#include <yarp/os/Bytes.h>
+#include <yarp/os/LogStream.h>
+
+#include "ShmLogComponent.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace yarp::os;
+
+namespace {
+constexpr size_t slotLengthSize = sizeof(uint64_t);
+} // namespace
+
+
+ShmTwoWayStream::~ShmTwoWayStream()
+{
+    close();
+    if (pool && segment.header() != nullptr) {
+        if (reading && readShared >= 0) {
+            releaseShared();
+        }
+        if (outRing == dataRing) {
+            releaseReferences();
+        }
+    }
+}
+
+
+bool ShmTwoWayStream::create(uint32_t slotCount, uint64_t slotSize)
+{
+    const uint32_t counts[2] = {slotCount, replySlotCount};
+    const uint64_t sizes[2] = {slotSize, replySlotSize};
+    inRing = replyRing;
+    outRing = dataRing;
+    happy = segment.create(counts, sizes);
+    return happy;
+}
+
+
+bool ShmTwoWayStream::open(const std::string& name, const std::string& poolName)
+{
+    inRing = dataRing;
+    outRing = replyRing;
+    happy = segment.open(name);
+    if (happy && !poolName.empty()) {
+        pool = std::make_shared<ShmBroadcastPool>();
+        happy = pool->open(poolName);
+    }
+    return happy;
+}
+
+
+void ShmTwoWayStream::setPool(std::shared_ptr<ShmBroadcastPool> sharedPool)
+{
+    pool = std::move(sharedPool);
+}
+
+
+InputStream& ShmTwoWayStream::getInputStream()
+{
+    return *this;
+}
+
+
+OutputStream& ShmTwoWayStream::getOutputStream()
+{
+    return *this;
+}
+
+
+const Contact& ShmTwoWayStream::getLocalAddress() const
+{
+    return localAddress;
+}
+
+
+const Contact& ShmTwoWayStream::getRemoteAddress() const
+{
+    return remoteAddress;
+}
+
+
+void ShmTwoWayStream::setLocalAddress(const Contact& _localAddress)
+{
+    localAddress = _localAddress;
+}
+
+
+void ShmTwoWayStream::setRemoteAddress(const Contact& _remoteAddress)
+{
+    remoteAddress = _remoteAddress;
+}
+
+
+void ShmTwoWayStream::interrupt()
+{
+    // Waiting threads are woken up, the memory is unmapped only on
+    // destruction
+    happy = false;
+    segment.close();
+}
+
+
+void ShmTwoWayStream::close()
+{
+    interrupt();
+}
+
+
+yarp::conf::ssize_t ShmTwoWayStream::read(Bytes& b)
+{
+    if (!happy) {
+        return -1;
+    }
+    if (b.length() == 0) {
+        return 0;
+    }
+
+    // The other side might be waiting for the data written so far
+    if (writing && writePos > 0) {
+        publish();
+    }
+
+    ShmRingHeader& ring = segment.ring(inRing);
+    if (!reading) {
+        readSeq = ring.tail.load(std::memory_order_relaxed);
+        bool ok = segment.wait(ring.headFutex, ring.readerWaiting, [&]() {
+            return ring.head.load(std::memory_order_acquire) > readSeq;
+        });
+        if (!ok) {
+            happy = false;
+            return -1;
+        }
+
+        char* slot = segment.slot(inRing, readSeq);
+        uint64_t field = 0;
+        std::memcpy(&field, slot, slotLengthSize);
+        if ((field & referenceFlag) != 0) {
+            // The content is in the broadcast pool
+            auto* ref = reinterpret_cast<ShmReference*>(slot + slotLengthSize);
+            bool claimed = (ref->claimed.exchange(ShmReference::claimedByReceiver) == ShmReference::unclaimed);
+            int index = ref->index;
+            uint64_t messageId = ref->messageId;
+            readLen = ref->length;
+            if (!claimed || !pool || !pool->contains(index, messageId, readLen)) {
+                releaseSlot(readSeq);
+                yCError(SHMCARRIER, "Invalid reference in %s", segment.getName().c_str());
+                happy = false;
+                return -1;
+            }
+            // From now on the sender releases the slot of the pool if this
+            // process dies
+            segment.header()->poolSlot.store(static_cast<uint32_t>(index) + 1);
+            releaseSlot(readSeq);
+            readShared = index;
+            readData = pool->data(index);
+        } else {
+            readLen = field;
+            readData = slot + slotLengthSize;
+        }
+        if (readLen == 0 || (readShared < 0 && readLen > ring.slotSize)) {
+            yCError(SHMCARRIER, "Corrupted slot in %s", segment.getName().c_str());
+            happy = false;
+            return -1;
+        }
+        readPos = 0;
+        reading = true;
+    }
+
+    // Copy straight from the shared memory to the destination
+    size_t len = static_cast<size_t>(std::min<uint64_t>(b.length(), readLen - readPos));
+    std::memcpy(b.get(), readData + readPos, len);
+    readPos += len;
+
+    if (readPos == readLen) {
+        reading = false;
+        if (readShared >= 0) {
+            releaseShared();
+        } else {
+            releaseSlot(readSeq);
+        }
+    }
+    return static_cast<yarp::conf::ssize_t>(len);
+}
+
+
+void ShmTwoWayStream::releaseSlot(uint64_t seq)
+{
+    ShmRingHeader& ring = segment.ring(inRing);
+    ring.tail.store(seq + 1, std::memory_order_release);
+    ShmSegment::notify(ring.tailFutex, ring.writerWaiting);
+}
+
+
+bool ShmTwoWayStream::acquireSlot()
+{
+    ShmRingHeader& ring = segment.ring(outRing);
+    writeSeq = ring.head.load(std::memory_order_relaxed);
+    bool ok = segment.wait(ring.tailFutex, ring.writerWaiting, [&]() {
+        return writeSeq - ring.tail.load(std::memory_order_acquire) < ring.slotCount;
+    });
+    if (!ok) {
+        happy = false;
+        return false;
+    }
+    writePos = 0;
+    writing = true;
+    return true;
+}
+
+
+void ShmTwoWayStream::write(const Bytes& b)
+{
+    if (!happy) {
+        return;
+    }
+
+    ShmRingHeader& ring = segment.ring(outRing);
+    const char* data = b.get();
+    size_t remaining = b.length();
+    while (remaining > 0) {
+        if (!writing && !acquireSlot()) {
+            return;
+        }
+
+        size_t len = static_cast<size_t>(std::min<uint64_t>(remaining, ring.slotSize - writePos));
+        std::memcpy(segment.slot(outRing, writeSeq) + slotLengthSize + writePos, data, len);
+        writePos += len;
+        data += len;
+        remaining -= len;
+
+        if (writePos == ring.slotSize) {
+            publish();
+        }
+    }
+}
+
+
+bool ShmTwoWayStream::writeShared(uint64_t messageId, yarp::os::SizedWriter& writer, size_t length)
+{
+    ShmRingHeader& ring = segment.ring(outRing);
+    // Only the sender writes in the pool
+    if (!happy || !pool || outRing != dataRing || ring.slotSize < sizeof(ShmReference)) {
+        return false;
+    }
+    int index = pool->acquire(messageId, writer, length);
+    if (index < 0) {
+        return false;
+    }
+
+    // The data written so far goes first
+    if (writing && writePos > 0) {
+        publish();
+    }
+    if (!writing && !acquireSlot()) {
+        pool->release(index);
+        return false;
+    }
+
+    char* slot = segment.slot(outRing, writeSeq);
+    auto* ref = new (slot + slotLengthSize) ShmReference;
+    ref->claimed.store(0, std::memory_order_relaxed);
+    ref->index = index;
+    ref->messageId = messageId;
+    ref->length = length;
+    uint64_t field = referenceFlag | sizeof(ShmReference);
+    std::memcpy(slot, &field, slotLengthSize);
+    ring.head.store(writeSeq + 1, std::memory_order_release);
+    ShmSegment::notify(ring.headFutex, ring.readerWaiting);
+    writing = false;
+    return true;
+}
+
+
+void ShmTwoWayStream::releaseShared()
+{
+    // Nobody else releases the slot while this process is alive
+    if (segment.header()->poolSlot.exchange(0) != 0) {
+        pool->release(readShared);
+    }
+    readShared = -1;
+}
+
+
+void ShmTwoWayStream::releaseReferences()
+{
+    // The slot of the pool that a dead receiver was reading
+    bool receiverDied = !segment.isPeerAlive();
+    uint32_t held = receiverDied ? segment.header()->poolSlot.exchange(0) : 0;
+    if (held != 0) {
+        pool->release(static_cast<int>(held - 1));
+    }
+
+    // References not read yet by the receiver (and not claimed by it).  A
+    // reference claimed by a receiver that died before publishing the slot
+    // it was reading is still in the ring.
+    ShmRingHeader& ring = segment.ring(outRing);
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    for (uint64_t seq = ring.tail.load(std::memory_order_acquire); seq < head; seq++) {
+        char* slot = segment.slot(outRing, seq);
+        uint64_t field = 0;
+        std::memcpy(&field, slot, slotLengthSize);
+        if ((field & referenceFlag) != 0) {
+            auto* ref = reinterpret_cast<ShmReference*>(slot + slotLengthSize);
+            uint32_t claimed = ref->claimed.exchange(ShmReference::claimedBySender);
+            if (claimed == ShmReference::unclaimed
+                || (claimed == ShmReference::claimedByReceiver && receiverDied && held == 0)) {
+                pool->release(ref->index);
+            }
+        }
+    }
+}
+
+
+void ShmTwoWayStream::publish()
+{
+    ShmRingHeader& ring = segment.ring(outRing);
+    std::memcpy(segment.slot(outRing, writeSeq), &writePos, slotLengthSize);
+    ring.head.store(writeSeq + 1, std::memory_order_release);
+    ShmSegment::notify(ring.headFutex, ring.readerWaiting);
+    writing = false;
+}
+
+
+void ShmTwoWayStream::flush()
+{
+    if (happy && writing && writePos > 0) {
+        publish();
+    }
+}
+
+
+bool ShmTwoWayStream::isOk() const
+{
+    // Checking if the other process is alive requires a system call, it
+    // is done only while waiting
+    return happy && segment.header()->closed.load() == 0;
+}
+
+
+void ShmTwoWayStream::reset()
+{
+}
+
+
+void ShmTwoWayStream::beginPacket()
+{
+}
+
+
+void ShmTwoWayStream::endPacket()
+{
+    flush();
+}
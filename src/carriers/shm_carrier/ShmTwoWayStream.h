@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHM_SHMTWOWAYSTREAM_H
+#define YARP_SHM_SHMTWOWAYSTREAM_H
+
+#include <yarp/os/Contact.h>
+#include <yarp/os/SizedWriter.h>
+#include <yarp/os/TwoWayStream.h>
+
+#include <memory>
+
+#include "ShmBroadcastPool.h"
+#include "ShmSegment.h"
+
+/**
+ * A reference to a slot of the broadcast pool, sent instead of the
+ * content of the slot.
+ *
+ * Either the receiver (when it reads the reference) or the sender (when
+ * the connection is closed before) claims the reference, and releases the
+ * slot of the pool.  The receiver publishes the slot it is reading in the
+ * header of the segment, so that the sender can release it if the
+ * receiver dies before.
+ */
+struct ShmReference
+{
+    static constexpr uint32_t unclaimed = 0;
+    static constexpr uint32_t claimedByReceiver = 1;
+    static constexpr uint32_t claimedBySender = 2;
+
+    std::atomic<uint32_t> claimed;
+    int32_t index;
+    uint64_t messageId;
+    uint64_t length;
+};
+
+/**
+ * A stream using two rings of slots in a shared memory segment, one for
+ * each direction.
+ *
+ * Data written is copied to the current slot, that is published when it
+ * is full, or when the stream is flushed.  Data is read directly from the
+ * published slots, without any intermediate copy and without system calls
+ * unless the reader has to wait.  This is a single copy, not a zero-copy
+ * receive: InputStream::read() always fills a buffer owned by the reader,
+ * so the slot is released as soon as its content is copied out.
+ *
+ * In broadcast mode, large messages are written once in a pool shared by
+ * all the connections of the output port, and a slot of the ring contains
+ * just a reference to the pool.
+ */
+class ShmTwoWayStream :
+        public yarp::os::TwoWayStream,
+        public yarp::os::InputStream,
+        public yarp::os::OutputStream
+{
+public:
+    ShmTwoWayStream() = default;
+    ShmTwoWayStream(const ShmTwoWayStream&) = delete;
+    ShmTwoWayStream(ShmTwoWayStream&&) = delete;
+    ShmTwoWayStream& operator=(const ShmTwoWayStream&) = delete;
+    ShmTwoWayStream& operator=(ShmTwoWayStream&&) = delete;
+
+    ~ShmTwoWayStream() override;
+
+    /**
+     * Create the shared memory segment (sender side).
+     *
+     * @param slotCount the number of slots for the data sent
+     * @param slotSize the size of the slots for the data sent
+     * @return true on success
+     */
+    bool create(uint32_t slotCount, uint64_t slotSize);
+
+    /**
+     * Open the shared memory segment created by the sender (receiver side).
+     *
+     * @param name the name of the segment
+     * @param poolName the name of the broadcast pool, if any
+     * @return true on success
+     */
+    bool open(const std::string& name, const std::string& poolName = "");
+
+    /**
+     * Use a broadcast pool (sender side).
+     */
+    void setPool(std::shared_ptr<ShmBroadcastPool> sharedPool);
+
+    /**
+     * @return the broadcast pool, or nullptr if not in broadcast mode
+     */
+    ShmBroadcastPool* getPool() const { return pool.get(); }
+
+    /**
+     * Write a message through the broadcast pool.
+     *
+     * @param messageId the identifier of the message
+     * @param writer the message
+     * @param length the total length of the message
+     * @return false if the message was not written, and must be written
+     *         normally
+     */
+    bool writeShared(uint64_t messageId, yarp::os::SizedWriter& writer, size_t length);
+
+    ShmSegment& getSegment() { return segment; }
+
+    InputStream& getInputStream() override;
+    OutputStream& getOutputStream() override;
+
+    const yarp::os::Contact& getLocalAddress() const override;
+    const yarp::os::Contact& getRemoteAddress() const override;
+
+    void setLocalAddress(const yarp::os::Contact& _localAddress);
+    void setRemoteAddress(const yarp::os::Contact& _remoteAddress);
+
+    void interrupt() override;
+    void close() override;
+
+    using yarp::os::InputStream::read;
+    yarp::conf::ssize_t read(yarp::os::Bytes& b) override;
+
+    using yarp::os::OutputStream::write;
+    void write(const yarp::os::Bytes& b) override;
+    void flush() override;
+
+    bool isOk() const override;
+
+    void reset() override;
+
+    void beginPacket() override;
+    void endPacket() override;
+
+private:
+    // The sender writes on ring 0 and reads replies from ring 1
+    static constexpr int dataRing = 0;
+    static constexpr int replyRing = 1;
+
+    static constexpr uint32_t replySlotCount = 2;
+    static constexpr uint64_t replySlotSize = 64 * 1024;
+
+    // Set in the length of a slot containing a ShmReference
+    static constexpr uint64_t referenceFlag = 1ULL << 63;
+
+    bool acquireSlot();
+    void publish();
+    void releaseSlot(uint64_t seq);
+    void releaseShared();
+    void releaseReferences();
+
+    ShmSegment segment;
+    std::shared_ptr<ShmBroadcastPool> pool;
+    int inRing {replyRing};
+    int outRing {dataRing};
+    bool happy {false};
+
+    yarp::os::Contact localAddress;
+    yarp::os::Contact remoteAddress;
+
+    // Slot being written
+    bool writing {false};
+    uint64_t writeSeq {0};
+    uint64_t writePos {0};
+
+    // Slot being read
+    bool reading {false};
+    uint64_t readSeq {0};
+    uint64_t readPos {0};
+    uint64_t readLen {0};
+    const char* readData {nullptr};
+    int readShared {-1};
+};
+
+#endif // YARP_SHM_SHMTWOWAYSTREAM_H
@@ -80,6 +80,16 @@ bool ControlBoardRemapper::parseOptions(Property& prop)
         ok = parseNetworks(prop);
     }
 
+    int threads = prop.check("subdevicesThreads", Value(0), "number of threads calling the remapped controlboards in parallel").asInt32();
+    if (threads < 0)
+    {
+        yCError(CONTROLBOARDREMAPPER) << "Parsing parameters: \"subdevicesThreads\" should be a non negative integer";
+        return false;
+    }
+    subdevicesThreads = static_cast<size_t>(threads);
+
+    subdevicesStatisticsPeriod = prop.check("subdevicesStatisticsPeriod", Value(0.0), "period of the printing of the timing statistics of the remapped controlboards").asFloat64();
+
     return ok;
 }
 
@@ -465,6 +475,12 @@ bool ControlBoardRemapper::attachAllUsingNetworks(const PolyDriverList &polylist
 
 bool ControlBoardRemapper::detachAll()
 {
+    fanOut.stop();
+    if (_verb)
+    {
+        fanOut.printStatistics();
+    }
+
     //check if we already instantiated a subdevice previously
     int devices=remappedControlBoards.getNrOfSubControlBoards();
     for(int k=0;k<devices;k++)
@@ -478,6 +494,8 @@ void ControlBoardRemapper::configureBuffers()
 {
     allJointsBuffers.configure(remappedControlBoards);
     selectedJointsBuffers.configure(remappedControlBoards);
+    fullJointStateBuffers.configure(remappedControlBoards);
+    fanOut.configure(remappedControlBoards, subdevicesThreads, subdevicesStatisticsPeriod);
 }
 
 
@@ -1013,15 +1031,16 @@ bool ControlBoardRemapper::positionMove(const double *refs)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(refs,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->positionMove(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1033,15 +1052,16 @@ bool ControlBoardRemapper::positionMove(const int n_joints, const int *joints, c
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(refs,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->positionMove(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1072,7 +1092,7 @@ bool ControlBoardRemapper::getTargetPositions(double *spds)
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1089,8 +1109,8 @@ bool ControlBoardRemapper::getTargetPositions(double *spds)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(spds,remappedControlBoards);
 
@@ -1106,7 +1126,7 @@ bool ControlBoardRemapper::getTargetPositions(const int n_joints, const int *joi
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1123,8 +1143,8 @@ bool ControlBoardRemapper::getTargetPositions(const int n_joints, const int *joi
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(targets,n_joints,joints,remappedControlBoards);
 
@@ -1158,15 +1178,16 @@ bool ControlBoardRemapper::relativeMove(const double *deltas)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(deltas,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->relativeMove(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1178,15 +1199,16 @@ bool ControlBoardRemapper::relativeMove(const int n_joints, const int *joints, c
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(deltas,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->relativeMove(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1305,15 +1327,16 @@ bool ControlBoardRemapper::setRefSpeeds(const double *spds)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(spds,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->setRefSpeeds(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1325,15 +1348,16 @@ bool ControlBoardRemapper::setRefSpeeds(const int n_joints, const int *joints, c
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(spds,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->setRefSpeeds(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1365,15 +1389,16 @@ bool ControlBoardRemapper::setRefAccelerations(const double *accs)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(accs,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->setRefAccelerations(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                                allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                                allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1385,15 +1410,16 @@ bool ControlBoardRemapper::setRefAccelerations(const int n_joints, const int *jo
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(accs,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->setRefAccelerations(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                                selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                                selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1423,7 +1449,7 @@ bool ControlBoardRemapper::getRefSpeeds(double *spds)
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1440,8 +1466,8 @@ bool ControlBoardRemapper::getRefSpeeds(double *spds)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(spds,remappedControlBoards);
 
@@ -1457,7 +1483,7 @@ bool ControlBoardRemapper::getRefSpeeds(const int n_joints, const int *joints, d
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1474,8 +1500,8 @@ bool ControlBoardRemapper::getRefSpeeds(const int n_joints, const int *joints, d
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(spds,n_joints,joints,remappedControlBoards);
 
@@ -1507,7 +1533,7 @@ bool ControlBoardRemapper::getRefAccelerations(double *accs)
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1524,8 +1550,8 @@ bool ControlBoardRemapper::getRefAccelerations(double *accs)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(accs,remappedControlBoards);
 
@@ -1540,7 +1566,7 @@ bool ControlBoardRemapper::getRefAccelerations(const int n_joints, const int *jo
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1557,8 +1583,8 @@ bool ControlBoardRemapper::getRefAccelerations(const int n_joints, const int *jo
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(accs,n_joints,joints,remappedControlBoards);
 
@@ -1590,7 +1616,7 @@ bool ControlBoardRemapper::stop()
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -1599,8 +1625,8 @@ bool ControlBoardRemapper::stop()
         ok = p->pos ? p->pos->stop(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                      allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data()) : false;
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1614,14 +1640,15 @@ bool ControlBoardRemapper::stop(const int n_joints, const int *joints)
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(buffers.dummyBuffer.data(),n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->pos->stop(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                 selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -1656,15 +1683,16 @@ bool ControlBoardRemapper::velocityMove(const double *v)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(v,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->vel->velocityMove(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3247,7 +3275,7 @@ bool ControlBoardRemapper::setRefTorques(const double *t)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(t,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3264,8 +3292,8 @@ bool ControlBoardRemapper::setRefTorques(const double *t)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3295,15 +3323,16 @@ bool ControlBoardRemapper::setRefTorques(const int n_joints, const int *joints,
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(t,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->iTorque->setRefTorques(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                             selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                             selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3565,7 +3594,7 @@ bool ControlBoardRemapper::getControlModes(int *modes)
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3582,8 +3611,8 @@ bool ControlBoardRemapper::getControlModes(int *modes)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(modes,remappedControlBoards);
 
@@ -3599,7 +3628,7 @@ bool ControlBoardRemapper::getControlModes(const int n_joints, const int *joints
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3616,8 +3645,8 @@ bool ControlBoardRemapper::getControlModes(const int n_joints, const int *joints
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(modes,n_joints,joints,remappedControlBoards);
 
@@ -3650,15 +3679,16 @@ bool ControlBoardRemapper::setControlModes(const int n_joints, const int *joints
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(modes,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->iMode->setControlModes(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                              selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                              selectedJointsBuffers.m_bufferForSubControlBoardControlModes[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3670,15 +3700,16 @@ bool ControlBoardRemapper::setControlModes(int *modes)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(modes,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->iMode->setControlModes(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                              allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                              allJointsBuffers.m_bufferForSubControlBoardControlModes[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3710,15 +3741,16 @@ bool ControlBoardRemapper::setPositions(const int n_joints, const int *joints, c
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(dpos,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->posDir->setPositions(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                           selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                           selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3730,15 +3762,16 @@ bool ControlBoardRemapper::setPositions(const double *refs)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(refs,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->posDir->setPositions(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                           allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                           allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3807,7 +3840,7 @@ bool ControlBoardRemapper::getRefPositions(double *spds)
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3824,8 +3857,8 @@ bool ControlBoardRemapper::getRefPositions(double *spds)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(spds,remappedControlBoards);
 
@@ -3841,7 +3874,7 @@ bool ControlBoardRemapper::getRefPositions(const int n_joints, const int *joints
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3858,8 +3891,8 @@ bool ControlBoardRemapper::getRefPositions(const int n_joints, const int *joints
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(targets,n_joints,joints,remappedControlBoards);
 
@@ -3877,15 +3910,16 @@ bool ControlBoardRemapper::velocityMove(const int n_joints, const int *joints, c
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(spds,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->vel->velocityMove(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                         selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                         selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -3917,7 +3951,7 @@ bool ControlBoardRemapper::getRefVelocities(double* vels)
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3934,8 +3968,8 @@ bool ControlBoardRemapper::getRefVelocities(double* vels)
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(vels,remappedControlBoards);
 
@@ -3950,7 +3984,7 @@ bool ControlBoardRemapper::getRefVelocities(const int n_joints, const int* joint
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -3967,8 +4001,8 @@ bool ControlBoardRemapper::getRefVelocities(const int n_joints, const int* joint
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(vels,n_joints,joints,remappedControlBoards);
 
@@ -4003,7 +4037,7 @@ bool ControlBoardRemapper::getInteractionModes(int n_joints, int *joints, yarp::
     // Resize the input buffers
     selectedJointsBuffers.resizeSubControlBoardBuffers(n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -4020,8 +4054,8 @@ bool ControlBoardRemapper::getInteractionModes(int n_joints, int *joints, yarp::
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     selectedJointsBuffers.fillArbitraryJointVectorFromSubControlBoardBuffers(modes,n_joints,joints,remappedControlBoards);
 
@@ -4033,7 +4067,7 @@ bool ControlBoardRemapper::getInteractionModes(yarp::dev::InteractionModeEnum* m
     bool ret=true;
     std::lock_guard<std::mutex> lock(allJointsBuffers.mutex);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
@@ -4050,8 +4084,8 @@ bool ControlBoardRemapper::getInteractionModes(yarp::dev::InteractionModeEnum* m
             ok = false;
         }
 
-        ret = ret && ok;
-    }
+        return ok;
+    }) && ret;
 
     allJointsBuffers.fillCompleteJointVectorFromSubControlBoardBuffers(modes,remappedControlBoards);
 
@@ -4085,15 +4119,16 @@ bool ControlBoardRemapper::setInteractionModes(int n_joints, int *joints, yarp::
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(modes,n_joints,joints,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->iInteract->setInteractionModes(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                                     selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                                     selectedJointsBuffers.m_bufferForSubControlBoardInteractionModes[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -4105,15 +4140,16 @@ bool ControlBoardRemapper::setInteractionModes(yarp::dev::InteractionModeEnum* m
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(modes,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->iInteract->setInteractionModes(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                                     allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                                     allJointsBuffers.m_bufferForSubControlBoardInteractionModes[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -4377,21 +4413,21 @@ bool ControlBoardRemapper::setRefCurrents(const int n_motor, const int* motors,
 
     selectedJointsBuffers.fillSubControlBoardBuffersFromArbitraryJointVector(currs,n_motor,motors,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         if (!(p && p->iCurr))
         {
-            ret = false;
-            break;
+            return false;
         }
 
         bool ok = p->iCurr->setRefCurrents(selectedJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                           selectedJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                           selectedJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -4403,15 +4439,16 @@ bool ControlBoardRemapper::setRefCurrents(const double* currs)
 
     allJointsBuffers.fillSubControlBoardBuffersFromCompleteJointVector(currs,remappedControlBoards);
 
-    for(size_t ctrlBrd=0; ctrlBrd < remappedControlBoards.getNrOfSubControlBoards(); ctrlBrd++)
+    ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
     {
         RemappedSubControlBoard *p=remappedControlBoards.getSubControlBoard(ctrlBrd);
 
         bool ok = p->iCurr->setRefCurrents(allJointsBuffers.m_nJointsInSubControlBoard[ctrlBrd],
                                            allJointsBuffers.m_jointsInSubControlBoard[ctrlBrd].data(),
                                            allJointsBuffers.m_bufferForSubControlBoard[ctrlBrd].data());
-        ret = ret && ok;
-    }
+
+        return ok;
+    }) && ret;
 
     return ret;
 }
@@ -4462,3 +4499,14 @@ bool ControlBoardRemapper::getRefCurrents(double* currs)
 
     return ret;
 }
+
+//
+// IFullJointState Interface
+//
+
+bool ControlBoardRemapper::getFullJointState(FullJointState& state)
+{
+    std::lock_guard<std::mutex> lock(fullJointStateBuffers.mutex);
+
+    return fullJointStateBuffers.getFullJointState(state, remappedControlBoards, fanOut);
+}
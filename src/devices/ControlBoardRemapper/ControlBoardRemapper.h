@@ -41,6 +41,8 @@
  * | Parameter name | SubParameter   | Type    | Units          | Default Value | Required                    | Description                                                       | Notes |
  * |:--------------:|:--------------:|:-------:|:--------------:|:-------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
  * | axesNames     |      -         | vector of strings  | -      |   -           | Yes     | Ordered list of the axes that are part of the remapped device. |  |
+ * | subdevicesThreads |  -         | int     | -              |   0           | No      | Number of threads calling the remapped controlboards in parallel, in addition to the calling thread. | If 0, the remapped controlboards are called sequentially. |
+ * | subdevicesStatisticsPeriod | - | double  | s              |   0.0         | No      | Period of the printing of the time taken by each remapped controlboard to serve the calls. | If 0, the times are printed only when the device is detached, in verbose mode. |
  *
  * The axes are then mapped to the wrapped controlboard in the attachAll method, using the
  * values returned by the getAxisName method of the controlboard. If different axes
@@ -91,7 +93,8 @@ class ControlBoardRemapper :
         public yarp::dev::IAxisInfo,
         public yarp::dev::IPreciselyTimed,
         public yarp::dev::IInteractionMode,
-        public yarp::dev::IRemoteVariables {
+        public yarp::dev::IRemoteVariables,
+        public yarp::dev::IFullJointState {
 private:
     std::vector<std::string> axesNames;
     RemappedControlBoards remappedControlBoards;
@@ -114,6 +117,14 @@ private:
     // Buffer data for multiple arbitrary joint methods
     ControlBoardArbitraryAxesDecomposition selectedJointsBuffers;
 
+    // Buffer data for the full joint state method
+    ControlBoardFullJointStateDecomposition fullJointStateBuffers;
+
+    // Calls to all the SubControlBoards, sequential or parallel
+    ControlBoardSubControlBoardFanOut fanOut;
+    size_t subdevicesThreads{0};
+    double subdevicesStatisticsPeriod{0.0};
+
     /**
      * Set the number of controlled axes, resizing appropriately
      * all the necessary buffers.
@@ -579,6 +590,9 @@ public:
     bool getRefCurrents(double *currs) override;
 
     bool getRefCurrent(int m, double *curr) override;
+
+    // IFullJointState
+    bool getFullJointState(yarp::dev::FullJointState& state) override;
 };
 
 #endif // YARP_DEV_CONTROLBOARDREMAPPER_CONTROLBOARDREMAPPER_H
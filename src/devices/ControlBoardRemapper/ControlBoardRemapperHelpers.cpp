@@ -10,6 +10,9 @@
 #include "ControlBoardRemapperLogComponent.h"
 
 #include <yarp/os/LogStream.h>
+#include <yarp/os/SystemClock.h>
+
+#include <algorithm>
 
 
 using namespace yarp::os;
@@ -44,6 +47,7 @@ RemappedSubControlBoard::RemappedSubControlBoard()
     iCurr = nullptr;
 
     subdevice=nullptr;
+    totalAxis=0;
 
 
     attachedF=false;
@@ -75,6 +79,9 @@ void RemappedSubControlBoard::detach()
     iPwm = nullptr;
     iCurr = nullptr;
 
+    fullState.detach();
+    totalAxis=0;
+
     attachedF=false;
 }
 
@@ -116,6 +123,7 @@ bool RemappedSubControlBoard::attach(yarp::dev::PolyDriver *d, const std::string
         subdevice->view(iVar);
         subdevice->view(iPwm);
         subdevice->view(iCurr);
+        fullState.attach(subdevice);
     }
     else
     {
@@ -208,11 +216,203 @@ bool RemappedSubControlBoard::attach(yarp::dev::PolyDriver *d, const std::string
             return false;
         }
     }
+    totalAxis = static_cast<size_t>(deviceJoints);
 
     attachedF=true;
     return true;
 }
 
+ControlBoardSubControlBoardFanOut::~ControlBoardSubControlBoardFanOut()
+{
+    stop();
+}
+
+void ControlBoardSubControlBoardFanOut::configure(const RemappedControlBoards& remappedControlBoards,
+                                                  size_t nrOfThreads,
+                                                  double statisticsPeriod)
+{
+    stop();
+
+    size_t nrOfSubControlBoards = remappedControlBoards.getNrOfSubControlBoards();
+
+    m_ids.resize(nrOfSubControlBoards);
+    for(size_t ctrlBrd=0; ctrlBrd < nrOfSubControlBoards; ctrlBrd++)
+    {
+        m_ids[ctrlBrd] = remappedControlBoards.subdevices[ctrlBrd].id;
+    }
+
+    m_results.assign(nrOfSubControlBoards, 0);
+    m_statisticsPeriod = statisticsPeriod;
+    resetStatistics();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = false;
+    size_t nrOfWorkers = std::min(nrOfThreads, nrOfSubControlBoards > 0 ? nrOfSubControlBoards - 1 : 0);
+    for(size_t i=0; i < nrOfWorkers; i++)
+    {
+        m_workers.emplace_back(&ControlBoardSubControlBoardFanOut::worker, this);
+    }
+}
+
+void ControlBoardSubControlBoardFanOut::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workAvailable.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+bool ControlBoardSubControlBoardFanOut::forEachSubControlBoard(const std::function<bool(size_t)>& call)
+{
+    bool ret = true;
+
+    std::unique_lock<std::mutex> callLock(m_callMutex, std::defer_lock);
+    if (!isParallel() || !callLock.try_lock())
+    {
+        for(size_t ctrlBrd=0; ctrlBrd < m_results.size(); ctrlBrd++)
+        {
+            bool ok = callAndMeasure(call, ctrlBrd);
+            ret = ret && ok;
+        }
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_call = &call;
+            m_nextCall = 0;
+            m_generation++;
+        }
+        m_workAvailable.notify_all();
+
+        // Serve the calls with the workers, and wait for all of them
+        runPendingCalls();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workDone.wait(lock, [this]() { return m_nextCall >= m_results.size() && m_runningCalls == 0; });
+            m_call = nullptr;
+        }
+
+        for (auto ok : m_results)
+        {
+            ret = ret && ok;
+        }
+    }
+
+    if (m_statisticsPeriod > 0.0)
+    {
+        std::unique_lock<std::mutex> lock(m_statisticsMutex);
+        double now = SystemClock::nowSystem();
+        if (now - m_lastStatisticsPrint >= m_statisticsPeriod)
+        {
+            m_lastStatisticsPrint = now;
+            lock.unlock();
+            printStatistics();
+            resetStatistics();
+        }
+    }
+
+    return ret;
+}
+
+bool ControlBoardSubControlBoardFanOut::callAndMeasure(const std::function<bool(size_t)>& call, size_t ctrlBrd)
+{
+    double start = SystemClock::nowSystem();
+    bool ok = call(ctrlBrd);
+    double elapsed = SystemClock::nowSystem() - start;
+
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    Statistics& stats = m_statistics[ctrlBrd];
+    stats.calls++;
+    stats.totalTime += elapsed;
+    stats.maxTime = std::max(stats.maxTime, elapsed);
+    stats.lastTime = elapsed;
+
+    return ok;
+}
+
+void ControlBoardSubControlBoardFanOut::runPendingCalls()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_call && m_nextCall < m_results.size())
+    {
+        size_t ctrlBrd = m_nextCall++;
+        m_runningCalls++;
+        const std::function<bool(size_t)>& call = *m_call;
+
+        lock.unlock();
+        bool ok = callAndMeasure(call, ctrlBrd);
+        lock.lock();
+
+        m_results[ctrlBrd] = ok;
+        m_runningCalls--;
+    }
+
+    if (m_nextCall >= m_results.size() && m_runningCalls == 0)
+    {
+        m_workDone.notify_all();
+    }
+}
+
+void ControlBoardSubControlBoardFanOut::worker()
+{
+    size_t generation = 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_workAvailable.wait(lock, [&]() { return m_stop || m_generation != generation; });
+        if (m_stop)
+        {
+            return;
+        }
+        generation = m_generation;
+
+        lock.unlock();
+        runPendingCalls();
+        lock.lock();
+    }
+}
+
+ControlBoardSubControlBoardFanOut::Statistics ControlBoardSubControlBoardFanOut::getStatistics(size_t ctrlBrd) const
+{
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    return m_statistics[ctrlBrd];
+}
+
+void ControlBoardSubControlBoardFanOut::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    m_statistics.assign(m_ids.size(), Statistics());
+    m_lastStatisticsPrint = SystemClock::nowSystem();
+}
+
+void ControlBoardSubControlBoardFanOut::printStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    for(size_t ctrlBrd=0; ctrlBrd < m_statistics.size(); ctrlBrd++)
+    {
+        const Statistics& stats = m_statistics[ctrlBrd];
+        if (stats.calls == 0)
+        {
+            continue;
+        }
+        yCInfo(CONTROLBOARDREMAPPER, "subdevice %s: %zu calls, mean %.3f ms, max %.3f ms, last %.3f ms",
+               m_ids[ctrlBrd].c_str(),
+               stats.calls,
+               1000.0 * stats.totalTime / stats.calls,
+               1000.0 * stats.maxTime,
+               1000.0 * stats.lastTime);
+    }
+}
+
 bool ControlBoardSubControlBoardAxesDecomposition::configure(const RemappedControlBoards& remappedControlBoards)
 {
     // Resize buffers
@@ -353,6 +553,133 @@ void ControlBoardSubControlBoardAxesDecomposition::fillCompleteJointVectorFromSu
     }
 }
 
+namespace {
+
+double* FullJointState::* const fullStateDoubleArrays[] = {
+    &FullJointState::jointPosition,
+    &FullJointState::jointTimestamp,
+    &FullJointState::jointVelocity,
+    &FullJointState::jointAcceleration,
+    &FullJointState::motorPosition,
+    &FullJointState::motorVelocity,
+    &FullJointState::motorAcceleration,
+    &FullJointState::torque,
+    &FullJointState::pwmDutycycle,
+    &FullJointState::current
+};
+
+int* FullJointState::* const fullStateIntArrays[] = {
+    &FullJointState::controlMode,
+    &FullJointState::interactionMode
+};
+
+bool FullJointState::* const fullStateValidFlags[] = {
+    &FullJointState::jointPosition_isValid,
+    &FullJointState::jointVelocity_isValid,
+    &FullJointState::jointAcceleration_isValid,
+    &FullJointState::motorPosition_isValid,
+    &FullJointState::motorVelocity_isValid,
+    &FullJointState::motorAcceleration_isValid,
+    &FullJointState::torque_isValid,
+    &FullJointState::pwmDutycycle_isValid,
+    &FullJointState::current_isValid,
+    &FullJointState::controlMode_isValid,
+    &FullJointState::interactionMode_isValid
+};
+
+constexpr size_t fullStateDoubleArraysCount = sizeof(fullStateDoubleArrays) / sizeof(fullStateDoubleArrays[0]);
+constexpr size_t fullStateIntArraysCount = sizeof(fullStateIntArrays) / sizeof(fullStateIntArrays[0]);
+
+} // namespace
+
+bool ControlBoardFullJointStateDecomposition::configure(const RemappedControlBoards& remappedControlBoards)
+{
+    size_t nrOfSubControlBoards = remappedControlBoards.getNrOfSubControlBoards();
+
+    // The SubControlBoards fill all their axes, not only the remapped ones
+    m_nAxesOfSubControlBoard.assign(nrOfSubControlBoards, 0);
+    for(size_t ctrlBrd=0; ctrlBrd < nrOfSubControlBoards; ctrlBrd++)
+    {
+        m_nAxesOfSubControlBoard[ctrlBrd] = remappedControlBoards.subdevices[ctrlBrd].totalAxis;
+    }
+
+    m_bufferForSubControlBoard.resize(nrOfSubControlBoards);
+    m_bufferForSubControlBoardModes.resize(nrOfSubControlBoards);
+    m_stateOfSubControlBoard.resize(nrOfSubControlBoards);
+
+    for(size_t ctrlBrd=0; ctrlBrd < nrOfSubControlBoards; ctrlBrd++)
+    {
+        m_bufferForSubControlBoard[ctrlBrd].resize(fullStateDoubleArraysCount * m_nAxesOfSubControlBoard[ctrlBrd]);
+        m_bufferForSubControlBoardModes[ctrlBrd].resize(fullStateIntArraysCount * m_nAxesOfSubControlBoard[ctrlBrd]);
+    }
+
+    return true;
+}
+
+bool ControlBoardFullJointStateDecomposition::getFullJointState(FullJointState& state,
+                                                                RemappedControlBoards& remappedControlBoards,
+                                                                ControlBoardSubControlBoardFanOut& fanOut)
+{
+    // Read each SubControlBoard once
+    bool ret = fanOut.forEachSubControlBoard([&](size_t ctrlBrd)
+    {
+        size_t axes = m_nAxesOfSubControlBoard[ctrlBrd];
+        FullJointState& sub = m_stateOfSubControlBoard[ctrlBrd];
+        sub = FullJointState();
+
+        for (size_t i = 0; i < fullStateDoubleArraysCount; i++)
+        {
+            if (state.*fullStateDoubleArrays[i])
+            {
+                sub.*fullStateDoubleArrays[i] = m_bufferForSubControlBoard[ctrlBrd].data() + i * axes;
+            }
+        }
+        for (size_t i = 0; i < fullStateIntArraysCount; i++)
+        {
+            if (state.*fullStateIntArrays[i])
+            {
+                sub.*fullStateIntArrays[i] = m_bufferForSubControlBoardModes[ctrlBrd].data() + i * axes;
+            }
+        }
+
+        return remappedControlBoards.getSubControlBoard(ctrlBrd)->fullState.getFullJointState(sub);
+    });
+
+    for (auto flag : fullStateValidFlags)
+    {
+        state.*flag = true;
+        for (const auto& sub : m_stateOfSubControlBoard)
+        {
+            state.*flag = state.*flag && sub.*flag;
+        }
+    }
+
+    // Remap the axes
+    for(size_t j=0; j < remappedControlBoards.getNrOfRemappedAxes(); j++)
+    {
+        size_t off=remappedControlBoards.lut[j].axisIndexInSubControlBoard;
+        size_t subIndex=remappedControlBoards.lut[j].subControlBoardIndex;
+        const FullJointState& sub = m_stateOfSubControlBoard[subIndex];
+
+        for (auto array : fullStateDoubleArrays)
+        {
+            if (state.*array)
+            {
+                (state.*array)[j] = (sub.*array)[off];
+            }
+        }
+        for (auto array : fullStateIntArrays)
+        {
+            if (state.*array)
+            {
+                (state.*array)[j] = (sub.*array)[off];
+            }
+        }
+    }
+
+    return ret;
+}
+
 bool ControlBoardArbitraryAxesDecomposition::configure(const RemappedControlBoards& remappedControlBoards)
 {
     // Resize buffers
@@ -20,14 +20,18 @@
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/IInteractionMode.h>
 #include <yarp/dev/IControlLimits2.h>
+#include <yarp/dev/FullJointStateReader.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/IPreciselyTimed.h>
 
 
 #include <yarp/sig/Vector.h>
 
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -67,6 +71,11 @@ public:
     yarp::dev::IPWMControl           *iPwm;
     yarp::dev::ICurrentControl       *iCurr;
 
+    yarp::dev::FullJointStateReader  fullState;
+
+    // The number of axes of the subdevice, not only the remapped ones
+    size_t totalAxis;
+
     RemappedSubControlBoard();
 
     bool attach(yarp::dev::PolyDriver *d, const std::string &id);
@@ -136,6 +145,106 @@ public:
     }
 };
 
+/**
+ * Class issuing a call to each SubControlBoard, and measuring how long
+ * each SubControlBoard takes to serve it.
+ *
+ * In parallel mode the calls are issued concurrently on a pool of
+ * worker threads (and on the calling thread), and joined before
+ * returning. Only one call at a time is issued in parallel: a call made
+ * while another one is running is issued sequentially by the calling
+ * thread.
+ */
+class ControlBoardSubControlBoardFanOut
+{
+public:
+    /**
+     * Timing statistics of the calls to a SubControlBoard.
+     */
+    struct Statistics
+    {
+        size_t calls {0};
+        double totalTime {0.0};
+        double maxTime {0.0};
+        double lastTime {0.0};
+    };
+
+    ControlBoardSubControlBoardFanOut() = default;
+    ControlBoardSubControlBoardFanOut(const ControlBoardSubControlBoardFanOut&) = delete;
+    ControlBoardSubControlBoardFanOut& operator=(const ControlBoardSubControlBoardFanOut&) = delete;
+    ~ControlBoardSubControlBoardFanOut();
+
+    /**
+     * Configure the calls to the SubControlBoards in the
+     * RemappedControlBoards and, if nrOfThreads is greater than zero,
+     * start the worker threads of the parallel mode. The worker threads
+     * are at most one less than the SubControlBoards, since the calling
+     * thread serves the calls as well.
+     * If statisticsPeriod is greater than zero, the statistics are
+     * printed and reset every statisticsPeriod seconds.
+     */
+    void configure(const RemappedControlBoards & remappedControlBoards,
+                   size_t nrOfThreads,
+                   double statisticsPeriod);
+
+    /**
+     * Stop the worker threads.
+     */
+    void stop();
+
+    bool isParallel() const
+    {
+        return !m_workers.empty();
+    }
+
+    /**
+     * Call call(ctrlBrd) for each SubControlBoard.
+     *
+     * @return true iff all the calls returned true.
+     */
+    bool forEachSubControlBoard(const std::function<bool(size_t)>& call);
+
+    /**
+     * Return the statistics of the calls to a SubControlBoard
+     * since they were last reset.
+     */
+    Statistics getStatistics(size_t ctrlBrd) const;
+
+    void resetStatistics();
+
+    /**
+     * Print the statistics of each SubControlBoard.
+     */
+    void printStatistics() const;
+
+private:
+    bool callAndMeasure(const std::function<bool(size_t)>& call, size_t ctrlBrd);
+    void runPendingCalls();
+    void worker();
+
+    std::vector<std::thread> m_workers;
+
+    // Mutex held by the thread issuing the calls in parallel
+    std::mutex m_callMutex;
+
+    // State of the calls issued in parallel, protected by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_workDone;
+    const std::function<bool(size_t)>* m_call {nullptr};
+    size_t m_nextCall {0};
+    size_t m_runningCalls {0};
+    size_t m_generation {0};
+    bool m_stop {false};
+    std::vector<char> m_results;
+
+    std::vector<std::string> m_ids;
+    mutable std::mutex m_statisticsMutex;
+    std::vector<Statistics> m_statistics;
+    double m_statisticsPeriod {0.0};
+    double m_lastStatisticsPrint {0.0};
+};
+
 class ControlBoardRemapperBuffers
 {
 public:
@@ -231,6 +340,42 @@ public:
     std::vector<int> m_counterForControlBoard;
 };
 
+/**
+ * Class storing the buffers used to read the whole state
+ * of each SubControlBoard with a single
+ * IFullJointState::getFullJointState call, and to remap it
+ * on the axes of the Remapped ControlBoard.
+ */
+class ControlBoardFullJointStateDecomposition
+{
+public:
+    /**
+     * Resize the buffers using the information in
+     * the RemappedControlBoards
+     */
+    bool configure(const RemappedControlBoards & remappedControlBoards);
+
+    /**
+     * Read the state of all the SubControlBoards, and
+     * fill the arrays of state requested.
+     */
+    bool getFullJointState(yarp::dev::FullJointState & state,
+                           RemappedControlBoards & remappedControlBoards,
+                           ControlBoardSubControlBoardFanOut & fanOut);
+
+    /**
+     * Mutex to grab to use this class.
+     */
+    std::mutex mutex;
+
+    // Number of axes of each SubControlBoard read, i.e. the largest index remapped plus one
+    std::vector<size_t> m_nAxesOfSubControlBoard;
+
+    std::vector< std::vector<double> > m_bufferForSubControlBoard;
+    std::vector< std::vector<int>    > m_bufferForSubControlBoardModes;
+    std::vector< yarp::dev::FullJointState > m_stateOfSubControlBoard;
+};
+
 /**
  * Class storing the decomposition of a subset of the total
  * remapped axes of the remapped controlboard in the
@@ -29,6 +29,8 @@
  * | remoteControlBoards |     -     | vector of strings  | -   |   -           | Yes          | List of remote prefix used by the remote controlboards.           | The element of this list are then passed as "remote" parameter to the RemoteControlBoard device. |
  * | localPortPrefix |     -         | string             | -   |   -           | Yes          | All ports opened by this device will start with this prefix       |       |
  * | REMOTE_CONTROLBOARD_OPTIONS | - | group              | -   |   -           | No           | Options that will be passed directly to the remote_controlboard devices | |
+ * | subdevicesThreads |     -       | int                | -   |   0           | No           | Number of threads calling the remote controlboards in parallel, in addition to the calling thread. | If 0, the remote controlboards are called sequentially. |
+ * | subdevicesStatisticsPeriod | -  | double             | s   |   0.0         | No           | Period of the printing of the time taken by each remote controlboard to serve the calls. | If 0, the times are printed only when the device is closed, in verbose mode. |
  * All the passed remote controlboards are opened, and then the axesNames and the opened device are
  * passed to the ControlBoardRemapper device. If different axes
  * in two attached controlboard have the same name, the behaviour of this device is undefined.
@@ -35,6 +35,7 @@ ControlBoardWrapper::ControlBoardWrapper() :
 {
     streaming_parser.init(this);
     RPC_parser.init(this);
+    RPC_parser.setStateExtendedProfile(&stateExtProfile);
 }
 
 void ControlBoardWrapper::cleanup_yarpPorts()
@@ -52,6 +53,7 @@ void ControlBoardWrapper::cleanup_yarpPorts()
 
     extendedOutputStatePort.interrupt();
     extendedOutputStatePort.close();
+    stateExtProfile.unwatch(extendedOutputStatePort);
 
     rpcData.destroy();
 }
@@ -322,6 +324,7 @@ bool ControlBoardWrapper::initialize_YARP(yarp::os::Searchable& prop)
             break;
         }
         extendedOutputState_buffer.attach(extendedOutputStatePort);
+        stateExtProfile.watch(extendedOutputStatePort);
         success = true;
     } break;
     } // end switch
@@ -780,17 +783,52 @@ void ControlBoardWrapper::run()
         yCWarning(CONTROLBOARD) << "Number of streaming input messages to be read is " << inputStreamingPort.getPendingReads() << " and can overflow";
     }
 
-    // Small optimization: Avoid to call getEncoders twice, one for YARP port
-    // and again for ROS topic.
+    // Read the whole state with a single getFullJointState() call, that reads
+    // each subdevice only once.
     //
-    // Calling getStuff here on ros_struct because it is a class member, hence
-    // always available. In the other side, to have the yarp struct to write into
-    // it will be rewuired to call port.prepare, that it is something I should
-    // not do if the wrapper is in ROS_only configuration.
-
-    bool positionsOk = getEncodersTimed(ros_struct.position.data(), times.data());
-    bool speedsOk = getEncoderSpeeds(ros_struct.velocity.data());
-    bool torqueOk = getTorques(ros_struct.effort.data());
+    // Position, velocity and torque are read in ros_struct, because it is a
+    // class member, hence always available. In the other side, to have the
+    // yarp struct to write into it will be required to call port.prepare, that
+    // it is something I should not do if the wrapper is in ROS_only
+    // configuration.
+    yarp::dev::FullJointState state;
+    state.jointPosition = ros_struct.position.data();
+    state.jointTimestamp = times.data();
+    state.jointVelocity = ros_struct.velocity.data();
+    state.torque = ros_struct.effort.data();
+
+    jointData* yarp_struct = nullptr;
+    if (useROS != ROS_only) {
+        yarp_struct = &extendedOutputState_buffer.get();
+
+        yarp_struct->jointPosition.resize(controlledJoints);
+        yarp_struct->jointVelocity.resize(controlledJoints);
+        yarp_struct->jointAcceleration.resize(controlledJoints);
+        yarp_struct->motorPosition.resize(controlledJoints);
+        yarp_struct->motorVelocity.resize(controlledJoints);
+        yarp_struct->motorAcceleration.resize(controlledJoints);
+        yarp_struct->torque.resize(controlledJoints);
+        yarp_struct->pwmDutycycle.resize(controlledJoints);
+        yarp_struct->current.resize(controlledJoints);
+        yarp_struct->controlMode.resize(controlledJoints);
+        yarp_struct->interactionMode.resize(controlledJoints);
+
+        // Read only the fields streamed to the clients connected
+        stateExtProfile.update(extendedOutputStatePort);
+        auto streamed = [this](StateExtendedProfile::Field field, auto& v) {
+            return stateExtProfile.isStreamed(field) ? v.data() : nullptr;
+        };
+        state.jointAcceleration = streamed(StateExtendedProfile::JointAcceleration, yarp_struct->jointAcceleration);
+        state.motorPosition = streamed(StateExtendedProfile::MotorPosition, yarp_struct->motorPosition);
+        state.motorVelocity = streamed(StateExtendedProfile::MotorVelocity, yarp_struct->motorVelocity);
+        state.motorAcceleration = streamed(StateExtendedProfile::MotorAcceleration, yarp_struct->motorAcceleration);
+        state.pwmDutycycle = streamed(StateExtendedProfile::PwmDutycycle, yarp_struct->pwmDutycycle);
+        state.current = streamed(StateExtendedProfile::Current, yarp_struct->current);
+        state.controlMode = streamed(StateExtendedProfile::ControlMode, yarp_struct->controlMode);
+        state.interactionMode = streamed(StateExtendedProfile::InteractionMode, yarp_struct->interactionMode);
+    }
+
+    getFullJointState(state);
 
     // Update the port envelope time by averaging all timestamps
     timeMutex.lock();
@@ -800,40 +838,25 @@ void ControlBoardWrapper::run()
 
     if (useROS != ROS_only) {
         // handle stateExt first
-        jointData& yarp_struct = extendedOutputState_buffer.get();
-
-        yarp_struct.jointPosition.resize(controlledJoints);
-        yarp_struct.jointVelocity.resize(controlledJoints);
-        yarp_struct.jointAcceleration.resize(controlledJoints);
-        yarp_struct.motorPosition.resize(controlledJoints);
-        yarp_struct.motorVelocity.resize(controlledJoints);
-        yarp_struct.motorAcceleration.resize(controlledJoints);
-        yarp_struct.torque.resize(controlledJoints);
-        yarp_struct.pwmDutycycle.resize(controlledJoints);
-        yarp_struct.current.resize(controlledJoints);
-        yarp_struct.controlMode.resize(controlledJoints);
-        yarp_struct.interactionMode.resize(controlledJoints);
-
-        // Get already stored data from before. This is to avoid a double call to HW device,
-        // which may require more time.        //
-        yarp_struct.jointPosition_isValid = positionsOk;
-        std::copy(ros_struct.position.begin(), ros_struct.position.end(), yarp_struct.jointPosition.begin());
-
-        yarp_struct.jointVelocity_isValid = speedsOk;
-        std::copy(ros_struct.velocity.begin(), ros_struct.velocity.end(), yarp_struct.jointVelocity.begin());
-
-        yarp_struct.torque_isValid = torqueOk;
-        std::copy(ros_struct.effort.begin(), ros_struct.effort.end(), yarp_struct.torque.begin());
-
-        // Get remaining data from HW
-        yarp_struct.jointAcceleration_isValid = getEncoderAccelerations(yarp_struct.jointAcceleration.data());
-        yarp_struct.motorPosition_isValid = getMotorEncoders(yarp_struct.motorPosition.data());
-        yarp_struct.motorVelocity_isValid = getMotorEncoderSpeeds(yarp_struct.motorVelocity.data());
-        yarp_struct.motorAcceleration_isValid = getMotorEncoderAccelerations(yarp_struct.motorAcceleration.data());
-        yarp_struct.pwmDutycycle_isValid = getDutyCycles(yarp_struct.pwmDutycycle.data());
-        yarp_struct.current_isValid = ControlBoardWrapperCommon::getCurrents(yarp_struct.current.data());
-        yarp_struct.controlMode_isValid = getControlModes(yarp_struct.controlMode.data());
-        yarp_struct.interactionMode_isValid = getInteractionModes(reinterpret_cast<yarp::dev::InteractionModeEnum*>(yarp_struct.interactionMode.data()));
+        yarp_struct->jointPosition_isValid = state.jointPosition_isValid;
+        std::copy(ros_struct.position.begin(), ros_struct.position.end(), yarp_struct->jointPosition.begin());
+
+        yarp_struct->jointVelocity_isValid = state.jointVelocity_isValid;
+        std::copy(ros_struct.velocity.begin(), ros_struct.velocity.end(), yarp_struct->jointVelocity.begin());
+
+        yarp_struct->torque_isValid = state.torque_isValid;
+        std::copy(ros_struct.effort.begin(), ros_struct.effort.end(), yarp_struct->torque.begin());
+
+        yarp_struct->jointAcceleration_isValid = state.jointAcceleration_isValid;
+        yarp_struct->motorPosition_isValid = state.motorPosition_isValid;
+        yarp_struct->motorVelocity_isValid = state.motorVelocity_isValid;
+        yarp_struct->motorAcceleration_isValid = state.motorAcceleration_isValid;
+        yarp_struct->pwmDutycycle_isValid = state.pwmDutycycle_isValid;
+        yarp_struct->current_isValid = state.current_isValid;
+        yarp_struct->controlMode_isValid = state.controlMode_isValid;
+        yarp_struct->interactionMode_isValid = state.interactionMode_isValid;
+
+        stateExtProfile.apply(*yarp_struct);
 
         extendedOutputStatePort.setEnvelope(averageTime);
         extendedOutputState_buffer.write();
@@ -841,7 +864,7 @@ void ControlBoardWrapper::run()
         // handle state:o
         yarp::sig::Vector& v = outputPositionStatePort.prepare();
         v.resize(controlledJoints);
-        std::copy(yarp_struct.jointPosition.begin(), yarp_struct.jointPosition.end(), v.begin());
+        std::copy(ros_struct.position.begin(), ros_struct.position.end(), v.begin());
 
         outputPositionStatePort.setEnvelope(averageTime);
         outputPositionStatePort.write();
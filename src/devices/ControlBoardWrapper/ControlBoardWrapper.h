@@ -57,10 +57,12 @@
 #include "ControlBoardWrapperPWMControl.h"
 #include "ControlBoardWrapperCurrentControl.h"
 #include "ControlBoardWrapperPreciselyTimed.h"
+#include "ControlBoardWrapperFullJointState.h"
 
 #include "SubDevice.h"
 #include "StreamingMessagesParser.h"
 #include "RPCMessagesParser.h"
+#include "StateExtendedProfile.h"
 
 
 #ifdef MSVC
@@ -200,7 +202,8 @@ class ControlBoardWrapper :
         public ControlBoardWrapperInteractionMode,
         public ControlBoardWrapperRemoteVariables,
         public ControlBoardWrapperPWMControl,
-        public ControlBoardWrapperCurrentControl
+        public ControlBoardWrapperCurrentControl,
+        public ControlBoardWrapperFullJointState
 {
 private:
     std::string rootName;
@@ -218,6 +221,7 @@ private:
     // from the YARP .thrift file
     yarp::os::PortWriterBuffer<yarp::dev::impl::jointData>           extendedOutputState_buffer;
     yarp::os::Port extendedOutputStatePort;         // Port /stateExt:o streaming out the struct with the robot data
+    StateExtendedProfile stateExtProfile;           // Fields streamed on the extendedOutputStatePort port, requested by the clients
 
     // ROS state publisher
     ROSTopicUsageType                                   useROS {ROS_disabled};               // decide if open ROS topic or not
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ControlBoardWrapperFullJointState.h"
+
+#include "ControlBoardLogComponent.h"
+
+#include <algorithm>
+
+using yarp::dev::FullJointState;
+
+namespace {
+
+double* FullJointState::* const doubleArrays[] = {
+    &FullJointState::jointPosition,
+    &FullJointState::jointTimestamp,
+    &FullJointState::jointVelocity,
+    &FullJointState::jointAcceleration,
+    &FullJointState::motorPosition,
+    &FullJointState::motorVelocity,
+    &FullJointState::motorAcceleration,
+    &FullJointState::torque,
+    &FullJointState::pwmDutycycle,
+    &FullJointState::current
+};
+
+int* FullJointState::* const intArrays[] = {
+    &FullJointState::controlMode,
+    &FullJointState::interactionMode
+};
+
+constexpr size_t doubleArraysCount = sizeof(doubleArrays) / sizeof(doubleArrays[0]);
+constexpr size_t intArraysCount = sizeof(intArrays) / sizeof(intArrays[0]);
+
+bool FullJointState::* const validFlags[] = {
+    &FullJointState::jointPosition_isValid,
+    &FullJointState::jointVelocity_isValid,
+    &FullJointState::jointAcceleration_isValid,
+    &FullJointState::motorPosition_isValid,
+    &FullJointState::motorVelocity_isValid,
+    &FullJointState::motorAcceleration_isValid,
+    &FullJointState::torque_isValid,
+    &FullJointState::pwmDutycycle_isValid,
+    &FullJointState::current_isValid,
+    &FullJointState::controlMode_isValid,
+    &FullJointState::interactionMode_isValid
+};
+
+// Point the arrays of the subdevice either directly into the arrays of the
+// caller (when the subdevice is mapped entirely) or into the buffers.
+template <typename T, size_t N>
+void setArrays(T* FullJointState::* const (&arrays)[N], const FullJointState& state, FullJointState& sub, bool direct, size_t wbase, T* buffer, size_t size)
+{
+    for (size_t i = 0; i < N; i++) {
+        T* dst = state.*arrays[i];
+        if (dst == nullptr) {
+            sub.*arrays[i] = nullptr;
+        } else {
+            sub.*arrays[i] = direct ? dst + wbase : buffer + i * size;
+        }
+    }
+}
+
+// Copy the joints of the subdevice from the buffers to the arrays of the caller
+template <typename T, size_t N>
+void copyArrays(T* FullJointState::* const (&arrays)[N], const FullJointState& state, const FullJointState& sub, const SubDevice& p)
+{
+    for (auto array : arrays) {
+        if (state.*array != nullptr) {
+            std::copy(sub.*array + p.base, sub.*array + p.top + 1, state.*array + p.wbase);
+        }
+    }
+}
+
+} // namespace
+
+
+bool ControlBoardWrapperFullJointState::getFullJointState(FullJointState& state)
+{
+    std::lock_guard<std::mutex> lock(fullStateMutex);
+
+    size_t size = device.maxNumOfJointsInDevices;
+    if (fullStateDoubles.size() < doubleArraysCount * size) {
+        fullStateDoubles.resize(doubleArraysCount * size);
+        fullStateInts.resize(intArraysCount * size);
+    }
+
+    for (auto flag : validFlags) {
+        state.*flag = !device.subdevices.empty();
+    }
+
+    bool ret = !device.subdevices.empty();
+    for (size_t d = 0; d < device.subdevices.size(); d++) {
+        SubDevice* p = device.getSubdevice(d);
+        if (!p || !p->subdevice) {
+            ret = false;
+            for (auto flag : validFlags) {
+                state.*flag = false;
+            }
+            break;
+        }
+
+        bool direct = (p->base == 0 && p->axes == p->totalAxis);
+        FullJointState sub;
+        setArrays(doubleArrays, state, sub, direct, p->wbase, fullStateDoubles.data(), size);
+        setArrays(intArrays, state, sub, direct, p->wbase, fullStateInts.data(), size);
+
+        if (!p->fullState.getFullJointState(sub)) {
+            ret = false;
+            printError("getFullJointState", p->id, false);
+        }
+        if (!direct) {
+            copyArrays(doubleArrays, state, sub, *p);
+            copyArrays(intArrays, state, sub, *p);
+        }
+        for (auto flag : validFlags) {
+            state.*flag = state.*flag && sub.*flag;
+        }
+    }
+    return ret;
+}
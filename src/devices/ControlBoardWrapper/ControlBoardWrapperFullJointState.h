@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_CONTROLBOARDWRAPPER_CONTROLBOARDWRAPPERFULLJOINTSTATE_H
+#define YARP_DEV_CONTROLBOARDWRAPPER_CONTROLBOARDWRAPPERFULLJOINTSTATE_H
+
+#include <yarp/dev/IFullJointState.h>
+
+#include "ControlBoardWrapperCommon.h"
+
+#include <mutex>
+#include <vector>
+
+
+class ControlBoardWrapperFullJointState :
+        virtual public ControlBoardWrapperCommon,
+        public yarp::dev::IFullJointState
+{
+private:
+    // Buffers for the subdevices that are not mapped entirely on the wrapper,
+    // resized on the first call and then reused.
+    std::mutex fullStateMutex;
+    std::vector<double> fullStateDoubles;
+    std::vector<int> fullStateInts;
+
+public:
+    bool getFullJointState(yarp::dev::FullJointState& state) override;
+};
+
+#endif // YARP_DEV_CONTROLBOARDWRAPPER_CONTROLBOARDWRAPPERFULLJOINTSTATE_H
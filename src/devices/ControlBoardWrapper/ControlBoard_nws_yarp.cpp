@@ -27,6 +27,7 @@ using yarp::dev::impl::jointData;
 ControlBoard_nws_yarp::ControlBoard_nws_yarp() :
         yarp::os::PeriodicThread(default_period)
 {
+    RPC_parser.setStateExtendedProfile(&extendedOutputStateProfile);
 }
 
 void ControlBoard_nws_yarp::closePorts()
@@ -43,6 +44,7 @@ void ControlBoard_nws_yarp::closePorts()
 
     extendedOutputStatePort.interrupt();
     extendedOutputStatePort.close();
+    extendedOutputStateProfile.unwatch(extendedOutputStatePort);
 }
 
 bool ControlBoard_nws_yarp::close()
@@ -163,6 +165,7 @@ bool ControlBoard_nws_yarp::open(Searchable& config)
         return false;
     }
     extendedOutputState_buffer.attach(extendedOutputStatePort);
+    extendedOutputStateProfile.watch(extendedOutputStatePort);
 
     // In case attach is not deferred and the controlboard already owns a valid device
     // we can start the thread. Otherwise this will happen when attachAll is called
@@ -341,6 +344,8 @@ bool ControlBoard_nws_yarp::setDevice(yarp::dev::DeviceDriver* driver, bool owne
     subdevice_joints = static_cast<size_t>(tmp_axes);
     times.resize(subdevice_joints);
 
+    fullStateReader.attach(subdevice_ptr);
+
     // Initialization
     streaming_parser.init(subdevice_ptr);
     streaming_parser.initialize();
@@ -389,6 +394,7 @@ void ControlBoard_nws_yarp::closeDevice()
     iRemoteVariables = nullptr;
     iPWMControl = nullptr;
     iCurrentControl = nullptr;
+    fullStateReader.detach();
 }
 
 bool ControlBoard_nws_yarp::attach(yarp::dev::PolyDriver* poly)
@@ -484,67 +490,51 @@ void ControlBoard_nws_yarp::run()
     data.controlMode.resize(subdevice_joints);
     data.interactionMode.resize(subdevice_joints);
 
-    // Get data from HW
-    if (iEncodersTimed) {
-        data.jointPosition_isValid = iEncodersTimed->getEncodersTimed(data.jointPosition.data(), times.data());
-        data.jointVelocity_isValid = iEncodersTimed->getEncoderSpeeds(data.jointVelocity.data());
-        data.jointAcceleration_isValid = iEncodersTimed->getEncoderAccelerations(data.jointAcceleration.data());
-    } else {
-        data.jointPosition_isValid = false;
-        data.jointVelocity_isValid = false;
-        data.jointAcceleration_isValid = false;
-    }
-
-    if (iMotorEncoders) {
-        data.motorPosition_isValid = iMotorEncoders->getMotorEncoders(data.motorPosition.data());
-        data.motorVelocity_isValid = iMotorEncoders->getMotorEncoderSpeeds(data.motorVelocity.data());
-        data.motorAcceleration_isValid = iMotorEncoders->getMotorEncoderAccelerations(data.motorAcceleration.data());
-    } else {
-        data.motorPosition_isValid = false;
-        data.motorVelocity_isValid = false;
-        data.motorAcceleration_isValid = false;
-    }
-
-    if (iTorqueControl) {
-        data.torque_isValid = iTorqueControl->getTorques(data.torque.data());
-    } else {
-        data.torque_isValid = false;
-    }
-
-    if (iPWMControl) {
-        data.pwmDutycycle_isValid = iPWMControl->getDutyCycles(data.pwmDutycycle.data());
-    } else {
-        data.pwmDutycycle_isValid = false;
-    }
-
-    if (iCurrentControl) {
-        data.current_isValid = iCurrentControl->getCurrents(data.current.data());
-    } else if (iAmplifierControl) {
-        data.current_isValid = iAmplifierControl->getCurrents(data.current.data());
-    } else {
-        data.current_isValid = false;
-    }
+    // Get data from HW, in a single call if the subdevice implements
+    // IFullJointState. The positions are always read for the state:o port,
+    // the other fields only if they are streamed to the clients connected.
+    extendedOutputStateProfile.update(extendedOutputStatePort);
+    auto streamed = [this](StateExtendedProfile::Field field, auto& v) {
+        return extendedOutputStateProfile.isStreamed(field) ? v.data() : nullptr;
+    };
+    yarp::dev::FullJointState state;
+    state.jointPosition = data.jointPosition.data();
+    state.jointTimestamp = times.data();
+    state.jointVelocity = streamed(StateExtendedProfile::JointVelocity, data.jointVelocity);
+    state.jointAcceleration = streamed(StateExtendedProfile::JointAcceleration, data.jointAcceleration);
+    state.motorPosition = streamed(StateExtendedProfile::MotorPosition, data.motorPosition);
+    state.motorVelocity = streamed(StateExtendedProfile::MotorVelocity, data.motorVelocity);
+    state.motorAcceleration = streamed(StateExtendedProfile::MotorAcceleration, data.motorAcceleration);
+    state.torque = streamed(StateExtendedProfile::Torque, data.torque);
+    state.pwmDutycycle = streamed(StateExtendedProfile::PwmDutycycle, data.pwmDutycycle);
+    state.current = streamed(StateExtendedProfile::Current, data.current);
+    state.controlMode = streamed(StateExtendedProfile::ControlMode, data.controlMode);
+    state.interactionMode = streamed(StateExtendedProfile::InteractionMode, data.interactionMode);
+    fullStateReader.getFullJointState(state);
+
+    data.jointPosition_isValid = state.jointPosition_isValid;
+    data.jointVelocity_isValid = state.jointVelocity_isValid;
+    data.jointAcceleration_isValid = state.jointAcceleration_isValid;
+    data.motorPosition_isValid = state.motorPosition_isValid;
+    data.motorVelocity_isValid = state.motorVelocity_isValid;
+    data.motorAcceleration_isValid = state.motorAcceleration_isValid;
+    data.torque_isValid = state.torque_isValid;
+    data.pwmDutycycle_isValid = state.pwmDutycycle_isValid;
+    data.current_isValid = state.current_isValid;
+    data.controlMode_isValid = state.controlMode_isValid;
+    data.interactionMode_isValid = state.interactionMode_isValid;
+
+    // prepare state:o before removing the fields not streamed
+    yarp::sig::Vector& v = outputPositionStatePort.prepare();
+    v.resize(subdevice_joints);
+    std::copy(data.jointPosition.begin(), data.jointPosition.end(), v.begin());
 
-    if (iControlMode) {
-        data.controlMode_isValid = iControlMode->getControlModes(data.controlMode.data());
-    } else {
-        data.controlMode_isValid = false;
-    }
-
-    if (iInteractionMode) {
-        data.interactionMode_isValid = iInteractionMode->getInteractionModes(reinterpret_cast<yarp::dev::InteractionModeEnum*>(data.interactionMode.data()));
-    } else {
-        data.interactionMode_isValid = false;
-    }
+    extendedOutputStateProfile.apply(data);
 
     extendedOutputStatePort.setEnvelope(averageTime);
     extendedOutputState_buffer.write();
 
     // handle state:o
-    yarp::sig::Vector& v = outputPositionStatePort.prepare();
-    v.resize(subdevice_joints);
-    std::copy(data.jointPosition.begin(), data.jointPosition.end(), v.begin());
-
     outputPositionStatePort.setEnvelope(averageTime);
     outputPositionStatePort.write();
 }
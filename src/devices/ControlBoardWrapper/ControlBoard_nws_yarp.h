@@ -35,6 +35,7 @@
 #include <yarp/dev/ICurrentControl.h>
 #include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/dev/IMotor.h>
+#include <yarp/dev/FullJointStateReader.h>
 
 #include <yarp/os/BufferedPort.h>
 #include <yarp/os/Stamp.h>
@@ -46,6 +47,7 @@
 
 #include "StreamingMessagesParser.h"
 #include "RPCMessagesParser.h"
+#include "StateExtendedProfile.h"
 
 
 /**
@@ -81,6 +83,7 @@ private:
 
     yarp::os::PortWriterBuffer<yarp::dev::impl::jointData> extendedOutputState_buffer; // Buffer associated to the extendedOutputStatePort port
     yarp::os::PortReaderBuffer<yarp::os::Bottle> inputRPC_buffer;                      // Buffer associated to the inputRPCPort port
+    StateExtendedProfile extendedOutputStateProfile;                                   // Fields streamed on the extendedOutputStatePort port, requested by the clients
 
     RPCMessagesParser RPC_parser;             // Message parser associated to the inputRPCPort port
     StreamingMessagesParser streaming_parser; // Message parser associated to the inputStreamingPort port
@@ -117,6 +120,8 @@ private:
     yarp::dev::IPWMControl* iPWMControl{nullptr};
     yarp::dev::ICurrentControl* iCurrentControl{nullptr};
 
+    yarp::dev::FullJointStateReader fullStateReader; // reads the state streamed on stateExt:o
+
     bool setDevice(yarp::dev::DeviceDriver* device, bool owned);
     bool openAndAttachSubDevice(yarp::os::Property& prop);
 
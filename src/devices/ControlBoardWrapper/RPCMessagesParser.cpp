@@ -51,6 +51,40 @@ void RPCMessagesParser::handleProtocolVersionRequest(const yarp::os::Bottle& cmd
     *ok = true;
 }
 
+void RPCMessagesParser::handleStateExtendedProfileMsg(const yarp::os::Bottle& cmd,
+                                                      yarp::os::Bottle& response,
+                                                      bool* rec,
+                                                      bool* ok)
+{
+    // [set] [sexp] $portName ($vocabField ...) $iDelta
+    // [set] [sexp] $portName
+    if (cmd.get(0).asVocab() != VOCAB_SET || !cmd.get(2).isString()) {
+        *rec = false;
+        *ok = false;
+        return;
+    }
+
+    *rec = true;
+    if (!rpc_stateExtProfile) {
+        *ok = false;
+        return;
+    }
+
+    std::string portName = cmd.get(2).asString();
+    if (cmd.size() == 3) {
+        rpc_stateExtProfile->removeRequest(portName);
+        *ok = true;
+        return;
+    }
+
+    yarp::os::Bottle* fields = cmd.get(3).asList();
+    if (!fields) {
+        *ok = false;
+        return;
+    }
+    *ok = rpc_stateExtProfile->setRequest(portName, *fields, cmd.get(4).asInt32() != 0);
+}
+
 void RPCMessagesParser::handleImpedanceMsg(const yarp::os::Bottle& cmd,
                                            yarp::os::Bottle& response,
                                            bool* rec,
@@ -1364,6 +1398,10 @@ bool RPCMessagesParser::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& r
             handleProtocolVersionRequest(cmd, response, &rec, &ok);
             break;
 
+        case VOCAB_STATE_EXT_PROFILE:
+            handleStateExtendedProfileMsg(cmd, response, &rec, &ok);
+            break;
+
         case VOCAB_REMOTE_CALIBRATOR_INTERFACE:
             handleRemoteCalibratorMsg(cmd, response, &rec, &ok);
             break;
@@ -2358,6 +2396,8 @@ bool RPCMessagesParser::initialize()
     addUsage("[set] [adi] $iAxisNumber", "disable (amplifier for) the given axis");
     addUsage("[get] [acu] $iAxisNumber", "get current for the given axis");
     addUsage("[get] [acus]", "get current for all axes");
+    addUsage("[set] [sexp] $sPortName ($vField ...) $iDelta", "stream on stateExt:o only the fields read by the client $sPortName (encs esps eacs mncs msps macs trqs pwms acus cmds mods), and the modes only when they change if $iDelta is 1");
+    addUsage("[set] [sexp] $sPortName", "stream on stateExt:o all the fields for the client $sPortName");
 
     return ok;
 }
@@ -2386,6 +2426,11 @@ void RPCMessagesParser::init(yarp::dev::DeviceDriver* x)
     controlledJoints = 0;
 }
 
+void RPCMessagesParser::setStateExtendedProfile(StateExtendedProfile* profile)
+{
+    rpc_stateExtProfile = profile;
+}
+
 void RPCMessagesParser::reset()
 {
     rpc_IPid = nullptr;
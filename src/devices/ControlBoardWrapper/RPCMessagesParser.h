@@ -26,6 +26,8 @@
 #include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/dev/PolyDriver.h>
 
+#include "StateExtendedProfile.h"
+
 #include <mutex>
 #include <string>
 #include <vector>
@@ -76,6 +78,7 @@ protected:
     yarp::dev::IRemoteVariables* rpc_IVar {nullptr};
     yarp::dev::ICurrentControl* rpc_ICurrent {nullptr};
     yarp::dev::IPWMControl* rpc_IPWM {nullptr};
+    StateExtendedProfile* rpc_stateExtProfile {nullptr};
     yarp::sig::Vector tmpVect;
     yarp::os::Stamp lastRpcStamp;
     std::mutex mutex;
@@ -96,6 +99,11 @@ public:
     void init(yarp::dev::DeviceDriver* x);
     void reset();
 
+    /**
+    * Set the profile of the stateExt:o port updated by the clients requests.
+    */
+    void setStateExtendedProfile(StateExtendedProfile* profile);
+
     bool respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& response) override;
 
     void handleTorqueMsg(const yarp::os::Bottle& cmd,
@@ -123,6 +131,11 @@ public:
                                       bool* rec,
                                       bool* ok);
 
+    void handleStateExtendedProfileMsg(const yarp::os::Bottle& cmd,
+                                       yarp::os::Bottle& response,
+                                       bool* rec,
+                                       bool* ok);
+
     void handleRemoteCalibratorMsg(const yarp::os::Bottle& cmd, yarp::os::Bottle& response, bool* rec, bool* ok);
 
     void handleRemoteVariablesMsg(const yarp::os::Bottle& cmd, yarp::os::Bottle& response, bool* rec, bool* ok);
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "StateExtendedProfile.h"
+
+#include "ControlBoardLogComponent.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/PortInfo.h>
+#include <yarp/os/PortReport.h>
+#include <yarp/os/Time.h>
+
+#include <yarp/dev/ControlBoardInterfaces.h>
+
+#include <algorithm>
+#include <set>
+
+using yarp::dev::impl::jointData;
+
+constexpr double StateExtendedProfile::keyframePeriod;
+
+namespace {
+
+class ConnectionsReport : public yarp::os::PortReport
+{
+public:
+    std::set<std::string> targets;
+
+    void report(const yarp::os::PortInfo& info) override
+    {
+        if (info.tag == yarp::os::PortInfo::PORTINFO_CONNECTION && !info.incoming) {
+            targets.insert(info.targetName);
+        }
+    }
+};
+
+template <typename T>
+void removeField(T& data, bool& isValid)
+{
+    data.resize(0);
+    isValid = false;
+}
+
+// Send the modes only if they changed since they were last sent
+void removeUnchanged(yarp::sig::VectorOf<int>& data, bool isValid, yarp::sig::VectorOf<int>& sent, bool keyframe)
+{
+    if (!isValid) {
+        return;
+    }
+    if (!keyframe && data.size() == sent.size() && std::equal(data.begin(), data.end(), sent.begin())) {
+        data.resize(0);
+        return;
+    }
+    sent = data;
+}
+
+} // namespace
+
+
+bool StateExtendedProfile::setRequest(const std::string& portName, const yarp::os::Bottle& vocabs, bool requestDelta)
+{
+    unsigned int requestFields = 0;
+    for (size_t i = 0; i < vocabs.size(); i++) {
+        switch (vocabs.get(i).asVocab()) {
+        case VOCAB_ENCODERS: requestFields |= JointPosition; break;
+        case VOCAB_ENCODER_SPEEDS: requestFields |= JointVelocity; break;
+        case VOCAB_ENCODER_ACCELERATIONS: requestFields |= JointAcceleration; break;
+        case VOCAB_MOTOR_ENCODERS: requestFields |= MotorPosition; break;
+        case VOCAB_MOTOR_ENCODER_SPEEDS: requestFields |= MotorVelocity; break;
+        case VOCAB_MOTOR_ENCODER_ACCELERATIONS: requestFields |= MotorAcceleration; break;
+        case VOCAB_TRQS: requestFields |= Torque; break;
+        case VOCAB_PWMCONTROL_PWM_OUTPUTS: requestFields |= PwmDutycycle; break;
+        case VOCAB_AMP_CURRENTS: requestFields |= Current; break;
+        case VOCAB_CM_CONTROL_MODES: requestFields |= ControlMode; break;
+        case VOCAB_INTERACTION_MODES: requestFields |= InteractionMode; break;
+        default:
+            yCError(CONTROLBOARD) << "Unknown field" << vocabs.get(i).toString() << "requested for the stateExt:o port by" << portName;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    requests[portName] = {requestFields, requestDelta};
+    requestsChanged = true;
+    return true;
+}
+
+
+void StateExtendedProfile::removeRequest(const std::string& portName)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.erase(portName);
+    requestsChanged = true;
+}
+
+
+void StateExtendedProfile::ConnectionsWatcher::report(const yarp::os::PortInfo& info)
+{
+    if (info.tag == yarp::os::PortInfo::PORTINFO_CONNECTION && !info.incoming) {
+        events++;
+    }
+}
+
+
+void StateExtendedProfile::watch(yarp::os::Contactable& port)
+{
+    port.setReporter(watcher);
+}
+
+
+void StateExtendedProfile::unwatch(yarp::os::Contactable& port)
+{
+    port.resetReporter();
+}
+
+
+void StateExtendedProfile::update(yarp::os::Contactable& port)
+{
+    // Read the events before the connections, an event arriving meanwhile
+    // is handled at the next update
+    unsigned int events = watcher.events.load();
+    int count = port.getOutputCount();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!requestsChanged && count == connections && events == connectionEvents) {
+        return;
+    }
+    requestsChanged = false;
+    connections = count;
+    connectionEvents = events;
+
+    ConnectionsReport report;
+    port.getReport(report);
+
+    // Forget the requests of the clients no longer connected
+    for (auto it = requests.begin(); it != requests.end();) {
+        if (report.targets.find(it->first) == report.targets.end()) {
+            it = requests.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    unsigned int newFields = report.targets.empty() ? static_cast<unsigned int>(AllFields) : 0;
+    bool newDelta = !report.targets.empty();
+    for (const auto& target : report.targets) {
+        auto it = requests.find(target);
+        if (it == requests.end()) {
+            newFields = AllFields;
+            newDelta = false;
+        } else {
+            newFields |= it->second.fields;
+            newDelta = newDelta && it->second.delta;
+        }
+    }
+
+    fields = newFields;
+    delta = newDelta;
+
+    // A new client needs all the modes
+    keyframe = true;
+}
+
+
+void StateExtendedProfile::apply(jointData& data)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (fields != AllFields) {
+        if (!isStreamed(JointPosition)) { removeField(data.jointPosition, data.jointPosition_isValid); }
+        if (!isStreamed(JointVelocity)) { removeField(data.jointVelocity, data.jointVelocity_isValid); }
+        if (!isStreamed(JointAcceleration)) { removeField(data.jointAcceleration, data.jointAcceleration_isValid); }
+        if (!isStreamed(MotorPosition)) { removeField(data.motorPosition, data.motorPosition_isValid); }
+        if (!isStreamed(MotorVelocity)) { removeField(data.motorVelocity, data.motorVelocity_isValid); }
+        if (!isStreamed(MotorAcceleration)) { removeField(data.motorAcceleration, data.motorAcceleration_isValid); }
+        if (!isStreamed(Torque)) { removeField(data.torque, data.torque_isValid); }
+        if (!isStreamed(PwmDutycycle)) { removeField(data.pwmDutycycle, data.pwmDutycycle_isValid); }
+        if (!isStreamed(Current)) { removeField(data.current, data.current_isValid); }
+        if (!isStreamed(ControlMode)) { removeField(data.controlMode, data.controlMode_isValid); }
+        if (!isStreamed(InteractionMode)) { removeField(data.interactionMode, data.interactionMode_isValid); }
+    }
+
+    if (!delta) {
+        return;
+    }
+
+    double now = yarp::os::Time::now();
+    if (now - lastKeyframe >= keyframePeriod) {
+        keyframe = true;
+    }
+    if (isStreamed(ControlMode)) {
+        removeUnchanged(data.controlMode, data.controlMode_isValid, sentControlMode, keyframe);
+    }
+    if (isStreamed(InteractionMode)) {
+        removeUnchanged(data.interactionMode, data.interactionMode_isValid, sentInteractionMode, keyframe);
+    }
+    if (keyframe) {
+        keyframe = false;
+        lastKeyframe = now;
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_CONTROLBOARDWRAPPER_STATEEXTENDEDPROFILE_H
+#define YARP_DEV_CONTROLBOARDWRAPPER_STATEEXTENDEDPROFILE_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Contactable.h>
+#include <yarp/os/PortReport.h>
+#include <yarp/sig/Vector.h>
+
+#include <yarp/dev/impl/jointData.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+/*
+ * The profile of the jointData streamed on the stateExt:o port.
+ *
+ * Each client can request, through the rpc port, the fields of jointData it
+ * reads, and whether the control and interaction modes can be sent only when
+ * they change (delta encoding).
+ * The port streams the fields requested by any of the clients connected, and
+ * uses the delta encoding only if all of them requested it. The clients that
+ * did not request a profile (e.g. older clients) receive all the fields.
+ *
+ * The fields not streamed are sent as empty vectors not valid, the modes that
+ * did not change are sent as empty vectors valid. The modes are sent anyway
+ * at least every keyframePeriod seconds, so that a client that dropped a
+ * message is updated.
+ */
+class StateExtendedProfile
+{
+public:
+    enum Field : unsigned int
+    {
+        JointPosition = 1 << 0,
+        JointVelocity = 1 << 1,
+        JointAcceleration = 1 << 2,
+        MotorPosition = 1 << 3,
+        MotorVelocity = 1 << 4,
+        MotorAcceleration = 1 << 5,
+        Torque = 1 << 6,
+        PwmDutycycle = 1 << 7,
+        Current = 1 << 8,
+        ControlMode = 1 << 9,
+        InteractionMode = 1 << 10,
+        AllFields = (1 << 11) - 1
+    };
+
+    static constexpr double keyframePeriod = 0.1; // s
+
+    /*
+     * Set the profile requested by the client connected to the port portName.
+     * fields is the list of the vocabs of the fields (VOCAB_ENCODERS,
+     * VOCAB_ENCODER_SPEEDS, ..., VOCAB_CM_CONTROL_MODES, VOCAB_INTERACTION_MODES)
+     * @return false if fields contains an unknown vocab
+     */
+    bool setRequest(const std::string& portName, const yarp::os::Bottle& fields, bool delta);
+
+    /*
+     * Remove the profile requested by the client connected to the port portName.
+     */
+    void removeRequest(const std::string& portName);
+
+    /*
+     * Start counting the connections and disconnections of the port, so that
+     * the profile is updated also when a client replaces another one between
+     * two updates. The port must be released with unwatch() before closing
+     * this profile.
+     */
+    void watch(yarp::os::Contactable& port);
+    void unwatch(yarp::os::Contactable& port);
+
+    /*
+     * Update the profile with the clients connected to the port.
+     * Cheap when neither the requests nor the connections changed.
+     */
+    void update(yarp::os::Contactable& port);
+
+    bool isStreamed(Field field) const
+    {
+        return (fields & field) != 0;
+    }
+
+    /*
+     * Remove from data the fields that are not streamed and, with the delta
+     * encoding, the modes that did not change since they were last sent.
+     */
+    void apply(yarp::dev::impl::jointData& data);
+
+private:
+    struct Request
+    {
+        unsigned int fields;
+        bool delta;
+    };
+
+    // Called by the threads of the port, does not take the mutex
+    class ConnectionsWatcher : public yarp::os::PortReport
+    {
+    public:
+        std::atomic<unsigned int> events {0};
+        void report(const yarp::os::PortInfo& info) override;
+    };
+
+    ConnectionsWatcher watcher;
+    unsigned int connectionEvents {0};
+
+    std::mutex mutex;
+    std::map<std::string, Request> requests;
+    bool requestsChanged {true};
+    int connections {0};
+
+    unsigned int fields {AllFields};
+    bool delta {false};
+
+    bool keyframe {true};
+    double lastKeyframe {0.0};
+    yarp::sig::VectorOf<int> sentControlMode;
+    yarp::sig::VectorOf<int> sentInteractionMode;
+};
+
+#endif // YARP_DEV_CONTROLBOARDWRAPPER_STATEEXTENDEDPROFILE_H
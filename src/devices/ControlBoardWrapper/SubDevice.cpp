@@ -81,6 +81,7 @@ void SubDevice::detach()
     iTimed = nullptr;
     iInteract = nullptr;
     iVar = nullptr;
+    fullState.detach();
     configuredF = false;
     attachedF = false;
 }
@@ -125,6 +126,7 @@ bool SubDevice::attach(yarp::dev::PolyDriver* d, const std::string& k)
         subdevice->view(iVar);
         subdevice->view(iCurr);
         subdevice->view(iPWM);
+        fullState.attach(subdevice);
     } else {
         yCError(CONTROLBOARD, "Part <%s>: Invalid device %s (isValid() returned false).", parentName.c_str(), k.c_str());
         return false;
@@ -26,6 +26,7 @@
 
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/ControlBoardInterfacesImpl.h>
+#include <yarp/dev/FullJointStateReader.h>
 #include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/dev/PolyDriver.h>
 
@@ -87,6 +88,8 @@ public:
     yarp::dev::IPWMControl* iPWM {nullptr};
     yarp::dev::ICurrentControl* iCurr {nullptr};
 
+    yarp::dev::FullJointStateReader fullState;
+
     yarp::sig::Vector subDev_joint_encoders;
     yarp::sig::Vector jointEncodersTimes;
     yarp::sig::Vector subDev_motor_encoders;
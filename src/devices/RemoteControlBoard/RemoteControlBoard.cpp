@@ -30,6 +30,7 @@
 #include <yarp/dev/ControlBoardHelpers.h>
 #include <yarp/dev/IPreciselyTimed.h>
 
+#include <map>
 #include <mutex>
 
 
@@ -174,6 +175,62 @@ bool RemoteControlBoard::checkProtocolVersion(bool ignore)
     return ret;
 }
 
+bool RemoteControlBoard::requestStateExtendedProfile(Searchable& config)
+{
+    bool delta = config.check("stateExtDelta", Value(false)).asBool();
+    if (!config.check("stateExtFields") && !delta) {
+        return true;
+    }
+
+    // The fields of jointData, and the vocabs used to request them
+    static const std::map<std::string, yarp::conf::vocab32_t> stateExtFields = {
+        {"jointPosition", VOCAB_ENCODERS},
+        {"jointVelocity", VOCAB_ENCODER_SPEEDS},
+        {"jointAcceleration", VOCAB_ENCODER_ACCELERATIONS},
+        {"motorPosition", VOCAB_MOTOR_ENCODERS},
+        {"motorVelocity", VOCAB_MOTOR_ENCODER_SPEEDS},
+        {"motorAcceleration", VOCAB_MOTOR_ENCODER_ACCELERATIONS},
+        {"torque", VOCAB_TRQS},
+        {"pwmDutycycle", VOCAB_PWMCONTROL_PWM_OUTPUTS},
+        {"current", VOCAB_AMP_CURRENTS},
+        {"controlMode", VOCAB_CM_CONTROL_MODES},
+        {"interactionMode", VOCAB_INTERACTION_MODES}
+    };
+
+    Bottle cmd, reply;
+    cmd.addVocab(VOCAB_SET);
+    cmd.addVocab(VOCAB_STATE_EXT_PROFILE);
+    cmd.addString(extendedIntputStatePort.getName());
+    Bottle& fields = cmd.addList();
+    if (config.check("stateExtFields")) {
+        Bottle names;
+        Value& value = config.find("stateExtFields");
+        if (value.isList()) {
+            names = *value.asList();
+        } else {
+            names.add(value);
+        }
+        for (size_t i = 0; i < names.size(); i++) {
+            auto it = stateExtFields.find(names.get(i).asString());
+            if (it == stateExtFields.end()) {
+                yCError(REMOTECONTROLBOARD) << "Unknown field" << names.get(i).toString() << "in stateExtFields";
+                return false;
+            }
+            fields.addVocab(it->second);
+        }
+    } else {
+        for (const auto& field : stateExtFields) {
+            fields.addVocab(field.second);
+        }
+    }
+    cmd.addInt32(delta ? 1 : 0);
+
+    if (!rpc_p.write(cmd, reply) || reply.get(0).asVocab() != VOCAB_OK) {
+        yCWarning(REMOTECONTROLBOARD, "The remote device does not support the stateExtFields and stateExtDelta parameters, all the fields will be streamed");
+    }
+    return true;
+}
+
 bool RemoteControlBoard::open(Searchable& config)
 {
     remote = config.find("remote").asString();
@@ -341,6 +398,15 @@ bool RemoteControlBoard::open(Searchable& config)
         }
     }
 
+    extendedIntputStatePort.init(nj);
+    if (!requestStateExtendedProfile(config)) {
+        command_buffer.detach();
+        rpc_p.close();
+        command_p.close();
+        extendedIntputStatePort.close();
+        return false;
+    }
+
     if (config.check("diagnostic"))
     {
         diagnosticThread = new DiagnosticThread(DIAGNOSTIC_THREAD_PERIOD);
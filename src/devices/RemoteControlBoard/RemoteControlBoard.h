@@ -62,6 +62,11 @@ class DiagnosticThread;
 * | remote         |       -        | string  | -     |   -           | Yes          | Prefix of the port to which to connect.        |       |
 * | local          |       -        | string  | -     |   -           | Yes          | Port prefix of the port opened by this device. |       |
 * | writeStrict    |       -        | string  | -     | See note      | No           |                                                |       |
+* | stateExtFields |       -        | list    | -     | all the fields | No          | Fields of the state read by the client: jointPosition jointVelocity jointAcceleration motorPosition motorVelocity motorAcceleration torque pwmDutycycle current controlMode interactionMode | The methods reading the other fields fail |
+* | stateExtDelta  |       -        | bool    | -     | false         | No           | Receive the control and interaction modes only when they change | |
+*
+* The stateExtFields and stateExtDelta parameters reduce the data streamed by
+* the remote device, that streams the fields read by all its clients.
 *
 */
 class RemoteControlBoard :
@@ -120,6 +125,8 @@ protected:
 
     bool checkProtocolVersion(bool ignore);
 
+    bool requestStateExtendedProfile(yarp::os::Searchable& config);
+
     bool send1V(int v);
     bool send2V(int v1, int v2);
     bool send2V1I(int v1, int v2, int axis);
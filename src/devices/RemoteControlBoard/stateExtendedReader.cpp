@@ -50,30 +50,50 @@ StateExtendedInputPort::StateExtendedInputPort() : deltaT{0},
                                                    now{Time::now()},
                                                    prev{now},
                                                    timeout{0.5},
-                                                   valid{false},
                                                    count{0}
 {
 }
 
 void StateExtendedInputPort::init(int numberOfJoints)
 {
-    last.jointPosition.resize(numberOfJoints);
-    last.jointVelocity.resize(numberOfJoints);
-    last.jointAcceleration.resize(numberOfJoints);
-    last.motorPosition.resize(numberOfJoints);
-    last.motorVelocity.resize(numberOfJoints);
-    last.motorAcceleration.resize(numberOfJoints);
-    last.torque.resize(numberOfJoints);
-    last.pwmDutycycle.resize(numberOfJoints);
-    last.current.resize(numberOfJoints);
-    last.controlMode.resize(numberOfJoints);
-    last.interactionMode.resize(numberOfJoints);
+    last.update([&](LastState& state) {
+        state.data.jointPosition.resize(numberOfJoints);
+        state.data.jointVelocity.resize(numberOfJoints);
+        state.data.jointAcceleration.resize(numberOfJoints);
+        state.data.motorPosition.resize(numberOfJoints);
+        state.data.motorVelocity.resize(numberOfJoints);
+        state.data.motorAcceleration.resize(numberOfJoints);
+        state.data.torque.resize(numberOfJoints);
+        state.data.pwmDutycycle.resize(numberOfJoints);
+        state.data.current.resize(numberOfJoints);
+        state.data.controlMode.resize(numberOfJoints);
+        state.data.interactionMode.resize(numberOfJoints);
+    });
 }
 
+namespace {
+
+// The fields not streamed are empty and not valid, the modes that did not
+// change since the previous message (delta encoding) are empty and valid:
+// keep the data received last, so that the state stays complete.
+template <typename T>
+void update(T& last, bool& last_isValid, const T& v, bool v_isValid)
+{
+    if (v.size() != 0) {
+        last = v;
+        last_isValid = v_isValid;
+    } else if (!v_isValid) {
+        last_isValid = false;
+    }
+}
+
+} // namespace
+
 void StateExtendedInputPort::onRead(yarp::dev::impl::jointData &v)
 {
-    now=Time::now();
+    double arrivalTime=Time::now();
     mutex.lock();
+    now=arrivalTime;
 
     if (count>0)
     {
@@ -87,14 +107,27 @@ void StateExtendedInputPort::onRead(yarp::dev::impl::jointData &v)
 
     prev=now;
     count++;
-
-    valid=true;
-    last=v;
-    getEnvelope(lastStamp);
-    //check that timestamp are available
-    if (!lastStamp.isValid())
-        lastStamp.update(now);
     mutex.unlock();
+
+    last.update([&](LastState& state) {
+        state.valid=true;
+        update(state.data.jointPosition, state.data.jointPosition_isValid, v.jointPosition, v.jointPosition_isValid);
+        update(state.data.jointVelocity, state.data.jointVelocity_isValid, v.jointVelocity, v.jointVelocity_isValid);
+        update(state.data.jointAcceleration, state.data.jointAcceleration_isValid, v.jointAcceleration, v.jointAcceleration_isValid);
+        update(state.data.motorPosition, state.data.motorPosition_isValid, v.motorPosition, v.motorPosition_isValid);
+        update(state.data.motorVelocity, state.data.motorVelocity_isValid, v.motorVelocity, v.motorVelocity_isValid);
+        update(state.data.motorAcceleration, state.data.motorAcceleration_isValid, v.motorAcceleration, v.motorAcceleration_isValid);
+        update(state.data.torque, state.data.torque_isValid, v.torque, v.torque_isValid);
+        update(state.data.pwmDutycycle, state.data.pwmDutycycle_isValid, v.pwmDutycycle, v.pwmDutycycle_isValid);
+        update(state.data.current, state.data.current_isValid, v.current, v.current_isValid);
+        update(state.data.controlMode, state.data.controlMode_isValid, v.controlMode, v.controlMode_isValid);
+        update(state.data.interactionMode, state.data.interactionMode_isValid, v.interactionMode, v.interactionMode_isValid);
+        state.arrivalTime=arrivalTime;
+        getEnvelope(state.stamp);
+        //check that timestamp are available
+        if (!state.stamp.isValid())
+            state.stamp.update(arrivalTime);
+    });
 }
 
 void StateExtendedInputPort::setTimeout(const double& timeout) {
@@ -103,201 +136,199 @@ void StateExtendedInputPort::setTimeout(const double& timeout) {
 
 bool StateExtendedInputPort::getLastSingle(int j, int field, double *data, Stamp &stamp, double &localArrivalTime)
 {
-    mutex.lock();
-    bool ret = valid;
-    if (ret)
-    {
-        switch(field)
+    return last.read([&](const LastState& state) {
+        bool ret = state.valid;
+        if (ret)
         {
-            case VOCAB_ENCODER:
-                *data = last.jointPosition[j];
-                ret  = last.jointPosition_isValid;
-            break;
-
-            case VOCAB_ENCODER_SPEED:
-                ret = last.jointVelocity_isValid;
-                *data = last.jointVelocity[j];
+            switch(field)
+            {
+                case VOCAB_ENCODER:
+                    *data = state.data.jointPosition[j];
+                    ret  = state.data.jointPosition_isValid;
                 break;
 
-            case VOCAB_ENCODER_ACCELERATION:
-                ret = last.jointAcceleration_isValid;
-                *data = last.jointAcceleration[j];
-            break;
-
-            case VOCAB_MOTOR_ENCODER:
-                ret = last.motorPosition_isValid;
-                *data = last.motorPosition[j];
-            break;
-
-            case VOCAB_MOTOR_ENCODER_SPEED:
-                ret = last.motorVelocity_isValid;
-                *data = last.motorVelocity[j];
-            break;
-
-            case VOCAB_MOTOR_ENCODER_ACCELERATION:
-                ret = last.motorAcceleration_isValid;
-                *data = last.motorAcceleration[j];
-            break;
-
-            case VOCAB_TRQ:
-                ret = last.torque_isValid;
-                *data = last.torque[j];
-            break;
-
-            case VOCAB_PWMCONTROL_PWM_OUTPUT:
-                ret = last.pwmDutycycle_isValid;
-                *data = last.pwmDutycycle[j];
-            break;
-
-            case VOCAB_AMP_CURRENT:
-                ret = last.current_isValid;
-                *data = last.current[j];
+                case VOCAB_ENCODER_SPEED:
+                    ret = state.data.jointVelocity_isValid;
+                    *data = state.data.jointVelocity[j];
+                    break;
+
+                case VOCAB_ENCODER_ACCELERATION:
+                    ret = state.data.jointAcceleration_isValid;
+                    *data = state.data.jointAcceleration[j];
                 break;
 
-            default:
-                yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'single' data of type " << yarp::os::Vocab::decode(field);
-            break;
-        }
+                case VOCAB_MOTOR_ENCODER:
+                    ret = state.data.motorPosition_isValid;
+                    *data = state.data.motorPosition[j];
+                break;
 
-        localArrivalTime=now;
-        stamp = lastStamp;
-        if (ret && ( (Time::now()-localArrivalTime) > timeout) )
-            ret = false;
-    }
-    mutex.unlock();
+                case VOCAB_MOTOR_ENCODER_SPEED:
+                    ret = state.data.motorVelocity_isValid;
+                    *data = state.data.motorVelocity[j];
+                break;
 
-    return ret;
+                case VOCAB_MOTOR_ENCODER_ACCELERATION:
+                    ret = state.data.motorAcceleration_isValid;
+                    *data = state.data.motorAcceleration[j];
+                break;
+
+                case VOCAB_TRQ:
+                    ret = state.data.torque_isValid;
+                    *data = state.data.torque[j];
+                break;
+
+                case VOCAB_PWMCONTROL_PWM_OUTPUT:
+                    ret = state.data.pwmDutycycle_isValid;
+                    *data = state.data.pwmDutycycle[j];
+                break;
+
+                case VOCAB_AMP_CURRENT:
+                    ret = state.data.current_isValid;
+                    *data = state.data.current[j];
+                    break;
+
+                default:
+                    yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'single' data of type " << yarp::os::Vocab::decode(field);
+                break;
+            }
+
+            localArrivalTime=state.arrivalTime;
+            stamp = state.stamp;
+            if (ret && ( (Time::now()-localArrivalTime) > timeout) )
+                ret = false;
+        }
+        return ret;
+    });
 }
 
 bool StateExtendedInputPort::getLastSingle(int j, int field, int *data, Stamp &stamp, double &localArrivalTime)
 {
-    mutex.lock();
-    bool ret = valid;
-    if (ret)
-    {
-        switch(field)
+    return last.read([&](const LastState& state) {
+        bool ret = state.valid;
+        if (ret)
         {
-            case VOCAB_CM_CONTROL_MODE:
-                ret = last.controlMode_isValid;
-                *data = last.controlMode[j];
-            break;
-
-            case VOCAB_INTERACTION_MODE:
-                ret = last.interactionMode_isValid;
-                *data = last.interactionMode[j];
-            break;
-
-            default:
-                yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'single' data of type " << yarp::os::Vocab::decode(field);
-            break;
-        }
-        localArrivalTime=now;
-        stamp = lastStamp;
-        if (ret && ( (Time::now()-localArrivalTime) > timeout) )
-            ret = false;
+            switch(field)
+            {
+                case VOCAB_CM_CONTROL_MODE:
+                    ret = state.data.controlMode_isValid;
+                    *data = state.data.controlMode[j];
+                break;
 
-    }
-    mutex.unlock();
-    return ret;
+                case VOCAB_INTERACTION_MODE:
+                    ret = state.data.interactionMode_isValid;
+                    *data = state.data.interactionMode[j];
+                break;
+
+                default:
+                    yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'single' data of type " << yarp::os::Vocab::decode(field);
+                break;
+            }
+            localArrivalTime=state.arrivalTime;
+            stamp = state.stamp;
+            if (ret && ( (Time::now()-localArrivalTime) > timeout) )
+                ret = false;
+
+        }
+        return ret;
+    });
 }
 
 bool StateExtendedInputPort::getLastVector(int field, double* data, Stamp& stamp, double& localArrivalTime)
 {
-    mutex.lock();
-    bool ret = valid;
-    if (ret)
-    {
-        switch(field)
+    return last.read([&](const LastState& state) {
+        bool ret = state.valid;
+        if (ret)
         {
-            case VOCAB_ENCODERS:
-                ret = last.jointPosition_isValid;
-                memcpy(data, last.jointPosition.data(), last.jointPosition.size() * last.jointPosition.getElementSize() );
-            break;
-
-            case VOCAB_ENCODER_SPEEDS:
-                ret = last.jointVelocity_isValid;
-                memcpy(data, last.jointVelocity.data(), last.jointVelocity.size() * last.jointVelocity.getElementSize() );
-            break;
-
-            case VOCAB_ENCODER_ACCELERATIONS:
-                ret = last.jointAcceleration_isValid;
-                memcpy(data, last.jointAcceleration.data(), last.jointAcceleration.size() * last.jointAcceleration.getElementSize() );
-            break;
-
-            case VOCAB_MOTOR_ENCODERS:
-                ret = last.motorPosition_isValid;
-                memcpy(data, last.motorPosition.data(), last.motorPosition.size() * last.motorPosition.getElementSize() );
-            break;
-
-            case VOCAB_MOTOR_ENCODER_SPEEDS:
-                ret = last.motorVelocity_isValid;
-                memcpy(data, last.motorVelocity.data(), last.motorVelocity.size() * last.motorVelocity.getElementSize() );
-            break;
-
-            case VOCAB_MOTOR_ENCODER_ACCELERATIONS:
-                ret = last.motorAcceleration_isValid;
-                memcpy(data, last.motorAcceleration.data(), last.motorAcceleration.size() * last.motorAcceleration.getElementSize() );
-            break;
-
-            case VOCAB_TRQS:
-                ret = last.torque_isValid;
-                memcpy(data, last.torque.data(), last.torque.size() * last.torque.getElementSize() );
-            break;
-
-            case VOCAB_PWMCONTROL_PWM_OUTPUTS:
-                ret = last.pwmDutycycle_isValid;
-                memcpy(data, last.pwmDutycycle.data(), last.pwmDutycycle.size() * last.pwmDutycycle.getElementSize());
-            break;
-
-            case VOCAB_AMP_CURRENTS:
-                ret = last.current_isValid;
-                memcpy(data, last.current.data(), last.current.size() * last.current.getElementSize());
+            switch(field)
+            {
+                case VOCAB_ENCODERS:
+                    ret = state.data.jointPosition_isValid;
+                    memcpy(data, state.data.jointPosition.data(), state.data.jointPosition.size() * state.data.jointPosition.getElementSize() );
                 break;
 
-            default:
-                yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'vector' data of type " << yarp::os::Vocab::decode(field);
-            break;
-        }
+                case VOCAB_ENCODER_SPEEDS:
+                    ret = state.data.jointVelocity_isValid;
+                    memcpy(data, state.data.jointVelocity.data(), state.data.jointVelocity.size() * state.data.jointVelocity.getElementSize() );
+                break;
 
-        localArrivalTime=now;
-        stamp = lastStamp;
-        if (ret && ( (Time::now()-localArrivalTime) > timeout) )
-            ret = false;
-    }
-    mutex.unlock();
+                case VOCAB_ENCODER_ACCELERATIONS:
+                    ret = state.data.jointAcceleration_isValid;
+                    memcpy(data, state.data.jointAcceleration.data(), state.data.jointAcceleration.size() * state.data.jointAcceleration.getElementSize() );
+                break;
 
-    return ret;
+                case VOCAB_MOTOR_ENCODERS:
+                    ret = state.data.motorPosition_isValid;
+                    memcpy(data, state.data.motorPosition.data(), state.data.motorPosition.size() * state.data.motorPosition.getElementSize() );
+                break;
+
+                case VOCAB_MOTOR_ENCODER_SPEEDS:
+                    ret = state.data.motorVelocity_isValid;
+                    memcpy(data, state.data.motorVelocity.data(), state.data.motorVelocity.size() * state.data.motorVelocity.getElementSize() );
+                break;
+
+                case VOCAB_MOTOR_ENCODER_ACCELERATIONS:
+                    ret = state.data.motorAcceleration_isValid;
+                    memcpy(data, state.data.motorAcceleration.data(), state.data.motorAcceleration.size() * state.data.motorAcceleration.getElementSize() );
+                break;
+
+                case VOCAB_TRQS:
+                    ret = state.data.torque_isValid;
+                    memcpy(data, state.data.torque.data(), state.data.torque.size() * state.data.torque.getElementSize() );
+                break;
+
+                case VOCAB_PWMCONTROL_PWM_OUTPUTS:
+                    ret = state.data.pwmDutycycle_isValid;
+                    memcpy(data, state.data.pwmDutycycle.data(), state.data.pwmDutycycle.size() * state.data.pwmDutycycle.getElementSize());
+                break;
+
+                case VOCAB_AMP_CURRENTS:
+                    ret = state.data.current_isValid;
+                    memcpy(data, state.data.current.data(), state.data.current.size() * state.data.current.getElementSize());
+                    break;
+
+                default:
+                    yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'vector' data of type " << yarp::os::Vocab::decode(field);
+                break;
+            }
+
+            localArrivalTime=state.arrivalTime;
+            stamp = state.stamp;
+            if (ret && ( (Time::now()-localArrivalTime) > timeout) )
+                ret = false;
+        }
+        return ret;
+    });
 }
 
 bool StateExtendedInputPort::getLastVector(int field, int* data, Stamp& stamp, double& localArrivalTime)
 {
-    mutex.lock();
-    bool ret = valid;
-    if (ret)
-    {
-        switch(field)
+    return last.read([&](const LastState& state) {
+        bool ret = state.valid;
+        if (ret)
         {
-            case VOCAB_CM_CONTROL_MODES:
-                ret = last.controlMode_isValid;
-                memcpy(data, last.controlMode.data(), last.controlMode.size() * last.controlMode.getElementSize());
-            break;
-
-            case VOCAB_INTERACTION_MODES:
-                ret = last.interactionMode_isValid;
-                memcpy(data, last.interactionMode.data(), last.interactionMode.size() * last.interactionMode.getElementSize());
-            break;
-
-            default:
-                yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'vector' data of type " << yarp::os::Vocab::decode(field);
-            break;
+            switch(field)
+            {
+                case VOCAB_CM_CONTROL_MODES:
+                    ret = state.data.controlMode_isValid;
+                    memcpy(data, state.data.controlMode.data(), state.data.controlMode.size() * state.data.controlMode.getElementSize());
+                break;
+
+                case VOCAB_INTERACTION_MODES:
+                    ret = state.data.interactionMode_isValid;
+                    memcpy(data, state.data.interactionMode.data(), state.data.interactionMode.size() * state.data.interactionMode.getElementSize());
+                break;
+
+                default:
+                    yCError(REMOTECONTROLBOARD) << "RemoteControlBoard internal error while reading data. Cannot get 'vector' data of type " << yarp::os::Vocab::decode(field);
+                break;
+            }
+            localArrivalTime=state.arrivalTime;
+            stamp = state.stamp;
+            if (ret && ( (Time::now()-localArrivalTime) > timeout) )
+                ret = false;
         }
-        localArrivalTime=now;
-        stamp = lastStamp;
-        if (ret && ( (Time::now()-localArrivalTime) > timeout) )
-            ret = false;
-    }
-    mutex.unlock();
-    return ret;
+        return ret;
+    });
 }
 
 int StateExtendedInputPort::getIterations()
@@ -18,6 +18,7 @@
 #include <yarp/os/Vocab.h>
 #include <yarp/os/Stamp.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/SnapshotBuffer.h>
 
 #include <yarp/sig/Vector.h>
 
@@ -42,9 +43,19 @@ using namespace yarp::sig;
 class StateExtendedInputPort :
         public yarp::os::BufferedPort<yarp::dev::impl::jointData>
 {
-    yarp::dev::impl::jointData last;
+    // The state received last, read by the control threads without
+    // waiting for onRead
+    struct LastState
+    {
+        yarp::dev::impl::jointData data;
+        Stamp stamp;
+        double arrivalTime {0.0};
+        bool valid {false};
+    };
+    yarp::os::SnapshotBuffer<LastState> last;
+
+    // Statistics of the messages received
     std::mutex mutex;
-    Stamp lastStamp;
     double deltaT;
     double deltaTMax;
     double deltaTMin;
@@ -52,7 +63,6 @@ class StateExtendedInputPort :
     double prev;
     double timeout;
 
-    bool valid;
     int count;
 public:
 
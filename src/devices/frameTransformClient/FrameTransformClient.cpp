@@ -21,6 +21,7 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/math/Math.h>
+#include <algorithm>
 #include <mutex>
 
 /*! \file FrameTransformClient.cpp */
@@ -108,6 +109,7 @@ void Transforms_client_storage::onRead(yarp::os::Bottle &b)
                 m_transforms.push_back(t);
             }
         }
+        m_tree.update(m_transforms);
     }
     else
     {
@@ -159,6 +161,7 @@ void Transforms_client_storage::clear()
 {
     std::lock_guard<std::recursive_mutex> l(m_mutex);
     m_transforms.clear();
+    m_tree.clear();
 }
 
 Transforms_client_storage::Transforms_client_storage(std::string local_streaming_name)
@@ -482,62 +485,16 @@ bool FrameTransformClient::allFramesAsString(std::string &all_frames)
     return true;
 }
 
-FrameTransformClient::ConnectionType FrameTransformClient::getConnectionType(const std::string &target_frame, const std::string &source_frame, std::string* commonAncestor = nullptr)
-{
-    if (target_frame == source_frame) {return IDENTITY;}
-
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, j;
-    std::vector<std::string>   tar2root_vec;
-    std::vector<std::string>   src2root_vec;
-    std::string                ancestor, child;
-    child = target_frame;
-    std::lock_guard<std::recursive_mutex> l(tfVec.m_mutex);
-    while(getParent(child, ancestor))
-    {
-        if(ancestor == source_frame)
-        {
-            return DIRECT;
-        }
-
-        tar2root_vec.push_back(ancestor);
-        child = ancestor;
-    }
-    child = source_frame;
-    while(getParent(child, ancestor))
-    {
-        if(ancestor == target_frame)
-        {
-            return INVERSE;
-        }
-
-        src2root_vec.push_back(ancestor);
-        child = ancestor;
-    }
-
-    for(i = 0; i < tar2root_vec.size(); i++)
-    {
-        std::string a;
-        a = tar2root_vec[i];
-        for(j = 0; j < src2root_vec.size(); j++)
-        {
-            if(a == src2root_vec[j])
-            {
-                if(commonAncestor)
-                {
-                    *commonAncestor = a;
-                }
-                return UNDIRECT;
-            }
-        }
-    }
-
-    return DISCONNECTED;
-}
-
 bool FrameTransformClient::canTransform(const std::string &target_frame, const std::string &source_frame)
 {
-    return getConnectionType(target_frame, source_frame) != DISCONNECTED;
+    if (target_frame == source_frame) { return true; }
+
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    FrameTransformTree& tree = m_transform_storage->tree();
+    size_t target = tree.getFrame(target_frame);
+    size_t source = tree.getFrame(source_frame);
+    if (target == FrameTransformTree::npos || source == FrameTransformTree::npos) { return false; }
+    return tree.canTransform(target, source);
 }
 
 bool FrameTransformClient::clear()
@@ -567,134 +524,94 @@ bool FrameTransformClient::clear()
 
 bool FrameTransformClient::frameExists(const std::string &frame_id)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
-    {
-        if (((*m_transform_storage)[i].src_frame_id) == frame_id) { return true; }
-        if (((*m_transform_storage)[i].dst_frame_id) == frame_id) { return true; }
-    }
-    return false;
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    return m_transform_storage->tree().getFrame(frame_id) != FrameTransformTree::npos;
 }
 
 bool FrameTransformClient::getAllFrameIds(std::vector< std::string > &ids)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
-    {
-        bool found = false;
-        for (const auto& id : ids)
-        {
-            if (((*m_transform_storage)[i].src_frame_id) == id) { found = true; break; }
-        }
-        if (found == false) ids.push_back((*m_transform_storage)[i].src_frame_id);
-    }
-
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    FrameTransformTree& tree = m_transform_storage->tree();
+    // The frames of the tree are unique, check only the ids passed
+    auto given = static_cast<std::ptrdiff_t>(ids.size());
+    for (size_t frame : tree.getFrames())
     {
-        bool found = false;
-        for (const auto& id : ids)
-        {
-            if (((*m_transform_storage)[i].dst_frame_id) == id) { found = true; break; }
-        }
-        if (found == false) ids.push_back((*m_transform_storage)[i].dst_frame_id);
+        const std::string& id = tree.getName(frame);
+        if (std::find(ids.begin(), ids.begin() + given, id) == ids.begin() + given) ids.push_back(id);
     }
-
     return true;
 }
 
 bool FrameTransformClient::getParent(const std::string &frame_id, std::string &parent_frame_id)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
-    {
-        std::string par((*m_transform_storage)[i].dst_frame_id);
-        if (((*m_transform_storage)[i].dst_frame_id == frame_id))
-        {
-
-            parent_frame_id = (*m_transform_storage)[i].src_frame_id;
-            return true;
-        }
-    }
-    return false;
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    FrameTransformTree& tree = m_transform_storage->tree();
+    size_t frame = tree.getFrame(frame_id);
+    if (frame == FrameTransformTree::npos) { return false; }
+    size_t parent = tree.getParent(frame);
+    if (parent == FrameTransformTree::npos) { return false; }
+    parent_frame_id = tree.getName(parent);
+    return true;
 }
 
 bool FrameTransformClient::canExplicitTransform(const std::string& target_frame_id, const std::string& source_frame_id) const
 {
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, tfVec_size;
-    std::lock_guard<std::recursive_mutex>         l(tfVec.m_mutex);
-
-    tfVec_size = tfVec.size();
-    for (i = 0; i < tfVec_size; i++)
-    {
-        if (tfVec[i].dst_frame_id == target_frame_id && tfVec[i].src_frame_id == source_frame_id)
-        {
-            return true;
-        }
-    }
-    return false;
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    FrameTransformTree& tree = m_transform_storage->tree();
+    size_t target = tree.getFrame(target_frame_id);
+    size_t source = tree.getFrame(source_frame_id);
+    if (target == FrameTransformTree::npos || source == FrameTransformTree::npos) { return false; }
+    return tree.hasTransform(target, source);
 }
 
-bool FrameTransformClient::getChainedTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform) const
+bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform)
 {
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, tfVec_size;
-    std::lock_guard<std::recursive_mutex>         l(tfVec.m_mutex);
+    if (target_frame_id == source_frame_id)
+    {
+        yarp::sig::Matrix tmp(4, 4); tmp.eye();
+        transform = tmp;
+        return true;
+    }
 
-    tfVec_size = tfVec.size();
-    for (i = 0; i < tfVec_size; i++)
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    FrameTransformTree& tree = m_transform_storage->tree();
+    size_t target = tree.getFrame(target_frame_id);
+    size_t source = tree.getFrame(source_frame_id);
+    FixedMatrix4x4 m;
+    if (target == FrameTransformTree::npos || source == FrameTransformTree::npos || !tree.getTransform(target, source, m))
     {
-        if (tfVec[i].dst_frame_id == target_frame_id)
-        {
-            if (tfVec[i].src_frame_id == source_frame_id)
-            {
-                transform = tfVec[i].toMatrix();
-                return true;
-            }
-            else
-            {
-                yarp::sig::Matrix m;
-                if (getChainedTransform(tfVec[i].src_frame_id, source_frame_id, m))
-                {
-                    transform = m * tfVec[i].toMatrix();
-                    return true;
-                }
-            }
-        }
+        yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
+        return false;
     }
-    return false;
+    m.toMatrix(transform);
+    return true;
 }
 
-bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform)
+bool FrameTransformClient::getAllTransforms(const std::string& source_frame_id, std::vector<std::string>& frame_ids, std::vector<yarp::sig::Matrix>& transforms)
 {
-    ConnectionType ct;
-    std::string    ancestor;
-    ct = getConnectionType(target_frame_id, source_frame_id, &ancestor);
-    if (ct == DIRECT)
-    {
-        return getChainedTransform(target_frame_id, source_frame_id, transform);
-    }
-    else if (ct == INVERSE)
-    {
-        yarp::sig::Matrix m(4, 4);
-        getChainedTransform(source_frame_id, target_frame_id, m);
-        transform = yarp::math::SE3inv(m);
-        return true;
-    }
-    else if(ct == UNDIRECT)
+    frame_ids.clear();
+    transforms.clear();
+
+    std::lock_guard<std::recursive_mutex> l(m_transform_storage->m_mutex);
+    FrameTransformTree& tree = m_transform_storage->tree();
+    size_t source = tree.getFrame(source_frame_id);
+    if (source == FrameTransformTree::npos)
     {
-        yarp::sig::Matrix root2tar(4, 4), root2src(4, 4);
-        getChainedTransform(source_frame_id, ancestor, root2src);
-        getChainedTransform(target_frame_id, ancestor, root2tar);
-        transform = yarp::math::SE3inv(root2src) * root2tar;
-        return true;
+        yCError(FRAMETRANSFORMCLIENT) << "getAllTransforms(): Frame " << source_frame_id << " does not exist";
+        return false;
     }
-    else if (ct == IDENTITY)
+
+    // The transform of the source from its root is composed only once
+    FixedMatrix4x4 m;
+    for (size_t frame : tree.getFrames())
     {
-        yarp::sig::Matrix tmp(4, 4); tmp.eye();
-        transform = tmp;
-        return true;
+        if (frame != source && tree.getTransform(frame, source, m))
+        {
+            frame_ids.push_back(tree.getName(frame));
+            transforms.push_back(m.toMatrix());
+        }
     }
-
-    yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
-    return false;
+    return true;
 }
 
 bool FrameTransformClient::setTransform(const std::string& target_frame_id, const std::string& source_frame_id, const yarp::sig::Matrix& transform)
@@ -35,6 +35,8 @@
 #include <yarp/os/PeriodicThread.h>
 #include <mutex>
 
+#include "FrameTransformTree.h"
+
 
 #define DEFAULT_THREAD_PERIOD 20 //ms
 const int TRANSFORM_TIMEOUT_MS = 100; //ms
@@ -56,11 +58,14 @@ private:
     int              m_count;
 
     std::vector <yarp::math::FrameTransform> m_transforms;
+    FrameTransformTree                       m_tree;
 
 public:
     std::recursive_mutex  m_mutex;
     size_t   size();
     yarp::math::FrameTransform& operator[]   (std::size_t idx);
+    // The index of the transforms, to be used holding m_mutex
+    FrameTransformTree& tree() { return m_tree; }
     void clear();
 
 public:
@@ -91,12 +96,7 @@ class FrameTransformClient :
         public yarp::os::PeriodicThread
 {
 private:
-    enum ConnectionType {DISCONNECTED = 0, DIRECT, INVERSE, UNDIRECT, IDENTITY};
-
-    FrameTransformClient::ConnectionType getConnectionType(const std::string &target_frame, const std::string &source_frame, std::string* commonAncestor);
-
     bool canExplicitTransform(const std::string& target_frame_id, const std::string& source_frame_id) const;
-    bool getChainedTransform(const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) const;
 
 protected:
 
@@ -145,6 +145,7 @@ public:
      bool     getAllFrameIds(std::vector< std::string > &ids) override;
      bool     getParent(const std::string &frame_id, std::string &parent_frame_id) override;
      bool     getTransform(const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) override;
+     bool     getAllTransforms(const std::string &source_frame_id, std::vector<std::string> &frame_ids, std::vector<yarp::sig::Matrix> &transforms) override;
      bool     setTransform(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Matrix &transform) override;
      bool     setTransformStatic(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Matrix &transform) override;
      bool     deleteTransform(const std::string &target_frame_id, const std::string &source_frame_id) override;
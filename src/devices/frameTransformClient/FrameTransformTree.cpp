@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "FrameTransformTree.h"
+
+#include <algorithm>
+
+using yarp::math::FixedMatrix4x4;
+using yarp::math::FrameTransform;
+
+constexpr size_t FrameTransformTree::npos;
+
+void FrameTransformTree::update(const std::vector<FrameTransform>& transforms)
+{
+    std::vector<size_t> oldParents(m_frames.size());
+    for (size_t i = 0; i < m_frames.size(); i++) {
+        oldParents[i] = getParent(i);
+        m_frames[i].exists = false;
+        m_frames[i].parents.clear();
+        m_frames[i].children.clear();
+    }
+
+    // Same order of the frames as the list of transforms: sources first
+    m_existing.clear();
+    auto use = [this](const std::string& frame_id) {
+        size_t frame = addFrame(frame_id);
+        if (!m_frames[frame].exists) {
+            m_frames[frame].exists = true;
+            m_existing.push_back(frame);
+        }
+    };
+    for (const auto& t : transforms) {
+        use(t.src_frame_id);
+    }
+    for (const auto& t : transforms) {
+        use(t.dst_frame_id);
+    }
+
+    std::vector<bool> changed(m_frames.size(), false);
+    FixedMatrix4x4 m;
+    for (const auto& t : transforms) {
+        size_t source = getFrame(t.src_frame_id);
+        size_t target = getFrame(t.dst_frame_id);
+        Frame& frame = m_frames[target];
+        frame.parents.push_back(source);
+        if (frame.parents.size() > 1) {
+            continue;
+        }
+        m_frames[source].children.push_back(target);
+
+        t.toMatrix(m);
+        size_t oldParent = target < oldParents.size() ? oldParents[target] : npos;
+        if (source != oldParent || !std::equal(m.data(), m.data() + m.rows() * m.cols(), frame.fromParent.data())) {
+            frame.fromParent = m;
+            changed[target] = true;
+        }
+    }
+
+    for (size_t i = 0; i < m_frames.size(); i++) {
+        Frame& frame = m_frames[i];
+        if (!frame.exists) {
+            frame.composed = false;
+        } else if (frame.parents.empty() && i < oldParents.size() && oldParents[i] != npos) {
+            // The frame is a new root
+            changed[i] = true;
+        }
+    }
+
+    for (size_t i = 0; i < m_frames.size(); i++) {
+        if (changed[i]) {
+            invalidate(i);
+        }
+    }
+}
+
+void FrameTransformTree::clear()
+{
+    m_frames.clear();
+    m_ids.clear();
+    m_existing.clear();
+}
+
+size_t FrameTransformTree::getFrame(const std::string& frame_id) const
+{
+    auto it = m_ids.find(frame_id);
+    if (it == m_ids.end() || !m_frames[it->second].exists) {
+        return npos;
+    }
+    return it->second;
+}
+
+size_t FrameTransformTree::getParent(size_t frame) const
+{
+    const auto& parents = m_frames[frame].parents;
+    return parents.empty() ? npos : parents.front();
+}
+
+bool FrameTransformTree::hasTransform(size_t target, size_t source) const
+{
+    const auto& parents = m_frames[target].parents;
+    return std::find(parents.begin(), parents.end(), source) != parents.end();
+}
+
+bool FrameTransformTree::canTransform(size_t target, size_t source)
+{
+    if (target == source) {
+        return true;
+    }
+    compose(target);
+    compose(source);
+    const Frame& t = m_frames[target];
+    const Frame& s = m_frames[source];
+    return t.composed && s.composed && t.root == s.root;
+}
+
+bool FrameTransformTree::getTransform(size_t target, size_t source, FixedMatrix4x4& transform)
+{
+    if (target == source) {
+        transform = FixedMatrix4x4::identity();
+        return true;
+    }
+    if (!canTransform(target, source)) {
+        return false;
+    }
+    transform = yarp::math::SE3inv(m_frames[source].fromRoot) * m_frames[target].fromRoot;
+    return true;
+}
+
+size_t FrameTransformTree::addFrame(const std::string& frame_id)
+{
+    auto it = m_ids.find(frame_id);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+    size_t frame = m_frames.size();
+    m_frames.emplace_back();
+    m_frames.back().name = frame_id;
+    m_ids.emplace(frame_id, frame);
+    return frame;
+}
+
+void FrameTransformTree::invalidate(size_t frame)
+{
+    // The descendants of a frame not composed are not composed either
+    std::vector<size_t> pending {frame};
+    while (!pending.empty()) {
+        Frame& f = m_frames[pending.back()];
+        pending.pop_back();
+        if (f.composed) {
+            f.composed = false;
+            pending.insert(pending.end(), f.children.begin(), f.children.end());
+        }
+    }
+}
+
+void FrameTransformTree::compose(size_t frame)
+{
+    // Find the closest ancestor already composed, or the root
+    std::vector<size_t> chain;
+    while (!m_frames[frame].composed) {
+        size_t parent = getParent(frame);
+        if (parent == npos) {
+            m_frames[frame].composed = true;
+            m_frames[frame].root = frame;
+            m_frames[frame].fromRoot = FixedMatrix4x4::identity();
+            break;
+        }
+        chain.push_back(frame);
+        if (chain.size() > m_frames.size()) {
+            // The parents form a loop, there is no root
+            return;
+        }
+        frame = parent;
+    }
+
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        Frame& f = m_frames[*it];
+        const Frame& parent = m_frames[f.parents.front()];
+        f.root = parent.root;
+        f.fromRoot = parent.fromRoot * f.fromParent;
+        f.composed = true;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_FRAMETRANSFORMCLIENT_FRAMETRANSFORMTREE_H
+#define YARP_DEV_FRAMETRANSFORMCLIENT_FRAMETRANSFORMTREE_H
+
+#include <yarp/math/FixedMatrix.h>
+#include <yarp/math/FrameTransform.h>
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Index of the transforms received by the transformClient.
+ *
+ * The frames are identified by an index, and each frame points to its parent,
+ * i.e. to the source of the first transform received having the frame as
+ * target. Each frame caches the transform from the root of its tree, composed
+ * along the chain of its parents when it is first needed, so that the
+ * transform between two frames is obtained from the cache with a single
+ * product.
+ *
+ * The cache of a frame is invalidated only when a transform along its chain
+ * is changed, added or removed, so the chains of static transforms are
+ * composed once, while the server sends the same transforms over and over.
+ *
+ * Not thread safe, the transformClient serializes the accesses.
+ */
+class FrameTransformTree
+{
+public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /*
+     * Replace the transforms with the ones received, keeping the cache of the
+     * frames whose chain did not change.
+     */
+    void update(const std::vector<yarp::math::FrameTransform>& transforms);
+
+    void clear();
+
+    // @return the index of the frame, or npos if it does not exist
+    size_t getFrame(const std::string& frame_id) const;
+
+    const std::string& getName(size_t frame) const { return m_frames[frame].name; }
+
+    // @return the parent of the frame, or npos if the frame is a root
+    size_t getParent(size_t frame) const;
+
+    // @return the existing frames, sources first, in the order received
+    const std::vector<size_t>& getFrames() const { return m_existing; }
+
+    // @return true if a transform from source to target was received
+    bool hasTransform(size_t target, size_t source) const;
+
+    // @return true if the two frames belong to the same tree
+    bool canTransform(size_t target, size_t source);
+
+    /*
+     * Get the transform from source to target.
+     * @return false if the frames are not connected
+     */
+    bool getTransform(size_t target, size_t source, yarp::math::FixedMatrix4x4& transform);
+
+private:
+    struct Frame
+    {
+        std::string name;
+        bool exists {false};
+        // the sources of the transforms to this frame, the first one is the parent
+        std::vector<size_t> parents;
+        std::vector<size_t> children;
+        yarp::math::FixedMatrix4x4 fromParent;
+
+        bool composed {false};
+        size_t root {npos};
+        yarp::math::FixedMatrix4x4 fromRoot;
+    };
+
+    size_t addFrame(const std::string& frame_id);
+    void invalidate(size_t frame);
+    void compose(size_t frame);
+
+    std::vector<Frame> m_frames;
+    std::unordered_map<std::string, size_t> m_ids;
+    std::vector<size_t> m_existing;
+};
+
+#endif // YARP_DEV_FRAMETRANSFORMCLIENT_FRAMETRANSFORMTREE_H
@@ -21,6 +21,7 @@
 
 #include <yarp/dev/IEncoders.h>
 #include <yarp/dev/IEncodersTimed.h>
+#include <yarp/dev/IFullJointState.h>
 #include <yarp/dev/ITorqueControl.h>
 #include <yarp/dev/IControlMode2.h>
 #include <yarp/dev/IImpedanceControl.h>
@@ -39,4 +39,7 @@ constexpr yarp::conf::vocab32_t VOCAB_VELOCITY_MOVES = yarp::os::createVocab('v'
 // protocol version
 constexpr yarp::conf::vocab32_t VOCAB_PROTOCOL_VERSION = yarp::os::createVocab('p', 'r', 'o', 't');
 
+// profile of the data streamed on the stateExt:o port
+constexpr yarp::conf::vocab32_t VOCAB_STATE_EXT_PROFILE = yarp::os::createVocab('s', 'e', 'x', 'p');
+
 #endif // YARP_DEV_CONTROLBOARDVOCABS_H
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/FullJointStateReader.h>
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IAmplifierControl.h>
+#include <yarp/dev/IControlMode.h>
+#include <yarp/dev/ICurrentControl.h>
+#include <yarp/dev/IEncodersTimed.h>
+#include <yarp/dev/IInteractionMode.h>
+#include <yarp/dev/IMotorEncoders.h>
+#include <yarp/dev/IPWMControl.h>
+#include <yarp/dev/ITorqueControl.h>
+
+using yarp::dev::FullJointState;
+using yarp::dev::FullJointStateReader;
+
+void FullJointStateReader::attach(yarp::dev::DeviceDriver* device)
+{
+    detach();
+    if (device == nullptr) {
+        return;
+    }
+    device->view(iFullState);
+    device->view(iJntEnc);
+    device->view(iMotEnc);
+    device->view(iTorque);
+    device->view(iPWM);
+    device->view(iCurr);
+    device->view(amp);
+    device->view(iMode);
+    device->view(iInteract);
+}
+
+void FullJointStateReader::detach()
+{
+    iFullState = nullptr;
+    iJntEnc = nullptr;
+    iMotEnc = nullptr;
+    iTorque = nullptr;
+    iPWM = nullptr;
+    iCurr = nullptr;
+    amp = nullptr;
+    iMode = nullptr;
+    iInteract = nullptr;
+}
+
+bool FullJointStateReader::getFullJointState(FullJointState& state)
+{
+    if (iFullState) {
+        return iFullState->getFullJointState(state);
+    }
+
+    // One call for each array requested, through the other interfaces
+    auto read = [](bool requested, bool available, bool& valid, bool& ret, auto call) {
+        valid = requested && available && call();
+        ret = ret && (!requested || valid);
+    };
+
+    bool ret = true;
+    read(state.jointPosition, iJntEnc, state.jointPosition_isValid, ret, [&]() { return state.jointTimestamp ? iJntEnc->getEncodersTimed(state.jointPosition, state.jointTimestamp) : iJntEnc->getEncoders(state.jointPosition); });
+    read(state.jointVelocity, iJntEnc, state.jointVelocity_isValid, ret, [&]() { return iJntEnc->getEncoderSpeeds(state.jointVelocity); });
+    read(state.jointAcceleration, iJntEnc, state.jointAcceleration_isValid, ret, [&]() { return iJntEnc->getEncoderAccelerations(state.jointAcceleration); });
+    read(state.motorPosition, iMotEnc, state.motorPosition_isValid, ret, [&]() { return iMotEnc->getMotorEncoders(state.motorPosition); });
+    read(state.motorVelocity, iMotEnc, state.motorVelocity_isValid, ret, [&]() { return iMotEnc->getMotorEncoderSpeeds(state.motorVelocity); });
+    read(state.motorAcceleration, iMotEnc, state.motorAcceleration_isValid, ret, [&]() { return iMotEnc->getMotorEncoderAccelerations(state.motorAcceleration); });
+    read(state.torque, iTorque, state.torque_isValid, ret, [&]() { return iTorque->getTorques(state.torque); });
+    read(state.pwmDutycycle, iPWM, state.pwmDutycycle_isValid, ret, [&]() { return iPWM->getDutyCycles(state.pwmDutycycle); });
+    read(state.current, iCurr || amp, state.current_isValid, ret, [&]() { return iCurr ? iCurr->getCurrents(state.current) : amp->getCurrents(state.current); });
+    read(state.controlMode, iMode, state.controlMode_isValid, ret, [&]() { return iMode->getControlModes(state.controlMode); });
+    read(state.interactionMode, iInteract, state.interactionMode_isValid, ret, [&]() { return iInteract->getInteractionModes(reinterpret_cast<yarp::dev::InteractionModeEnum*>(state.interactionMode)); });
+    return ret;
+}
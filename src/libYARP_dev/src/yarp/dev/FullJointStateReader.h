@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_FULLJOINTSTATEREADER_H
+#define YARP_DEV_FULLJOINTSTATEREADER_H
+
+#include <yarp/dev/IFullJointState.h>
+#include <yarp/dev/api.h>
+
+namespace yarp {
+namespace dev {
+
+class DeviceDriver;
+class IAmplifierControl;
+class ICurrentControl;
+class IControlMode;
+class IEncodersTimed;
+class IInteractionMode;
+class IMotorEncoders;
+class IPWMControl;
+class ITorqueControl;
+
+/**
+ * \ingroup dev_class
+ *
+ * Read the whole state of the axes of a control board.
+ *
+ * The state is read with a single IFullJointState::getFullJointState() call
+ * if the device implements IFullJointState, otherwise with one call for each
+ * quantity to the other interfaces of the device (IEncodersTimed,
+ * IMotorEncoders, ITorqueControl, IPWMControl, ICurrentControl or
+ * IAmplifierControl, IControlMode, IInteractionMode).  The interfaces are
+ * looked up once, when the device is attached.
+ */
+class YARP_dev_API FullJointStateReader
+{
+public:
+    FullJointStateReader() = default;
+
+    /**
+     * Attach the device whose state is read.
+     * \param device the device, nullptr to detach the device
+     */
+    void attach(yarp::dev::DeviceDriver* device);
+
+    /**
+     * Detach the device.
+     */
+    void detach();
+
+    /**
+     * \return true iff the device implements IFullJointState.
+     */
+    bool isBulk() const
+    {
+        return iFullState != nullptr;
+    }
+
+    /**
+     * Read the state of all the axes of the device.
+     * \see IFullJointState::getFullJointState()
+     * \return true iff all the arrays requested were read correctly
+     */
+    bool getFullJointState(FullJointState& state);
+
+private:
+    yarp::dev::IFullJointState* iFullState {nullptr};
+    yarp::dev::IEncodersTimed* iJntEnc {nullptr};
+    yarp::dev::IMotorEncoders* iMotEnc {nullptr};
+    yarp::dev::ITorqueControl* iTorque {nullptr};
+    yarp::dev::IPWMControl* iPWM {nullptr};
+    yarp::dev::ICurrentControl* iCurr {nullptr};
+    yarp::dev::IAmplifierControl* amp {nullptr};
+    yarp::dev::IControlMode* iMode {nullptr};
+    yarp::dev::IInteractionMode* iInteract {nullptr};
+};
+
+} // namespace dev
+} // namespace yarp
+
+#endif // YARP_DEV_FULLJOINTSTATEREADER_H
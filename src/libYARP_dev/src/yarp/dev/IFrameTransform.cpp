@@ -9,3 +9,25 @@
 #include <yarp/dev/IFrameTransform.h>
 
 yarp::dev::IFrameTransform::~IFrameTransform() = default;
+
+bool yarp::dev::IFrameTransform::getAllTransforms(const std::string& source_frame_id, std::vector<std::string>& frame_ids, std::vector<yarp::sig::Matrix>& transforms)
+{
+    frame_ids.clear();
+    transforms.clear();
+    if (!frameExists(source_frame_id)) {
+        return false;
+    }
+
+    std::vector<std::string> ids;
+    if (!getAllFrameIds(ids)) {
+        return false;
+    }
+    yarp::sig::Matrix transform;
+    for (const auto& id : ids) {
+        if (id != source_frame_id && canTransform(id, source_frame_id) && getTransform(id, source_frame_id, transform)) {
+            frame_ids.push_back(id);
+            transforms.push_back(transform);
+        }
+    }
+    return true;
+}
@@ -97,6 +97,16 @@ public:
     */
     virtual bool     getTransform (const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) = 0;
 
+    /**
+     Get the transforms from a frame to all the frames connected to it.
+     The default implementation calls getTransform() for each frame.
+    * @param source_frame_id the name of source reference frame
+    * @param frame_ids the returned names of the frames connected to source_frame_id
+    * @param transforms the returned transformation matrices from source_frame_id to each frame in frame_ids
+    * @return true/false
+    */
+    virtual bool     getAllTransforms (const std::string &source_frame_id, std::vector<std::string> &frame_ids, std::vector<yarp::sig::Matrix> &transforms);
+
     /**
      Register a transform between two frames.
      * @param target_frame_id the name of target reference frame
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_IFULLJOINTSTATE_H
+#define YARP_DEV_IFULLJOINTSTATE_H
+
+#include <yarp/dev/api.h>
+
+namespace yarp {
+namespace dev {
+
+/**
+ * \ingroup dev_iface_motor
+ *
+ * The arrays filled by IFullJointState::getFullJointState(), each one of
+ * getAxes() elements, owned by the caller.
+ *
+ * The arrays that are nullptr are not read.  After the call, the _isValid
+ * flags tell which arrays were read correctly.
+ */
+struct FullJointState
+{
+    double* jointPosition {nullptr};
+    double* jointTimestamp {nullptr}; ///< timestamps of jointPosition
+    double* jointVelocity {nullptr};
+    double* jointAcceleration {nullptr};
+    double* motorPosition {nullptr};
+    double* motorVelocity {nullptr};
+    double* motorAcceleration {nullptr};
+    double* torque {nullptr};
+    double* pwmDutycycle {nullptr};
+    double* current {nullptr};
+    int* controlMode {nullptr};
+    int* interactionMode {nullptr}; ///< values of yarp::dev::InteractionModeEnum
+
+    bool jointPosition_isValid {false}; ///< jointPosition and jointTimestamp
+    bool jointVelocity_isValid {false};
+    bool jointAcceleration_isValid {false};
+    bool motorPosition_isValid {false};
+    bool motorVelocity_isValid {false};
+    bool motorAcceleration_isValid {false};
+    bool torque_isValid {false};
+    bool pwmDutycycle_isValid {false};
+    bool current_isValid {false};
+    bool controlMode_isValid {false};
+    bool interactionMode_isValid {false};
+};
+
+/**
+ * \ingroup dev_iface_motor
+ *
+ * \brief Control board, read the whole state of all the axes in a single
+ * call.
+ *
+ * A device implements this interface when it can read all its state at once
+ * (e.g. from the last message received from the hardware, under a single
+ * lock), instead of one call for each quantity (getEncodersTimed(),
+ * getEncoderSpeeds(), getTorques(), getControlModes(), ...).  The
+ * ControlBoardWrapper and the ControlBoardRemapper use it when all their
+ * subdevices implement it.
+ *
+ * \see FullJointStateReader, to read the state also from the devices that do
+ * not implement this interface.
+ */
+class YARP_dev_API IFullJointState
+{
+public:
+    virtual ~IFullJointState();
+
+    /**
+     * Read the state of all the axes.
+     * \param state the arrays to fill, the arrays that are nullptr are not
+     *        read, the _isValid flags are set for all the arrays
+     * \return true iff all the arrays requested were read correctly
+     */
+    virtual bool getFullJointState(FullJointState& state) = 0;
+};
+
+} // namespace dev
+} // namespace yarp
+
+#endif // YARP_DEV_IFULLJOINTSTATE_H
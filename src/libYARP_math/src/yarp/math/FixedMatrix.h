@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_MATH_FIXEDMATRIX_H
+#define YARP_MATH_FIXEDMATRIX_H
+
+#include <yarp/os/Log.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+
+namespace yarp {
+namespace math {
+
+/**
+ * Vector of N elements, stored in the object itself.
+ *
+ * Unlike yarp::sig::Vector, the fixed size vectors never allocate memory, and
+ * the operations on them are inlined and unrolled by the compiler.  They are
+ * meant for the small vectors (positions, twists, ...) computed in the
+ * control loops.  The elements are initialized to zero.
+ */
+template <size_t N>
+class FixedVector
+{
+public:
+    /**
+     * Default constructor, all the elements are zero.
+     */
+    FixedVector() = default;
+
+    /**
+     * Build a vector from a list of elements (at most N), the missing
+     * elements are zero.
+     */
+    FixedVector(std::initializer_list<double> values)
+    {
+        yAssert(values.size() <= N);
+        size_t i = 0;
+        for (double value : values) {
+            m_data[i++] = value;
+        }
+    }
+
+    /**
+     * Build a vector from a yarp::sig::Vector of N elements.
+     */
+    explicit FixedVector(const yarp::sig::Vector& v)
+    {
+        yAssert(v.size() == N);
+        for (size_t i = 0; i < N; i++) {
+            m_data[i] = v[i];
+        }
+    }
+
+    static constexpr size_t size() { return N; }
+
+    double* data() { return m_data; }
+    const double* data() const { return m_data; }
+
+    double& operator[](size_t i) { return m_data[i]; }
+    const double& operator[](size_t i) const { return m_data[i]; }
+    double& operator()(size_t i) { return m_data[i]; }
+    const double& operator()(size_t i) const { return m_data[i]; }
+
+    /**
+     * Set all the elements to zero.
+     */
+    void zero()
+    {
+        for (size_t i = 0; i < N; i++) {
+            m_data[i] = 0.0;
+        }
+    }
+
+    /**
+     * Copy the vector in a yarp::sig::Vector, resized only if its size is
+     * not N.
+     */
+    void toVector(yarp::sig::Vector& v) const
+    {
+        if (v.size() != N) {
+            v.resize(N);
+        }
+        for (size_t i = 0; i < N; i++) {
+            v[i] = m_data[i];
+        }
+    }
+
+    /**
+     * @return a yarp::sig::Vector with the elements of the vector.
+     */
+    yarp::sig::Vector toVector() const
+    {
+        yarp::sig::Vector v(N);
+        toVector(v);
+        return v;
+    }
+
+    FixedVector& operator+=(const FixedVector& b)
+    {
+        for (size_t i = 0; i < N; i++) {
+            m_data[i] += b.m_data[i];
+        }
+        return *this;
+    }
+
+    FixedVector& operator-=(const FixedVector& b)
+    {
+        for (size_t i = 0; i < N; i++) {
+            m_data[i] -= b.m_data[i];
+        }
+        return *this;
+    }
+
+    FixedVector& operator*=(double k)
+    {
+        for (size_t i = 0; i < N; i++) {
+            m_data[i] *= k;
+        }
+        return *this;
+    }
+
+    FixedVector& operator/=(double k)
+    {
+        for (size_t i = 0; i < N; i++) {
+            m_data[i] /= k;
+        }
+        return *this;
+    }
+
+    // The operators are found only through argument dependent lookup, not to
+    // hide the operators of yarp::sig::Vector defined in the global namespace.
+    friend FixedVector operator+(FixedVector a, const FixedVector& b) { return a += b; }
+    friend FixedVector operator-(FixedVector a, const FixedVector& b) { return a -= b; }
+    friend FixedVector operator-(FixedVector a) { return a *= -1.0; }
+    friend FixedVector operator*(FixedVector a, double k) { return a *= k; }
+    friend FixedVector operator*(double k, FixedVector a) { return a *= k; }
+    friend FixedVector operator/(FixedVector a, double k) { return a /= k; }
+
+private:
+    double m_data[N] {};
+};
+
+
+/**
+ * Matrix of R rows and C columns, stored in the object itself, by rows as
+ * yarp::sig::Matrix.
+ *
+ * See FixedVector.  The elements are initialized to zero.
+ */
+template <size_t R, size_t C>
+class FixedMatrix
+{
+public:
+    /**
+     * Default constructor, all the elements are zero.
+     */
+    FixedMatrix() = default;
+
+    /**
+     * Build a matrix from a list of elements (at most R*C), by rows, the
+     * missing elements are zero.
+     */
+    FixedMatrix(std::initializer_list<double> values)
+    {
+        yAssert(values.size() <= R * C);
+        size_t i = 0;
+        for (double value : values) {
+            m_data[i++] = value;
+        }
+    }
+
+    /**
+     * Build a matrix from a yarp::sig::Matrix of R rows and C columns.
+     */
+    explicit FixedMatrix(const yarp::sig::Matrix& m)
+    {
+        yAssert(m.rows() == R && m.cols() == C);
+        const double* src = m.data();
+        for (size_t i = 0; i < R * C; i++) {
+            m_data[i] = src[i];
+        }
+    }
+
+    /**
+     * @return the identity matrix.
+     */
+    static FixedMatrix identity()
+    {
+        FixedMatrix m;
+        for (size_t i = 0; i < R && i < C; i++) {
+            m(i, i) = 1.0;
+        }
+        return m;
+    }
+
+    static constexpr size_t rows() { return R; }
+    static constexpr size_t cols() { return C; }
+
+    double* data() { return m_data; }
+    const double* data() const { return m_data; }
+
+    double& operator()(size_t r, size_t c) { return m_data[r * C + c]; }
+    const double& operator()(size_t r, size_t c) const { return m_data[r * C + c]; }
+
+    /**
+     * Set all the elements to zero.
+     */
+    void zero()
+    {
+        for (size_t i = 0; i < R * C; i++) {
+            m_data[i] = 0.0;
+        }
+    }
+
+    /**
+     * Copy the matrix in a yarp::sig::Matrix, resized only if its size is
+     * not RxC.
+     */
+    void toMatrix(yarp::sig::Matrix& m) const
+    {
+        if (m.rows() != R || m.cols() != C) {
+            m.resize(R, C);
+        }
+        double* dest = m.data();
+        for (size_t i = 0; i < R * C; i++) {
+            dest[i] = m_data[i];
+        }
+    }
+
+    /**
+     * @return a yarp::sig::Matrix with the elements of the matrix.
+     */
+    yarp::sig::Matrix toMatrix() const
+    {
+        yarp::sig::Matrix m(R, C);
+        toMatrix(m);
+        return m;
+    }
+
+    /**
+     * @return the transposed matrix.
+     */
+    FixedMatrix<C, R> transposed() const
+    {
+        FixedMatrix<C, R> t;
+        for (size_t r = 0; r < R; r++) {
+            for (size_t c = 0; c < C; c++) {
+                t(c, r) = (*this)(r, c);
+            }
+        }
+        return t;
+    }
+
+    FixedMatrix& operator+=(const FixedMatrix& b)
+    {
+        for (size_t i = 0; i < R * C; i++) {
+            m_data[i] += b.m_data[i];
+        }
+        return *this;
+    }
+
+    FixedMatrix& operator-=(const FixedMatrix& b)
+    {
+        for (size_t i = 0; i < R * C; i++) {
+            m_data[i] -= b.m_data[i];
+        }
+        return *this;
+    }
+
+    FixedMatrix& operator*=(double k)
+    {
+        for (size_t i = 0; i < R * C; i++) {
+            m_data[i] *= k;
+        }
+        return *this;
+    }
+
+    FixedMatrix& operator/=(double k)
+    {
+        for (size_t i = 0; i < R * C; i++) {
+            m_data[i] /= k;
+        }
+        return *this;
+    }
+
+    // See FixedVector about the friend operators.
+    friend FixedMatrix operator+(FixedMatrix a, const FixedMatrix& b) { return a += b; }
+    friend FixedMatrix operator-(FixedMatrix a, const FixedMatrix& b) { return a -= b; }
+    friend FixedMatrix operator*(FixedMatrix a, double k) { return a *= k; }
+    friend FixedMatrix operator*(double k, FixedMatrix a) { return a *= k; }
+    friend FixedMatrix operator/(FixedMatrix a, double k) { return a /= k; }
+
+    /**
+     * Product of two matrices.
+     */
+    template <size_t C2>
+    friend FixedMatrix<R, C2> operator*(const FixedMatrix& a, const FixedMatrix<C, C2>& b)
+    {
+        FixedMatrix<R, C2> res;
+        for (size_t r = 0; r < R; r++) {
+            for (size_t k = 0; k < C; k++) {
+                const double ark = a(r, k);
+                for (size_t c = 0; c < C2; c++) {
+                    res(r, c) += ark * b(k, c);
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Product of the matrix and a column vector.
+     */
+    friend FixedVector<R> operator*(const FixedMatrix& m, const FixedVector<C>& v)
+    {
+        FixedVector<R> res;
+        for (size_t r = 0; r < R; r++) {
+            double sum = 0.0;
+            for (size_t c = 0; c < C; c++) {
+                sum += m(r, c) * v[c];
+            }
+            res[r] = sum;
+        }
+        return res;
+    }
+
+private:
+    double m_data[R * C] {};
+};
+
+
+using FixedVector3 = FixedVector<3>;
+using FixedVector4 = FixedVector<4>;
+using FixedVector6 = FixedVector<6>;
+using FixedMatrix3x3 = FixedMatrix<3, 3>;
+using FixedMatrix4x4 = FixedMatrix<4, 4>;
+using FixedMatrix6x6 = FixedMatrix<6, 6>;
+
+
+/**
+ * Scalar product of two vectors.
+ */
+template <size_t N>
+inline double dot(const FixedVector<N>& a, const FixedVector<N>& b)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < N; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/**
+ * Squared Euclidean norm of a vector.
+ */
+template <size_t N>
+inline double norm2(const FixedVector<N>& v)
+{
+    return dot(v, v);
+}
+
+/**
+ * Euclidean norm of a vector.
+ */
+template <size_t N>
+inline double norm(const FixedVector<N>& v)
+{
+    return std::sqrt(dot(v, v));
+}
+
+/**
+ * Cross product of two 3D vectors.
+ */
+inline FixedVector3 cross(const FixedVector3& a, const FixedVector3& b)
+{
+    return {a[1] * b[2] - a[2] * b[1],
+            a[2] * b[0] - a[0] * b[2],
+            a[0] * b[1] - a[1] * b[0]};
+}
+
+/**
+ * Inverse of a 4x4 homogeneous transformation, the rotation is transposed.
+ */
+inline FixedMatrix4x4 SE3inv(const FixedMatrix4x4& H)
+{
+    FixedMatrix4x4 inv;
+    for (size_t r = 0; r < 3; r++) {
+        for (size_t c = 0; c < 3; c++) {
+            inv(r, c) = H(c, r);
+        }
+        inv(r, 3) = -(H(0, r) * H(0, 3) + H(1, r) * H(1, 3) + H(2, r) * H(2, 3));
+    }
+    inv(3, 3) = 1.0;
+    return inv;
+}
+
+} // namespace math
+} // namespace yarp
+
+#endif // YARP_MATH_FIXEDMATRIX_H
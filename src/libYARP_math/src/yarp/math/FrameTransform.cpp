@@ -99,6 +99,22 @@ bool yarp::math::FrameTransform::fromMatrix(const yarp::sig::Matrix& mat)
     return true;
 }
 
+void yarp::math::FrameTransform::toMatrix(yarp::math::FixedMatrix4x4& mat) const
+{
+    rotation.toRotationMatrix4x4(mat);
+    mat(0, 3) = translation.tX;
+    mat(1, 3) = translation.tY;
+    mat(2, 3) = translation.tZ;
+}
+
+void yarp::math::FrameTransform::fromMatrix(const yarp::math::FixedMatrix4x4& mat)
+{
+    translation.tX = mat(0, 3);
+    translation.tY = mat(1, 3);
+    translation.tZ = mat(2, 3);
+    rotation.fromRotationMatrix(mat);
+}
+
 
 
 std::string yarp::math::FrameTransform::toString(display_transform_mode_t format) const
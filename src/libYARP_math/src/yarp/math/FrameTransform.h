@@ -12,6 +12,7 @@
 #include <yarp/sig/Vector.h>
 #include <yarp/sig/Matrix.h>
 #include <yarp/math/api.h>
+#include <yarp/math/FixedMatrix.h>
 #include <yarp/math/Quaternion.h>
 
 namespace yarp {
@@ -61,6 +62,16 @@ public:
     yarp::sig::Matrix toMatrix() const;
     bool fromMatrix(const yarp::sig::Matrix& mat);
 
+    /**
+     * Homogeneous matrix of the transform, without allocating memory.
+     */
+    void toMatrix(yarp::math::FixedMatrix4x4& mat) const;
+
+    /**
+     * Set the transform from an homogeneous matrix, without allocating memory.
+     */
+    void fromMatrix(const yarp::math::FixedMatrix4x4& mat);
+
     enum display_transform_mode_t
     {
        rotation_as_quaternion=0,
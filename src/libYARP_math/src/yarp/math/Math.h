@@ -392,6 +392,41 @@ namespace yarp
         */
         YARP_math_API bool crossProductMatrix(const yarp::sig::Vector &v, yarp::sig::Matrix &res);
 
+        /**
+        * Adds a scaled vector to a vector, y = alpha*x + y, without allocating memory (defined in Math.h).
+        * @param alpha the scale factor of x.
+        * @param x the vector to add.
+        * @param y the result, a vector of the same size of x.
+        */
+        YARP_math_API void axpy(double alpha, const yarp::sig::Vector &x, yarp::sig::Vector &y);
+
+        /**
+        * Matrix-vector product, y = alpha*op(A)*x + beta*y, where op(A) is A or its transpose (defined in Math.h).
+        * No memory is allocated if y has the right size.
+        * @param alpha the scale factor of the product.
+        * @param A the matrix.
+        * @param x the vector, it must not be y.
+        * @param beta the scale factor of y. If 0, the content of y is ignored and y is resized if needed.
+        * @param y the result.
+        * @param transposeA if true, op(A) is the transpose of A.
+        */
+        YARP_math_API void gemv(double alpha, const yarp::sig::Matrix &A, const yarp::sig::Vector &x,
+                                double beta, yarp::sig::Vector &y, bool transposeA = false);
+
+        /**
+        * Matrix-matrix product, C = alpha*op(A)*op(B) + beta*C, where op(X) is X or its transpose (defined in
+        * Math.h). No memory is allocated if C has the right size.
+        * @param alpha the scale factor of the product.
+        * @param A the first matrix, it must not be C.
+        * @param B the second matrix, it must not be C.
+        * @param beta the scale factor of C. If 0, the content of C is ignored and C is resized if needed.
+        * @param C the result.
+        * @param transposeA if true, op(A) is the transpose of A.
+        * @param transposeB if true, op(B) is the transpose of B.
+        */
+        YARP_math_API void gemm(double alpha, const yarp::sig::Matrix &A, const yarp::sig::Matrix &B,
+                                double beta, yarp::sig::Matrix &C, bool transposeA = false, bool transposeB = false);
+
         /**
         * Returns the Euclidean norm of the vector (defined in Math.h).
         * @param v is the input vector.
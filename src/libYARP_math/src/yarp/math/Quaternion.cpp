@@ -19,7 +19,79 @@ using namespace yarp::math;
 
 namespace {
 YARP_LOG_COMPONENT(QUATERNION, "yarp.math.Quaternion")
+
+// The quaternion of the rotation in the top left 3x3 block of R
+// (yarp::sig::Matrix or FixedMatrix)
+template <typename M>
+void rotationToQuaternion(const M& R, double* q)
+{
+    double tr = R(0, 0) + R(1, 1) + R(2, 2);
+
+    if (tr>0.0)
+    {
+        double sqtrp1 = sqrt(tr + 1.0);
+        double sqtrp12 = 2.0*sqtrp1;
+        q[0] = 0.5*sqtrp1;
+        q[1] = (R(2, 1) - R(1, 2)) / sqtrp12;
+        q[2] = (R(0, 2) - R(2, 0)) / sqtrp12;
+        q[3] = (R(1, 0) - R(0, 1)) / sqtrp12;
+    }
+    else if ((R(1, 1)>R(0, 0)) && (R(1, 1)>R(2, 2)))
+    {
+        double sqdip1 = sqrt(R(1, 1) - R(0, 0) - R(2, 2) + 1.0);
+        q[2] = 0.5*sqdip1;
+
+        if (sqdip1>0.0)
+            sqdip1 = 0.5 / sqdip1;
+
+        q[0] = (R(0, 2) - R(2, 0))*sqdip1;
+        q[1] = (R(1, 0) + R(0, 1))*sqdip1;
+        q[3] = (R(2, 1) + R(1, 2))*sqdip1;
+    }
+    else if (R(2, 2)>R(0, 0))
+    {
+        double sqdip1 = sqrt(R(2, 2) - R(0, 0) - R(1, 1) + 1.0);
+        q[3] = 0.5*sqdip1;
+
+        if (sqdip1>0.0)
+            sqdip1 = 0.5 / sqdip1;
+
+        q[0] = (R(1, 0) - R(0, 1))*sqdip1;
+        q[1] = (R(0, 2) + R(2, 0))*sqdip1;
+        q[2] = (R(2, 1) + R(1, 2))*sqdip1;
+    }
+    else
+    {
+        double sqdip1 = sqrt(R(0, 0) - R(1, 1) - R(2, 2) + 1.0);
+        q[1] = 0.5*sqdip1;
+
+        if (sqdip1>0.0)
+            sqdip1 = 0.5 / sqdip1;
+
+        q[0] = (R(2, 1) - R(1, 2))*sqdip1;
+        q[2] = (R(1, 0) + R(0, 1))*sqdip1;
+        q[3] = (R(0, 2) + R(2, 0))*sqdip1;
+    }
+}
+
+// Set the top left 3x3 block of R (yarp::sig::Matrix or FixedMatrix) to the
+// rotation of the quaternion q
+template <typename M>
+void quaternionToRotation(const double* q, M& R)
+{
+    const double k = 1.0 / std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    const double qin[4] = {k * q[0], k * q[1], k * q[2], k * q[3]};
+    R(0, 0) = qin[0] * qin[0] + qin[1] * qin[1] - qin[2] * qin[2] - qin[3] * qin[3];
+    R(1, 0) = 2.0*(qin[1] * qin[2] + qin[0] * qin[3]);
+    R(2, 0) = 2.0*(qin[1] * qin[3] - qin[0] * qin[2]);
+    R(0, 1) = 2.0*(qin[1] * qin[2] - qin[0] * qin[3]);
+    R(1, 1) = qin[0] * qin[0] - qin[1] * qin[1] + qin[2] * qin[2] - qin[3] * qin[3];
+    R(2, 1) = 2.0*(qin[2] * qin[3] + qin[0] * qin[1]);
+    R(0, 2) = 2.0*(qin[1] * qin[3] + qin[0] * qin[2]);
+    R(1, 2) = 2.0*(qin[2] * qin[3] - qin[0] * qin[1]);
+    R(2, 2) = qin[0] * qin[0] - qin[1] * qin[1] - qin[2] * qin[2] + qin[3] * qin[3];
 }
+} // namespace
 
 YARP_BEGIN_PACK
 class QuaternionPortContentHeader
@@ -159,91 +231,42 @@ void Quaternion::fromRotationMatrix(const yarp::sig::Matrix &R)
         yCAssert(QUATERNION, R.rows() >= 3 && R.cols() >= 3);
     }
 
-    double tr = R(0, 0) + R(1, 1) + R(2, 2);
-
-    if (tr>0.0)
-    {
-        double sqtrp1 = sqrt(tr + 1.0);
-        double sqtrp12 = 2.0*sqtrp1;
-        internal_data[0] = 0.5*sqtrp1;
-        internal_data[1] = (R(2, 1) - R(1, 2)) / sqtrp12;
-        internal_data[2] = (R(0, 2) - R(2, 0)) / sqtrp12;
-        internal_data[3] = (R(1, 0) - R(0, 1)) / sqtrp12;
-    }
-    else if ((R(1, 1)>R(0, 0)) && (R(1, 1)>R(2, 2)))
-    {
-        double sqdip1 = sqrt(R(1, 1) - R(0, 0) - R(2, 2) + 1.0);
-        internal_data[2] = 0.5*sqdip1;
-
-        if (sqdip1>0.0)
-            sqdip1 = 0.5 / sqdip1;
-
-        internal_data[0] = (R(0, 2) - R(2, 0))*sqdip1;
-        internal_data[1] = (R(1, 0) + R(0, 1))*sqdip1;
-        internal_data[3] = (R(2, 1) + R(1, 2))*sqdip1;
-    }
-    else if (R(2, 2)>R(0, 0))
-    {
-        double sqdip1 = sqrt(R(2, 2) - R(0, 0) - R(1, 1) + 1.0);
-        internal_data[3] = 0.5*sqdip1;
-
-        if (sqdip1>0.0)
-            sqdip1 = 0.5 / sqdip1;
-
-        internal_data[0] = (R(1, 0) - R(0, 1))*sqdip1;
-        internal_data[1] = (R(0, 2) + R(2, 0))*sqdip1;
-        internal_data[2] = (R(2, 1) + R(1, 2))*sqdip1;
-    }
-    else
-    {
-        double sqdip1 = sqrt(R(0, 0) - R(1, 1) - R(2, 2) + 1.0);
-        internal_data[1] = 0.5*sqdip1;
+    rotationToQuaternion(R, internal_data);
+}
 
-        if (sqdip1>0.0)
-            sqdip1 = 0.5 / sqdip1;
+void Quaternion::fromRotationMatrix(const FixedMatrix3x3 &R)
+{
+    rotationToQuaternion(R, internal_data);
+}
 
-        internal_data[0] = (R(2, 1) - R(1, 2))*sqdip1;
-        internal_data[2] = (R(1, 0) + R(0, 1))*sqdip1;
-        internal_data[3] = (R(0, 2) + R(2, 0))*sqdip1;
-    }
+void Quaternion::fromRotationMatrix(const FixedMatrix4x4 &R)
+{
+    rotationToQuaternion(R, internal_data);
 }
 
 yarp::sig::Matrix Quaternion::toRotationMatrix4x4() const
 {
-    yarp::sig::Vector q = this->toVector();
-    yarp::sig::Vector qin = (1.0 / yarp::math::norm(q))*q;
-
     yarp::sig::Matrix R = yarp::math::eye(4, 4);
-    R(0, 0) = qin[0] * qin[0] + qin[1] * qin[1] - qin[2] * qin[2] - qin[3] * qin[3];
-    R(1, 0) = 2.0*(qin[1] * qin[2] + qin[0] * qin[3]);
-    R(2, 0) = 2.0*(qin[1] * qin[3] - qin[0] * qin[2]);
-    R(0, 1) = 2.0*(qin[1] * qin[2] - qin[0] * qin[3]);
-    R(1, 1) = qin[0] * qin[0] - qin[1] * qin[1] + qin[2] * qin[2] - qin[3] * qin[3];
-    R(2, 1) = 2.0*(qin[2] * qin[3] + qin[0] * qin[1]);
-    R(0, 2) = 2.0*(qin[1] * qin[3] + qin[0] * qin[2]);
-    R(1, 2) = 2.0*(qin[2] * qin[3] - qin[0] * qin[1]);
-    R(2, 2) = qin[0] * qin[0] - qin[1] * qin[1] - qin[2] * qin[2] + qin[3] * qin[3];
-
+    quaternionToRotation(internal_data, R);
     return R;
 }
 
 yarp::sig::Matrix Quaternion::toRotationMatrix3x3() const
 {
-    yarp::sig::Vector q = this->toVector();
-    yarp::sig::Vector qin = (1.0 / yarp::math::norm(q))*q;
+    yarp::sig::Matrix R(3, 3);
+    quaternionToRotation(internal_data, R);
+    return R;
+}
 
-    yarp::sig::Matrix R = yarp::math::zeros(3,3);
-    R(0, 0) = qin[0] * qin[0] + qin[1] * qin[1] - qin[2] * qin[2] - qin[3] * qin[3];
-    R(1, 0) = 2.0*(qin[1] * qin[2] + qin[0] * qin[3]);
-    R(2, 0) = 2.0*(qin[1] * qin[3] - qin[0] * qin[2]);
-    R(0, 1) = 2.0*(qin[1] * qin[2] - qin[0] * qin[3]);
-    R(1, 1) = qin[0] * qin[0] - qin[1] * qin[1] + qin[2] * qin[2] - qin[3] * qin[3];
-    R(2, 1) = 2.0*(qin[2] * qin[3] + qin[0] * qin[1]);
-    R(0, 2) = 2.0*(qin[1] * qin[3] + qin[0] * qin[2]);
-    R(1, 2) = 2.0*(qin[2] * qin[3] - qin[0] * qin[1]);
-    R(2, 2) = qin[0] * qin[0] - qin[1] * qin[1] - qin[2] * qin[2] + qin[3] * qin[3];
+void Quaternion::toRotationMatrix4x4(FixedMatrix4x4 &R) const
+{
+    R = FixedMatrix4x4::identity();
+    quaternionToRotation(internal_data, R);
+}
 
-    return R;
+void Quaternion::toRotationMatrix3x3(FixedMatrix3x3 &R) const
+{
+    quaternionToRotation(internal_data, R);
 }
 
 std::string Quaternion::toString(int precision, int width) const
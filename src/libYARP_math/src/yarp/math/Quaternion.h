@@ -10,6 +10,7 @@
 #define YARP_QUATERNION
 
 #include <yarp/math/api.h>
+#include <yarp/math/FixedMatrix.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/sig/Matrix.h>
 #include <yarp/os/Portable.h>
@@ -105,6 +106,18 @@ public:
     */
     void fromRotationMatrix(const yarp::sig::Matrix &R);
 
+    /**
+    * Computes the quaternion from a 3x3 rotation matrix, without allocating memory.
+    * @param R the input rotation matrix.
+    */
+    void fromRotationMatrix(const yarp::math::FixedMatrix3x3 &R);
+
+    /**
+    * Computes the quaternion from the rotation of a 4x4 homogeneous matrix, without allocating memory.
+    * @param R the input homogeneous matrix.
+    */
+    void fromRotationMatrix(const yarp::math::FixedMatrix4x4 &R);
+
 #ifndef YARP_NO_DEPRECATED // Since YARP 3.0.0
     /**
      * Converts a quaternion to a rotation matrix.
@@ -149,6 +162,18 @@ public:
     */
     yarp::sig::Matrix toRotationMatrix3x3() const;
 
+    /**
+    * Converts a quaternion to a 4x4 homogeneous matrix, without allocating memory.
+    * @param R the matrix, with the rotation in the top left 3 by 3 submatrix.
+    */
+    void toRotationMatrix4x4(yarp::math::FixedMatrix4x4 &R) const;
+
+    /**
+    * Converts a quaternion to a 3x3 rotation matrix, without allocating memory.
+    * @param R the rotation matrix.
+    */
+    void toRotationMatrix3x3(yarp::math::FixedMatrix3x3 &R) const;
+
     /**
     * Converts the quaternion to a vector of length 4.
     */
@@ -517,6 +517,68 @@ bool yarp::math::crossProductMatrix(const Vector &v, Matrix &res)
     return true;
 }
 
+void yarp::math::axpy(double alpha, const Vector &x, Vector &y)
+{
+    yCAssert(MATH, x.size()==y.size());
+    toEigen(y) += alpha*toEigen(x);
+}
+
+void yarp::math::gemv(double alpha, const Matrix &A, const Vector &x, double beta, Vector &y, bool transposeA)
+{
+    const size_t m = transposeA ? A.cols() : A.rows();
+    const size_t n = transposeA ? A.rows() : A.cols();
+    yCAssert(MATH, n==x.size());
+    yCAssert(MATH, &x!=&y);
+
+    if (beta==0.0)
+    {
+        if (y.size()!=m)
+            y.resize(m);
+        toEigen(y).setZero();
+    }
+    else
+    {
+        yCAssert(MATH, y.size()==m);
+        toEigen(y) *= beta;
+    }
+
+    if (transposeA)
+        toEigen(y).noalias() += alpha*toEigen(A).transpose()*toEigen(x);
+    else
+        toEigen(y).noalias() += alpha*toEigen(A)*toEigen(x);
+}
+
+void yarp::math::gemm(double alpha, const Matrix &A, const Matrix &B, double beta, Matrix &C, bool transposeA, bool transposeB)
+{
+    const size_t m = transposeA ? A.cols() : A.rows();
+    const size_t k = transposeA ? A.rows() : A.cols();
+    const size_t kB = transposeB ? B.cols() : B.rows();
+    const size_t n = transposeB ? B.rows() : B.cols();
+    yCAssert(MATH, k==kB);
+    yCAssert(MATH, &A!=&C && &B!=&C);
+
+    if (beta==0.0)
+    {
+        if (C.rows()!=m || C.cols()!=n)
+            C.resize(m,n);
+        toEigen(C).setZero();
+    }
+    else
+    {
+        yCAssert(MATH, C.rows()==m && C.cols()==n);
+        toEigen(C) *= beta;
+    }
+
+    if (transposeA && transposeB)
+        toEigen(C).noalias() += alpha*toEigen(A).transpose()*toEigen(B).transpose();
+    else if (transposeA)
+        toEigen(C).noalias() += alpha*toEigen(A).transpose()*toEigen(B);
+    else if (transposeB)
+        toEigen(C).noalias() += alpha*toEigen(A)*toEigen(B).transpose();
+    else
+        toEigen(C).noalias() += alpha*toEigen(A)*toEigen(B);
+}
+
 double yarp::math::norm(const Vector &v)
 {
     return toEigen(v).norm();
@@ -256,6 +256,36 @@ size_t Bottle::size() const
     return static_cast<int>(implementation->size());
 }
 
+const std::int8_t* Bottle::getInt8Array() const
+{
+    return reinterpret_cast<const std::int8_t*>(implementation->getPackedItems(BOTTLE_TAG_INT8));
+}
+
+const std::int16_t* Bottle::getInt16Array() const
+{
+    return reinterpret_cast<const std::int16_t*>(implementation->getPackedItems(BOTTLE_TAG_INT16));
+}
+
+const std::int32_t* Bottle::getInt32Array() const
+{
+    return reinterpret_cast<const std::int32_t*>(implementation->getPackedItems(BOTTLE_TAG_INT32));
+}
+
+const std::int64_t* Bottle::getInt64Array() const
+{
+    return reinterpret_cast<const std::int64_t*>(implementation->getPackedItems(BOTTLE_TAG_INT64));
+}
+
+const yarp::conf::float32_t* Bottle::getFloat32Array() const
+{
+    return reinterpret_cast<const yarp::conf::float32_t*>(implementation->getPackedItems(BOTTLE_TAG_FLOAT32));
+}
+
+const yarp::conf::float64_t* Bottle::getFloat64Array() const
+{
+    return reinterpret_cast<const yarp::conf::float64_t*>(implementation->getPackedItems(BOTTLE_TAG_FLOAT64));
+}
+
 void Bottle::hasChanged()
 {
     implementation->hasChanged();
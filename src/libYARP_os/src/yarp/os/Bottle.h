@@ -304,6 +304,56 @@ public:
      */
     size_type size() const;
 
+    /**
+     * Gets the items of a list of 8-bit integers.
+     *
+     * The items of a list of numbers of the same type received from a
+     * connection are also stored contiguously, and can be read without
+     * going through the Value objects.  Appending items of the same type
+     * keeps them up to date, while the items assigned in place through
+     * get() are not reflected.
+     *
+     * @return a pointer to the size() items, or nullptr if the bottle was
+     *         not received as a list of 8-bit integers, or if it was
+     *         modified since in any other way (including hasChanged()).
+     */
+    const std::int8_t* getInt8Array() const;
+
+    /**
+     * Gets the items of a list of 16-bit integers.
+     *
+     * @see getInt8Array()
+     */
+    const std::int16_t* getInt16Array() const;
+
+    /**
+     * Gets the items of a list of 32-bit integers.
+     *
+     * @see getInt8Array()
+     */
+    const std::int32_t* getInt32Array() const;
+
+    /**
+     * Gets the items of a list of 64-bit integers.
+     *
+     * @see getInt8Array()
+     */
+    const std::int64_t* getInt64Array() const;
+
+    /**
+     * Gets the items of a list of 32-bit floating point numbers.
+     *
+     * @see getInt8Array()
+     */
+    const yarp::conf::float32_t* getFloat32Array() const;
+
+    /**
+     * Gets the items of a list of 64-bit floating point numbers.
+     *
+     * @see getInt8Array()
+     */
+    const yarp::conf::float64_t* getFloat64Array() const;
+
     /**
      * Initializes bottle from a string.
      *
@@ -72,6 +72,8 @@ bool yarp::os::BufferedPort<T>::addOutput(const Contact& contact)
 template <typename T>
 void yarp::os::BufferedPort<T>::close()
 {
+    // the input threads might be waiting for the reader to make space
+    reader.interrupt();
     port.close();
     reader.detach();
     writer.detach();
@@ -82,6 +84,7 @@ template <typename T>
 void yarp::os::BufferedPort<T>::interrupt()
 {
     interrupted = true;
+    reader.interrupt();
     port.interrupt();
 }
 
@@ -297,6 +300,13 @@ void yarp::os::BufferedPort<T>::setTargetPeriod(double period)
     reader.setTargetPeriod(period);
 }
 
+template <typename T>
+void yarp::os::BufferedPort<T>::setLockFree(bool flag)
+{
+    attachIfNeeded();
+    reader.setLockFree(flag);
+}
+
 template <typename T>
 yarp::os::Type yarp::os::BufferedPort<T>::getType()
 {
@@ -258,6 +258,14 @@ public:
     // documented in TypedReader
     void setTargetPeriod(double period) override;
 
+    /**
+     * Use a lock-free ring buffer for the incoming data.
+     * Call this before the port receives any data.
+     *
+     * @see PortReaderBuffer::setLockFree
+     */
+    void setLockFree(bool flag = true);
+
     // documented in Contactable
     Type getType() override;
 
@@ -136,3 +136,8 @@ yarp::os::Face* Carrier::createFace() const
 {
     return new yarp::os::impl::TcpFace();
 }
+
+yarp::os::PortWriter* Carrier::retainReference()
+{
+    return nullptr;
+}
@@ -27,6 +27,7 @@ class ContactStyle;
 class ConnectionReader;
 class ConnectionState;
 class Face;
+class PortWriter;
 
 
 /**
@@ -457,6 +458,17 @@ public:
      *
      */
     virtual yarp::os::Face* createFace() const;
+
+    /**
+     * Keep the object received by reference (see
+     * ConnectionState::setReference()) valid after the end of the current
+     * message.  This is called through ConnectionReader::retainReference().
+     *
+     * @return an object whose onCompletion() method must be called once
+     *         the object is not needed anymore, or nullptr if the carrier
+     *         cannot keep it (the default)
+     */
+    virtual yarp::os::PortWriter* retainReference();
 };
 
 } // namespace os
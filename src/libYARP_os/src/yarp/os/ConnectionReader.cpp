@@ -20,6 +20,11 @@ Bytes ConnectionReader::readEnvelope()
     return {nullptr, 0};
 }
 
+PortWriter* ConnectionReader::retainReference()
+{
+    return nullptr;
+}
+
 void ConnectionReader::setParentConnectionReader(ConnectionReader* parentConnectionReader)
 {
     YARP_UNUSED(parentConnectionReader);
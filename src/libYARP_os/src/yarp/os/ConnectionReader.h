@@ -22,6 +22,7 @@ namespace yarp {
 namespace os {
 class ConnectionWriter;
 class PortReader;
+class PortWriter;
 class Portable;
 class InputStream;
 } // namespace os
@@ -189,6 +190,16 @@ public:
      */
     virtual Portable* getReference() const = 0;
 
+    /**
+     * Keep the object returned by getReference() valid after the end of
+     * the message.  The sender of the object will not modify it until
+     * onCompletion() is called on the returned object.
+     * @return The object to notify once the reference is not needed
+     *         anymore, or nullptr if the reference cannot be kept (in
+     *         this case it is only valid until the end of the message)
+     */
+    virtual PortWriter* retainReference();
+
     /**
      * Gets information about who is supplying the data being read, if
      * that information is available.
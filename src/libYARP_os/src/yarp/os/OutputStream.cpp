@@ -25,6 +25,13 @@ void yarp::os::OutputStream::write(const Bytes& b, int offset, int len)
     write(bytes);
 }
 
+void yarp::os::OutputStream::writeBlocks(const Bytes* blocks, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        write(blocks[i]);
+    }
+}
+
 void yarp::os::OutputStream::flush()
 {
 }
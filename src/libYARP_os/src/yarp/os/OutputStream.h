@@ -12,6 +12,8 @@
 
 #include <yarp/os/api.h>
 
+#include <cstddef>
+
 namespace yarp {
 namespace os {
 
@@ -54,6 +56,18 @@ public:
      */
     virtual void write(const yarp::os::Bytes& b) = 0;
 
+    /**
+     * Write a sequence of blocks of bytes to the stream (scatter-gather
+     * write).  Streams that can send several blocks at once (for example
+     * using writev) should override this method, so that a whole message
+     * can be sent without copying its blocks into a single buffer.
+     * By default, this calls write(const Bytes& b) on each block.
+     *
+     * @param blocks the blocks to write
+     * @param count the number of blocks
+     */
+    virtual void writeBlocks(const yarp::os::Bytes* blocks, size_t count);
+
     /**
      * Terminate the stream.
      */
@@ -209,5 +209,11 @@ void yarp::os::PortReaderBuffer<T>::setTargetPeriod(double period)
     implementation.setTargetPeriod(period);
 }
 
+template <typename T>
+void yarp::os::PortReaderBuffer<T>::setLockFree(bool flag)
+{
+    implementation.setLockFree(flag);
+}
+
 
 #endif // YARP_OS_PORTREADERBUFFER_INL_H
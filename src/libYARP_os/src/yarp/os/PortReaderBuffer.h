@@ -139,6 +139,29 @@ public:
     // documented in TypedReader
     void setTargetPeriod(double period) override;
 
+    /**
+     * Use a lock-free ring buffer to pass the objects received from the
+     * connections to the reader.
+     *
+     * The default implementation serializes readers and writers through a
+     * mutex and a couple of semaphores, which becomes noticeable for
+     * high-rate streams.  The lock-free implementation never blocks the
+     * writers, unless the strict policy is used and the buffer is full,
+     * and it wakes up the reader only when it is waiting for data.
+     *
+     * The capacity of the ring buffer is the maximum number of buffers
+     * passed to the constructor, or 128 if there is no limit.  When the
+     * buffer is full, the oldest object is dropped (see setStrict(false)),
+     * or the writer waits until the reader consumes an object (see
+     * setStrict(true)).
+     *
+     * This should be called before the port receives any data, objects
+     * already in the buffer are discarded.
+     *
+     * @param flag true to use the lock-free implementation
+     */
+    void setLockFree(bool flag = true);
+
 private:
     yarp::os::PortReaderBufferBase implementation;
     bool autoDiscard;
@@ -16,11 +16,13 @@
 #include <yarp/os/StringInputStream.h>
 #include <yarp/os/Thread.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/impl/LockFreeQueue.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PortCorePacket.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
 #include <list>
+#include <memory>
 #include <mutex>
 
 using namespace yarp::os::impl;
@@ -28,6 +30,9 @@ using namespace yarp::os;
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTREADERBUFFERBASE, "yarp.os.PortReaderBufferBase")
+
+// Capacity of the lock-free ring when no maximum number of buffers is set
+constexpr unsigned int defaultLockFreeCapacity = 128;
 } // namespace
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -163,6 +168,8 @@ public:
     void addInactivePacket(PortReaderPacket* packet)
     {
         if (packet != nullptr) {
+            // let the sender of an external object know it is free
+            packet->resetExternal();
             inactive.push_back(packet);
         }
     }
@@ -203,6 +210,11 @@ public:
     yarp::os::Semaphore consumeSema;
     std::mutex stateMutex;
 
+    // lock-free backend (see setLockFree()), the packets received are
+    // queued in "content", and reused through "recycled"
+    std::unique_ptr<LockFreeQueue> content;
+    std::unique_ptr<LockFreeQueue> recycled;
+
     Private(PortReaderBufferBase& owner, unsigned int maxBuffer) :
             owner(owner),
             prev(nullptr),
@@ -238,6 +250,17 @@ public:
 
     void clear()
     {
+        if (content) {
+            delete prev;
+            prev = nullptr;
+            while (auto* packet = static_cast<PortReaderPacket*>(content->pop())) {
+                delete packet;
+            }
+            while (auto* packet = static_cast<PortReaderPacket*>(recycled->pop())) {
+                delete packet;
+            }
+            return;
+        }
         if (prev != nullptr) {
             pool.addInactivePacket(prev);
             prev = nullptr;
@@ -246,6 +269,82 @@ public:
         ct = 0;
     }
 
+    void setLockFree(bool flag)
+    {
+        if (flag == (content != nullptr)) {
+            return;
+        }
+        clear();
+        if (flag) {
+            unsigned int capacity = (maxBuffer > 0) ? maxBuffer : defaultLockFreeCapacity;
+            content = std::make_unique<LockFreeQueue>(capacity);
+            // packets held by the reader, or being filled by the writers,
+            // are not in the ring.
+            recycled = std::make_unique<LockFreeQueue>(content->capacity() * 2);
+        } else {
+            content.reset();
+            recycled.reset();
+        }
+    }
+
+    PortReaderPacket* getLockFree()
+    {
+        auto* packet = static_cast<PortReaderPacket*>(recycled->pop());
+        if (packet == nullptr) {
+            packet = new PortReaderPacket();
+        }
+        return packet;
+    }
+
+    void recycleLockFree(PortReaderPacket* packet)
+    {
+        if (packet == nullptr) {
+            return;
+        }
+        // let the sender of an external object know it is free
+        packet->resetExternal();
+        if (!recycled->push(packet)) {
+            delete packet;
+        }
+    }
+
+    void addContentLockFree(PortReaderPacket* packet)
+    {
+        if (prune) {
+            // keep only the most recent packet
+            recycleLockFree(static_cast<PortReaderPacket*>(content->pop()));
+        }
+        while (!content->push(packet)) {
+            if (prune) {
+                recycleLockFree(static_cast<PortReaderPacket*>(content->pop()));
+            } else if (!content->waitForSpace()) {
+                // strict policy, but the reader was interrupted and will
+                // not make any space: drop the packet
+                recycleLockFree(packet);
+                return;
+            }
+        }
+    }
+
+    bool waitContentLockFree(double timeout)
+    {
+        return content->waitForItem(timeout);
+    }
+
+    PortReaderPacket* getContentLockFree()
+    {
+        recycleLockFree(prev);
+        prev = static_cast<PortReaderPacket*>(content->pop());
+        if (prev == nullptr) {
+            // woken up by interrupt(), or by a failed read
+            content->checkInterrupt();
+        } else {
+            // reading again, the writers can wait for some space
+            content->resume();
+        }
+        return prev;
+    }
+
 
     std::string getName()
     {
@@ -370,6 +469,9 @@ yarp::os::PortReader* PortReaderBufferBase::create()
 
 int PortReaderBufferBase::check()
 {
+    if (mPriv->content) {
+        return static_cast<int>(mPriv->content->size());
+    }
     mPriv->stateMutex.lock();
     int count = mPriv->checkContent();
     mPriv->stateMutex.unlock();
@@ -380,14 +482,23 @@ int PortReaderBufferBase::check()
 void PortReaderBufferBase::interrupt()
 {
     // give read a chance
+    if (mPriv->content) {
+        mPriv->content->interrupt();
+        return;
+    }
     mPriv->contentSema.post();
 }
 
 PortReader* PortReaderBufferBase::readBase(bool& missed, bool cleanup)
 {
     missed = false;
+    LockFreeQueue* content = mPriv->content.get();
     if (mPriv->period < 0 || cleanup) {
-        mPriv->contentSema.wait();
+        if (content != nullptr) {
+            content->waitForItem();
+        } else {
+            mPriv->contentSema.wait();
+        }
     } else {
         bool ok = false;
         double now = SystemClock::nowSystem();
@@ -396,7 +507,9 @@ PortReader* PortReaderBufferBase::readBase(bool& missed, bool cleanup)
             target = mPriv->last_recv + mPriv->period;
         }
         double diff = target - now;
-        if (diff > 0) {
+        if (content != nullptr) {
+            ok = content->waitForItem((diff > 0) ? diff : 0);
+        } else if (diff > 0) {
             ok = mPriv->contentSema.waitWithTimeout(diff);
         } else {
             ok = mPriv->contentSema.check();
@@ -422,6 +535,14 @@ PortReader* PortReaderBufferBase::readBase(bool& missed, bool cleanup)
             mPriv->last_recv = target;
         }
     }
+    if (content != nullptr) {
+        PortReaderPacket* readerPacket = mPriv->getContentLockFree();
+        if (readerPacket == nullptr) {
+            return nullptr;
+        }
+        PortReader* external = readerPacket->getExternal();
+        return (external == nullptr) ? readerPacket->getReader() : external;
+    }
     mPriv->stateMutex.lock();
     PortReaderPacket* readerPacket = mPriv->getContent();
     PortReader* reader = nullptr;
@@ -446,7 +567,9 @@ bool PortReaderBufferBase::read(ConnectionReader& connection)
     if (connection.getReference() != nullptr) {
         //printf("REF %ld %d\n", (long int)connection.getReference(),
         //     connection.isValid());
-        return acceptObjectBase(connection.getReference(), nullptr);
+        // Keep the object until the reader is done with it, if the
+        // sender allows it
+        return acceptObjectBase(connection.getReference(), connection.retainReference());
     }
 
     if (mPriv->replier != nullptr) {
@@ -454,6 +577,10 @@ bool PortReaderBufferBase::read(ConnectionReader& connection)
             return mPriv->replier->read(connection);
         }
     }
+    if (mPriv->content) {
+        return readLockFree(connection);
+    }
+
     PortReaderPacket* reader = nullptr;
     while (reader == nullptr) {
         mPriv->stateMutex.lock();
@@ -508,6 +635,40 @@ bool PortReaderBufferBase::read(ConnectionReader& connection)
 }
 
 
+bool PortReaderBufferBase::readLockFree(ConnectionReader& connection)
+{
+    // Same as read(), using the lock-free ring
+    PortReaderPacket* reader = mPriv->getLockFree();
+    reader->resetExternal();
+    if (reader->getReader() == nullptr) {
+        PortReader* next = create();
+        yCAssert(PORTREADERBUFFERBASE, next != nullptr);
+        reader->setReader(next);
+    }
+    bool ok = false;
+    if (connection.isValid()) {
+        ok = reader->getReader()->read(connection);
+        reader->setEnvelope(connection.readEnvelope());
+    } else {
+        // this is a disconnection
+        // don't talk to this port ever again
+        mPriv->port = nullptr;
+    }
+    if (ok) {
+        mPriv->addContentLockFree(reader);
+        yCTrace(PORTREADERBUFFERBASE, ">>>>>>>>>>>>>>>>> adding data");
+    } else {
+        mPriv->recycleLockFree(reader);
+        yCTrace(PORTREADERBUFFERBASE, ">>>>>>>>>>>>>>>>> skipping data");
+
+        // important to give reader a shot anyway, allowing proper closing
+        yCDebug(PORTREADERBUFFERBASE, "giving PortReaderBuffer chance to close");
+        mPriv->content->interrupt();
+    }
+    return ok;
+}
+
+
 void PortReaderBufferBase::setCreator(PortReaderBufferBaseCreator* creator)
 {
     mPriv->creator = creator;
@@ -528,6 +689,18 @@ void PortReaderBufferBase::setTargetPeriod(double period)
     mPriv->period = period;
 }
 
+void PortReaderBufferBase::setLockFree(bool flag)
+{
+    mPriv->stateMutex.lock();
+    mPriv->setLockFree(flag);
+    mPriv->stateMutex.unlock();
+}
+
+bool PortReaderBufferBase::isLockFree() const
+{
+    return mPriv->content != nullptr;
+}
+
 std::string PortReaderBufferBase::getName() const
 {
     return mPriv->getName();
@@ -561,6 +734,14 @@ bool PortReaderBufferBase::acceptObjectBase(PortReader* obj,
     // receiving from a Port -- except no need to create/read
     // the object
 
+    if (mPriv->content) {
+        PortReaderPacket* reader = mPriv->getLockFree();
+        reader->setExternal(obj, wrapper);
+        mPriv->addContentLockFree(reader);
+        yCTrace(PORTREADERBUFFERBASE, ">>>>>>>>>>>>>>>>> adding data");
+        return true;
+    }
+
     PortReaderPacket* reader = nullptr;
     while (reader == nullptr) {
         mPriv->stateMutex.lock();
@@ -609,6 +790,10 @@ void* PortReaderBufferBase::acquire()
 
 void PortReaderBufferBase::release(void* key)
 {
+    if (mPriv->content) {
+        mPriv->recycleLockFree(static_cast<PortReaderPacket*>(key));
+        return;
+    }
     mPriv->stateMutex.lock();
     mPriv->release(key);
     mPriv->stateMutex.unlock();
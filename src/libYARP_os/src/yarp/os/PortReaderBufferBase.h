@@ -36,6 +36,15 @@ public:
 
     void setTargetPeriod(double period);
 
+    /**
+     * Use a lock-free ring buffer instead of the default mutex and
+     * semaphore based queue (see PortReaderBuffer::setLockFree()).
+     * Data already in the buffer is discarded.
+     */
+    void setLockFree(bool flag = true);
+
+    bool isLockFree() const;
+
     std::string getName() const;
 
     unsigned int getMaxBuffer();
@@ -74,6 +83,8 @@ public:
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 private:
+    bool readLockFree(yarp::os::ConnectionReader& connection);
+
     class Private;
     Private* mPriv;
 #endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -12,8 +12,11 @@
 #include <yarp/os/Port.h>
 #include <yarp/os/Semaphore.h>
 #include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/ObjectLease.h>
 #include <yarp/os/impl/PortCorePackets.h>
 
+#include <vector>
+
 using namespace yarp::os::impl;
 using namespace yarp::os;
 
@@ -89,6 +92,19 @@ public:
         stateSema.wait();
         PortCorePacket* packet = packets.getFreePacket();
         yCAssert(PORTWRITERBUFFERBASE, packet != nullptr);
+        if (ObjectLease::isLeased(packet->getContent())) {
+            // Some reader in the same process still uses this buffer,
+            // prepare the message in another one
+            std::vector<PortCorePacket*> leased;
+            while (ObjectLease::isLeased(packet->getContent())) {
+                leased.push_back(packet);
+                packet = packets.getFreePacket();
+                yCAssert(PORTWRITERBUFFERBASE, packet != nullptr);
+            }
+            for (auto* leasedPacket : leased) {
+                packets.freePacket(leasedPacket, false);
+            }
+        }
         if (packet->getContent() == nullptr) {
             yCDebug(PORTWRITERBUFFERBASE, "creating a writer buffer");
             //packet->setContent(owner.create(*this, packet), true);
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_SNAPSHOTBUFFER_H
+#define YARP_OS_SNAPSHOTBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace yarp {
+namespace os {
+
+/**
+ * \ingroup key_class
+ *
+ * The latest value of an object, written by a thread and read by any
+ * number of threads.
+ *
+ * The value is stored in Slots slots.  The writer modifies a slot that
+ * is not being read, and then publishes it as the latest value, so the
+ * readers always see a consistent value, and never wait for the writer
+ * or for each other.  A reader retries only if a new value was published
+ * while it was looking up the latest one.
+ *
+ * The writer never waits for the readers, unless all the slots but the
+ * latest one are being read, i.e. unless more than Slots-2 readers read
+ * the value at the same time.  Concurrent writers are serialized.
+ *
+ * The readers access the value in place, so they can copy only the part
+ * of the value they need.
+ *
+ * \code{.cpp}
+ *   yarp::os::SnapshotBuffer<std::vector<double>> buffer;
+ *
+ *   // writer
+ *   buffer.update([&](std::vector<double>& value) { value[j] = x; });
+ *
+ *   // readers
+ *   double x = buffer.read([&](const std::vector<double>& value) { return value[j]; });
+ * \endcode
+ *
+ * \tparam T the type of the value, default constructible and copy assignable
+ * \tparam Slots the number of slots, at least 3
+ */
+template <typename T, size_t Slots = 8>
+class SnapshotBuffer
+{
+    static_assert(Slots >= 3, "SnapshotBuffer needs at least 3 slots");
+
+public:
+    SnapshotBuffer()
+    {
+        for (auto& readers : m_readers) {
+            readers = 0;
+        }
+    }
+
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer(SnapshotBuffer&&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(SnapshotBuffer&&) = delete;
+    ~SnapshotBuffer() = default;
+
+    /**
+     * Publish a new value, obtained calling \a modify on a copy of the
+     * latest value.
+     *
+     * \param modify a callable with signature void(T&)
+     */
+    template <typename F>
+    void update(F&& modify)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+
+        size_t latest = m_latest.load();
+        size_t slot = acquireFreeSlot(latest);
+        m_slots[slot] = m_slots[latest];
+        modify(m_slots[slot]);
+        m_latest.store(slot);
+    }
+
+    /**
+     * Publish a new value.
+     */
+    void write(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+
+        size_t slot = acquireFreeSlot(m_latest.load());
+        m_slots[slot] = value;
+        m_latest.store(slot);
+    }
+
+    /**
+     * Call \a access on the latest value, and return what it returns.
+     * The value is not modified until \a access returns.
+     *
+     * \param access a callable with signature R(const T&)
+     */
+    template <typename F>
+    auto read(F&& access) const -> decltype(access(std::declval<const T&>()))
+    {
+        ReadGuard guard(*this);
+        return access(m_slots[guard.slot]);
+    }
+
+    /**
+     * \return a copy of the latest value.
+     */
+    T get() const
+    {
+        return read([](const T& value) { return value; });
+    }
+
+private:
+    // Pin the latest slot, so that the writer does not modify it
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const SnapshotBuffer& buffer) :
+                m_buffer(buffer)
+        {
+            while (true) {
+                slot = m_buffer.m_latest.load();
+                m_buffer.m_readers[slot].fetch_add(1);
+                // The writer might have chosen the slot before it was pinned
+                if (m_buffer.m_latest.load() == slot) {
+                    return;
+                }
+                m_buffer.m_readers[slot].fetch_sub(1);
+            }
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard()
+        {
+            m_buffer.m_readers[slot].fetch_sub(1);
+        }
+
+        size_t slot;
+
+    private:
+        const SnapshotBuffer& m_buffer;
+    };
+
+    size_t acquireFreeSlot(size_t latest)
+    {
+        while (true) {
+            for (size_t i = 0; i < Slots; ++i) {
+                if (i != latest && m_readers[i].load() == 0) {
+                    return i;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    std::array<T, Slots> m_slots;
+    mutable std::array<std::atomic<unsigned int>, Slots> m_readers;
+    std::atomic<size_t> m_latest {0};
+    std::mutex m_writeMutex;
+};
+
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_SNAPSHOTBUFFER_H
@@ -18,6 +18,8 @@
 #include <yarp/os/impl/MemoryOutputStream.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 using yarp::os::Bottle;
@@ -31,12 +33,49 @@ using yarp::os::impl::Storable;
 
 namespace {
 YARP_OS_LOG_COMPONENT(BOTTLEIMPL, "yarp.os.impl.BottleImpl")
+
+#if !defined(YARP_LITTLE_ENDIAN)
+// Items are little endian on the wire
+void swapItems(char* items, size_t length, size_t itemSize)
+{
+    for (size_t i = 0; i < length; i += itemSize) {
+        std::reverse(items + i, items + i + itemSize);
+    }
+}
+#endif
+
+template <typename T, typename Store>
+Storable* unpackItem(const char* item, Storable* s)
+{
+    T x;
+    memcpy(&x, item, sizeof(T));
+    if (s == nullptr) {
+        return new Store(x);
+    }
+    s->copy(Store(x));
+    return s;
+}
+
+template <typename T>
+void appendItem(std::vector<char>& items, T x)
+{
+    const char* bytes = reinterpret_cast<const char*>(&x);
+    items.insert(items.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool itemMatches(const char* item, T x)
+{
+    // compared bitwise, a NaN matches itself
+    return memcmp(item, &x, sizeof(T)) == 0;
+}
 } // namespace
 
 BottleImpl::BottleImpl() :
         parent(nullptr),
         invalid(false),
         ro(false),
+        packed(false),
         speciality(0),
         nested(false),
         dirty(true)
@@ -47,6 +86,7 @@ BottleImpl::BottleImpl(Searchable* parent) :
         parent(parent),
         invalid(false),
         ro(false),
+        packed(false),
         speciality(0),
         nested(false),
         dirty(true)
@@ -62,6 +102,21 @@ BottleImpl::~BottleImpl()
 
 void BottleImpl::add(Storable* s)
 {
+    if (packed) {
+        if (s->getCode() == speciality) {
+            // keep the packed items up to date
+            switch (speciality) {
+            case BOTTLE_TAG_INT8: appendItem(packedItems, s->asInt8()); break;
+            case BOTTLE_TAG_INT16: appendItem(packedItems, s->asInt16()); break;
+            case BOTTLE_TAG_INT32: appendItem(packedItems, s->asInt32()); break;
+            case BOTTLE_TAG_INT64: appendItem(packedItems, s->asInt64()); break;
+            case BOTTLE_TAG_FLOAT32: appendItem(packedItems, s->asFloat32()); break;
+            case BOTTLE_TAG_FLOAT64: appendItem(packedItems, s->asFloat64()); break;
+            }
+        } else {
+            dropPacked();
+        }
+    }
     content.push_back(s);
     dirty = true;
 }
@@ -73,9 +128,62 @@ void BottleImpl::clear()
         delete i;
     }
     content.clear();
+    for (auto& i : spare) {
+        delete i;
+    }
+    spare.clear();
+    packedItems.clear();
+    packed = false;
+    dirty = true;
+}
+
+
+void BottleImpl::recycle()
+{
+    packed = false;
+    if (content.empty()) {
+        return;
+    }
+    for (auto& i : spare) {
+        delete i;
+    }
+    spare.clear();
+    // reversed, the first item to be read is the last one
+    spare.assign(content.rbegin(), content.rend());
+    content.clear();
     dirty = true;
 }
 
+
+Storable* BottleImpl::reuse(std::int32_t id)
+{
+    // The spare items are matched in order: the one at the same position in
+    // the previous message is reused if it has the same type, and it is
+    // deleted otherwise.
+    if (spare.empty()) {
+        return nullptr;
+    }
+    Storable* s = spare.back();
+    spare.pop_back();
+    bool list = ((id & GROUP_MASK) != 0);
+    bool match = false;
+    if (list) {
+        match = ((id & BOTTLE_TAG_DICT) == 0 && s->isList());
+    } else {
+        match = (!s->isList() && !s->isDict() && s->getCode() == id);
+    }
+    if (!match) {
+        delete s;
+        return nullptr;
+    }
+    if (list) {
+        BottleImpl* impl = s->asList()->implementation;
+        impl->specialize(id & UNIT_MASK);
+        impl->setNested(true);
+    }
+    return s;
+}
+
 void BottleImpl::smartAdd(const std::string& str)
 {
     if (str.length() > 0) {
@@ -344,7 +452,10 @@ bool BottleImpl::fromBytes(ConnectionReader& reader)
     } else {
         yCTrace(BOTTLEIMPL, "READ skipped subcode %" PRId32, speciality);
     }
-    Storable* storable = Storable::createByCode(id);
+    Storable* storable = reuse(id);
+    if (storable == nullptr) {
+        storable = Storable::createByCode(id);
+    }
     if (storable == nullptr) {
         yCError(BOTTLEIMPL, "Reader failed, unrecognized object code %" PRId32, id);
         return false;
@@ -398,6 +509,9 @@ bool BottleImpl::fromBytes(const Bytes& data)
         return false;
     }
     yCTrace(BOTTLEIMPL, "READ bottle length %d", len);
+    if (packedItemSize(speciality) != 0) {
+        return readPacked(reader, len);
+    }
     for (int i = 0; i < len; i++) {
         bool ok = fromBytes(reader);
         if (!ok) {
@@ -479,11 +593,11 @@ bool BottleImpl::read(ConnectionReader& reader)
         fromString(str);
         result = true;
     } else {
+        recycle();
         if (!nested) {
             // no byte length any more to facilitate nesting
             // reader.expectInt32(); // the bottle byte ct; ignored
 
-            clear();
             specialize(0);
 
             std::int32_t code = reader.expectInt32();
@@ -498,7 +612,6 @@ bool BottleImpl::read(ConnectionReader& reader)
         }
 
         result = true;
-        clear();
         dirty = true; // for clarity
 
         std::int32_t len = 0;
@@ -507,6 +620,9 @@ bool BottleImpl::read(ConnectionReader& reader)
             return false;
         }
         yCTrace(BOTTLEIMPL, "READ got length %d", len);
+        if (packedItemSize(speciality) != 0) {
+            return readPacked(reader, len);
+        }
         for (int i = 0; i < len; i++) {
             bool ok = fromBytes(reader);
             if (!ok) {
@@ -537,18 +653,31 @@ void BottleImpl::synch()
         }
         yCTrace(BOTTLEIMPL, "bottle length %zd", size());
         writer.appendInt32(static_cast<std::int32_t>(size()));
-        for (auto s : content) {
-            if (speciality == 0) {
-                yCTrace(BOTTLEIMPL, "subcode %" PRId32, s->getCode());
-                writer.appendInt32(s->getCode());
-            } else {
-                yCTrace(BOTTLEIMPL, "skipped subcode %" PRId32, s->getCode());
-                yCAssert(BOTTLEIMPL, speciality == s->getCode());
-            }
-            if (s->isList()) {
-                s->asList()->implementation->setNested(true);
+#if !defined(YARP_LITTLE_ENDIAN)
+        std::vector<char> swapped;
+#endif
+        if (packedMatches()) {
+#if defined(YARP_LITTLE_ENDIAN)
+            writer.appendBlock(packedItems.data(), packedItems.size());
+#else
+            swapped = packedItems;
+            swapItems(swapped.data(), swapped.size(), packedItemSize(speciality));
+            writer.appendBlock(swapped.data(), swapped.size());
+#endif
+        } else {
+            for (auto s : content) {
+                if (speciality == 0) {
+                    yCTrace(BOTTLEIMPL, "subcode %" PRId32, s->getCode());
+                    writer.appendInt32(s->getCode());
+                } else {
+                    yCTrace(BOTTLEIMPL, "skipped subcode %" PRId32, s->getCode());
+                    yCAssert(BOTTLEIMPL, speciality == s->getCode());
+                }
+                if (s->isList()) {
+                    s->asList()->implementation->setNested(true);
+                }
+                s->writeRaw(writer);
             }
-            s->writeRaw(writer);
         }
         data.resize(writer.dataSize(), ' ');
         MemoryOutputStream m(&data[0]);
@@ -560,6 +689,9 @@ void BottleImpl::synch()
 
 void BottleImpl::specialize(std::int32_t subCode)
 {
+    if (packed && subCode != speciality) {
+        dropPacked();
+    }
     speciality = subCode;
 }
 
@@ -577,6 +709,9 @@ void BottleImpl::setNested(bool nested)
 
 std::int32_t BottleImpl::subCode()
 {
+    if (packedMatches()) {
+        return speciality;
+    }
     return subCoder(*this);
 }
 
@@ -627,6 +762,7 @@ bool BottleImpl::isList(int index)
 
 Storable* BottleImpl::pop()
 {
+    dropPacked();
     Storable* stb = nullptr;
     if (size() == 0) {
         stb = new StoreNull();
@@ -676,6 +812,19 @@ void BottleImpl::copyRange(const BottleImpl* alt, size_type first, size_type len
 
     clear();
 
+    if (src->packed) {
+        size_t itemSize = packedItemSize(src->speciality);
+        size_t count = (first < src->size()) ? std::min(len, src->size() - first) : 0;
+        if (count > 0) {
+            auto begin = src->packedItems.begin() + first * itemSize;
+            packedItems.assign(begin, begin + count * itemSize);
+            speciality = src->speciality;
+            packed = true;
+            unpack();
+        }
+        return;
+    }
+
     const size_t last = src->size() - 1;
     for (size_t i = 0; (i < len) && (first + i <= last); ++i) {
         add(src->get(first + i).cloneStorable());
@@ -745,3 +894,113 @@ Value& BottleImpl::findBit(const std::string& key) const
     }
     return get(-1);
 }
+
+
+size_t BottleImpl::packedItemSize(std::int32_t code)
+{
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        return sizeof(std::int8_t);
+    case BOTTLE_TAG_INT16:
+        return sizeof(std::int16_t);
+    case BOTTLE_TAG_INT32:
+        return sizeof(std::int32_t);
+    case BOTTLE_TAG_INT64:
+        return sizeof(std::int64_t);
+    case BOTTLE_TAG_FLOAT32:
+        return sizeof(yarp::conf::float32_t);
+    case BOTTLE_TAG_FLOAT64:
+        return sizeof(yarp::conf::float64_t);
+    default:
+        return 0;
+    }
+}
+
+bool BottleImpl::readPacked(ConnectionReader& reader, std::int32_t len)
+{
+    if (len <= 0) {
+        return true;
+    }
+    size_t length = len * packedItemSize(speciality);
+    if (reader.getSize() != 0 && length > reader.getSize()) {
+        yCError(BOTTLEIMPL, "Reader failed, list of %" PRId32 " items is longer than the message", len);
+        return false;
+    }
+    packedItems.resize(length);
+    if (!reader.expectBlock(packedItems.data(), length)) {
+        packedItems.clear();
+        return false;
+    }
+#if !defined(YARP_LITTLE_ENDIAN)
+    swapItems(packedItems.data(), length, packedItemSize(speciality));
+#endif
+    packed = true;
+    unpack();
+    return true;
+}
+
+void BottleImpl::unpack()
+{
+    size_t itemSize = packedItemSize(speciality);
+    content.reserve(packedItems.size() / itemSize);
+    for (size_t i = 0; i < packedItems.size(); i += itemSize) {
+        const char* item = packedItems.data() + i;
+        Storable* s = reuse(speciality);
+        switch (speciality) {
+        case BOTTLE_TAG_INT8: s = unpackItem<std::int8_t, StoreInt8>(item, s); break;
+        case BOTTLE_TAG_INT16: s = unpackItem<std::int16_t, StoreInt16>(item, s); break;
+        case BOTTLE_TAG_INT32: s = unpackItem<std::int32_t, StoreInt32>(item, s); break;
+        case BOTTLE_TAG_INT64: s = unpackItem<std::int64_t, StoreInt64>(item, s); break;
+        case BOTTLE_TAG_FLOAT32: s = unpackItem<yarp::conf::float32_t, StoreFloat32>(item, s); break;
+        case BOTTLE_TAG_FLOAT64: s = unpackItem<yarp::conf::float64_t, StoreFloat64>(item, s); break;
+        }
+        content.push_back(s);
+    }
+    dirty = true;
+}
+
+bool BottleImpl::packedMatches() const
+{
+    if (!packed) {
+        return false;
+    }
+    size_t itemSize = packedItemSize(speciality);
+    if (content.size() * itemSize != packedItems.size()) {
+        return false;
+    }
+    // The items can be changed in place through get(), without notice
+    const char* item = packedItems.data();
+    for (auto s : content) {
+        if (s->getCode() != speciality) {
+            return false;
+        }
+        bool match = false;
+        switch (speciality) {
+        case BOTTLE_TAG_INT8: match = itemMatches(item, s->asInt8()); break;
+        case BOTTLE_TAG_INT16: match = itemMatches(item, s->asInt16()); break;
+        case BOTTLE_TAG_INT32: match = itemMatches(item, s->asInt32()); break;
+        case BOTTLE_TAG_INT64: match = itemMatches(item, s->asInt64()); break;
+        case BOTTLE_TAG_FLOAT32: match = itemMatches(item, s->asFloat32()); break;
+        case BOTTLE_TAG_FLOAT64: match = itemMatches(item, s->asFloat64()); break;
+        }
+        if (!match) {
+            return false;
+        }
+        item += itemSize;
+    }
+    return true;
+}
+
+void BottleImpl::dropPacked()
+{
+    packedItems.clear();
+    packed = false;
+}
+
+const char* BottleImpl::getPackedItems(std::int32_t code) const
+{
+    if (!packed || speciality != code || packedItems.empty()) {
+        return nullptr;
+    }
+    return packedItems.data();
+}
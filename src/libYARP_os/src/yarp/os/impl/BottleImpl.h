@@ -166,6 +166,7 @@ public:
 
     void hasChanged()
     {
+        dropPacked();
         dirty = true;
     }
 
@@ -179,8 +180,21 @@ public:
     Value& findGroupBit(const std::string& key) const;
     Value& findBit(const std::string& key) const;
 
+    /**
+     * Get the items of a list of numbers of the same type, stored
+     * contiguously.
+     *
+     * @param code the type of the numbers (e.g. BOTTLE_TAG_FLOAT64)
+     * @return the items, or nullptr if the bottle was not received as a
+     *         list of numbers of this type, or if it was modified since.
+     */
+    const char* getPackedItems(std::int32_t code) const;
+
 private:
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<Storable*>) content;
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<Storable*>) spare;
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<char>) packedItems;
+    bool packed;
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<char>) data;
     int speciality;
     bool nested;
@@ -189,6 +203,35 @@ private:
     void add(Storable* s);
     void smartAdd(const std::string& str);
 
+    /*
+     * Reading a message in a bottle does not delete its items, they are kept
+     * as spare items and each one is reused for the item at the same
+     * position of the new message, if it has the same type (recursively for
+     * nested lists).  Reading the same kind of messages in the same bottle,
+     * as BufferedPort does, therefore does not allocate memory after the
+     * first couple of messages.  The spare items that are not reused are
+     * deleted as soon as they do not match, at the next read, and by clear().
+     */
+    void recycle();
+    Storable* reuse(std::int32_t id);
+
+    /*
+     * Lists of numbers of the same type (e.g. the joint positions streamed
+     * by a device) are received as a single block, and are kept as they
+     * are received, in packedItems, for getPackedItems() and to be written
+     * back with a single copy.  The Storables of the items are created
+     * (reusing the spare ones) by unpack() while reading, so that the const
+     * methods never modify the bottle.  Appending an item of the same type
+     * keeps packedItems up to date, any other change drops it.  The items
+     * can still be assigned in place through get(), so packedItems is
+     * written only if packedMatches() confirms that it matches them.
+     */
+    static size_t packedItemSize(std::int32_t code);
+    bool readPacked(ConnectionReader& reader, std::int32_t len);
+    void unpack();
+    bool packedMatches() const;
+    void dropPacked();
+
     /*
      * Bottle is using a lazy synchronization method. Whenever some operation
      * is performed, a dirty flag is set, and when it is used, the synch()
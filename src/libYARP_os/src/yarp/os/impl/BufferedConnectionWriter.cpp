@@ -38,11 +38,13 @@ BufferedConnectionWriter::BufferedConnectionWriter(bool textMode,
         bareMode(bareMode),
         convertTextModePending(false),
         ref(nullptr),
+        refLease(nullptr),
         shouldDrop(false),
         lst_used(0),
         header_used(0),
         target_used(&lst_used),
-        initialPoolSize(BUFFERED_CONNECTION_INITIAL_POOL_SIZE)
+        initialPoolSize(BUFFERED_CONNECTION_INITIAL_POOL_SIZE),
+        messageId(0)
 {
     stopPool();
 }
@@ -60,7 +62,9 @@ void BufferedConnectionWriter::reset(bool textMode)
     clear();
     reader = nullptr;
     ref = nullptr;
+    refLease = nullptr;
     convertTextModePending = false;
+    messageId = 0;
 }
 
 void BufferedConnectionWriter::restart()
@@ -69,7 +73,9 @@ void BufferedConnectionWriter::restart()
     header_used = 0;
     reader = nullptr;
     ref = nullptr;
+    refLease = nullptr;
     convertTextModePending = false;
+    messageId = 0;
     target = &lst;
     target_used = &lst_used;
     stopPool();
@@ -359,14 +365,20 @@ bool BufferedConnectionWriter::write(ConnectionWriter& connection) const
 void BufferedConnectionWriter::write(OutputStream& os)
 {
     stopWrite();
+    // Hand all the blocks to the stream at once, so that streams
+    // supporting scatter-gather writes can send the whole message
+    // without copying external blocks.
+    std::vector<yarp::os::Bytes> blocks;
+    blocks.reserve(header_used + lst_used);
     for (size_t i = 0; i < header_used; i++) {
         yarp::os::ManagedBytes& b = *(header[i]);
-        os.write(b.usedBytes());
+        blocks.push_back(b.usedBytes());
     }
     for (size_t i = 0; i < lst_used; i++) {
         yarp::os::ManagedBytes& b = *(lst[i]);
-        os.write(b.usedBytes());
+        blocks.push_back(b.usedBytes());
     }
+    os.writeBlocks(blocks.data(), blocks.size());
     os.flush();
 }
 
@@ -472,6 +484,30 @@ void BufferedConnectionWriter::setInitialPoolSize(size_t size)
 }
 
 
+void BufferedConnectionWriter::setMessageId(uint64_t id)
+{
+    messageId = id;
+}
+
+
+uint64_t BufferedConnectionWriter::getMessageId() const
+{
+    return messageId;
+}
+
+
+void BufferedConnectionWriter::setReferenceLease(ObjectLease* lease)
+{
+    refLease = lease;
+}
+
+
+ObjectLease* BufferedConnectionWriter::getReferenceLease() const
+{
+    return refLease;
+}
+
+
 std::string BufferedConnectionWriter::toString() const
 {
     stopWrite();
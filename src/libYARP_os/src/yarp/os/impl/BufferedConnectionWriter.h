@@ -13,6 +13,7 @@
 #include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/SizedWriter.h>
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,8 @@ class ManagedBytes;
 
 namespace impl {
 
+class ObjectLease;
+
 /*
  * When allocating space to store serialized data, we start off with
  * a block of this size.  It will be resized as necessary.
@@ -226,6 +229,37 @@ public:
     void setInitialPoolSize(size_t size);
 
 
+    /**
+     * Set the identifier of the message being written.  The same message
+     * sent on several connections has the same identifier, that carriers
+     * can use to share a single copy of the message.
+     *
+     * @param id the identifier (0 if unknown)
+     */
+    void setMessageId(uint64_t id);
+
+    /**
+     * @return the identifier of the message being written, or 0 if unknown
+     */
+    uint64_t getMessageId() const;
+
+
+    /**
+     * Set the lease of the object passed with setReference(), that a
+     * reader in the same process can hold to keep using the object after
+     * the end of the message.
+     *
+     * @param lease the lease (nullptr if the object cannot be kept)
+     */
+    void setReferenceLease(ObjectLease* lease);
+
+    /**
+     * @return the lease of the object passed with setReference(), or
+     *         nullptr
+     */
+    ObjectLease* getReferenceLease() const;
+
+
     /**
      * @return the message serialized as a string
      */
@@ -262,11 +296,13 @@ private:
     bool bareMode;                ///< should we be writing without including type info
     bool convertTextModePending;  ///< will we need to do an automatic textmode conversion
     yarp::os::Portable* ref;      ///< object reference for when serialization can be skipped
+    ObjectLease* refLease;      ///< lease keeping the object reference valid, if any
     bool shouldDrop;              ///< should the connection drop after writes
     size_t lst_used;              ///< how many payload buffers are in use for the current message
     size_t header_used;           ///< how many header buffers are in use for the current message
     size_t* target_used;          ///< points to lst_used of header_used
     size_t initialPoolSize;       ///< size of new pool buffers
+    uint64_t messageId;           ///< identifier of the message, shared by all its connections
 };
 
 
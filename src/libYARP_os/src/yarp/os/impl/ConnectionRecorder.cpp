@@ -156,6 +156,11 @@ yarp::os::Portable* yarp::os::impl::ConnectionRecorder::getReference() const
     return reader->getReference();
 }
 
+yarp::os::PortWriter* yarp::os::impl::ConnectionRecorder::retainReference()
+{
+    return reader->retainReference();
+}
+
 yarp::os::Contact yarp::os::impl::ConnectionRecorder::getRemoteContact() const
 {
     return reader->getRemoteContact();
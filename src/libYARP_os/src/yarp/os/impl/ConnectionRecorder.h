@@ -71,6 +71,7 @@ public:
     size_t getSize() const override;
     yarp::os::ConnectionWriter* getWriter() override;
     yarp::os::Portable* getReference() const override;
+    yarp::os::PortWriter* retainReference() override;
     yarp::os::Contact getRemoteContact() const override;
     yarp::os::Contact getLocalContact() const override;
     bool isValid() const override;
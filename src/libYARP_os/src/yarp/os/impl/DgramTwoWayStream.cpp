@@ -12,7 +12,10 @@
 #include <yarp/conf/system.h>
 #include <yarp/conf/environment.h>
 
+#include <yarp/os/NetInt32.h>
 #include <yarp/os/NetType.h>
+#include <yarp/os/NetUint16.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/LogComponent.h>
 
@@ -38,7 +41,9 @@
 #    include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdint>
 #include <cstring>
 
 using namespace yarp::os::impl;
@@ -47,13 +52,25 @@ using namespace yarp::os;
 #define CRC_SIZE 8
 #define UDP_MAX_DATAGRAM_SIZE (65507 - CRC_SIZE)
 
+// Header of a fragment: crc, message id, message length, data size of the
+// fragments, fragment index, number of data fragments, fec group, padding
+#define FRAGMENT_HEADER_SIZE 24
+#define MAX_FRAGMENTS 65535
+#define MAX_PARTIAL_MESSAGES 4
+#define PARTIAL_MESSAGE_TIMEOUT 1.0
+
+// Datagrams can be sent and received in batches with sendmmsg and recvmmsg
+#if !defined(YARP_HAS_ACE) && defined(__linux__)
+#    define DGRAM_HAS_MMSG
+#endif
+
 
 namespace {
 YARP_OS_LOG_COMPONENT(DGRAMTWOWAYSTREAM, "yarp.os.impl.DgramTwoWayStream")
 } // namespace
 
 
-static bool checkCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t crcLength, int pct, int* store_altPct = nullptr)
+static bool checkCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t crcLength, int pct, int* store_altPct = nullptr, bool* store_crcError = nullptr)
 {
     auto alt = (NetInt32)NetType::getCrc(buf + crcLength,
                                          (length > crcLength) ? (length - crcLength) : 0);
@@ -73,6 +90,9 @@ static bool checkCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t
     if (store_altPct != nullptr) {
         *store_altPct = altPct;
     }
+    if (store_crcError != nullptr) {
+        *store_crcError = (alt != curr);
+    }
 
     return ok;
 }
@@ -89,6 +109,352 @@ static void addCrc(char* buf, yarp::conf::ssize_t length, yarp::conf::ssize_t cr
 }
 
 
+namespace {
+
+struct FragmentHeader
+{
+    NetInt32 crc;
+    NetInt32 id;
+    NetInt32 length;
+    NetInt32 fragmentSize;
+    NetUint16 index;
+    NetUint16 count;
+    NetUint16 group;
+    NetUint16 padding;
+};
+static_assert(sizeof(FragmentHeader) == FRAGMENT_HEADER_SIZE, "unexpected fragment header size");
+
+void addFragmentHeader(char* buf, size_t datagramLength, FragmentHeader header)
+{
+    header.padding = 0;
+    memcpy(buf, &header, sizeof(header));
+    header.crc = static_cast<NetInt32>(NetType::getCrc(buf + sizeof(NetInt32), datagramLength - sizeof(NetInt32)));
+    memcpy(buf, &header.crc, sizeof(NetInt32));
+}
+
+bool checkFragmentHeader(char* buf, size_t datagramLength, FragmentHeader& header)
+{
+    if (datagramLength < FRAGMENT_HEADER_SIZE) {
+        return false;
+    }
+    memcpy(&header, buf, sizeof(header));
+    auto crc = static_cast<NetInt32>(NetType::getCrc(buf + sizeof(NetInt32), datagramLength - sizeof(NetInt32)));
+    return crc == header.crc;
+}
+
+// Difference between message ids, taking care of wrap around
+int32_t idDistance(int32_t id, int32_t from)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(id) - static_cast<uint32_t>(from));
+}
+
+void xorBytes(char* dest, const char* src, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        dest[i] ^= src[i];
+    }
+}
+
+} // namespace
+
+
+/**
+ * Collects the fragments of the messages sent by a fragmenting
+ * DgramTwoWayStream, and rebuilds the messages.
+ */
+class yarp::os::impl::DgramReassembler
+{
+public:
+    /**
+     * Add a fragment.
+     *
+     * @param header the header of the fragment
+     * @param data the data of the fragment
+     * @param length the length of the data
+     * @param[out] message the message completed by the fragment, if any
+     * @return true if a message was completed
+     */
+    bool add(const FragmentHeader& header, const char* data, size_t length, std::vector<char>& message)
+    {
+        const size_t fragmentSize = static_cast<size_t>(header.fragmentSize);
+        const size_t messageLength = static_cast<size_t>(header.length);
+        const size_t count = header.count;
+        const size_t group = header.group;
+        const size_t index = header.index;
+        if (header.length <= 0 || header.fragmentSize <= 0 || count == 0
+            || (messageLength + fragmentSize - 1) / fragmentSize != count) {
+            yCDebug(DGRAMTWOWAYSTREAM, "invalid fragment");
+            droppedPackets++;
+            return false;
+        }
+        const size_t groups = (group > 0) ? (count + group - 1) / group : 0;
+        if (count + groups > MAX_FRAGMENTS || fragmentSize > UDP_MAX_DATAGRAM_SIZE - FRAGMENT_HEADER_SIZE
+            || messageLength > maxMessageSize) {
+            yCDebug(DGRAMTWOWAYSTREAM, "invalid fragment");
+            droppedPackets++;
+            return false;
+        }
+        const size_t expected = (index >= count) ? fragmentSize : dataLength(messageLength, fragmentSize, index);
+        if (index >= count + groups || length != expected) {
+            yCDebug(DGRAMTWOWAYSTREAM, "invalid fragment");
+            droppedPackets++;
+            return false;
+        }
+        if (delivered && idDistance(header.id, lastId) <= 0) {
+            // the fragments of the last message still arriving are not needed
+            if (header.id != lastId) {
+                yCDebug(DGRAMTWOWAYSTREAM, "fragment of an old message %d", static_cast<int>(header.id));
+                droppedPackets++;
+            }
+            return false;
+        }
+
+        const double now = SystemClock::nowSystem();
+        expire(header.id, now);
+        Frame& frame = getFrame(header, groups);
+        if (frame.length != messageLength || frame.fragmentSize != fragmentSize
+            || frame.count != count || frame.group != group) {
+            yCDebug(DGRAMTWOWAYSTREAM, "inconsistent fragment of message %d", static_cast<int>(header.id));
+            droppedPackets++;
+            return false;
+        }
+        if (frame.received[index]) {
+            // already rebuilt, or duplicated by the network
+            return false;
+        }
+        frame.received[index] = true;
+        frame.lastFragment = now;
+        if (index < count) {
+            char* dest = frame.data.data() + index * fragmentSize;
+            memcpy(dest, data, length);
+            // the parity covers zero padded fragments
+            memset(dest + length, 0, fragmentSize - length);
+            frame.missing--;
+        } else {
+            memcpy(frame.parity.data() + (index - count) * fragmentSize, data, length);
+        }
+        if (group > 0) {
+            recover(frame, (index < count) ? index / group : index - count);
+        }
+        if (frame.missing > 0) {
+            return false;
+        }
+
+        // Deliver the message, and forget about the older ones
+        frame.data.resize(messageLength);
+        message.swap(frame.data);
+        delivered = true;
+        lastId = header.id;
+        for (auto& f : frames) {
+            if (f.used && idDistance(f.id, lastId) <= 0) {
+                f.used = false;
+                if (f.id != lastId) {
+                    droppedMessages++;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::atomic<std::uint64_t> droppedPackets {0};
+    std::atomic<std::uint64_t> recoveredPackets {0};
+    std::atomic<std::uint64_t> droppedMessages {0};
+    size_t maxMessageSize {0};
+
+private:
+    struct Frame
+    {
+        bool used {false};
+        int32_t id {0};
+        size_t length {0};
+        size_t fragmentSize {0};
+        size_t count {0};
+        size_t group {0};
+        size_t missing {0};
+        double lastFragment {0};
+        std::vector<char> data;
+        std::vector<char> parity;
+        std::vector<bool> received;
+    };
+
+    Frame& getFrame(const FragmentHeader& header, size_t groups)
+    {
+        Frame* frame = nullptr;
+        for (auto& f : frames) {
+            if (f.used && f.id == header.id) {
+                return f;
+            }
+            if (frame == nullptr && !f.used) {
+                frame = &f;
+            }
+        }
+        if (frame == nullptr) {
+            // Too many partial messages, drop the oldest one
+            frame = &frames[0];
+            for (auto& f : frames) {
+                if (idDistance(f.id, frame->id) < 0) {
+                    frame = &f;
+                }
+            }
+            yCDebug(DGRAMTWOWAYSTREAM, "dropping partial message %d", static_cast<int>(frame->id));
+            droppedMessages++;
+        }
+        frame->used = true;
+        frame->id = header.id;
+        frame->length = static_cast<size_t>(header.length);
+        frame->fragmentSize = static_cast<size_t>(header.fragmentSize);
+        frame->count = header.count;
+        frame->group = header.group;
+        frame->missing = frame->count;
+        frame->data.resize(frame->count * frame->fragmentSize);
+        frame->parity.resize(groups * frame->fragmentSize);
+        frame->received.assign(frame->count + groups, false);
+        return *frame;
+    }
+
+    // Drop the partial messages that stopped receiving fragments
+    void expire(int32_t id, double now)
+    {
+        for (auto& f : frames) {
+            if (f.used && f.id != id && now - f.lastFragment > PARTIAL_MESSAGE_TIMEOUT) {
+                yCDebug(DGRAMTWOWAYSTREAM, "partial message %d timed out", static_cast<int>(f.id));
+                f.used = false;
+                // release the memory of the message
+                std::vector<char>().swap(f.data);
+                std::vector<char>().swap(f.parity);
+                droppedMessages++;
+            }
+        }
+    }
+
+    // Rebuild the fragment of a group that is missing, if it is the only one
+    void recover(Frame& frame, size_t g)
+    {
+        if (!frame.received[frame.count + g]) {
+            return;
+        }
+        const size_t first = g * frame.group;
+        const size_t last = std::min(first + frame.group, frame.count);
+        size_t lost = last;
+        for (size_t i = first; i < last; i++) {
+            if (!frame.received[i]) {
+                if (lost != last) {
+                    return;
+                }
+                lost = i;
+            }
+        }
+        if (lost == last) {
+            return;
+        }
+        char* dest = frame.data.data() + lost * frame.fragmentSize;
+        memcpy(dest, frame.parity.data() + g * frame.fragmentSize, frame.fragmentSize);
+        for (size_t i = first; i < last; i++) {
+            if (i != lost) {
+                xorBytes(dest, frame.data.data() + i * frame.fragmentSize, frame.fragmentSize);
+            }
+        }
+        // The padding is zero unless the fragments do not match the length
+        // of the message
+        const size_t length = dataLength(frame.length, frame.fragmentSize, lost);
+        for (size_t i = length; i < frame.fragmentSize; i++) {
+            if (dest[i] != 0) {
+                yCDebug(DGRAMTWOWAYSTREAM, "fragment %zu of message %d does not match the message length", lost, static_cast<int>(frame.id));
+                droppedPackets++;
+                return;
+            }
+        }
+        frame.received[lost] = true;
+        frame.missing--;
+        recoveredPackets++;
+        yCDebug(DGRAMTWOWAYSTREAM, "recovered fragment %zu of message %d", lost, static_cast<int>(frame.id));
+    }
+
+    // Length of the data carried by a data fragment
+    static size_t dataLength(size_t messageLength, size_t fragmentSize, size_t index)
+    {
+        return std::min(fragmentSize, messageLength - index * fragmentSize);
+    }
+
+    Frame frames[MAX_PARTIAL_MESSAGES];
+    bool delivered {false};
+    int32_t lastId {0};
+};
+
+
+/**
+ * A set of datagrams sent or received with a single system call.
+ */
+class yarp::os::impl::DgramBatch
+{
+public:
+    DgramBatch(size_t capacity, size_t slotSize) :
+            capacity(capacity),
+            slotSize(slotSize),
+            data(capacity * slotSize),
+            lengths(capacity, 0)
+    {
+#if defined(DGRAM_HAS_MMSG)
+        headers.resize(capacity);
+        vectors.resize(capacity);
+        for (size_t i = 0; i < capacity; i++) {
+            vectors[i].iov_base = slot(i);
+            vectors[i].iov_len = slotSize;
+            memset(&headers[i], 0, sizeof(headers[i]));
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+#endif
+    }
+
+    char* slot(size_t i)
+    {
+        return data.data() + i * slotSize;
+    }
+
+#if defined(DGRAM_HAS_MMSG)
+    // Wait for some datagrams, and take all of those available
+    int receive(int fd)
+    {
+        for (size_t i = 0; i < capacity; i++) {
+            vectors[i].iov_len = slotSize;
+        }
+        int n = recvmmsg(fd, headers.data(), static_cast<unsigned int>(capacity), MSG_WAITFORONE, nullptr);
+        used = (n > 0) ? static_cast<size_t>(n) : 0;
+        next = 0;
+        for (size_t i = 0; i < used; i++) {
+            lengths[i] = headers[i].msg_len;
+        }
+        return n;
+    }
+
+    // Send the datagrams from the first one not sent yet
+    int send(int fd)
+    {
+        for (size_t i = next; i < used; i++) {
+            vectors[i].iov_len = lengths[i];
+        }
+        int n = sendmmsg(fd, headers.data() + next, static_cast<unsigned int>(used - next), 0);
+        if (n > 0) {
+            next += static_cast<size_t>(n);
+        }
+        return n;
+    }
+#endif
+
+    const size_t capacity;
+    const size_t slotSize;
+    std::vector<char> data;
+    std::vector<size_t> lengths;
+    size_t used {0};
+    size_t next {0};
+#if defined(DGRAM_HAS_MMSG)
+    std::vector<mmsghdr> headers;
+    std::vector<iovec> vectors;
+#endif
+};
+
+
 bool DgramTwoWayStream::open(const Contact& remote)
 {
 #if defined(YARP_HAS_ACE)
@@ -244,6 +610,16 @@ void DgramTwoWayStream::allocate(int readSize, int writeSize)
 #endif
     }
 
+    std::string _env_batch = yarp::conf::environment::get_string("YARP_DGRAM_BATCH_SIZE");
+    if (!_env_batch.empty()) {
+        setBatchSize(yarp::conf::numeric::from_string<int>(_env_batch));
+    }
+
+    std::string _env_max_message = yarp::conf::environment::get_string("YARP_DGRAM_MAX_MESSAGE_SIZE");
+    if (!_env_max_message.empty()) {
+        setMaxMessageSize(yarp::conf::numeric::from_string<size_t>(_env_max_message));
+    }
+
     readBuffer.allocate(_read_size);
     writeBuffer.allocate(_write_size);
     readAt = 0;
@@ -600,6 +976,70 @@ bool DgramTwoWayStream::join(const Contact& group, bool sender, const Contact& i
 DgramTwoWayStream::~DgramTwoWayStream()
 {
     closeMain();
+    delete reassembler;
+    delete batch;
+}
+
+void DgramTwoWayStream::setBatchSize(int batchSize)
+{
+    if (batchSize < 1) {
+        batchSize = 1;
+    }
+#if !defined(DGRAM_HAS_MMSG)
+    if (batchSize > 1) {
+        yCWarning(DGRAMTWOWAYSTREAM, "Datagrams cannot be sent or received in batches on this system");
+    }
+    batchSize = 1;
+#endif
+    if (batchSize != this->batchSize) {
+        // the batch is allocated when needed
+        sendBatch();
+        delete batch;
+        batch = nullptr;
+        this->batchSize = batchSize;
+    }
+}
+
+DgramTwoWayStream::Statistics DgramTwoWayStream::getStatistics() const
+{
+    Statistics stats;
+    stats.sentPackets = sentPackets.load();
+    stats.sendCalls = sendCalls.load();
+    stats.receivedPackets = receivedPackets.load();
+    stats.receiveCalls = receiveCalls.load();
+    stats.droppedPackets = droppedPackets.load();
+    stats.crcErrors = crcErrors.load();
+    if (reassembler != nullptr) {
+        stats.droppedPackets += reassembler->droppedPackets.load();
+        stats.recoveredPackets = reassembler->recoveredPackets.load();
+        stats.droppedMessages = reassembler->droppedMessages.load();
+    }
+    return stats;
+}
+
+void DgramTwoWayStream::setFragmentation(bool fragmented, int fecGroup, int fragmentSize)
+{
+    this->fragmented = fragmented;
+    this->fecGroup = (fecGroup > 0) ? fecGroup : 0;
+    this->fragmentSize = (fragmentSize > 0) ? fragmentSize : 0;
+    pending.clear();
+    message.clear();
+    messageAt = 0;
+    if (fragmented && reassembler == nullptr) {
+        reassembler = new DgramReassembler;
+        reassembler->maxMessageSize = maxMessageSize;
+    }
+}
+
+void DgramTwoWayStream::setMaxMessageSize(size_t maxMessageSize)
+{
+    if (maxMessageSize == 0) {
+        maxMessageSize = defaultMaxMessageSize;
+    }
+    this->maxMessageSize = maxMessageSize;
+    if (reassembler != nullptr) {
+        reassembler->maxMessageSize = this->maxMessageSize;
+    }
 }
 
 void DgramTwoWayStream::interrupt()
@@ -696,9 +1136,106 @@ void DgramTwoWayStream::closeMain()
     happy = false;
 }
 
+void DgramTwoWayStream::reportDroppedPacket(const char* reason)
+{
+    if (bufferAlertNeeded && !bufferAlerted) {
+        yCError(DGRAMTWOWAYSTREAM, "*** Multicast/UDP packet dropped - %s ***", reason);
+        yCInfo(DGRAMTWOWAYSTREAM, "The UDP/MCAST system buffer limit on your system is low.");
+        yCInfo(DGRAMTWOWAYSTREAM, "You may get packet loss under heavy conditions.");
+#ifdef __linux__
+        yCInfo(DGRAMTWOWAYSTREAM, "To change the buffer limit on linux: sysctl -w net.core.rmem_max=8388608");
+        yCInfo(DGRAMTWOWAYSTREAM, "(Might be something like: sudo /sbin/sysctl -w net.core.rmem_max=8388608)");
+#else
+        yCInfo(DGRAMTWOWAYSTREAM, "To change the limit use: sysctl for Linux/FreeBSD, ndd for Solaris, no for AIX");
+#endif
+        bufferAlerted = true;
+    } else {
+        errCount++;
+        double now = SystemClock::nowSystem();
+        if (now - lastReportTime > 1) {
+            yCError(DGRAMTWOWAYSTREAM, "*** %d datagram packet(s) dropped - %s ***", errCount, reason);
+            lastReportTime = now;
+            errCount = 0;
+        }
+    }
+}
+
+yarp::conf::ssize_t DgramTwoWayStream::receiveDatagram()
+{
+    readData = readBuffer.get();
+
+#if defined(DGRAM_HAS_MMSG)
+    if (batchSize > 1 && dgram != nullptr) {
+        if (batch == nullptr) {
+            batch = new DgramBatch(batchSize, std::min(readBuffer.length(), static_cast<size_t>(UDP_MAX_DATAGRAM_SIZE + CRC_SIZE)));
+        }
+        if (batch->next >= batch->used) {
+            yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
+            int n = batch->receive(dgram_sockfd);
+            receiveCalls++;
+            if (n <= 0) {
+                return -1;
+            }
+            receivedPackets += n;
+            yCDebug(DGRAMTWOWAYSTREAM, "DGRAM Got %d datagrams", n);
+        }
+        readData = batch->slot(batch->next);
+        return static_cast<yarp::conf::ssize_t>(batch->lengths[batch->next++]);
+    }
+#endif
+
+    //yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
+    yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
+    yarp::conf::ssize_t result = -1;
+#if defined(YARP_HAS_ACE)
+    if ((dgram != nullptr) && restrictInterfaceIp.isValid()) {
+        yCTrace(DGRAMTWOWAYSTREAM, "Consider remote mcast");
+        yCTrace(DGRAMTWOWAYSTREAM, "What we know:");
+        yCTrace(DGRAMTWOWAYSTREAM, "  %s", restrictInterfaceIp.toString().c_str());
+        yCTrace(DGRAMTWOWAYSTREAM, "  %s", localAddress.toString().c_str());
+        yCTrace(DGRAMTWOWAYSTREAM, "  %s", remoteAddress.toString().c_str());
+
+        ACE_INET_Addr iface(restrictInterfaceIp.getPort(),
+                            restrictInterfaceIp.getHost().c_str());
+        ACE_INET_Addr dummy((u_short)0, (ACE_UINT32)INADDR_ANY);
+        result = dgram->recv(readBuffer.get(), readBuffer.length(), dummy);
+        yCDebug(DGRAMTWOWAYSTREAM, "MCAST Got %zd bytes", result);
+
+    } else
+#endif
+        if (dgram != nullptr) {
+        yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
+#if defined(YARP_HAS_ACE)
+        ACE_INET_Addr dummy((u_short)0, (ACE_UINT32)INADDR_ANY);
+        yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
+        result = dgram->recv(readBuffer.get(), readBuffer.length(), dummy);
+#else
+        result = recv(dgram_sockfd, readBuffer.get(), readBuffer.length(), 0);
+#endif
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM Got %zd bytes", result);
+    } else {
+        onMonitorInput();
+        //printf("Monitored input of %d bytes\n", monitor.length());
+        if (monitor.length() > readBuffer.length()) {
+            printf("Too big!\n");
+            std::exit(1);
+        }
+        memcpy(readBuffer.get(), monitor.get(), monitor.length());
+        result = monitor.length();
+    }
+    receiveCalls++;
+    if (result >= 0) {
+        receivedPackets++;
+    }
+    return result;
+}
+
 yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 {
     reader = true;
+    if (fragmented) {
+        return readFragmented(b);
+    }
     bool done = false;
 
     while (!done) {
@@ -713,45 +1250,7 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
             readAt = 0;
 
 
-            //yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
-            yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
-            yarp::conf::ssize_t result = -1;
-#if defined(YARP_HAS_ACE)
-            if ((dgram != nullptr) && restrictInterfaceIp.isValid()) {
-                yCTrace(DGRAMTWOWAYSTREAM, "Consider remote mcast");
-                yCTrace(DGRAMTWOWAYSTREAM, "What we know:");
-                yCTrace(DGRAMTWOWAYSTREAM, "  %s", restrictInterfaceIp.toString().c_str());
-                yCTrace(DGRAMTWOWAYSTREAM, "  %s", localAddress.toString().c_str());
-                yCTrace(DGRAMTWOWAYSTREAM, "  %s", remoteAddress.toString().c_str());
-
-                ACE_INET_Addr iface(restrictInterfaceIp.getPort(),
-                                    restrictInterfaceIp.getHost().c_str());
-                ACE_INET_Addr dummy((u_short)0, (ACE_UINT32)INADDR_ANY);
-                result = dgram->recv(readBuffer.get(), readBuffer.length(), dummy);
-                yCDebug(DGRAMTWOWAYSTREAM, "MCAST Got %zd bytes", result);
-
-            } else
-#endif
-                if (dgram != nullptr) {
-                yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
-#if defined(YARP_HAS_ACE)
-                ACE_INET_Addr dummy((u_short)0, (ACE_UINT32)INADDR_ANY);
-                yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
-                result = dgram->recv(readBuffer.get(), readBuffer.length(), dummy);
-#else
-                result = recv(dgram_sockfd, readBuffer.get(), readBuffer.length(), 0);
-#endif
-                yCDebug(DGRAMTWOWAYSTREAM, "DGRAM Got %zd bytes", result);
-            } else {
-                onMonitorInput();
-                //printf("Monitored input of %d bytes\n", monitor.length());
-                if (monitor.length() > readBuffer.length()) {
-                    printf("Too big!\n");
-                    std::exit(1);
-                }
-                memcpy(readBuffer.get(), monitor.get(), monitor.length());
-                result = monitor.length();
-            }
+            yarp::conf::ssize_t result = receiveDatagram();
 
             if (closed || (result < 0)) {
                 happy = false;
@@ -761,30 +1260,16 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 
             // deal with CRC
             int altPct = 0;
-            bool crcOk = checkCrc(readBuffer.get(), readAvail, CRC_SIZE, pct, &altPct);
+            bool crcError = false;
+            bool crcOk = checkCrc(readData, readAvail, CRC_SIZE, pct, &altPct, &crcError);
             if (altPct != -1) {
                 pct++;
                 if (!crcOk) {
-                    if (bufferAlertNeeded && !bufferAlerted) {
-                        yCError(DGRAMTWOWAYSTREAM, "*** Multicast/UDP packet dropped - checksum error ***");
-                        yCInfo(DGRAMTWOWAYSTREAM, "The UDP/MCAST system buffer limit on your system is low.");
-                        yCInfo(DGRAMTWOWAYSTREAM, "You may get packet loss under heavy conditions.");
-#ifdef __linux__
-                        yCInfo(DGRAMTWOWAYSTREAM, "To change the buffer limit on linux: sysctl -w net.core.rmem_max=8388608");
-                        yCInfo(DGRAMTWOWAYSTREAM, "(Might be something like: sudo /sbin/sysctl -w net.core.rmem_max=8388608)");
-#else
-                        yCInfo(DGRAMTWOWAYSTREAM, "To change the limit use: sysctl for Linux/FreeBSD, ndd for Solaris, no for AIX");
-#endif
-                        bufferAlerted = true;
-                    } else {
-                        errCount++;
-                        double now = SystemClock::nowSystem();
-                        if (now - lastReportTime > 1) {
-                            yCError(DGRAMTWOWAYSTREAM, "*** %d datagram packet(s) dropped - checksum error ***", errCount);
-                            lastReportTime = now;
-                            errCount = 0;
-                        }
+                    droppedPackets++;
+                    if (crcError) {
+                        crcErrors++;
                     }
+                    reportDroppedPacket("checksum error");
                     reset();
                     return -1;
                 }
@@ -802,7 +1287,7 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
             if (take > b.length()) {
                 take = b.length();
             }
-            memcpy(b.get(), readBuffer.get() + readAt, take);
+            memcpy(b.get(), readData + readAt, take);
             readAt += take;
             readAvail -= take;
             return take;
@@ -812,6 +1297,47 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
     return 0;
 }
 
+yarp::conf::ssize_t DgramTwoWayStream::readFragmented(Bytes& b)
+{
+    while (true) {
+        if (closed) {
+            happy = false;
+            return -1;
+        }
+
+        // if stuff is available, take it
+        if (messageAt < message.size()) {
+            size_t take = std::min(message.size() - messageAt, b.length());
+            memcpy(b.get(), message.data() + messageAt, take);
+            messageAt += take;
+            return take;
+        }
+
+        yarp::conf::ssize_t result = receiveDatagram();
+        if (closed || (result < 0)) {
+            happy = false;
+            return -1;
+        }
+        if (result == 0 && dgram == nullptr) {
+            // nothing left to read from the monitor
+            return -1;
+        }
+
+        FragmentHeader header;
+        if (!checkFragmentHeader(readData, result, header)) {
+            if (result >= FRAGMENT_HEADER_SIZE) {
+                droppedPackets++;
+                crcErrors++;
+                reportDroppedPacket("checksum error");
+            }
+            continue;
+        }
+        if (reassembler->add(header, readData + FRAGMENT_HEADER_SIZE, result - FRAGMENT_HEADER_SIZE, message)) {
+            messageAt = 0;
+        }
+    }
+}
+
 void DgramTwoWayStream::write(const Bytes& b)
 {
     yCTrace(DGRAMTWOWAYSTREAM, "DGRAM prep writing");
@@ -824,6 +1350,12 @@ void DgramTwoWayStream::write(const Bytes& b)
         return;
     }
 
+    if (fragmented) {
+        // the message is sent at the end of the packet
+        pending.insert(pending.end(), b.get(), b.get() + b.length());
+        return;
+    }
+
     Bytes local = b;
     while (local.length() > 0) {
         yCTrace(DGRAMTWOWAYSTREAM, "DGRAM prep writing");
@@ -838,9 +1370,83 @@ void DgramTwoWayStream::write(const Bytes& b)
         writeAvail += rem;
         local = Bytes(local.get() + rem, local.length() - rem);
         if (shouldFlush) {
-            flush();
+            flushDatagram();
+        }
+    }
+}
+
+
+yarp::conf::ssize_t DgramTwoWayStream::sendDatagram(char* buf, yarp::conf::ssize_t length)
+{
+#if defined(DGRAM_HAS_MMSG)
+    if (batchSize > 1 && dgram != nullptr) {
+        // queue the datagram, it is sent with the batch
+        if (batch == nullptr) {
+            batch = new DgramBatch(batchSize, writeBuffer.length());
+        }
+        memcpy(batch->slot(batch->used), buf, length);
+        batch->lengths[batch->used++] = length;
+        if (batch->used == batch->capacity) {
+            sendBatch();
         }
+        return happy ? length : -1;
     }
+#endif
+
+    //yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
+    yarp::conf::ssize_t len = 0;
+
+#if defined(YARP_HAS_ACE)
+    if (mgram != nullptr) {
+        len = mgram->send(buf, length);
+        yCDebug(DGRAMTWOWAYSTREAM, "MCAST - wrote %zd bytes", len);
+    } else
+#endif
+        if (dgram != nullptr) {
+#if defined(YARP_HAS_ACE)
+        len = dgram->send(buf, length, remoteHandle);
+#else
+        len = send(dgram_sockfd, buf, length, 0);
+#endif
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM - wrote %zd bytes to %s", len, remoteAddress.toString().c_str());
+    } else {
+        Bytes b(buf, length);
+        monitor = ManagedBytes(b, false);
+        monitor.copy();
+        //printf("Monitored output of %d bytes\n", monitor.length());
+        len = monitor.length();
+        onMonitorOutput();
+    }
+    sendCalls++;
+    if (len >= 0) {
+        sentPackets++;
+    }
+    if (len > writeBuffer.length() * 0.75) {
+        yCDebug(DGRAMTWOWAYSTREAM, "long dgrams might need a little time");
+
+        // Under heavy loads, packets could get dropped
+        // 640x480x3 images correspond to about 15 datagrams
+        // so there's not much time possible between them
+        // looked at iperf, it just does a busy-waiting delay
+        // there's an implementation below, but commented out -
+        // better solution was to increase recv buffer size
+
+        double first = yarp::os::SystemClock::nowSystem();
+        double now;
+        int ct = 0;
+        do {
+            //printf("Busy wait... %d\n", ct);
+            yarp::os::SystemClock::delaySystem(0);
+            now = yarp::os::SystemClock::nowSystem();
+            ct++;
+        } while (now - first < 0.001);
+    }
+
+    if (len < 0) {
+        happy = false;
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM failed to send message with error: %s", strerror(errno));
+    }
+    return len;
 }
 
 
@@ -850,6 +1456,56 @@ void DgramTwoWayStream::flush()
         return;
     }
 
+    if (fragmented) {
+        // inside a packet, wait for the whole message
+        if (!inPacket) {
+            flushFragments();
+        }
+        return;
+    }
+
+    flushDatagram();
+    sendBatch();
+}
+
+
+void DgramTwoWayStream::sendBatch()
+{
+#if defined(DGRAM_HAS_MMSG)
+    if (batch == nullptr || batch->used == 0 || dgram == nullptr) {
+        return;
+    }
+    bool longDgrams = false;
+    for (size_t i = 0; i < batch->used; i++) {
+        longDgrams = longDgrams || (batch->lengths[i] > writeBuffer.length() * 0.75);
+    }
+    while (batch->next < batch->used) {
+        int n = batch->send(dgram_sockfd);
+        sendCalls++;
+        if (n <= 0) {
+            happy = false;
+            yCDebug(DGRAMTWOWAYSTREAM, "DGRAM failed to send messages with error: %s", strerror(errno));
+            break;
+        }
+        sentPackets += n;
+        yCDebug(DGRAMTWOWAYSTREAM, "DGRAM - wrote %d datagrams to %s", n, remoteAddress.toString().c_str());
+    }
+    batch->used = 0;
+    batch->next = 0;
+
+    if (longDgrams) {
+        // see sendDatagram(), once per batch
+        double first = yarp::os::SystemClock::nowSystem();
+        do {
+            yarp::os::SystemClock::delaySystem(0);
+        } while (yarp::os::SystemClock::nowSystem() - first < 0.001);
+    }
+#endif
+}
+
+
+void DgramTwoWayStream::flushDatagram()
+{
     // should set CRC
     if (writeAvail <= CRC_SIZE) {
         return;
@@ -858,54 +1514,8 @@ void DgramTwoWayStream::flush()
     pct++;
 
     if (writeAvail > 0) {
-        //yCAssert(DGRAMTWOWAYSTREAM, dgram != nullptr);
-        yarp::conf::ssize_t len = 0;
-
-#if defined(YARP_HAS_ACE)
-        if (mgram != nullptr) {
-            len = mgram->send(writeBuffer.get(), writeAvail);
-            yCDebug(DGRAMTWOWAYSTREAM, "MCAST - wrote %zd bytes", len);
-        } else
-#endif
-            if (dgram != nullptr) {
-#if defined(YARP_HAS_ACE)
-            len = dgram->send(writeBuffer.get(), writeAvail, remoteHandle);
-#else
-            len = send(dgram_sockfd, writeBuffer.get(), writeAvail, 0);
-#endif
-            yCDebug(DGRAMTWOWAYSTREAM, "DGRAM - wrote %zd bytes to %s", len, remoteAddress.toString().c_str());
-        } else {
-            Bytes b(writeBuffer.get(), writeAvail);
-            monitor = ManagedBytes(b, false);
-            monitor.copy();
-            //printf("Monitored output of %d bytes\n", monitor.length());
-            len = monitor.length();
-            onMonitorOutput();
-        }
-        if (len > writeBuffer.length() * 0.75) {
-            yCDebug(DGRAMTWOWAYSTREAM, "long dgrams might need a little time");
-
-            // Under heavy loads, packets could get dropped
-            // 640x480x3 images correspond to about 15 datagrams
-            // so there's not much time possible between them
-            // looked at iperf, it just does a busy-waiting delay
-            // there's an implementation below, but commented out -
-            // better solution was to increase recv buffer size
-
-            double first = yarp::os::SystemClock::nowSystem();
-            double now;
-            int ct = 0;
-            do {
-                //printf("Busy wait... %d\n", ct);
-                yarp::os::SystemClock::delaySystem(0);
-                now = yarp::os::SystemClock::nowSystem();
-                ct++;
-            } while (now - first < 0.001);
-        }
-
+        yarp::conf::ssize_t len = sendDatagram(writeBuffer.get(), writeAvail);
         if (len < 0) {
-            happy = false;
-            yCDebug(DGRAMTWOWAYSTREAM, "DGRAM failed to send message with error: %s", strerror(errno));
             return;
         }
         writeAvail -= len;
@@ -923,6 +1533,63 @@ void DgramTwoWayStream::flush()
 }
 
 
+void DgramTwoWayStream::flushFragments()
+{
+    if (pending.empty()) {
+        return;
+    }
+
+    size_t payload = writeBuffer.length() - FRAGMENT_HEADER_SIZE;
+    if (fragmentSize > 0 && static_cast<size_t>(fragmentSize) < payload) {
+        payload = fragmentSize;
+    }
+    const size_t count = (pending.size() + payload - 1) / payload;
+    const size_t group = static_cast<size_t>(fecGroup);
+    const size_t groups = (group > 0) ? (count + group - 1) / group : 0;
+    if (count + groups > MAX_FRAGMENTS) {
+        // the parity fragments are indexed after the data fragments
+        yCError(DGRAMTWOWAYSTREAM, "Message of %zu bytes dropped, it needs more than %d fragments", pending.size(), MAX_FRAGMENTS);
+        pending.clear();
+        return;
+    }
+    parity.resize(payload);
+
+    FragmentHeader header;
+    header.id = ++messageId;
+    header.length = static_cast<NetInt32>(pending.size());
+    header.fragmentSize = static_cast<NetInt32>(payload);
+    header.count = static_cast<NetUint16>(count);
+    header.group = static_cast<NetUint16>(group);
+
+    char* buf = writeBuffer.get();
+    for (size_t i = 0; i < count && happy; i++) {
+        const size_t len = std::min(payload, pending.size() - i * payload);
+        char* data = pending.data() + i * payload;
+        memcpy(buf + FRAGMENT_HEADER_SIZE, data, len);
+        header.index = static_cast<NetUint16>(i);
+        addFragmentHeader(buf, FRAGMENT_HEADER_SIZE + len, header);
+        sendDatagram(buf, FRAGMENT_HEADER_SIZE + len);
+
+        if (group == 0) {
+            continue;
+        }
+        // The parity of a group is sent after its last fragment
+        if (i % group == 0) {
+            std::fill(parity.begin(), parity.end(), 0);
+        }
+        xorBytes(parity.data(), data, len);
+        if (i % group == group - 1 || i == count - 1) {
+            memcpy(buf + FRAGMENT_HEADER_SIZE, parity.data(), payload);
+            header.index = static_cast<NetUint16>(count + i / group);
+            addFragmentHeader(buf, FRAGMENT_HEADER_SIZE + payload, header);
+            sendDatagram(buf, FRAGMENT_HEADER_SIZE + payload);
+        }
+    }
+    pending.clear();
+    sendBatch();
+}
+
+
 bool DgramTwoWayStream::isOk() const
 {
     return happy;
@@ -942,6 +1609,14 @@ void DgramTwoWayStream::beginPacket()
 {
 //     yCError(DGRAMTWOWAYSTREAM, "Packet begins: %s", (reader ? "reader" : "writer"));
     pct = 0;
+    if (fragmented) {
+        if (reader) {
+            // skip what is left of the previous message
+            messageAt = message.size();
+        } else {
+            inPacket = true;
+        }
+    }
 }
 
 void DgramTwoWayStream::endPacket()
@@ -949,6 +1624,10 @@ void DgramTwoWayStream::endPacket()
 //     yCError(DGRAMTWOWAYSTREAM, "Packet ends: %s", (reader ? "reader" : "writer"));
     if (!reader) {
         pct = 0;
+        if (fragmented) {
+            inPacket = false;
+            flushFragments();
+        }
     }
 }
 
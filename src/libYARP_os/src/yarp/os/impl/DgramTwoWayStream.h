@@ -13,8 +13,11 @@
 #include <yarp/os/ManagedBytes.h>
 #include <yarp/os/TwoWayStream.h>
 
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
 #include <mutex>
+#include <vector>
 
 #ifdef YARP_HAS_ACE
 #    include <ace/SOCK_Dgram.h>
@@ -29,6 +32,9 @@ namespace yarp {
 namespace os {
 namespace impl {
 
+class DgramBatch;
+class DgramReassembler;
+
 /**
  * A stream abstraction for datagram communication.  It supports UDP and
  * MCAST.  This class is not concerned with making the stream reliable.
@@ -59,7 +65,24 @@ public:
             bufferAlerted(false),
             multiMode(false),
             errCount(0),
-            lastReportTime(0)
+            lastReportTime(0),
+            fragmented(false),
+            fecGroup(0),
+            fragmentSize(0),
+            inPacket(false),
+            messageId(0),
+            messageAt(0),
+            reassembler(nullptr),
+            maxMessageSize(defaultMaxMessageSize),
+            batchSize(1),
+            batch(nullptr),
+            readData(nullptr),
+            sentPackets(0),
+            sendCalls(0),
+            receivedPackets(0),
+            receiveCalls(0),
+            droppedPackets(0),
+            crcErrors(0)
     {
     }
 
@@ -159,6 +182,79 @@ public:
     {
     }
 
+    /**
+     * Send each message as a set of fragments, reassembled by the reader.
+     *
+     * In this mode a message is sent only when it is complete, split in
+     * fragments tagged with the identifier of the message.  The reader
+     * delivers complete messages only, in order, and drops the partial
+     * messages older than the last one delivered.  A parity fragment
+     * every \a fecGroup fragments allows the reader to rebuild one lost
+     * fragment of the group.
+     *
+     * @param fragmented true to enable the fragmentation
+     * @param fecGroup number of fragments protected by a parity fragment
+     *                 (0 to send no parity fragments)
+     * @param fragmentSize maximum size of the data of a fragment
+     *                     (0 to use the whole datagram size)
+     */
+    void setFragmentation(bool fragmented, int fecGroup = 0, int fragmentSize = 0);
+
+    /**
+     * Set the maximum length of the messages rebuilt from the fragments.
+     * The fragments of longer messages are dropped before allocating any
+     * memory for them; partial messages that receive no fragments for one
+     * second are dropped too.  The default value (32 MiB) can be set with
+     * the YARP_DGRAM_MAX_MESSAGE_SIZE environment variable.
+     *
+     * @param maxMessageSize the maximum length of a message, in bytes
+     *                       (0 to use the default value)
+     */
+    void setMaxMessageSize(size_t maxMessageSize);
+
+    size_t getMaxMessageSize() const
+    {
+        return maxMessageSize;
+    }
+
+    bool isFragmented() const
+    {
+        return fragmented;
+    }
+
+    /**
+     * Set the number of datagrams sent or received with a single system
+     * call.  Batching is available on Linux only, elsewhere datagrams are
+     * always handled one by one.  The default value can be set with the
+     * YARP_DGRAM_BATCH_SIZE environment variable.
+     *
+     * @param batchSize the maximum number of datagrams per system call
+     *                  (1 to disable the batching)
+     */
+    void setBatchSize(int batchSize);
+
+    int getBatchSize() const
+    {
+        return batchSize;
+    }
+
+    /**
+     * Counters of the datagrams handled by the stream.
+     */
+    struct Statistics
+    {
+        std::uint64_t sentPackets {0};       ///< datagrams sent
+        std::uint64_t sendCalls {0};         ///< system calls used to send them
+        std::uint64_t receivedPackets {0};   ///< datagrams received
+        std::uint64_t receiveCalls {0};      ///< system calls used to receive them
+        std::uint64_t droppedPackets {0};    ///< datagrams received and discarded
+        std::uint64_t crcErrors {0};         ///< datagrams with a checksum error
+        std::uint64_t recoveredPackets {0};  ///< fragments rebuilt from the parity fragments
+        std::uint64_t droppedMessages {0};   ///< partial messages dropped
+    };
+
+    Statistics getStatistics() const;
+
 private:
     yarp::os::ManagedBytes monitor;
     bool closed, interrupting, reader;
@@ -183,10 +279,45 @@ private:
     bool multiMode;
     int errCount;
     double lastReportTime;
+    bool fragmented;
+    int fecGroup;
+    int fragmentSize;
+    bool inPacket;
+    int messageId;
+    std::vector<char> pending;
+    std::vector<char> parity;
+    std::vector<char> message;
+    size_t messageAt;
+    DgramReassembler* reassembler;
+    static constexpr size_t defaultMaxMessageSize = 32 * 1024 * 1024;
+    size_t maxMessageSize;
+    int batchSize;
+    DgramBatch* batch;
+    char* readData;
+    std::atomic<std::uint64_t> sentPackets;
+    std::atomic<std::uint64_t> sendCalls;
+    std::atomic<std::uint64_t> receivedPackets;
+    std::atomic<std::uint64_t> receiveCalls;
+    std::atomic<std::uint64_t> droppedPackets;
+    std::atomic<std::uint64_t> crcErrors;
 
     void allocate(int readSize = 0, int writeSize = 0);
 
     void configureSystemBuffers();
+
+    void reportDroppedPacket(const char* reason);
+
+    yarp::conf::ssize_t receiveDatagram();
+
+    yarp::conf::ssize_t sendDatagram(char* buf, yarp::conf::ssize_t length);
+
+    yarp::conf::ssize_t readFragmented(yarp::os::Bytes& b);
+
+    void flushFragments();
+
+    void flushDatagram();
+
+    void sendBatch();
 };
 
 } // namespace impl
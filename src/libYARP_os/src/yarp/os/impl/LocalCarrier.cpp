@@ -10,12 +10,18 @@
 #include <yarp/os/impl/LocalCarrier.h>
 
 #include <yarp/os/ConnectionState.h>
+#include <yarp/os/Contactable.h>
 #include <yarp/os/Portable.h>
 #include <yarp/os/Route.h>
 #include <yarp/os/SizedWriter.h>
+#include <yarp/os/Type.h>
 
+#include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace yarp::os;
 
 namespace {
@@ -101,8 +107,10 @@ bool yarp::os::impl::LocalCarrierStream::setTypeOfService(int tos)
 
 yarp::conf::ssize_t yarp::os::impl::LocalCarrierStream::read(yarp::os::Bytes& b)
 {
-    yCAssert(LOCALCARRIER, false);
-    return b.length();
+    if (owner == nullptr || sender) {
+        return -1;
+    }
+    return owner->readMessage(b);
 }
 
 void yarp::os::impl::LocalCarrierStream::write(const yarp::os::Bytes& b)
@@ -148,6 +156,9 @@ yarp::os::impl::LocalCarrier::LocalCarrier() :
         peerMutex(), sent(0), received(0)
 {
     ref = nullptr;
+    lease = nullptr;
+    messageOffset = 0;
+    messageReady = false;
     peer = nullptr;
     doomed = false;
 }
@@ -183,6 +194,8 @@ void yarp::os::impl::LocalCarrier::shutdown()
             wasPeer->removePeer();
         }
         peerMutex.unlock();
+        // wake up a sender waiting for the end of a message
+        received.post();
     }
 }
 
@@ -193,7 +206,9 @@ std::string yarp::os::impl::LocalCarrier::getName() const
 
 bool yarp::os::impl::LocalCarrier::requireAck() const
 {
-    return false;
+    // The acknowledgement tells the sender that the receiver is done
+    // with the message (see sendAck())
+    return true;
 }
 
 bool yarp::os::impl::LocalCarrier::isConnectionless() const
@@ -299,9 +314,12 @@ bool yarp::os::impl::LocalCarrier::write(ConnectionState& proto, SizedWriter& wr
     YARP_UNUSED(proto);
     yarp::os::Portable* ref = writer.getReference();
     if (ref != nullptr) {
+        // The lease is set if the object can be shared with the receiver
+        auto* buf = dynamic_cast<BufferedConnectionWriter*>(&writer);
+        ObjectLease* lease = (buf != nullptr) ? buf->getReferenceLease() : nullptr;
         peerMutex.lock();
         if (peer != nullptr) {
-            peer->accept(ref);
+            peer->accept(ref, lease);
         } else {
             yCError(LOCALCARRIER, "local send failed - write without peer");
         }
@@ -332,22 +350,50 @@ bool yarp::os::impl::LocalCarrier::expectIndex(ConnectionState& proto)
     yCDebug(LOCALCARRIER, "local recv: wait send");
     sent.wait();
     yCDebug(LOCALCARRIER, "local recv: got send");
-    proto.setReference(ref);
-    received.post();
-    if (ref != nullptr) {
-        yCDebug(LOCALCARRIER, "local recv: received");
-    } else {
+    message.clear();
+    messageOffset = 0;
+    messageReady = false;
+    if (ref == nullptr) {
         yCDebug(LOCALCARRIER, "local recv: shutdown");
         proto.is().interrupt();
         return false;
     }
 
+    if (lease != nullptr && checkType(proto)) {
+        yCDebug(LOCALCARRIER, "local recv: received reference");
+        proto.setReference(ref);
+    } else {
+        // The sender may modify the object as soon as the message is
+        // read, or the receiver expects a different type: copy it.
+        yCDebug(LOCALCARRIER, "local recv: received copy");
+        serialize();
+        proto.setRemainingLength(static_cast<int>(message.length()));
+    }
+
+    return true;
+}
+
+bool yarp::os::impl::LocalCarrier::sendAck(ConnectionState& proto)
+{
+    YARP_UNUSED(proto);
+    yCDebug(LOCALCARRIER, "local recv: done");
+    ref = nullptr;
+    lease = nullptr;
+    received.post();
+    return true;
+}
+
+bool yarp::os::impl::LocalCarrier::expectAck(ConnectionState& proto)
+{
+    // accept() already waited for the receiver
+    YARP_UNUSED(proto);
     return true;
 }
 
-void yarp::os::impl::LocalCarrier::accept(yarp::os::Portable* ref)
+void yarp::os::impl::LocalCarrier::accept(yarp::os::Portable* ref, ObjectLease* lease)
 {
     this->ref = ref;
+    this->lease = lease;
     yCDebug(LOCALCARRIER, "local send: send ref");
     sent.post();
     if (ref != nullptr && !doomed) {
@@ -356,3 +402,58 @@ void yarp::os::impl::LocalCarrier::accept(yarp::os::Portable* ref)
         yCDebug(LOCALCARRIER, "local send: received");
     }
 }
+
+yarp::os::impl::ObjectLease* yarp::os::impl::LocalCarrier::retainReference()
+{
+    if (lease == nullptr) {
+        return nullptr;
+    }
+    lease->retain();
+    return lease;
+}
+
+yarp::conf::ssize_t yarp::os::impl::LocalCarrier::readMessage(yarp::os::Bytes& b)
+{
+    if (!messageReady) {
+        // The reader does not use the reference
+        serialize();
+    }
+    size_t len = std::min(b.length(), message.length() - messageOffset);
+    if (len == 0) {
+        return -1;
+    }
+    memcpy(b.get(), message.data() + messageOffset, len);
+    messageOffset += len;
+    return static_cast<yarp::conf::ssize_t>(len);
+}
+
+bool yarp::os::impl::LocalCarrier::checkType(ConnectionState& proto) const
+{
+    Contactable* port = proto.getContactable();
+    if (port == nullptr) {
+        return true;
+    }
+    // Ports store the type of their messages by its name on wire
+    auto typeName = [](const Type& type) {
+        std::string name = type.getNameOnWire();
+        return name.empty() ? type.getName() : name;
+    };
+    std::string readType = typeName(port->getType());
+    std::string writeType = typeName(ref->getType());
+    if (readType.empty() || writeType.empty()) {
+        // Nothing to compare, trust the user
+        return true;
+    }
+    return readType == writeType;
+}
+
+void yarp::os::impl::LocalCarrier::serialize()
+{
+    BufferedConnectionWriter writer;
+    if (ref != nullptr) {
+        ref->write(writer);
+    }
+    message = writer.toString();
+    messageOffset = 0;
+    messageReady = true;
+}
@@ -16,8 +16,10 @@
 #include <yarp/os/Portable.h>
 #include <yarp/os/Semaphore.h>
 #include <yarp/os/TwoWayStream.h>
+#include <yarp/os/impl/ObjectLease.h>
 
 #include <mutex>
+#include <string>
 
 namespace yarp {
 namespace os {
@@ -85,6 +87,15 @@ private:
 
 /**
  * A carrier for communicating locally within a process.
+ *
+ * The object being sent is handed over to the receiving port, without
+ * serializing it, if its type matches the type of the port and if the
+ * sender allows it to be shared (see ObjectLease).  Readers
+ * can keep the object after the end of the message with
+ * ConnectionReader::retainReference().  In all other cases, and for the
+ * readers that do not use the reference, the receiver reads a serialized
+ * copy of the object.  The sender waits until the receiver is done with
+ * the message.
  */
 class LocalCarrier :
         public AbstractCarrier
@@ -113,14 +124,36 @@ public:
     bool respondToHeader(ConnectionState& proto) override;
     bool expectReplyToHeader(ConnectionState& proto) override;
     bool expectIndex(ConnectionState& proto) override;
+    bool sendAck(ConnectionState& proto) override;
+    bool expectAck(ConnectionState& proto) override;
 
     void removePeer();
     void shutdown();
-    void accept(yarp::os::Portable* ref);
+    void accept(yarp::os::Portable* ref, ObjectLease* lease = nullptr);
+
+    /**
+     * Keep the object being received valid after the end of the message.
+     *
+     * @return the lease to release, or nullptr if the object cannot be
+     *         kept
+     */
+    ObjectLease* retainReference() override;
+
+    /**
+     * Read the serialized copy of the object being received.
+     */
+    yarp::conf::ssize_t readMessage(yarp::os::Bytes& b);
 
 protected:
+    bool checkType(ConnectionState& proto) const;
+    void serialize();
+
     bool doomed;
     yarp::os::Portable* ref;
+    ObjectLease* lease;
+    std::string message;
+    size_t messageOffset;
+    bool messageReady;
     LocalCarrier* peer;
     std::mutex peerMutex;
     yarp::os::Semaphore sent;
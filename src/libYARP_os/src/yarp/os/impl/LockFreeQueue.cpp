@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/LockFreeQueue.h>
+
+#include <yarp/os/SystemClock.h>
+
+#if defined(__linux__)
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    include <climits>
+#    include <cmath>
+#    include <ctime>
+#else
+#    include <chrono>
+#endif
+
+using namespace yarp::os::impl;
+
+/*
+ * The queue is the bounded MPMC queue described by Dmitry Vyukov: each cell
+ * has a sequence number telling whether it is ready to be written (sequence
+ * equal to the enqueue position) or to be read (sequence equal to the
+ * dequeue position + 1).
+ */
+
+LockFreeQueue::LockFreeQueue(size_t capacity) :
+        m_buffer(nullptr),
+        m_mask(0),
+        m_enqueuePos(0),
+        m_dequeuePos(0),
+        m_interrupts(0),
+        m_spaceInterrupted(false)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_buffer = new Cell[size];
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+        m_buffer[i].data = nullptr;
+    }
+}
+
+
+LockFreeQueue::~LockFreeQueue()
+{
+    delete[] m_buffer;
+}
+
+
+bool LockFreeQueue::push(void* item)
+{
+    Cell* cell;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_buffer[pos & m_mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->data = item;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    notify(m_itemEvent);
+    return true;
+}
+
+
+void* LockFreeQueue::pop()
+{
+    Cell* cell;
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_buffer[pos & m_mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    void* item = cell->data;
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    notify(m_spaceEvent);
+    return item;
+}
+
+
+size_t LockFreeQueue::size() const
+{
+    size_t dequeuePos = m_dequeuePos.load(std::memory_order_acquire);
+    size_t enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+    if (enqueuePos <= dequeuePos) {
+        return 0;
+    }
+    size_t count = enqueuePos - dequeuePos;
+    return (count > capacity()) ? capacity() : count;
+}
+
+
+size_t LockFreeQueue::capacity() const
+{
+    return m_mask + 1;
+}
+
+
+bool LockFreeQueue::hasItem() const
+{
+    // A cell is readable once its sequence is the dequeue position + 1
+    size_t pos = m_dequeuePos.load(std::memory_order_acquire);
+    return m_buffer[pos & m_mask].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+
+bool LockFreeQueue::hasSpace() const
+{
+    // A cell is writable once its sequence is the enqueue position
+    size_t pos = m_enqueuePos.load(std::memory_order_acquire);
+    return m_buffer[pos & m_mask].sequence.load(std::memory_order_acquire) == pos;
+}
+
+
+bool LockFreeQueue::waitForItem(double timeout)
+{
+    return wait(m_itemEvent, timeout, true);
+}
+
+
+bool LockFreeQueue::waitForSpace(double timeout)
+{
+    return wait(m_spaceEvent, timeout, false);
+}
+
+
+void LockFreeQueue::interrupt()
+{
+    m_interrupts.fetch_add(1);
+    notify(m_itemEvent);
+    m_spaceInterrupted.store(true);
+    notify(m_spaceEvent);
+}
+
+
+void LockFreeQueue::resume()
+{
+    if (m_spaceInterrupted.load(std::memory_order_relaxed)) {
+        m_spaceInterrupted.store(false);
+    }
+}
+
+
+bool LockFreeQueue::checkInterrupt()
+{
+    int pending = m_interrupts.load();
+    while (pending > 0) {
+        if (m_interrupts.compare_exchange_weak(pending, pending - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool LockFreeQueue::wait(Event& event, double timeout, bool forItem)
+{
+    auto ready = [&]() {
+        if (forItem) {
+            return hasItem() || m_interrupts.load() > 0;
+        }
+        return hasSpace() || m_spaceInterrupted.load();
+    };
+
+    auto result = [&]() {
+        // an interrupted wait for space fails
+        return forItem ? ready() : hasSpace();
+    };
+
+    if (ready()) {
+        return result();
+    }
+
+    double deadline = SystemClock::nowSystem() + timeout;
+
+    // The counter of waiters is incremented before checking the state of
+    // the queue for the last time, and notify() checks the counter after
+    // changing that state: either the waiter sees the change, or the
+    // notifier sees the waiter.
+    event.waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t seq = event.sequence.load();
+    while (!ready()) {
+        double remaining = -1;
+        if (timeout >= 0) {
+            remaining = deadline - SystemClock::nowSystem();
+            if (remaining <= 0) {
+                break;
+            }
+        }
+#if defined(__linux__)
+        static_assert(sizeof(event.sequence) == sizeof(uint32_t), "std::atomic<uint32_t> cannot be used as a futex");
+        struct timespec ts;
+        struct timespec* pts = nullptr;
+        if (remaining >= 0) {
+            double sec = std::floor(remaining);
+            ts.tv_sec = static_cast<time_t>(sec);
+            ts.tv_nsec = static_cast<long>((remaining - sec) * 1e9);
+            pts = &ts;
+        }
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&event.sequence), FUTEX_WAIT_PRIVATE, seq, pts, nullptr, 0);
+#else
+        std::unique_lock<std::mutex> lock(event.mutex);
+        auto changed = [&]() { return event.sequence.load() != seq; };
+        if (remaining >= 0) {
+            event.cv.wait_for(lock, std::chrono::duration<double>(remaining), changed);
+        } else {
+            event.cv.wait(lock, changed);
+        }
+#endif
+        seq = event.sequence.load();
+    }
+    event.waiters.fetch_sub(1);
+    return result();
+}
+
+
+void LockFreeQueue::notify(Event& event)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (event.waiters.load() == 0) {
+        // Nobody is waiting, no system call
+        return;
+    }
+#if defined(__linux__)
+    event.sequence.fetch_add(1);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&event.sequence), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    {
+        std::lock_guard<std::mutex> lock(event.mutex);
+        event.sequence.fetch_add(1);
+    }
+    event.cv.notify_all();
+#endif
+}
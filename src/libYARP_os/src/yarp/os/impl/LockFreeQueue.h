@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_LOCKFREEQUEUE_H
+#define YARP_OS_IMPL_LOCKFREEQUEUE_H
+
+#include <yarp/os/api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(__linux__)
+#    include <condition_variable>
+#    include <mutex>
+#endif
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * A bounded, lock-free, multi-producer multi-consumer queue of pointers.
+ *
+ * push() and pop() never block and never allocate memory.  Threads that
+ * need to wait for an item (or for some space) can use waitForItem() (or
+ * waitForSpace()).  Waiting uses a futex on Linux (a condition variable
+ * elsewhere), and the cost of waking up a thread is paid by push() and
+ * pop() only when some thread is actually waiting.
+ */
+class YARP_os_impl_API LockFreeQueue
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param capacity the maximum number of items in the queue, rounded up
+     *                 to the next power of two
+     */
+    explicit LockFreeQueue(size_t capacity);
+
+    virtual ~LockFreeQueue();
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    /**
+     * Add an item at the end of the queue.
+     *
+     * @param item the item to add (must not be nullptr)
+     * @return false if the queue is full
+     */
+    bool push(void* item);
+
+    /**
+     * Remove the item at the front of the queue.
+     *
+     * @return the item, or nullptr if the queue is empty
+     */
+    void* pop();
+
+    /**
+     * @return the number of items in the queue.  The result is only
+     * indicative if other threads are using the queue.
+     */
+    size_t size() const;
+
+    /**
+     * @return the maximum number of items in the queue
+     */
+    size_t capacity() const;
+
+    /**
+     * Wait until the queue is not empty, or it is interrupted.
+     *
+     * @param timeout maximum time to wait in seconds (negative = forever)
+     * @return true if the queue is not empty or it was interrupted, false
+     *         on timeout
+     */
+    bool waitForItem(double timeout = -1);
+
+    /**
+     * Wait until the queue is not full, or it is interrupted.
+     *
+     * @param timeout maximum time to wait in seconds (negative = forever)
+     * @return true if the queue is not full, false on timeout or if it
+     *         was interrupted
+     */
+    bool waitForSpace(double timeout = -1);
+
+    /**
+     * Wake up a thread waiting in waitForItem(), even if the queue is
+     * empty.  Interruptions are counted, and each of them makes a call
+     * to waitForItem() return immediately until it is consumed with
+     * checkInterrupt().
+     *
+     * The threads waiting in waitForSpace() are woken up too, and
+     * waitForSpace() does not wait anymore until resume() is called.
+     */
+    void interrupt();
+
+    /**
+     * Let waitForSpace() wait again after interrupt().
+     */
+    void resume();
+
+    /**
+     * Consume a pending interruption, if any.
+     *
+     * @return true if there was a pending interruption
+     */
+    bool checkInterrupt();
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        void* data;
+    };
+
+    struct Event
+    {
+        std::atomic<uint32_t> sequence {0};
+        std::atomic<int> waiters {0};
+#if !defined(__linux__)
+        std::mutex mutex;
+        std::condition_variable cv;
+#endif
+    };
+
+    bool hasItem() const;
+    bool hasSpace() const;
+    bool wait(Event& event, double timeout, bool forItem);
+    void notify(Event& event);
+
+    // Producers and consumers update different cache lines
+    static constexpr size_t cacheLineSize = 64;
+
+    Cell* m_buffer;
+    size_t m_mask;
+    char m_pad0[cacheLineSize];
+    std::atomic<size_t> m_enqueuePos;
+    char m_pad1[cacheLineSize];
+    std::atomic<size_t> m_dequeuePos;
+    char m_pad2[cacheLineSize];
+    Event m_itemEvent;
+    Event m_spaceEvent;
+    std::atomic<int> m_interrupts;
+    std::atomic<bool> m_spaceInterrupted;
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_LOCKFREEQUEUE_H
@@ -222,6 +222,7 @@ bool yarp::os::impl::McastCarrier::becomeMcast(ConnectionState& proto, bool send
         delete stream;
         return false;
     }
+    configureStream(*stream);
     proto.takeStreams(stream);
     return true;
 }
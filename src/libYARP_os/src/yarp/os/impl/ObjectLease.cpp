@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/ObjectLease.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+using yarp::os::impl::ObjectLease;
+
+namespace {
+
+// Number of leases of each object in the process
+std::mutex& leasesMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<const yarp::os::PortWriter*, int>& leases()
+{
+    static std::unordered_map<const yarp::os::PortWriter*, int> leases;
+    return leases;
+}
+
+// Total number of leases, checked without locking
+std::atomic<int> leaseCount {0};
+
+} // namespace
+
+ObjectLease::ObjectLease(const yarp::os::PortWriter* object) :
+        m_object(object),
+        m_holders(1)
+{
+    std::lock_guard<std::mutex> lock(leasesMutex());
+    leases()[m_object]++;
+    leaseCount++;
+}
+
+ObjectLease::~ObjectLease()
+{
+    std::lock_guard<std::mutex> lock(leasesMutex());
+    auto it = leases().find(m_object);
+    if (it != leases().end() && --it->second == 0) {
+        leases().erase(it);
+    }
+    leaseCount--;
+}
+
+void ObjectLease::retain()
+{
+    m_holders.fetch_add(1);
+}
+
+bool ObjectLease::write(yarp::os::ConnectionWriter& writer) const
+{
+    YARP_UNUSED(writer);
+    return false;
+}
+
+void ObjectLease::onCompletion() const
+{
+    if (m_holders.fetch_sub(1) == 1) {
+        delete this;
+    }
+}
+
+bool ObjectLease::isLeased(const yarp::os::PortWriter* object)
+{
+    if (leaseCount.load() == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(leasesMutex());
+    return leases().find(object) != leases().end();
+}
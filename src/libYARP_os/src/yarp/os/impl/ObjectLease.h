@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_OBJECTLEASE_H
+#define YARP_OS_IMPL_OBJECTLEASE_H
+
+#include <yarp/os/PortWriter.h>
+
+#include <atomic>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * Shared ownership of an object handed over to a reader in the same
+ * process, instead of a copy.
+ *
+ * While an object is leased, PortWriterBuffer does not use it to prepare
+ * new messages, and prepares them in a different buffer instead: the
+ * writer never modifies an object that a reader is still using.  Each
+ * holder of the lease calls onCompletion() once it does not need the
+ * object anymore, and the lease deletes itself when the last holder
+ * releases it.
+ */
+class YARP_os_impl_API ObjectLease :
+        public yarp::os::PortWriter
+{
+public:
+    /**
+     * Constructor.  The lease is created with one holder.
+     *
+     * @param object the object being shared
+     */
+    explicit ObjectLease(const yarp::os::PortWriter* object);
+
+    ObjectLease(const ObjectLease&) = delete;
+    ObjectLease& operator=(const ObjectLease&) = delete;
+
+    /**
+     * Add a holder to the lease.
+     */
+    void retain();
+
+    /**
+     * Nothing to write, the lease is only used to receive notifications.
+     */
+    bool write(yarp::os::ConnectionWriter& writer) const override;
+
+    /**
+     * Release the lease for one of its holders.
+     */
+    void onCompletion() const override;
+
+    /**
+     * @return true if some reader is still using the object
+     */
+    static bool isLeased(const yarp::os::PortWriter* object);
+
+private:
+    ~ObjectLease() override;
+
+    const yarp::os::PortWriter* m_object;
+    mutable std::atomic<int> m_holders;
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_OBJECTLEASE_H
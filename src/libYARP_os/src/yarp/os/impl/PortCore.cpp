@@ -23,12 +23,14 @@
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/ConnectionRecorder.h>
+#include <yarp/os/impl/DgramTwoWayStream.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PlatformUnistd.h>
 #include <yarp/os/impl/PortCoreInputUnit.h>
 #include <yarp/os/impl/PortCoreOutputUnit.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <functional>
 #include <random>
@@ -2238,6 +2240,7 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                                     qos.addString("qos");
                                     Property& qos_prop = qos.addDict();
                                     qos_prop.put("tos", tos);
+                                    addDgramStatistics(unit, result);
                                 }
                             } // end isFinished()
                         }     // end for loop
@@ -2776,6 +2779,41 @@ int PortCore::getTypeOfService(PortCoreUnit* unit)
     return -1;
 }
 
+void PortCore::addDgramStatistics(PortCoreUnit* unit, Bottle& result)
+{
+    DgramTwoWayStream* stream = nullptr;
+    if (unit->isOutput()) {
+        auto* outUnit = dynamic_cast<PortCoreOutputUnit*>(unit);
+        if (outUnit != nullptr && outUnit->getOutPutProtocol() != nullptr) {
+            stream = dynamic_cast<DgramTwoWayStream*>(&outUnit->getOutPutProtocol()->getOutputStream());
+        }
+    } else if (unit->isInput()) {
+        auto* inUnit = dynamic_cast<PortCoreInputUnit*>(unit);
+        if (inUnit != nullptr && inUnit->getInPutProtocol() != nullptr) {
+            stream = dynamic_cast<DgramTwoWayStream*>(&inUnit->getInPutProtocol()->getInputStream());
+        }
+    }
+    if (stream == nullptr) {
+        return;
+    }
+
+    DgramTwoWayStream::Statistics stats = stream->getStatistics();
+    Bottle& dgram = result.addList();
+    dgram.addString("dgram");
+    Property& dgram_prop = dgram.addDict();
+    dgram_prop.put("batch_size", stream->getBatchSize());
+    dgram_prop.put("sent_packets", Value::makeInt64(stats.sentPackets));
+    dgram_prop.put("send_calls", Value::makeInt64(stats.sendCalls));
+    dgram_prop.put("received_packets", Value::makeInt64(stats.receivedPackets));
+    dgram_prop.put("receive_calls", Value::makeInt64(stats.receiveCalls));
+    dgram_prop.put("packets_per_call",
+                   static_cast<double>(stats.sentPackets + stats.receivedPackets) / std::max<std::uint64_t>(stats.sendCalls + stats.receiveCalls, 1));
+    dgram_prop.put("dropped_packets", Value::makeInt64(stats.droppedPackets));
+    dgram_prop.put("crc_errors", Value::makeInt64(stats.crcErrors));
+    dgram_prop.put("recovered_packets", Value::makeInt64(stats.recoveredPackets));
+    dgram_prop.put("dropped_messages", Value::makeInt64(stats.droppedMessages));
+}
+
 // attach a portmonitor plugin to the port or to a specific connection
 bool PortCore::attachPortMonitor(yarp::os::Property& prop, bool isOutput, std::string& errMsg)
 {
@@ -580,6 +580,9 @@ YARP_WARNING_POP
     // get IP packet TOS
     int getTypeOfService(PortCoreUnit* unit);
 
+    // add the counters of a datagram connection (e.g. udp) to a reply
+    void addDgramStatistics(PortCoreUnit* unit, yarp::os::Bottle& result);
+
     // set the scheduling properties of all threads
     // within the process scope.
     bool setProcessSchedulingParam(int priority = -1, int policy = -1);
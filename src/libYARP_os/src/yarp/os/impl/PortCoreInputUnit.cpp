@@ -18,6 +18,8 @@
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PlatformSignal.h>
 #include <yarp/os/impl/PortCommand.h>
+#include <yarp/os/impl/PortCoreReactor.h>
+#include <yarp/os/impl/SocketTwoWayStream.h>
 
 #include <cstdio>
 
@@ -42,7 +44,11 @@ PortCoreInputUnit::PortCoreInputUnit(PortCore& owner,
         running(false),
         name(owner.getName()),
         localReader(nullptr),
-        reversed(reversed)
+        reversed(reversed),
+        wasNoticed(false),
+        posted(false),
+        reactorId(-1),
+        reactorStarted(false)
 {
     yCAssert(PORTCOREINPUTUNIT, ip != nullptr);
 
@@ -68,6 +74,26 @@ bool PortCoreInputUnit::start()
 
     phase.wait();
 
+    PortCoreReactor* reactor = PortCoreReactor::getInstance();
+    if (reactor != nullptr) {
+        // the handshake and the reads are performed by the reactor threads,
+        // once the socket is readable (a reversed connection has no header
+        // to wait for, therefore it is served immediately)
+        running = true;
+        reactorId = reactor->add([this]() { reactorStep(); });
+        int fd = reversed ? -1 : getSocket();
+        if (reactorId >= 0 && (fd >= 0 ? reactor->arm(reactorId, fd) : reactor->trigger(reactorId))) {
+            yCDebug(PORTCOREINPUTUNIT, "new input connection to %s served by the reactor", getOwner().getName().c_str());
+            phase.post();
+            return true;
+        }
+        if (reactorId >= 0) {
+            reactor->remove(reactorId);
+            reactorId = -1;
+        }
+        running = false;
+    }
+
     bool result = PortCoreUnit::start();
     if (result) {
         yCDebug(PORTCOREINPUTUNIT, "new input connection to %s started ok", getOwner().getName().c_str());
@@ -85,18 +111,66 @@ bool PortCoreInputUnit::start()
 void PortCoreInputUnit::run()
 {
     running = true;
-    phase.post();
 
-    Route route;
-    bool wasNoticed = false;
-    bool posted = false;
+    bool more = true;
+    if (!reactorStarted) {
+        phase.post();
+        more = openConnection();
+    }
+
+    while (more) {
+        more = readOnce();
+    }
+
+    closeConnection();
+
+    // it would be nice to get my entry removed from the port immediately,
+    // but it would be a bit dodgy to delete this object and join this
+    // thread within and from themselves
+}
+
 
+void PortCoreInputUnit::reactorStep()
+{
+    PortCoreReactor* reactor = PortCoreReactor::getInstance();
+    yCAssert(PORTCOREINPUTUNIT, reactor != nullptr);
+
+    bool more = true;
+    if (!reactorStarted) {
+        reactorStarted = true;
+        more = openConnection();
+        if (more && getSocket() < 0) {
+            // The carrier replaced the socket with something we cannot
+            // watch, therefore fall back to a dedicated thread.
+            yCDebug(PORTCOREINPUTUNIT, "input connection to %s needs a thread", getOwner().getName().c_str());
+            if (PortCoreUnit::start()) {
+                return;
+            }
+            more = false;
+        }
+    } else {
+        more = readOnce();
+    }
+
+    if (more) {
+        more = reactor->arm(reactorId, getSocket());
+    }
+
+    // The registration is left idle rather than removed from here: it is
+    // removed by closeMain(), that waits for this handler to return before
+    // the unit can be closed or deleted.
+    if (!more) {
+        closeConnection();
+    }
+}
+
+
+bool PortCoreInputUnit::openConnection()
+{
     bool done = false;
 
     yCAssert(PORTCOREINPUTUNIT, ip != nullptr);
 
-    PortCommand cmd;
-
     bool ok = true;
     if (!reversed) {
         ip->open(getName());
@@ -167,225 +241,230 @@ void PortCoreInputUnit::run()
         done = true;
     }
 
-    auto* id = reinterpret_cast<void*>(this);
-
     if (ip != nullptr && !ip->getConnection().canEscape()) {
         InputStream* is = &ip->getInputStream();
         is->setReadEnvelopeCallback(envelopeReadCallback, this);
     }
 
-    while (!done) {
-        if (ip == nullptr) {
-            break;
-        }
-        ConnectionReader& br = ip->beginRead();
-
-        if (br.getReference() != nullptr) {
-            //printf("HAVE A REFERENCE\n");
-            if (localReader != nullptr) {
-                bool ok = localReader->read(br);
-                if (!br.isActive()) {
-                    break;
-                }
-                if (!ok) {
-                    continue;
-                }
-            } else {
-                PortCore& man = getOwner();
-                bool ok = man.readBlock(br, id, nullptr);
-                if (!br.isActive()) {
-                    break;
-                }
-                if (!ok) {
-                    continue;
-                }
-            }
-            //printf("DONE WITH A REFERENCE\n");
-            if (ip != nullptr) {
-                ip->endRead();
-            }
-            continue;
-        }
+    return !done;
+}
 
-        if (ip->getConnection().canEscape()) {
-            bool ok = cmd.read(br);
-            if (!br.isActive()) {
-                break;
-            }
-            if (!ok) {
-                continue;
-            }
+
+bool PortCoreInputUnit::readOnce()
+{
+    bool done = false;
+
+    if (ip == nullptr) {
+        return false;
+    }
+
+    auto* id = reinterpret_cast<void*>(this);
+
+    ConnectionReader& br = ip->beginRead();
+
+    if (br.getReference() != nullptr) {
+        //printf("HAVE A REFERENCE\n");
+        if (localReader != nullptr) {
+            localReader->read(br);
         } else {
-            cmd = PortCommand('d', "");
-            if (!ip->isOk()) {
-                break;
-            }
+            PortCore& man = getOwner();
+            man.readBlock(br, id, nullptr);
         }
+        if (!br.isActive()) {
+            return false;
+        }
+        //printf("DONE WITH A REFERENCE\n");
+        // The sender waits for the end of the message, even if it
+        // could not be read.
+        if (ip != nullptr) {
+            ip->endRead();
+        }
+        return true;
+    }
 
-        if (closing || isDoomed()) {
-            break;
+    if (ip->getConnection().canEscape()) {
+        bool ok = cmd.read(br);
+        if (!br.isActive()) {
+            return false;
+        }
+        if (!ok) {
+            return true;
         }
-        char key = cmd.getKey();
-        //printf("Port command is [%c:%d/%s]\n",
-        //         (key>=32)?key:'?', key, cmd.getText().c_str());
-
-        PortCore& man = getOwner();
-        OutputStream* os = nullptr;
-        if (br.isTextMode()) {
-            os = &(ip->getOutputStream());
+    } else {
+        cmd = PortCommand('d', "");
+        if (!ip->isOk()) {
+            return false;
         }
+    }
 
-        switch (key) {
-        case '/':
-            yCDebug(PORTCOREINPUTUNIT,
-                    "Port command (%s): %s should add connection: %s",
-                    route.toString().c_str(),
-                    getOwner().getName().c_str(),
-                    cmd.getText().c_str());
-            man.addOutput(cmd.getText(), id, os);
-            break;
-        case '!':
-            yCDebug(PORTCOREINPUTUNIT,
-                    "Port command (%s): %s should remove output: %s",
-                    route.toString().c_str(),
-                    getOwner().getName().c_str(),
-                    cmd.getText().c_str());
-            man.removeOutput(cmd.getText().substr(1, std::string::npos), id, os);
-            break;
-        case '~':
-            yCDebug(PORTCOREINPUTUNIT,
-                    "Port command (%s): %s should remove input: %s",
-                    route.toString().c_str(),
-                    getOwner().getName().c_str(),
-                    cmd.getText().c_str());
-            man.removeInput(cmd.getText().substr(1, std::string::npos), id, os);
-            break;
-        case '*':
-            man.describe(id, os);
-            break;
-        case 'D':
-        case 'd': {
-            if (key == 'D') {
-                ip->suppressReply();
-            }
+    if (closing || isDoomed()) {
+        return false;
+    }
+    char key = cmd.getKey();
+    //printf("Port command is [%c:%d/%s]\n",
+    //         (key>=32)?key:'?', key, cmd.getText().c_str());
+
+    PortCore& man = getOwner();
+    OutputStream* os = nullptr;
+    if (br.isTextMode()) {
+        os = &(ip->getOutputStream());
+    }
 
-            std::string env = cmd.getText();
-            if (env.length() > 2) {
-                yCTrace(PORTCOREINPUTUNIT, "***** received an envelope! [%s]", env.c_str());
-                std::string env2 = env.substr(2, env.length());
-                man.setEnvelope(env2);
-                ip->setEnvelope(env2);
+    switch (key) {
+    case '/':
+        yCDebug(PORTCOREINPUTUNIT,
+                "Port command (%s): %s should add connection: %s",
+                route.toString().c_str(),
+                getOwner().getName().c_str(),
+                cmd.getText().c_str());
+        man.addOutput(cmd.getText(), id, os);
+        break;
+    case '!':
+        yCDebug(PORTCOREINPUTUNIT,
+                "Port command (%s): %s should remove output: %s",
+                route.toString().c_str(),
+                getOwner().getName().c_str(),
+                cmd.getText().c_str());
+        man.removeOutput(cmd.getText().substr(1, std::string::npos), id, os);
+        break;
+    case '~':
+        yCDebug(PORTCOREINPUTUNIT,
+                "Port command (%s): %s should remove input: %s",
+                route.toString().c_str(),
+                getOwner().getName().c_str(),
+                cmd.getText().c_str());
+        man.removeInput(cmd.getText().substr(1, std::string::npos), id, os);
+        break;
+    case '*':
+        man.describe(id, os);
+        break;
+    case 'D':
+    case 'd': {
+        if (key == 'D') {
+            ip->suppressReply();
+        }
+
+        std::string env = cmd.getText();
+        if (env.length() > 2) {
+            yCTrace(PORTCOREINPUTUNIT, "***** received an envelope! [%s]", env.c_str());
+            std::string env2 = env.substr(2, env.length());
+            man.setEnvelope(env2);
+            ip->setEnvelope(env2);
+        }
+        if (localReader != nullptr) {
+            localReader->read(br);
+            if (!br.isActive()) {
+                done = true;
+                break;
             }
-            if (localReader != nullptr) {
-                localReader->read(br);
-                if (!br.isActive()) {
-                    done = true;
-                    break;
-                }
-            } else {
-                if (ip->getReceiver().acceptIncomingData(br)) {
-                    ConnectionReader* cr = &(ip->getReceiver().modifyIncomingData(br));
-                    yarp::os::impl::PortDataModifier& modifier = getOwner().getPortModifier();
-                    modifier.inputMutex.lock();
-                    if (modifier.inputModifier != nullptr) {
-                        if (modifier.inputModifier->acceptIncomingData(*cr)) {
-                            cr = &(modifier.inputModifier->modifyIncomingData(*cr));
-                            modifier.inputMutex.unlock();
-                            man.readBlock(*cr, id, os);
-                        } else {
-                            modifier.inputMutex.unlock();
-                            skipIncomingData(*cr);
-                        }
-                    } else {
+        } else {
+            if (ip->getReceiver().acceptIncomingData(br)) {
+                ConnectionReader* cr = &(ip->getReceiver().modifyIncomingData(br));
+                yarp::os::impl::PortDataModifier& modifier = getOwner().getPortModifier();
+                modifier.inputMutex.lock();
+                if (modifier.inputModifier != nullptr) {
+                    if (modifier.inputModifier->acceptIncomingData(*cr)) {
+                        cr = &(modifier.inputModifier->modifyIncomingData(*cr));
                         modifier.inputMutex.unlock();
                         man.readBlock(*cr, id, os);
+                    } else {
+                        modifier.inputMutex.unlock();
+                        skipIncomingData(*cr);
                     }
                 } else {
-                    skipIncomingData(br);
-                }
-                if (!br.isActive()) {
-                    done = true;
-                    break;
+                    modifier.inputMutex.unlock();
+                    man.readBlock(*cr, id, os);
                 }
+            } else {
+                skipIncomingData(br);
             }
-        } break;
-        case 'a': {
-            man.adminBlock(br, id);
-        } break;
-        case 'r':
-            /*
-              In YARP implementation, OP=IP.
-              (This information is used rarely, and when used
-              is tagged with OP=IP keyword)
-              If it were not true, memory alloc would need to
-              reorganized here
-            */
-            {
-                OutputProtocol* op = &(ip->getOutput());
-                ip->endRead();
-                Route r = op->getRoute();
-                // reverse route
-                r.swapNames();
-                op->rename(r);
-
-                getOwner().addOutput(op);
-                ip = nullptr;
+            if (!br.isActive()) {
                 done = true;
+                break;
             }
-            break;
-        case 'q':
+        }
+    } break;
+    case 'a': {
+        man.adminBlock(br, id);
+    } break;
+    case 'r':
+        /*
+          In YARP implementation, OP=IP.
+          (This information is used rarely, and when used
+          is tagged with OP=IP keyword)
+          If it were not true, memory alloc would need to
+          reorganized here
+        */
+        {
+            OutputProtocol* op = &(ip->getOutput());
+            ip->endRead();
+            Route r = op->getRoute();
+            // reverse route
+            r.swapNames();
+            op->rename(r);
+
+            getOwner().addOutput(op);
+            ip = nullptr;
             done = true;
-            break;
+        }
+        break;
+    case 'q':
+        done = true;
+        break;
 #if !defined(NDEBUG)
-        case 'i':
-            printf("Interrupt requested\n");
-            //yarp::os::impl::kill(0, 2); // SIGINT
-            //yarp::os::impl::kill(yarp::os::getpid(), 2); // SIGINT
-            yarp::os::impl::kill(yarp::os::getpid(), 15); // SIGTERM
-            break;
+    case 'i':
+        printf("Interrupt requested\n");
+        //yarp::os::impl::kill(0, 2); // SIGINT
+        //yarp::os::impl::kill(yarp::os::getpid(), 2); // SIGINT
+        yarp::os::impl::kill(yarp::os::getpid(), 15); // SIGTERM
+        break;
 #endif
-        case '?':
-        case 'h':
-            if (os != nullptr) {
-                BufferedConnectionWriter bw(true);
-                bw.appendLine("This is a YARP port.  Here are the commands it responds to:");
-                bw.appendLine("*       Gives a description of this port");
-                bw.appendLine("d       Signals the beginning of input for the port's owner");
-                bw.appendLine(R"(do      The same as "d" except replies should be suppressed ("data-only"))");
-                bw.appendLine("q       Disconnects");
+    case '?':
+    case 'h':
+        if (os != nullptr) {
+            BufferedConnectionWriter bw(true);
+            bw.appendLine("This is a YARP port.  Here are the commands it responds to:");
+            bw.appendLine("*       Gives a description of this port");
+            bw.appendLine("d       Signals the beginning of input for the port's owner");
+            bw.appendLine(R"(do      The same as "d" except replies should be suppressed ("data-only"))");
+            bw.appendLine("q       Disconnects");
 #if !defined(NDEBUG)
-                bw.appendLine("i       Interrupt parent process (unix only)");
+            bw.appendLine("i       Interrupt parent process (unix only)");
 #endif
-                bw.appendLine("r       Reverse connection type to be a reader");
-                bw.appendLine("/port   Requests to send output to /port");
-                bw.appendLine("!/port  Requests to stop sending output to /port");
-                bw.appendLine("~/port  Requests to stop receiving input from /port");
-                bw.appendLine("a       Signals the beginning of an administrative message");
-                bw.appendLine("?       Gives this help");
-                bw.write(*os);
-            }
-            break;
-        default:
-            if (os != nullptr) {
-                BufferedConnectionWriter bw(true);
-                bw.appendLine("Port command not understood.");
-                bw.appendLine("Type d to send data to the port's owner.");
-                bw.appendLine("Type ? for help.");
-                bw.write(*os);
-            }
-            break;
+            bw.appendLine("r       Reverse connection type to be a reader");
+            bw.appendLine("/port   Requests to send output to /port");
+            bw.appendLine("!/port  Requests to stop sending output to /port");
+            bw.appendLine("~/port  Requests to stop receiving input from /port");
+            bw.appendLine("a       Signals the beginning of an administrative message");
+            bw.appendLine("?       Gives this help");
+            bw.write(*os);
         }
-        if (ip != nullptr) {
-            ip->endRead();
-        }
-        if (ip == nullptr) {
-            break;
-        }
-        if (closing || isDoomed() || (!ip->isOk())) {
-            break;
+        break;
+    default:
+        if (os != nullptr) {
+            BufferedConnectionWriter bw(true);
+            bw.appendLine("Port command not understood.");
+            bw.appendLine("Type d to send data to the port's owner.");
+            bw.appendLine("Type ? for help.");
+            bw.write(*os);
         }
+        break;
+    }
+    if (ip != nullptr) {
+        ip->endRead();
+    }
+    if (ip == nullptr) {
+        return false;
+    }
+    if (closing || isDoomed() || (!ip->isOk())) {
+        return false;
     }
+    return !done;
+}
+
 
+void PortCoreInputUnit::closeConnection()
+{
     setDoomed();
 
     yCDebug(PORTCOREINPUTUNIT, "Closing ip");
@@ -432,10 +511,19 @@ void PortCoreInputUnit::run()
 
     running = false;
     finished = true;
+}
 
-    // it would be nice to get my entry removed from the port immediately,
-    // but it would be a bit dodgy to delete this object and join this
-    // thread within and from themselves
+
+int PortCoreInputUnit::getSocket()
+{
+    if (ip == nullptr) {
+        return -1;
+    }
+    auto* stream = dynamic_cast<SocketTwoWayStream*>(&ip->getInputStream());
+    if (stream == nullptr || !stream->isOk()) {
+        return -1;
+    }
+    return stream->getSocket();
 }
 
 bool PortCoreInputUnit::isInput()
@@ -500,6 +588,17 @@ void PortCoreInputUnit::closeMain()
 
     yCDebug(PORTCOREINPUTUNIT, "[%s] closing", r.toString().c_str());
 
+    if (reactorId >= 0) {
+        // Once removed from the reactor, the handler is not running, and it
+        // will never run again
+        interrupt();
+        PortCoreReactor::getInstance()->remove(reactorId);
+        reactorId = -1;
+        if (!finished && !isRunning()) {
+            closeConnection();
+        }
+    }
+
     if (running) {
         yCDebug(PORTCOREINPUTUNIT, "[%s] joining", r.toString().c_str());
         interrupt();
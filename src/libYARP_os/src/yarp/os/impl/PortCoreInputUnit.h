@@ -12,6 +12,7 @@
 
 #include <yarp/os/InputProtocol.h>
 #include <yarp/os/Semaphore.h>
+#include <yarp/os/impl/PortCommand.h>
 #include <yarp/os/impl/PortCore.h>
 #include <yarp/os/impl/PortCoreUnit.h>
 
@@ -49,7 +50,8 @@ public:
 
     /**
      *
-     * Start a thread running to serve this input.
+     * Start a thread running to serve this input, or register it with
+     * the PortCoreReactor, if enabled.
      *
      */
     bool start() override;
@@ -92,9 +94,45 @@ private:
     yarp::os::PortReader* localReader;
     Route officialRoute;
     bool reversed;
+    Route route;
+    PortCommand cmd;
+    bool wasNoticed;
+    bool posted;
+    long reactorId;      ///< registration in the PortCoreReactor, or -1
+    bool reactorStarted; ///< openConnection() was called by the reactor
 
     void closeMain();
 
+    /**
+     * Handshake and report the new connection.
+     *
+     * @return true if messages should be read from the connection
+     */
+    bool openConnection();
+
+    /**
+     * Read and process one message.
+     *
+     * @return true if more messages should be read from the connection
+     */
+    bool readOnce();
+
+    /**
+     * Close the connection and report its removal.
+     */
+    void closeConnection();
+
+    /**
+     * Serve the connection from a PortCoreReactor worker thread.
+     */
+    void reactorStep();
+
+    /**
+     * @return the socket of the connection, or -1 if the connection is
+     * not using a socket that can be watched by the PortCoreReactor
+     */
+    int getSocket();
+
     bool skipIncomingData(yarp::os::ConnectionReader& reader);
 
     static void envelopeReadCallback(void* data, const Bytes& envelope);
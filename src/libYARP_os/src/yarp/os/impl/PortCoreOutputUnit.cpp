@@ -12,11 +12,15 @@
 #include <yarp/os/Name.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReport.h>
+#include <yarp/os/PortWriterBufferBase.h>
 #include <yarp/os/Portable.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/ObjectLease.h>
 #include <yarp/os/impl/PortCommand.h>
+#include <yarp/os/impl/PortCorePacket.h>
+#include <yarp/os/impl/PortCoreReactor.h>
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREOUTPUTUNIT, "yarp.os.impl.PortCoreOutputUnit")
@@ -39,7 +43,9 @@ PortCoreOutputUnit::PortCoreOutputUnit(PortCore& owner, int index, OutputProtoco
         cachedWriter(nullptr),
         cachedReader(nullptr),
         cachedCallback(nullptr),
-        cachedTracker(nullptr)
+        cachedTracker(nullptr),
+        cachedMessageId(0),
+        reactorId(-1)
 {
     yCAssert(PORTCOREOUTPUTUNIT, op != nullptr);
 }
@@ -62,6 +68,22 @@ bool PortCoreOutputUnit::start()
         return true;
     }
 
+    PortCoreReactor* reactor = PortCoreReactor::getInstance();
+    if (reactor != nullptr) {
+        // background writes are performed by the reactor threads
+        reactorId = reactor->add([this]() {
+            if (!closing) {
+                backgroundSend();
+            }
+        });
+        if (reactorId >= 0) {
+            running = true;
+            sending = false;
+            phase.post();
+            return true;
+        }
+    }
+
     bool result = PortCoreUnit::start();
     if (result) {
         phase.wait();
@@ -92,21 +114,7 @@ void PortCoreOutputUnit::run()
             activate.wait();
             yCDebug(PORTCOREOUTPUTUNIT, "woken");
             if (!closing) {
-                if (sending) {
-                    yCDebug(PORTCOREOUTPUTUNIT, "write something in background");
-                    sendHelper();
-                    yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
-                    trackerMutex.lock();
-                    if (cachedTracker != nullptr) {
-                        void* t = cachedTracker;
-                        cachedTracker = nullptr;
-                        sending = false;
-                        getOwner().notifyCompletion(t);
-                    } else {
-                        sending = false;
-                    }
-                    trackerMutex.unlock();
-                }
+                backgroundSend();
             }
             yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
         }
@@ -116,6 +124,26 @@ void PortCoreOutputUnit::run()
 }
 
 
+void PortCoreOutputUnit::backgroundSend()
+{
+    if (sending) {
+        yCDebug(PORTCOREOUTPUTUNIT, "write something in background");
+        sendHelper();
+        yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
+        trackerMutex.lock();
+        if (cachedTracker != nullptr) {
+            void* t = cachedTracker;
+            cachedTracker = nullptr;
+            sending = false;
+            getOwner().notifyCompletion(t);
+        } else {
+            sending = false;
+        }
+        trackerMutex.unlock();
+    }
+}
+
+
 void PortCoreOutputUnit::runSingleThreaded()
 {
     if (op != nullptr) {
@@ -227,8 +255,15 @@ void PortCoreOutputUnit::closeMain()
 
         closing = true;
         phase.post();
-        activate.post();
-        join();
+        if (reactorId >= 0) {
+            // wait for any background write in progress
+            PortCoreReactor::getInstance()->remove(reactorId);
+            reactorId = -1;
+            sending = false;
+        } else {
+            activate.post();
+            join();
+        }
     }
 
     yCDebug(PORTCOREOUTPUTUNIT, "internal join");
@@ -257,18 +292,25 @@ bool PortCoreOutputUnit::sendHelper()
     bool replied = false;
     if (op != nullptr) {
         bool done = false;
+        ObjectLease* lease = nullptr;
         BufferedConnectionWriter buf(op->getConnection().isTextMode(),
                                      op->getConnection().isBareMode());
         if (cachedReader != nullptr) {
             buf.setReplyHandler(*cachedReader);
         }
 
+        // The object prepared by the user, before any modification
+        const yarp::os::PortWriter* prepared = cachedWriter;
         if (op->getSender().modifiesOutgoingData()) {
             if (op->getSender().acceptOutgoingData(*cachedWriter)) {
                 cachedWriter = &op->getSender().modifyOutgoingData(*cachedWriter);
             } else {
                 return (done = true);
             }
+        } else {
+            // The message is serialized in the same way on all the
+            // connections that do not modify it, let the carrier know
+            buf.setMessageId(cachedMessageId);
         }
 
         if (op->getConnection().isLocal()) {
@@ -283,6 +325,15 @@ bool PortCoreOutputUnit::sendHelper()
                 return false;
             }
             buf.setReference(p);
+            // The reader can keep the object only if it was prepared by a
+            // PortWriterBuffer, that does not reuse it while it is leased.
+            // Other objects, including the ones returned by
+            // modifyOutgoingData(), can be modified as soon as the write
+            // returns, and the reader gets a copy.
+            if (pw == prepared && dynamic_cast<const yarp::os::PortWriterWrapper*>(cachedCallback) != nullptr) {
+                lease = new ObjectLease(pw);
+                buf.setReferenceLease(lease);
+            }
         } else {
             yCAssert(PORTCOREOUTPUTUNIT, cachedWriter != nullptr);
             bool ok = cachedWriter->write(buf);
@@ -328,6 +379,11 @@ bool PortCoreOutputUnit::sendHelper()
             }
         }
 
+        if (lease != nullptr) {
+            // The reader took its own share of the message, if needed
+            lease->onCompletion();
+        }
+
         if (buf.dropRequested()) {
             done = true;
         }
@@ -378,6 +434,7 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
         cachedReader = reader;
         cachedCallback = callback;
         cachedEnvelope = envelopeString;
+        cachedMessageId = (tracker != nullptr) ? static_cast<PortCorePacket*>(tracker)->getId() : 0;
 
         sending = true;
         if (waitAfter) {
@@ -388,7 +445,11 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
             void* nextTracker = tracker;
             tracker = cachedTracker;
             cachedTracker = nextTracker;
-            activate.post();
+            if (reactorId >= 0) {
+                PortCoreReactor::getInstance()->trigger(reactorId);
+            } else {
+                activate.post();
+            }
             trackerMutex.unlock();
         }
     } else {
@@ -15,6 +15,7 @@
 #include <yarp/os/impl/PortCore.h>
 #include <yarp/os/impl/PortCoreUnit.h>
 
+#include <cstdint>
 #include <mutex>
 
 namespace yarp {
@@ -46,7 +47,9 @@ public:
 
     /**
      * Prepare to serve this output.  A thread will start if a call
-     * to send() has been made with options that require a thread.
+     * to send() has been made with options that require a thread,
+     * unless the PortCoreReactor is enabled, in which case background
+     * writes are performed by the reactor threads.
      */
     bool start() override;
 
@@ -122,12 +125,19 @@ private:
                                           ///< completion events
     void *cachedTracker;        ///< memory tracker for current message
     std::string cachedEnvelope;      ///< some text to pass along with the message
+    uint64_t cachedMessageId;   ///< identifier of the current message
+    long reactorId;             ///< registration in the PortCoreReactor, or -1
 
     /**
      * The core logic for sending a message.
      */
     bool sendHelper();
 
+    /**
+     * Send the cached message, and notify its completion.
+     */
+    void backgroundSend();
+
     /**
      * Try to close the connection, but not very hard.
      */
@@ -13,6 +13,8 @@
 #include <yarp/os/NetType.h>
 #include <yarp/os/PortWriter.h>
 
+#include <cstdint>
+
 namespace yarp {
 namespace os {
 namespace impl {
@@ -32,6 +34,7 @@ public:
     bool owned;                           ///< should we memory-manage the content object
     bool ownedCallback;                   ///< should we memory-manage the callback object
     bool completed;                       ///< has a notification of completion been sent
+    uint64_t id;                          ///< unique identifier of the message
 
     /**
      * Constructor.
@@ -44,7 +47,8 @@ public:
             ct(0),
             owned(false),
             ownedCallback(false),
-            completed(false)
+            completed(false),
+            id(0)
     {
         reset();
     }
@@ -82,6 +86,24 @@ public:
         ct--;
     }
 
+    /**
+     * @return the unique identifier of the message, or 0 if unknown.
+     * Connections can use it to recognize a message sent on several of
+     * them.
+     */
+    uint64_t getId() const
+    {
+        return id;
+    }
+
+    /**
+     * Set the unique identifier of the message.
+     */
+    void setId(uint64_t id)
+    {
+        this->id = id;
+    }
+
     /**
      * @return the object being sent.
      */
@@ -136,6 +158,7 @@ public:
         owned = false;
         ownedCallback = false;
         completed = false;
+        id = 0;
     }
 
     /**
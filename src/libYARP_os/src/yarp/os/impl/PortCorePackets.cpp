@@ -11,11 +11,16 @@
 
 #include <yarp/os/impl/LogComponent.h>
 
+#include <atomic>
+
 using yarp::os::impl::PortCorePacket;
 using yarp::os::impl::PortCorePackets;
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREPACKETS, "yarp.os.impl.PortCorePackets")
+
+// Message identifiers are unique in the process
+std::atomic<uint64_t> messageCounter {0};
 } // namespace
 
 PortCorePackets::~PortCorePackets()
@@ -53,6 +58,7 @@ PortCorePacket* PortCorePackets::getFreePacket()
     yCAssert(PORTCOREPACKETS, next != nullptr);
     inactive.remove(next);
     active.push_back(next);
+    next->setId(++messageCounter);
     return next;
 }
 
@@ -0,0 +1,404 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCoreReactor.h>
+
+#include <yarp/conf/environment.h>
+#include <yarp/conf/numeric.h>
+
+#include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/PlatformSignal.h>
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#    include <sys/epoll.h>
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#    include <cerrno>
+#    include <cstring>
+#endif
+
+using namespace yarp::os::impl;
+
+namespace {
+YARP_OS_LOG_COMPONENT(PORTCOREREACTOR, "yarp.os.impl.PortCoreReactor")
+
+constexpr int maxEvents = 64;
+} // namespace
+
+constexpr double PortCoreReactor::idleTimeout;
+constexpr size_t PortCoreReactor::defaultMaxWorkers;
+
+
+PortCoreReactor::PortCoreReactor(size_t workers, size_t maxWorkers)
+{
+#if defined(__linux__)
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        yCError(PORTCOREREACTOR, "Cannot create epoll instance: %s", strerror(errno));
+        return;
+    }
+    m_wakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd < 0) {
+        yCError(PORTCOREREACTOR, "Cannot create eventfd: %s", strerror(errno));
+        ::close(m_epollFd);
+        m_epollFd = -1;
+        return;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = static_cast<uint64_t>(-1);
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    if (workers == 0) {
+        workers = 1;
+    }
+    m_poller = std::thread(&PortCoreReactor::pollLoop, this);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_minWorkers = workers;
+    m_maxWorkers = std::max(workers, maxWorkers);
+    for (size_t i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&PortCoreReactor::workLoop, this);
+        m_runningWorkers++;
+        m_idleWorkers++;
+    }
+    yCDebug(PORTCOREREACTOR, "Reactor started with %zu workers (at most %zu)", workers, m_maxWorkers);
+#else
+    YARP_UNUSED(workers);
+    YARP_UNUSED(maxWorkers);
+    yCWarning(PORTCOREREACTOR, "The port reactor is not supported on this platform");
+#endif
+}
+
+
+PortCoreReactor::~PortCoreReactor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+        m_registrations.clear();
+        m_queue.clear();
+    }
+    m_workCv.notify_all();
+    m_doneCv.notify_all();
+
+#if defined(__linux__)
+    if (m_wakeFd >= 0) {
+        uint64_t one = 1;
+        if (::write(m_wakeFd, &one, sizeof(one)) < 0) {
+            yCError(PORTCOREREACTOR, "Cannot wake up the poller: %s", strerror(errno));
+        }
+    }
+#endif
+
+    if (m_poller.joinable()) {
+        m_poller.join();
+    }
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+#if defined(__linux__)
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+    }
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+    }
+#endif
+}
+
+
+PortCoreReactor* PortCoreReactor::getInstance()
+{
+    static PortCoreReactor* instance = []() -> PortCoreReactor* {
+        std::string env = yarp::conf::environment::get_string("YARP_PORT_REACTOR");
+        if (env.empty()) {
+            return nullptr;
+        }
+        int workers = yarp::conf::numeric::from_string<int>(env, 0);
+        if (workers <= 0) {
+            return nullptr;
+        }
+        int maxWorkers = yarp::conf::numeric::from_string<int>(yarp::conf::environment::get_string("YARP_PORT_REACTOR_MAX_WORKERS"), 0);
+        if (maxWorkers <= 0) {
+            maxWorkers = static_cast<int>(defaultMaxWorkers);
+        }
+        // The reactor is never deleted: units may still be closing while
+        // static objects are being destroyed.
+        auto* reactor = new PortCoreReactor(static_cast<size_t>(workers), static_cast<size_t>(maxWorkers));
+        if (!reactor->isValid()) {
+            delete reactor;
+            return nullptr;
+        }
+        yCInfo(PORTCOREREACTOR, "Serving connections with %d reactor threads", workers);
+        return reactor;
+    }();
+    return instance;
+}
+
+
+bool PortCoreReactor::isValid() const
+{
+    return m_epollFd >= 0 && m_minWorkers > 0;
+}
+
+
+long PortCoreReactor::add(Handler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_closing || !isValid()) {
+        return -1;
+    }
+    long id = m_nextId++;
+    m_registrations[id].handler = std::move(handler);
+    return id;
+}
+
+
+bool PortCoreReactor::arm(long id, int fd)
+{
+#if defined(__linux__)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_registrations.find(id);
+    if (it == m_registrations.end() || fd < 0) {
+        return false;
+    }
+    Registration& reg = it->second;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.u64 = static_cast<uint64_t>(id);
+
+    int op = (reg.armed && reg.fd == fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (reg.armed && reg.fd != fd) {
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, reg.fd, nullptr);
+    }
+    if (::epoll_ctl(m_epollFd, op, fd, &ev) != 0) {
+        yCDebug(PORTCOREREACTOR, "Cannot watch socket %d: %s", fd, strerror(errno));
+        reg.armed = false;
+        return false;
+    }
+    reg.fd = fd;
+    reg.armed = true;
+    return true;
+#else
+    YARP_UNUSED(id);
+    YARP_UNUSED(fd);
+    return false;
+#endif
+}
+
+
+bool PortCoreReactor::trigger(long id)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_registrations.find(id);
+        if (it == m_registrations.end()) {
+            return false;
+        }
+        if (it->second.queued) {
+            return true;
+        }
+        it->second.queued = true;
+        m_queue.push_back(id);
+        reserveWorker();
+    }
+    m_workCv.notify_one();
+    return true;
+}
+
+
+void PortCoreReactor::remove(long id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_registrations.find(id);
+    if (it == m_registrations.end()) {
+        return;
+    }
+#if defined(__linux__)
+    if (it->second.armed) {
+        // The socket may already be closed, in which case the kernel
+        // already forgot about it.
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        it->second.armed = false;
+    }
+#endif
+    if (it->second.executing && it->second.executor != std::this_thread::get_id()) {
+        m_doneCv.wait(lock, [&]() {
+            auto jt = m_registrations.find(id);
+            return m_closing || jt == m_registrations.end() || !jt->second.executing;
+        });
+    }
+    // Queued ids that are no longer registered are simply skipped
+    m_registrations.erase(id);
+}
+
+
+size_t PortCoreReactor::getWorkerCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_runningWorkers;
+}
+
+
+size_t PortCoreReactor::getHandlerCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_registrations.size();
+}
+
+
+void PortCoreReactor::pollLoop()
+{
+#if defined(__linux__)
+    // just for now -- rather deal with broken pipes through normal procedures
+    yarp::os::impl::signal(SIGPIPE, SIG_IGN);
+
+    struct epoll_event events[maxEvents];
+    while (true) {
+        int n = ::epoll_wait(m_epollFd, events, maxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            yCError(PORTCOREREACTOR, "epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closing) {
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.u64 == static_cast<uint64_t>(-1)) {
+                    uint64_t count;
+                    if (::read(m_wakeFd, &count, sizeof(count)) < 0) {
+                        yCDebug(PORTCOREREACTOR, "Spurious wake up");
+                    }
+                    continue;
+                }
+                long id = static_cast<long>(events[i].data.u64);
+                auto it = m_registrations.find(id);
+                if (it == m_registrations.end() || it->second.queued) {
+                    continue;
+                }
+                it->second.queued = true;
+                m_queue.push_back(id);
+                reserveWorker();
+                wake = true;
+            }
+        }
+        if (wake) {
+            m_workCv.notify_all();
+        }
+    }
+#endif
+}
+
+
+void PortCoreReactor::workLoop()
+{
+    // just for now -- rather deal with broken pipes through normal procedures
+    yarp::os::impl::signal(SIGPIPE, SIG_IGN);
+
+    // The worker is counted as idle by whoever started it
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        bool ready = m_workCv.wait_for(lock, std::chrono::duration<double>(idleTimeout), [&]() { return m_closing || !m_queue.empty(); });
+        if (m_closing) {
+            break;
+        }
+        if (!ready) {
+            if (m_runningWorkers > m_minWorkers) {
+                // joined by the next reserveWorker(), or by the destructor
+                m_runningWorkers--;
+                m_idleWorkers--;
+                m_stoppedWorkers.push_back(std::this_thread::get_id());
+                break;
+            }
+            continue;
+        }
+        long id = m_queue.front();
+        m_queue.pop_front();
+
+        auto it = m_registrations.find(id);
+        if (it == m_registrations.end()) {
+            continue;
+        }
+        Registration& reg = it->second;
+        reg.queued = false;
+        if (reg.executing) {
+            // Never run a handler concurrently with itself, run it again
+            // once it is done instead.
+            reg.rerun = true;
+            continue;
+        }
+        reg.executing = true;
+        reg.executor = std::this_thread::get_id();
+        Handler handler = reg.handler;
+
+        m_idleWorkers--;
+        lock.unlock();
+        handler();
+        lock.lock();
+        m_idleWorkers++;
+
+        it = m_registrations.find(id);
+        if (it != m_registrations.end()) {
+            it->second.executing = false;
+            it->second.executor = std::thread::id();
+            if (it->second.rerun && !it->second.queued) {
+                it->second.rerun = false;
+                it->second.queued = true;
+                m_queue.push_back(id);
+                reserveWorker();
+                m_workCv.notify_one();
+            }
+        }
+        m_doneCv.notify_all();
+    }
+}
+
+
+void PortCoreReactor::reserveWorker()
+{
+    if (m_closing || m_queue.size() <= m_idleWorkers) {
+        return;
+    }
+    if (m_runningWorkers >= m_maxWorkers) {
+        // The handler waits in the queue for a worker to be done
+        yCDebug(PORTCOREREACTOR, "All the %zu workers are busy, %zu handlers queued", m_runningWorkers, m_queue.size());
+        return;
+    }
+
+    // Join the workers that stopped, they already released the mutex
+    for (const auto& stopped : m_stoppedWorkers) {
+        for (auto it = m_workers.begin(); it != m_workers.end(); ++it) {
+            if (it->get_id() == stopped) {
+                it->join();
+                m_workers.erase(it);
+                break;
+            }
+        }
+    }
+    m_stoppedWorkers.clear();
+
+    m_workers.emplace_back(&PortCoreReactor::workLoop, this);
+    m_runningWorkers++;
+    m_idleWorkers++;
+    yCDebug(PORTCOREREACTOR, "All the workers are busy, started a new one (%zu workers)", m_runningWorkers);
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_PORTCOREREACTOR_H
+#define YARP_OS_IMPL_PORTCOREREACTOR_H
+
+#include <yarp/os/api.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * An event-driven engine that serves port connections using a small
+ * pool of threads rather than one thread per connection.
+ *
+ * Connections (PortCoreInputUnit and PortCoreOutputUnit objects) register
+ * a handler with add().  The handler is executed on one of the worker
+ * threads either when it is explicitly triggered, or when the socket
+ * passed to arm() becomes readable.  Sockets are watched in "one shot"
+ * mode: once the handler has been dispatched, the socket is not watched
+ * again until arm() is called again.  This guarantees that a handler is
+ * never executed concurrently with itself.
+ *
+ * The reactor is disabled by default.  It is enabled for the whole
+ * process by setting the `YARP_PORT_REACTOR` environment variable to the
+ * number of worker threads to use (for example `YARP_PORT_REACTOR=4`)
+ * before the first port is opened.  It is available only on Linux, since
+ * it relies on epoll.  When disabled, or when unavailable, getInstance()
+ * returns nullptr and each connection uses its own thread, as usual.
+ *
+ * Handlers are allowed to block (a whole message is read or written
+ * synchronously by the worker thread, and a port may wait for the user to
+ * read a message).  When a handler is queued and all the workers are busy,
+ * a new worker is started, and it is stopped once it has been idle for
+ * idleTimeout seconds.  The number of threads therefore follows the
+ * number of connections transferring data at the same time, not the number
+ * of connections that are open.
+ *
+ * The number of workers is capped (defaultMaxWorkers, or the value of the
+ * `YARP_PORT_REACTOR_MAX_WORKERS` environment variable).  Once the cap is
+ * reached, the handlers that are ready stay queued until a worker is done
+ * with its handler, so a connection whose handler blocks for a long time
+ * (e.g. a port waiting for the user to read a message) delays the others.
+ */
+class YARP_os_impl_API PortCoreReactor
+{
+public:
+    typedef std::function<void()> Handler;
+
+    static constexpr double idleTimeout = 1.0; // s
+    static constexpr size_t defaultMaxWorkers = 64;
+
+    /**
+     * Constructor.
+     *
+     * @param workers number of threads dispatching handlers
+     * @param maxWorkers maximum number of threads started while all the
+     *                   others are busy (at least \a workers)
+     */
+    explicit PortCoreReactor(size_t workers, size_t maxWorkers = defaultMaxWorkers);
+
+    /**
+     * Destructor.  Stops all the threads.  Handlers still registered
+     * are dropped without being executed.
+     */
+    virtual ~PortCoreReactor();
+
+    PortCoreReactor(const PortCoreReactor&) = delete;
+    PortCoreReactor& operator=(const PortCoreReactor&) = delete;
+
+    /**
+     * @return the process-wide reactor, or nullptr if the reactor mode
+     * was not enabled through the `YARP_PORT_REACTOR` environment
+     * variable, or is not supported on this platform.
+     */
+    static PortCoreReactor* getInstance();
+
+    /**
+     * @return true if the reactor is running
+     */
+    bool isValid() const;
+
+    /**
+     * Register a new handler.
+     *
+     * @param handler the function to execute on the worker threads
+     * @return an id for the registration, or -1 on failure
+     */
+    long add(Handler handler);
+
+    /**
+     * Watch a socket, and trigger the handler once it becomes readable
+     * (or it is closed by the other side).
+     *
+     * @param id the registration id returned by add()
+     * @param fd the socket descriptor
+     * @return true on success
+     */
+    bool arm(long id, int fd);
+
+    /**
+     * Queue the handler for execution.  If the handler is already
+     * queued, this does nothing.
+     *
+     * @param id the registration id returned by add()
+     * @return true if the registration exists
+     */
+    bool trigger(long id);
+
+    /**
+     * Unregister a handler.  Once this method returns, the handler is no
+     * longer executing and will never be executed again, unless remove()
+     * is called from the handler itself, in which case the method
+     * returns immediately.
+     *
+     * @param id the registration id returned by add()
+     */
+    void remove(long id);
+
+    /**
+     * @return the number of worker threads currently running
+     */
+    size_t getWorkerCount();
+
+    /**
+     * @return the number of registered handlers
+     */
+    size_t getHandlerCount();
+
+private:
+    struct Registration
+    {
+        Handler handler;
+        int fd {-1};
+        bool armed {false};
+        bool queued {false};
+        bool executing {false};
+        bool rerun {false};
+        std::thread::id executor;
+    };
+
+    void pollLoop();
+    void workLoop();
+
+    // Called with m_mutex locked, after queueing a handler
+    void reserveWorker();
+
+    int m_epollFd {-1};
+    int m_wakeFd {-1};
+    bool m_closing {false};
+    long m_nextId {0};
+    size_t m_minWorkers {0};
+    size_t m_maxWorkers {0};
+    size_t m_runningWorkers {0};
+    size_t m_idleWorkers {0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_workCv;
+    std::condition_variable m_doneCv;
+    std::map<long, Registration> m_registrations;
+    std::deque<long> m_queue;
+
+    std::thread m_poller;
+    std::list<std::thread> m_workers;
+    std::vector<std::thread::id> m_stoppedWorkers;
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_PORTCOREREACTOR_H
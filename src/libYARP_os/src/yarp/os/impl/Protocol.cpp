@@ -149,6 +149,15 @@ void Protocol::setReference(yarp::os::Portable* ref)
 }
 
 
+yarp::os::PortWriter* Protocol::retainReference()
+{
+    if (ref == nullptr || delegate == nullptr) {
+        return nullptr;
+    }
+    return delegate->retainReference();
+}
+
+
 std::string Protocol::getSenderSpecifier() const
 {
     Route r = getRoute();
@@ -95,6 +95,12 @@ public:
         pendingReply = true;
     }
 
+    /**
+     * Keep the object passed with setReference() valid after the end of
+     * the current message, see ConnectionReader::retainReference().
+     */
+    yarp::os::PortWriter* retainReference();
+
 private:
     /**
      * Scan for a receiver modifier in the carrier options, and
@@ -145,6 +145,45 @@ void SocketTwoWayStream::updateAddresses()
     yCDebug(SOCKETTWOWAYSTREAM, "updateAddresses: remote address = %s", remoteAddress.getHost().c_str());
 }
 
+void SocketTwoWayStream::writeBlocks(const Bytes* blocks, size_t count)
+{
+    if (!isOk()) {
+        pending.clear();
+        return;
+    }
+    std::vector<iovec> iov;
+    iov.reserve(count + 1);
+    if (!pending.empty()) {
+        iovec v;
+        v.iov_base = pending.data();
+        v.iov_len = pending.size();
+        iov.push_back(v);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (blocks[i].length() == 0) {
+            continue;
+        }
+        iovec v;
+        v.iov_base = const_cast<char*>(blocks[i].get());
+        v.iov_len = blocks[i].length();
+        iov.push_back(v);
+    }
+    if (iov.empty()) {
+        return;
+    }
+    yarp::conf::ssize_t result;
+    if (haveWriteTimeout) {
+        result = stream.sendv_n(iov.data(), static_cast<int>(iov.size()), &writeTimeout);
+    } else {
+        result = stream.sendv_n(iov.data(), static_cast<int>(iov.size()));
+    }
+    pending.clear();
+    if (result < 0) {
+        happy = false;
+        yCDebug(SOCKETTWOWAYSTREAM, "bad socket write");
+    }
+}
+
 bool SocketTwoWayStream::setTypeOfService(int tos)
 {
     yCDebug(SOCKETTWOWAYSTREAM, "Setting tos = %d", tos);
@@ -19,7 +19,9 @@
 #include <yarp/os/impl/TcpAcceptor.h>
 #include <yarp/os/impl/TcpStream.h>
 
-#ifdef YARP_HAS_ACE // For TCP_CORK definition
+#include <vector>
+
+#ifdef YARP_HAS_ACE // For TCP_NODELAY definition
 #    include <ace/os_include/netinet/os_tcp.h>
 // In one the ACE headers there is a definition of "main" for WIN32
 #    ifdef main
@@ -37,6 +39,11 @@ namespace impl {
 
 /**
  * A stream abstraction for socket communication.  It supports TCP.
+ *
+ * Between beginPacket() and endPacket(), small writes are gathered and
+ * sent together with the following blocks using a single scatter-gather
+ * system call, either when a large block or a sequence of blocks (see
+ * writeBlocks()) is written, or when the stream is flushed.
  */
 class YARP_os_impl_API SocketTwoWayStream :
         public TwoWayStream,
@@ -47,7 +54,8 @@ public:
     SocketTwoWayStream() :
             haveWriteTimeout(false),
             haveReadTimeout(false),
-            happy(false)
+            happy(false),
+            gathering(false)
     {
     }
 
@@ -106,6 +114,10 @@ public:
         if (!isOk()) {
             return -1;
         }
+        if (!pending.empty()) {
+            // The other side may be waiting for this data before replying
+            flush();
+        }
         yarp::conf::ssize_t result;
         if (haveReadTimeout) {
             result = stream.recv_n(b.get(), b.length(), &readTimeout);
@@ -127,6 +139,9 @@ public:
         if (!isOk()) {
             return -1;
         }
+        if (!pending.empty()) {
+            flush();
+        }
         yarp::conf::ssize_t result;
         if (haveReadTimeout) {
             result = stream.recv(b.get(), b.length(), &readTimeout);
@@ -147,6 +162,17 @@ public:
     void write(const Bytes& b) override
     {
         if (!isOk()) {
+            // pending belongs to the writer thread, it is never touched
+            // by interrupt() or close()
+            pending.clear();
+            return;
+        }
+        if (gathering && b.length() < maxGatherCopy) {
+            pending.insert(pending.end(), b.get(), b.get() + b.length());
+            return;
+        }
+        if (!pending.empty()) {
+            writeBlocks(&b, 1);
             return;
         }
         yarp::conf::ssize_t result;
@@ -161,21 +187,13 @@ public:
         }
     }
 
+    void writeBlocks(const Bytes* blocks, size_t count) override;
+
     void flush() override
     {
-#ifdef TCP_CORK
-        int status = 0;
-        int sizeInt = sizeof(int);
-        stream.get_option(IPPROTO_TCP, TCP_CORK, &status, &sizeInt);
-        if (status == 1) {
-            // Remove CORK
-            int zero = 0;
-            stream.set_option(IPPROTO_TCP, TCP_CORK, &zero, sizeof(int));
-            // Set CORK
-            int one = 1;
-            stream.set_option(IPPROTO_TCP, TCP_CORK, &one, sizeof(int));
+        if (!pending.empty()) {
+            writeBlocks(nullptr, 0);
         }
-#endif
     }
 
     bool isOk() const override
@@ -189,20 +207,13 @@ public:
 
     void beginPacket() override
     {
-#ifdef TCP_CORK
-        // Set CORK
-        int one = 1;
-        stream.set_option(IPPROTO_TCP, TCP_CORK, &one, sizeof(int));
-#endif
+        gathering = true;
     }
 
     void endPacket() override
     {
-#ifdef TCP_CORK
-        // Remove CORK
-        int zero = 0;
-        stream.set_option(IPPROTO_TCP, TCP_CORK, &zero, sizeof(int));
-#endif
+        flush();
+        gathering = false;
     }
 
     bool setWriteTimeout(double timeout) override
@@ -230,6 +241,18 @@ public:
     bool setTypeOfService(int tos) override;
     int getTypeOfService() override;
 
+    /**
+     * @return the socket descriptor, or -1 if not available
+     */
+    int getSocket()
+    {
+#if defined(_WIN32)
+        return -1;
+#else
+        return static_cast<int>(stream.get_handle());
+#endif
+    }
+
 private:
     yarp::os::impl::TcpStream stream;
     bool haveWriteTimeout;
@@ -238,6 +261,9 @@ private:
     YARP_timeval readTimeout;
     Contact localAddress, remoteAddress;
     bool happy;
+    bool gathering;            ///< small writes are being gathered
+    std::vector<char> pending; ///< data gathered and not sent yet (used by the writer only)
+    static constexpr size_t maxGatherCopy = 1024; ///< larger writes are never copied
     void updateAddresses();
 };
 
@@ -615,7 +615,7 @@ bool StoreList::writeRaw(ConnectionWriter& writer) const
 
 std::int32_t StoreList::subCode() const
 {
-    return subCoder(*(content.implementation));
+    return content.implementation->subCode();
 }
 
 
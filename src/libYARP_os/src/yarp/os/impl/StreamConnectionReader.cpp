@@ -373,6 +373,14 @@ yarp::os::Portable* StreamConnectionReader::getReference() const
     return ref;
 }
 
+yarp::os::PortWriter* StreamConnectionReader::retainReference()
+{
+    if (ref == nullptr || protocol == nullptr) {
+        return nullptr;
+    }
+    return protocol->retainReference();
+}
+
 Bytes StreamConnectionReader::readEnvelope()
 {
     if (protocol != nullptr) {
@@ -80,6 +80,7 @@ public:
     bool isError() const override;
     bool isActive() const override;
     yarp::os::Portable* getReference() const override;
+    yarp::os::PortWriter* retainReference() override;
     yarp::os::Bytes readEnvelope() override;
     void requestDrop() override;
     const yarp::os::Searchable& getConnectionModifiers() const override;
@@ -11,12 +11,34 @@
 
 #include <yarp/os/ConnectionState.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/Name.h>
+#include <yarp/os/Route.h>
+#include <yarp/os/Value.h>
 
 #include <string>
 
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
+namespace {
+
+// Flag of the header of connections that fragment messages
+constexpr int fragmentFlag = 64;
+
+int getModifier(Name& n, const char* mod)
+{
+    bool hasField = false;
+    std::string str = n.getCarrierModifier(mod, &hasField);
+    if (!hasField) {
+        return 0;
+    }
+    Value v;
+    v.fromString(str.c_str());
+    return v.asInt32();
+}
+
+} // namespace
+
 yarp::os::impl::UdpCarrier::UdpCarrier() = default;
 
 yarp::os::Carrier* yarp::os::impl::UdpCarrier::create() const
@@ -41,12 +63,36 @@ bool yarp::os::impl::UdpCarrier::checkHeader(const Bytes& header)
 
 void yarp::os::impl::UdpCarrier::getHeader(Bytes& header) const
 {
-    createStandardHeader(getSpecifierCode(), header);
+    createStandardHeader(getSpecifierCode() + (fragmented ? fragmentFlag : 0), header);
 }
 
 void yarp::os::impl::UdpCarrier::setParameters(const Bytes& header)
 {
-    YARP_UNUSED(header);
+    // I am the receiver, the sender tells if messages are fragmented
+    fragmented = (getSpecifier(header) & fragmentFlag) != 0;
+}
+
+bool yarp::os::impl::UdpCarrier::configure(ConnectionState& proto)
+{
+    // I am the sender
+    Name n(proto.getRoute().getCarrierName() + "://test");
+    int fragment = getModifier(n, "fragment");
+    fecGroup = getModifier(n, "fec");
+    fragmentSize = getModifier(n, "fragment_size");
+    batchSize = getModifier(n, "batch");
+    if (fecGroup < 0 || fragmentSize < 0 || batchSize < 0) {
+        return false;
+    }
+    fragmented = (fragment != 0 || fecGroup > 0 || fragmentSize > 0);
+    return true;
+}
+
+void yarp::os::impl::UdpCarrier::configureStream(DgramTwoWayStream& stream) const
+{
+    stream.setFragmentation(fragmented, fecGroup, fragmentSize);
+    if (batchSize > 0) {
+        stream.setBatchSize(batchSize);
+    }
 }
 
 bool yarp::os::impl::UdpCarrier::requireAck() const
@@ -75,6 +121,8 @@ bool yarp::os::impl::UdpCarrier::respondToHeader(ConnectionState& proto)
         return false;
     }
 
+    configureStream(*stream);
+
     int myPort = stream->getLocalAddress().getPort();
     writeYarpInt(myPort, proto);
     proto.takeStreams(stream);
@@ -104,6 +152,7 @@ bool yarp::os::impl::UdpCarrier::expectReplyToHeader(ConnectionState& proto)
         delete stream;
         return false;
     }
+    configureStream(*stream);
     proto.takeStreams(stream);
     return true;
 }
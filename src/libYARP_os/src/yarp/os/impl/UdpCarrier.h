@@ -19,6 +19,17 @@ namespace impl {
 
 /**
  * Communicating between two ports via UDP.
+ *
+ * Large messages can be split in fragments, reassembled by the receiver,
+ * with the carrier modifiers:
+ *  - fragment.1: enable the fragmentation;
+ *  - fec.N: add a parity fragment every N fragments, so that the receiver
+ *    can rebuild one lost fragment out of N (implies fragment.1);
+ *  - fragment_size.B: maximum size of the data of a fragment, e.g. to fit
+ *    the MTU of the network (implies fragment.1).
+ *
+ * The batch.N modifier sends up to N datagrams with a single system call,
+ * where available.
  */
 class UdpCarrier :
         public AbstractCarrier
@@ -39,6 +50,15 @@ public:
     bool isConnectionless() const override;
     bool respondToHeader(ConnectionState& proto) override;
     bool expectReplyToHeader(ConnectionState& proto) override;
+    bool configure(ConnectionState& proto) override;
+
+protected:
+    void configureStream(DgramTwoWayStream& stream) const;
+
+    bool fragmented {false};
+    int fecGroup {0};
+    int fragmentSize {0};
+    int batchSize {0};
 };
 
 } // namespace impl
@@ -13,7 +13,12 @@
 
 // General files
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cstdio>
+#include <vector>
 
 #include <yarp/os/impl/TcpStream.h>
 #include <yarp/os/impl/LogComponent.h>
@@ -42,6 +47,49 @@ int TcpStream::open()
     return 0;
 }
 
+ssize_t TcpStream::sendv_n(const iovec iov[], int iovcnt)
+{
+#if defined(IOV_MAX)
+    constexpr int maxIov = IOV_MAX;
+#else
+    constexpr int maxIov = 1024;
+#endif
+
+    // Partial writes modify the vector, therefore work on a copy
+    std::vector<iovec> pending(iov, iov + iovcnt);
+    size_t first = 0;
+    ssize_t total = 0;
+
+    while (first < pending.size()) {
+        if (pending[first].iov_len == 0) {
+            first++;
+            continue;
+        }
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &pending[first];
+        msg.msg_iovlen = std::min(pending.size() - first, static_cast<size_t>(maxIov));
+        ssize_t result = ::sendmsg(sd, &msg, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        total += result;
+        auto sent = static_cast<size_t>(result);
+        while (first < pending.size() && sent >= pending[first].iov_len) {
+            sent -= pending[first].iov_len;
+            first++;
+        }
+        if (sent > 0) {
+            pending[first].iov_base = static_cast<char*>(pending[first].iov_base) + sent;
+            pending[first].iov_len -= sent;
+        }
+    }
+    return total;
+}
+
 int TcpStream::get_local_addr(sockaddr & sa)
 {
     int len = sizeof(sa);
@@ -13,6 +13,7 @@
 // General files
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -76,6 +77,21 @@ public:
         return ::send(sd, buf, n, 0);
     }
 
+    /**
+     * Send a sequence of buffers using a single system call whenever
+     * possible (scatter-gather write), retrying until all the data is
+     * sent or an error occurs.
+     *
+     * @return the number of bytes sent, or -1 on error
+     */
+    ssize_t sendv_n(const iovec iov[], int iovcnt);
+
+    inline ssize_t sendv_n(const iovec iov[], int iovcnt, struct timeval *tv)
+    {
+        setsockopt(sd, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<char *>(tv), sizeof (*tv));
+        return sendv_n(iov, iovcnt);
+    }
+
     // No idea what this should do...
     void flush() { }
 
@@ -10,7 +10,9 @@
 #include <yarp/os/Log.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/impl/IplImage.h>
+#include <yarp/sig/impl/PixelConversion.h>
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
@@ -25,6 +27,30 @@ static inline void CopyPixel(const T1 *src, T2 *dest)
     *dest = *src;
 }
 
+// The hue is scaled so that a full turn is 256 units (0 is red, 85 is green
+// and 171 is blue), saturation and value are between 0 and 255.
+static inline void RgbToHsv(int r, int g, int b, PixelHsv* dest)
+{
+    const int maxc = std::max(r, std::max(g, b));
+    const int diff = maxc - std::min(r, std::min(g, b));
+    dest->v = static_cast<unsigned char>(maxc);
+    if (diff == 0) {
+        dest->h = 0;
+        dest->s = 0;
+        return;
+    }
+    dest->s = static_cast<unsigned char>((diff * 255 + maxc / 2) / maxc);
+    int hue; // hue * 6 * diff, between 0 and 6 * diff
+    if (maxc == r) {
+        hue = (g >= b) ? g - b : 6 * diff + g - b;
+    } else if (maxc == g) {
+        hue = 2 * diff + b - r;
+    } else {
+        hue = 4 * diff + r - g;
+    }
+    dest->h = static_cast<unsigned char>((hue * 256 + 3 * diff) / (6 * diff));
+}
+
 /******************************************************************************/
 
 static inline void CopyPixel(const PixelMono* src, PixelRgb* dest)
@@ -131,9 +157,7 @@ static inline void CopyPixel(const PixelRgb* src, PixelInt* dest)
 
 static inline void CopyPixel(const PixelRgb* src, PixelHsv* dest)
 {
-    YARP_UNUSED(src);
-    YARP_UNUSED(dest);
-    yAssert(false); // Not implemented yet
+    RgbToHsv(src->r, src->g, src->b, dest);
 }
 
 static inline void CopyPixel(const PixelRgb* src, PixelMonoSigned* dest)
@@ -309,7 +333,7 @@ static inline void CopyPixel(const PixelBgr* src, PixelInt* dest)
 
 static inline void CopyPixel(const PixelBgr* src, PixelHsv* dest)
 {
-    yAssert(false); // Not implemented yet
+    RgbToHsv(src->r, src->g, src->b, dest);
 }
 
 static inline void CopyPixel(const PixelBgr* src, PixelMonoSigned* dest)
@@ -1264,6 +1288,18 @@ void Image::copyPixels(const unsigned char *src, size_t id1,
         return;
     }
 
+    // Optimized conversion of the most common formats
+    if (const auto* converter = impl::getPixelConverter(static_cast<int>(id1), static_cast<int>(id2))) {
+        const size_t rowSize1 = w * converter->srcPixelSize;
+        const size_t rowSize2 = w * converter->destPixelSize;
+        const size_t step1 = rowSize1 + PAD_BYTES(rowSize1, quantum1);
+        const size_t step2 = rowSize2 + PAD_BYTES(rowSize2, quantum2);
+        const bool flip = topIsLow1 != topIsLow2;
+        for (size_t i = 0; i < h; i++) {
+            converter->convertRow(src + i * step1, dest + (flip ? h - 1 - i : i) * step2, w);
+        }
+        return;
+    }
 
     switch(HASH(id1,id2)) {
         // Macros rely on len, x1, x2 variable names
@@ -21,7 +21,10 @@
 #include <yarp/os/Time.h>
 #include <yarp/os/Vocab.h>
 
+#include <yarp/sig/ImageBufferPool.h>
 #include <yarp/sig/ImageNetworkHeader.h>
+#include <yarp/sig/ImageUtils.h>
+#include <yarp/sig/ImageView.h>
 #include <yarp/sig/impl/IplImage.h>
 #include <yarp/sig/impl/DeBayer.h>
 
@@ -97,6 +100,7 @@ protected:
     void _alloc_data ();
     void _free ();
     void _free_data ();
+    void _release_image_data();
 
     void _make_independent();
     bool _set_ipl_header(size_t x, size_t y, int pixel_type, size_t quantum,
@@ -173,12 +177,13 @@ void ImageStorage::_alloc () {
 
     _free(); // was iplDeallocateImage(pImage); but that won't work with refs
 
-    if ((type_id == VOCAB_PIXEL_MONO_FLOAT) ||
-        (type_id == VOCAB_PIXEL_RGB_FLOAT)  ||
-        (type_id == VOCAB_PIXEL_HSV_FLOAT)) {
-        iplAllocateImageFP(pImage, 0, 0);
+    // as iplAllocateImage(), but reusing the buffers of the pool
+    pImage->imageData = static_cast<char*>(ImageBufferPool::getInstance().allocate(pImage->imageSize));
+    yAssert(pImage->imageData != nullptr);
+    if (pImage->origin == IPL_ORIGIN_TL) {
+        pImage->imageDataOrigin = pImage->imageData + pImage->imageSize - pImage->widthStep;
     } else {
-        iplAllocateImage (pImage, 0, 0);
+        pImage->imageDataOrigin = pImage->imageData;
     }
 
     iplSetBorderMode (pImage, IPL_BORDER_CONSTANT, IPL_SIDE_ALL, 0);
@@ -192,7 +197,7 @@ void ImageStorage::_alloc_extern (const void *buf)
 
     if (pImage != nullptr) {
         if (pImage->imageData != nullptr) {
-            iplDeallocateImage (pImage);
+            _release_image_data();
         }
     }
 
@@ -240,7 +245,7 @@ void ImageStorage::_free ()
     if (pImage != nullptr) {
         if (pImage->imageData != nullptr) {
             if (is_owner) {
-                iplDeallocateImage (pImage);
+                _release_image_data();
                 delete[] Data;
             } else {
                 delete[] Data;
@@ -253,6 +258,14 @@ void ImageStorage::_free ()
     }
 }
 
+// returns the image data to the pool, as iplDeallocateImage()
+void ImageStorage::_release_image_data()
+{
+    ImageBufferPool::getInstance().release(pImage->imageData, pImage->imageSize);
+    pImage->imageData = nullptr;
+    pImage->roi = nullptr;
+}
+
 void ImageStorage::_free_data ()
 {
     yAssert(Data==nullptr); // Now always free Data at same time
@@ -338,8 +351,7 @@ bool ImageStorage::_set_ipl_header(size_t x, size_t y, int pixel_type, size_t qu
                                    bool topIsLow)
 {
     if (pImage != nullptr) {
-        iplDeallocateImage(pImage);
-        pImage = nullptr;
+        _free_complete();
     }
 
     if (pixel_type == VOCAB_PIXEL_INVALID) {
@@ -717,11 +729,11 @@ bool Image::read(yarp::os::ConnectionReader& connection) {
     // Received and current images are binary incompatible do our best to convert
     //
 
-    // handle here all bayer encoding 8 bits
-    if (isBayer8(header.id))
+    // handle here all bayer encodings
+    if (isBayer8(header.id) || isBayer16(header.id))
     {
         FlexImage flex;
-        flex.setPixelCode(VOCAB_PIXEL_MONO);
+        flex.setPixelCode(isBayer8(header.id) ? VOCAB_PIXEL_MONO : VOCAB_PIXEL_MONO16);
         flex.setQuantum(header.quantum);
 
         bool ok = readFromConnection(flex, header, connection);
@@ -729,29 +741,11 @@ bool Image::read(yarp::os::ConnectionReader& connection) {
             return false;
         }
 
-        if (getPixelCode() == VOCAB_PIXEL_BGR && header.id==VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_BGR(flex, *this, 3);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_BGRA && header.id == VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_BGR(flex, *this, 4);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_RGB && header.id==VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_RGB(flex, *this, 3);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_RGBA && header.id == VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_RGB(flex, *this, 4);
+        if (!utils::deBayer(flex, header.id, *this)) {
+            YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding not yet implemented\n");
+            return false;
         }
-
-        YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding not yet implemented\n");
-        return false;
-    }
-
-    // handle here all bayer encodings 16 bits
-    if (isBayer16(header.id))
-    {
-        // as bayer16 seems unlikely we defer implementation for later
-        YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding 16 bits not yet implemented\n");
-        return false;
+        return true;
     }
 
     // Received image has valid YARP pixels and can be converted using Image primitives
@@ -908,27 +902,33 @@ bool Image::copy(const Image& alt, size_t w, size_t h) {
         return copy(img,w,h);
     }
 
-    resize(w,h);
-    size_t d = getPixelSize();
+    return utils::resample(alt, *this, w, h, utils::ResampleMethod::Nearest);
+}
+
 
-    size_t nw = w;
-    size_t nh = h;
-    w = alt.width();
-    h = alt.height();
+bool Image::copy(const ImageView& alt)
+{
+    if (getPixelCode()==0) {
+        setPixelCode(alt.getPixelCode());
+        setQuantum(alt.getQuantum());
+    }
 
-    float di = (static_cast<float>(h))/nh;
-    float dj = (static_cast<float>(w))/nw;
+    // a view of this image
+    const unsigned char* mem = getRawImage();
+    if (!alt.empty() && mem != nullptr && alt.getRow(0) >= mem && alt.getRow(0) < mem + getRawImageSize()) {
+        FlexImage img;
+        img.copy(alt);
+        return copy(img);
+    }
 
-    for (size_t i=0; i<nh; i++)
-        {
-            auto i0 = static_cast<size_t>(di*i);
-            for (size_t j=0; j<nw; j++)
-                {
-                    auto j0 = static_cast<size_t>(dj*j);
-                    memcpy(getPixelAddress(j,i),
-                           alt.getPixelAddress(j0,i0),
-                           d);
-                }
-        }
+    resize(alt.width(),alt.height());
+    const size_t rowSize = width()*getPixelSize();
+    for (size_t r = 0; r < height(); r++) {
+        // one row at a time, as the distance of the rows of the view is arbitrary
+        copyPixels(alt.getRow(r),alt.getPixelCode(),
+                   getRow(r),getPixelCode(),
+                   width(),1,
+                   rowSize,1,1,true,true);
+    }
     return true;
 }
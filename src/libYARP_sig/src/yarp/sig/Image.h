@@ -26,6 +26,7 @@ namespace yarp {
         class Image;
         class FlexImage;
         template <class T> class ImageOf;
+        class ImageView;
 
         /**
          * computes the padding of YARP images.
@@ -139,6 +140,7 @@ public:
      * Scaled copy.
      * Clones the content of another image, and resizes in a fast but
      * low-quality way.
+     * Use yarp::sig::utils::resample() for a better quality.
      * @param alt the image to copy
      * @param w target width for image
      * @param h target height for image
@@ -146,6 +148,16 @@ public:
     bool copy(const Image& alt, size_t w, size_t h);
 
 
+    /**
+     * Copy of a view.
+     * Clones the pixels of a view of an image, converting them to the pixel
+     * type of this image, if it is set.  The image is resized to the size of
+     * the view.
+     * @param alt the view to copy
+     */
+    bool copy(const ImageView& alt);
+
+
     /**
      * Gets width of image in pixels.
      * @return the width of the image in pixels (0 if no image present)
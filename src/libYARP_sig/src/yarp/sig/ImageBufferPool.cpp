@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/ImageBufferPool.h>
+
+#include <yarp/conf/environment.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#elif defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+using yarp::sig::ImageBufferPool;
+
+namespace {
+
+constexpr size_t pageSize = 4096;
+constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+// Smaller buffers are allocated with malloc(), that is fast enough for them
+constexpr size_t minPooledSize = 4 * pageSize;
+
+constexpr size_t defaultLimitMB = 64;
+
+/*
+ * The buffers are multiples of the page size.  Above 8 pages, each power of
+ * two is divided in 8 size classes, therefore at most 1/8 of a buffer is
+ * wasted, and an image reuses the buffer of a slightly larger image.
+ */
+size_t sizeClass(size_t size)
+{
+    size_t pages = (size + pageSize - 1) / pageSize;
+    if (pages > 8) {
+        size_t step = 1;
+        while ((step << 4) <= pages) {
+            step <<= 1;
+        }
+        pages = (pages + step - 1) / step * step;
+    }
+    return pages * pageSize;
+}
+
+void* systemAllocate(size_t size)
+{
+    const size_t alignment = (size >= hugePageSize) ? hugePageSize : pageSize;
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return nullptr;
+    }
+#  if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (size >= hugePageSize) {
+        // just a hint, ignored if transparent huge pages are disabled
+        madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#  endif
+    return ptr;
+#endif
+}
+
+void systemFree(void* ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+} // namespace
+
+
+class ImageBufferPool::Private
+{
+public:
+    struct Buffer
+    {
+        void* ptr;
+        size_t size;
+    };
+
+    // Free the least recently released buffers until the pool fits the limit
+    void trim(size_t limit, std::vector<void*>& freed)
+    {
+        auto it = unused.begin();
+        for (; it != unused.end() && stats.pooledBytes > limit; ++it) {
+            stats.pooledBytes -= it->size;
+            stats.releases++;
+            freed.push_back(it->ptr);
+        }
+        unused.erase(unused.begin(), it);
+    }
+
+    mutable std::mutex mutex;
+    std::vector<Buffer> unused; // in order of release
+    Statistics stats;
+};
+
+
+ImageBufferPool::ImageBufferPool() :
+        mPriv(new Private)
+{
+    mPriv->stats.limitBytes = yarp::conf::environment::get_numeric<size_t>("YARP_IMAGE_POOL_LIMIT", defaultLimitMB) * 1024 * 1024;
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    clear();
+    delete mPriv;
+}
+
+ImageBufferPool& ImageBufferPool::getInstance()
+{
+    // Never destroyed, the images with static storage duration can release
+    // their buffers after the destruction of the other static objects.
+    static auto* instance = new ImageBufferPool;
+    return *instance;
+}
+
+void* ImageBufferPool::allocate(size_t size)
+{
+    if (size < minPooledSize) {
+        return std::malloc(std::max<size_t>(size, 1));
+    }
+
+    const size_t bufferSize = sizeClass(size);
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        auto& unused = mPriv->unused;
+        // the most recently released buffer is more likely to be in the cache
+        for (auto it = unused.rbegin(); it != unused.rend(); ++it) {
+            if (it->size == bufferSize) {
+                void* ptr = it->ptr;
+                unused.erase(std::next(it).base());
+                mPriv->stats.pooledBytes -= bufferSize;
+                mPriv->stats.usedBytes += bufferSize;
+                mPriv->stats.reuses++;
+                return ptr;
+            }
+        }
+    }
+
+    void* ptr = systemAllocate(bufferSize);
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    auto& stats = mPriv->stats;
+    stats.allocations++;
+    stats.usedBytes += bufferSize;
+    stats.peakBytes = std::max(stats.peakBytes, stats.usedBytes + stats.pooledBytes);
+    return ptr;
+}
+
+void ImageBufferPool::release(void* ptr, size_t size)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    if (size < minPooledSize) {
+        std::free(ptr);
+        return;
+    }
+
+    const size_t bufferSize = sizeClass(size);
+    std::vector<void*> freed;
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        auto& stats = mPriv->stats;
+        stats.usedBytes -= bufferSize;
+        if (bufferSize > stats.limitBytes) {
+            stats.releases++;
+            freed.push_back(ptr);
+        } else {
+            mPriv->trim(stats.limitBytes - bufferSize, freed);
+            mPriv->unused.push_back({ptr, bufferSize});
+            stats.pooledBytes += bufferSize;
+        }
+    }
+    for (void* p : freed) {
+        systemFree(p);
+    }
+}
+
+void ImageBufferPool::setLimit(size_t bytes)
+{
+    std::vector<void*> freed;
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        mPriv->stats.limitBytes = bytes;
+        mPriv->trim(bytes, freed);
+    }
+    for (void* p : freed) {
+        systemFree(p);
+    }
+}
+
+void ImageBufferPool::clear()
+{
+    std::vector<void*> freed;
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        mPriv->trim(0, freed);
+    }
+    for (void* p : freed) {
+        systemFree(p);
+    }
+}
+
+ImageBufferPool::Statistics ImageBufferPool::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mPriv->mutex);
+    return mPriv->stats;
+}
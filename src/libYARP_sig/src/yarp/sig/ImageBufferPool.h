@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMAGEBUFFERPOOL_H
+#define YARP_SIG_IMAGEBUFFERPOOL_H
+
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+
+/**
+ * \ingroup sig_class
+ *
+ * Pool of the memory used for the pixels of the images, a singleton.
+ *
+ * When an Image is resized or destroyed, its pixel buffer is returned to the
+ * pool, and it is reused by the next image needing a buffer of the same size
+ * class.  Images streamed through a BufferedPort, even with different
+ * resolutions, are therefore received without allocating memory once the
+ * pool contains a buffer for each resolution.
+ *
+ * The buffers are page aligned, the buffers larger than 2 MB are aligned to
+ * 2 MB and, on Linux, use transparent huge pages.  Small buffers are not
+ * pooled.
+ *
+ * The memory kept in the pool by unused buffers is limited (64 MB by
+ * default, or the number of megabytes in the YARP_IMAGE_POOL_LIMIT
+ * environment variable), the least recently released buffers are freed
+ * first.  A limit of 0 disables the pool.
+ */
+class YARP_sig_API ImageBufferPool
+{
+    ImageBufferPool();
+
+public:
+    /**
+     * Memory usage of the pool.
+     */
+    struct Statistics
+    {
+        size_t allocations {0}; /**< Buffers allocated from the system. */
+        size_t reuses {0};      /**< Buffers taken from the pool. */
+        size_t releases {0};    /**< Unused buffers freed by the pool. */
+        size_t usedBytes {0};   /**< Memory of the buffers in use by the images. */
+        size_t pooledBytes {0}; /**< Memory of the unused buffers in the pool. */
+        size_t peakBytes {0};   /**< Maximum of usedBytes + pooledBytes. */
+        size_t limitBytes {0};  /**< Maximum of pooledBytes. */
+    };
+
+    ImageBufferPool(const ImageBufferPool&) = delete;
+    ImageBufferPool& operator=(const ImageBufferPool&) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~ImageBufferPool();
+
+    /**
+     * @return the pool used by the images.
+     */
+    static ImageBufferPool& getInstance();
+
+    /**
+     * Get a buffer, reusing an unused buffer of the same size class.
+     *
+     * @param size minimum size of the buffer in bytes.
+     * @return the buffer, aligned at least to 8 bytes, to be returned to
+     *         the pool with release(ptr, size).
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Return a buffer to the pool.
+     *
+     * @param ptr a buffer obtained from allocate(), or nullptr.
+     * @param size the size passed to allocate().
+     */
+    void release(void* ptr, size_t size);
+
+    /**
+     * Set the maximum memory kept by the unused buffers.
+     *
+     * @param bytes the limit in bytes, 0 disables the pool.
+     */
+    void setLimit(size_t bytes);
+
+    /**
+     * Free all the unused buffers.
+     */
+    void clear();
+
+    /**
+     * @return the memory usage of the pool.
+     */
+    Statistics getStatistics() const;
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    class Private;
+    Private* const mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMAGEBUFFERPOOL_H
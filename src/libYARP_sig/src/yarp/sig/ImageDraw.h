@@ -13,6 +13,7 @@
 #include <cmath>
 
 #include <yarp/sig/Image.h>
+#include <yarp/sig/ImageView.h>
 
 
 namespace yarp {
@@ -22,11 +23,13 @@ namespace yarp {
          *
          *  Very basic drawing functions, in case you don't have
          *  anything better available.
+         *
+         *  They draw on an ImageOf or on an ImageViewOf.
          */
         namespace draw {
 
-            template <class T>
-            void addSegment(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addSegment(ImageType<T>& dest, const T& pix,
                             int x, int y, int dx, int dy) {
                 const double vx = double(dx - x);
                 const double vy = double(dy - y);
@@ -39,8 +42,8 @@ namespace yarp {
                 }
             }
 
-            template <class T>
-            void addCircle(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addCircle(ImageType<T>& dest, const T& pix,
                            int i, int j, int r) {
                 float d, r2 = (float)(r*r);
                 for (int ii=i-r; ii<=i+r; ii++) {
@@ -53,8 +56,8 @@ namespace yarp {
                 }
             }
 
-            template <class T>
-            void addCrossHair(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addCrossHair(ImageType<T>& dest, const T& pix,
                               int i, int j, int r) {
                 for (int ii=i-r; ii<=i+r; ii++) {
                     for (int jj=j-r; jj<=j+r; jj++) {
@@ -65,8 +68,8 @@ namespace yarp {
                 }
             }
 
-            template <class T>
-            void addCircleOutline(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addCircleOutline(ImageType<T>& dest, const T& pix,
                                   int i, int j, int r) {
                 float d, r2 = float(r*r), r2l = float((r-1.1)*(r-1.1));
                 for (int ii=i-r; ii<=i+r; ii++) {
@@ -79,8 +82,8 @@ namespace yarp {
                 }
             }
 
-            template <class T>
-            void addOvalOutline(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addOvalOutline(ImageType<T>& dest, const T& pix,
                                 int i, int j, int h2, int w2) {
                 float x, y;
                 for (float th=0; th<2.0*3.14159; th+=0.01) {
@@ -91,8 +94,8 @@ namespace yarp {
             }
 
 
-            template <class T>
-            void addRectangleOutline(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addRectangleOutline(ImageType<T>& dest, const T& pix,
                                      int i, int j, int w, int h) {
                 for (int ii=i-w; ii<=i+w; ii++) {
                     dest.safePixel(ii,j-h) = pix;
@@ -111,8 +114,8 @@ namespace yarp {
             /**
              * warning : i, j is x, y center of rectangle
              */
-            template <class T>
-            void addRectangle(ImageOf<T>& dest, const T& pix,
+            template <class T, template <class> class ImageType>
+            void addRectangle(ImageType<T>& dest, const T& pix,
                               int i, int j, int w, int h) {
                 for (int ii=i-w; ii<=i+w; ii++) {
                     for (int jj=j-h; jj<=j+h; jj++) {
@@ -121,8 +124,8 @@ namespace yarp {
                 }
             }
 
-            template <class T>
-            int applyThreshold(ImageOf<T>& src, ImageOf<T>& dest,
+            template <class T, template <class> class SrcImage, template <class> class DestImage>
+            int applyThreshold(SrcImage<T>& src, DestImage<T>& dest,
                                const T& thetalo, const T& thetahi,
                                const T& pix0, const T& pix1) {
                 int h = src.height();
@@ -139,8 +142,8 @@ namespace yarp {
                 return 0;
             }
 
-            template <class T>
-            void setImagePixels(ImageOf<T>& src, const T& pix) {
+            template <class T, template <class> class ImageType>
+            void setImagePixels(ImageType<T>& src, const T& pix) {
                 int h = src.height();
                 int w = src.width();
                 for (int i=0; i<h; i++) {
@@ -7,8 +7,20 @@
  */
 
 #include <yarp/sig/ImageUtils.h>
+#include <yarp/sig/impl/ParallelRows.h>
 #include <cstring>
+#include <cmath>
+#include <cstdint>
 #include <algorithm> // std::math
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define YARP_SIG_RESAMPLE_SSE2 1
+#  include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(__ARM_BIG_ENDIAN)
+#  define YARP_SIG_RESAMPLE_NEON 1
+#  include <arm_neon.h>
+#endif
 
 using namespace yarp::sig;
 
@@ -32,24 +44,27 @@ bool utils::vertSplit(const Image& inImg, Image& outImgL, Image& outImgR)
         return false;
     }
 
-    size_t inHeight = inImg.height();
-    size_t singleImage_rowSizeByte = outImgL.getRowSize();
-    unsigned char *pixelLeft = outImgL.getRawImage();
-    unsigned char *pixelRight = outImgR.getRawImage();
-    unsigned char *pixelInput = inImg.getRawImage();
-
-    for(size_t h=0; h<inHeight; h++)
-    {
-        // Copy the memory
-        memcpy(pixelLeft  + h*singleImage_rowSizeByte, pixelInput, singleImage_rowSizeByte);
-        memcpy(pixelRight + h*singleImage_rowSizeByte, pixelInput+=singleImage_rowSizeByte, singleImage_rowSizeByte);
-
-        // Update the pointers
-        pixelInput+= singleImage_rowSizeByte;
+    // Copy the halves row by row, they do not include the padding of the input rows
+    ImageView viewL, viewR;
+    if (!vertSplit(inImg, viewL, viewR)) {
+        return false;
     }
+    outImgL.copy(viewL);
+    outImgR.copy(viewR);
     return true;
 }
 
+bool utils::vertSplit(const Image& inImg, ImageView& outImgL, ImageView& outImgR)
+{
+    if (inImg.width() % 2 != 0) {
+        return false;
+    }
+    const size_t width = inImg.width() / 2;
+    outImgL = ImageView(inImg, 0, 0, width, inImg.height());
+    outImgR = ImageView(inImg, width, 0, width, inImg.height());
+    return !outImgL.empty();
+}
+
 bool utils::horzSplit(const Image& inImg, Image& outImgUp, Image& outImgDown)
 {
     outImgUp.resize(inImg.width(), inImg.height()/2);
@@ -66,6 +81,17 @@ bool utils::horzSplit(const Image& inImg, Image& outImgUp, Image& outImgDown)
 }
 
 
+bool utils::horzSplit(const Image& inImg, ImageView& outImgUp, ImageView& outImgDown)
+{
+    if (inImg.height() % 2 != 0) {
+        return false;
+    }
+    const size_t height = inImg.height() / 2;
+    outImgUp = ImageView(inImg, 0, 0, inImg.width(), height);
+    outImgDown = ImageView(inImg, 0, height, inImg.width(), height);
+    return !outImgUp.empty();
+}
+
 
 bool utils::horzConcat(const Image& inImgL, const Image& inImgR, Image& outImg)
 {
@@ -132,15 +158,384 @@ bool utils::cropRect(const yarp::sig::Image& inImg,
         return false;
     }
 
-    outImg.resize(brx - tlx + 1, bry - tly + 1); // width, height
+    outImg.copy(ImageView(inImg, tlx, tly, brx - tlx + 1, bry - tly + 1));
+    return true;
+}
+
+bool utils::cropRect(const yarp::sig::Image& inImg,
+                     const std::pair<unsigned int, unsigned int>& vertex1,
+                     const std::pair<unsigned int, unsigned int>& vertex2,
+                     yarp::sig::ImageView& outImg)
+{
+    // Normalize vertices: upper-left (tlx,tly) and bottom-right (brx,bry) corners
+    auto tlx = std::min(vertex1.first, vertex2.first);
+    auto tly = std::min(vertex1.second, vertex2.second);
+    auto brx = std::max(vertex1.first, vertex2.first);
+    auto bry = std::max(vertex1.second, vertex2.second);
+
+    if (!inImg.isPixel(brx, bry)) {
+        return false;
+    }
+
+    outImg = ImageView(inImg, tlx, tly, brx - tlx + 1, bry - tly + 1);
+    return true;
+}
+
+namespace {
+
+// Input pixels contributing to each output pixel, along one axis of the image
+struct Taps
+{
+    size_t count {1};          // taps for each output pixel
+    std::vector<size_t> index; // input pixel of each tap
+    std::vector<float> weight; // weight of each tap, they sum to 1 for each output pixel
+};
+
+Taps bilinearTaps(size_t inSize, size_t outSize)
+{
+    Taps taps;
+    taps.count = 2;
+    taps.index.resize(outSize * taps.count);
+    taps.weight.resize(outSize * taps.count);
+    const double scale = static_cast<double>(inSize) / outSize;
+    for (size_t o = 0; o < outSize; o++) {
+        const double x = std::min(std::max((o + 0.5) * scale - 0.5, 0.0), static_cast<double>(inSize - 1));
+        const auto x0 = static_cast<size_t>(x);
+        const auto f = static_cast<float>(x - x0);
+        taps.index[o * 2] = x0;
+        taps.index[o * 2 + 1] = std::min(x0 + 1, inSize - 1);
+        taps.weight[o * 2] = 1.0F - f;
+        taps.weight[o * 2 + 1] = f;
+    }
+    return taps;
+}
+
+Taps areaTaps(size_t inSize, size_t outSize)
+{
+    if (outSize >= inSize) {
+        return bilinearTaps(inSize, outSize);
+    }
+    Taps taps;
+    const double scale = static_cast<double>(inSize) / outSize;
+    taps.count = static_cast<size_t>(std::ceil(scale)) + ((inSize % outSize != 0) ? 1 : 0);
+    taps.index.resize(outSize * taps.count);
+    taps.weight.resize(outSize * taps.count);
+    for (size_t o = 0; o < outSize; o++) {
+        const double begin = o * scale;
+        const double end = std::min((o + 1) * scale, static_cast<double>(inSize));
+        const auto first = static_cast<size_t>(begin);
+        for (size_t k = 0; k < taps.count; k++) {
+            const size_t i = first + k;
+            const double overlap = std::min(end, i + 1.0) - std::max(begin, static_cast<double>(i));
+            taps.index[o * taps.count + k] = std::min(i, inSize - 1);
+            taps.weight[o * taps.count + k] = (i < inSize && overlap > 0.0) ? static_cast<float>(overlap / (end - begin)) : 0.0F;
+        }
+    }
+    return taps;
+}
+
+Taps boxTaps(size_t factor, size_t outSize)
+{
+    Taps taps;
+    taps.count = factor;
+    taps.index.resize(outSize * factor);
+    taps.weight.assign(outSize * factor, 1.0F / factor);
+    for (size_t i = 0; i < outSize * factor; i++) {
+        taps.index[i] = i;
+    }
+    return taps;
+}
+
+// 8 bit channels are resampled in fixed point arithmetic, with weights
+// summing to 2^11, the others in floating point.
+constexpr int weightBits = 11;
+
+void convertWeights(const Taps& taps, std::vector<float>& weights)
+{
+    weights = taps.weight;
+}
+
+void convertWeights(const Taps& taps, std::vector<std::int32_t>& weights)
+{
+    weights.resize(taps.weight.size());
+    for (size_t o = 0; o < weights.size(); o += taps.count) {
+        std::int32_t sum = 0;
+        size_t largest = o;
+        for (size_t k = o; k < o + taps.count; k++) {
+            weights[k] = static_cast<std::int32_t>(std::lround(taps.weight[k] * (1 << weightBits)));
+            sum += weights[k];
+            largest = (weights[k] > weights[largest]) ? k : largest;
+        }
+        // make sure that the weights sum exactly to 1
+        weights[largest] += (1 << weightBits) - sum;
+    }
+}
+
+inline void storeChannel(std::int32_t sum, unsigned char& dest)
+{
+    dest = static_cast<unsigned char>(std::min((sum + (1 << (2 * weightBits - 1))) >> (2 * weightBits), 255));
+}
 
-    auto * pixelOut = outImg.getRawImage();
+inline void storeChannel(float sum, std::uint16_t& dest)
+{
+    dest = static_cast<std::uint16_t>(std::min(sum + 0.5F, 65535.0F));
+}
 
-    for (unsigned int row = 0; row < outImg.height(); row++) {
-        const auto * pixelIn = inImg.getPixelAddress(tlx, tly + row);
-        memcpy(pixelOut, pixelIn, outImg.getRowSize());
-        pixelOut += outImg.getRowSize();
+inline void storeChannel(float sum, float& dest)
+{
+    dest = sum;
+}
+
+// Combine the input rows, weighted by the vertical taps of an output row
+template <typename T, typename Acc>
+void combineRows(const T* const* rows, const Acc* weights, size_t n, Acc* dest, size_t length, size_t first = 0)
+{
+    for (size_t j = first; j < length; j++) {
+        Acc sum = 0;
+        for (size_t k = 0; k < n; k++) {
+            sum += weights[k] * static_cast<Acc>(rows[k][j]);
+        }
+        dest[j] = sum;
     }
+}
 
+#if defined(YARP_SIG_RESAMPLE_SSE2)
+void combineRows(const unsigned char* const* rows, const std::int32_t* weights, size_t n, std::int32_t* dest, size_t length)
+{
+    // Two rows at a time: the pixels of the two rows are interleaved and
+    // multiplied by the two weights with a single instruction.
+    const __m128i zero = _mm_setzero_si128();
+    size_t j = 0;
+    for (; j + 16 <= length; j += 16) {
+        __m128i acc0 = zero;
+        __m128i acc1 = zero;
+        __m128i acc2 = zero;
+        __m128i acc3 = zero;
+        for (size_t k = 0; k < n; k += 2) {
+            const bool pair = k + 1 < n;
+            const __m128i w = _mm_set1_epi32(weights[k] | (pair ? (weights[k + 1] << 16) : 0));
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + j));
+            const __m128i b = pair ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + j)) : zero;
+            const __m128i alo = _mm_unpacklo_epi8(a, zero);
+            const __m128i ahi = _mm_unpackhi_epi8(a, zero);
+            const __m128i blo = _mm_unpacklo_epi8(b, zero);
+            const __m128i bhi = _mm_unpackhi_epi8(b, zero);
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi16(alo, blo), w));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi16(alo, blo), w));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi16(ahi, bhi), w));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi16(ahi, bhi), w));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j), acc0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j + 4), acc1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j + 8), acc2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j + 12), acc3);
+    }
+    combineRows<unsigned char, std::int32_t>(rows, weights, n, dest, length, j);
+}
+#elif defined(YARP_SIG_RESAMPLE_NEON)
+void combineRows(const unsigned char* const* rows, const std::int32_t* weights, size_t n, std::int32_t* dest, size_t length)
+{
+    size_t j = 0;
+    for (; j + 16 <= length; j += 16) {
+        uint32x4_t acc0 = vdupq_n_u32(0);
+        uint32x4_t acc1 = vdupq_n_u32(0);
+        uint32x4_t acc2 = vdupq_n_u32(0);
+        uint32x4_t acc3 = vdupq_n_u32(0);
+        for (size_t k = 0; k < n; k++) {
+            const auto w = static_cast<uint16_t>(weights[k]);
+            const uint8x16_t px = vld1q_u8(rows[k] + j);
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(px));
+            const uint16x8_t hi = vmovl_u8(vget_high_u8(px));
+            acc0 = vmlal_n_u16(acc0, vget_low_u16(lo), w);
+            acc1 = vmlal_n_u16(acc1, vget_high_u16(lo), w);
+            acc2 = vmlal_n_u16(acc2, vget_low_u16(hi), w);
+            acc3 = vmlal_n_u16(acc3, vget_high_u16(hi), w);
+        }
+        vst1q_s32(dest + j, vreinterpretq_s32_u32(acc0));
+        vst1q_s32(dest + j + 4, vreinterpretq_s32_u32(acc1));
+        vst1q_s32(dest + j + 8, vreinterpretq_s32_u32(acc2));
+        vst1q_s32(dest + j + 12, vreinterpretq_s32_u32(acc3));
+    }
+    combineRows<unsigned char, std::int32_t>(rows, weights, n, dest, length, j);
+}
+#endif
+
+// Combine the columns, weighted by the horizontal taps of each output pixel
+template <typename T, typename Acc, size_t C>
+void resampleRow(const Acc* src, T* dest, const Taps& taps, const std::vector<Acc>& weights, size_t outWidth)
+{
+    const size_t n = taps.count;
+    const size_t* index = taps.index.data();
+    const Acc* weight = weights.data();
+    static_assert(C <= 4, "Up to 4 channels");
+    for (size_t x = 0; x < outWidth; x++) {
+        // one variable for each channel, so that they are kept in registers
+        Acc sum0 = 0;
+        Acc sum1 = 0;
+        Acc sum2 = 0;
+        Acc sum3 = 0;
+        for (size_t k = 0; k < n; k++) {
+            const Acc* pixel = src + index[k] * C;
+            const Acc w = weight[k];
+            sum0 += w * pixel[0];
+            if (C > 1) {
+                sum1 += w * pixel[1];
+            }
+            if (C > 2) {
+                sum2 += w * pixel[2];
+            }
+            if (C > 3) {
+                sum3 += w * pixel[3];
+            }
+        }
+        storeChannel(sum0, dest[0]);
+        if (C > 1) {
+            storeChannel(sum1, dest[1]);
+        }
+        if (C > 2) {
+            storeChannel(sum2, dest[2]);
+        }
+        if (C > 3) {
+            storeChannel(sum3, dest[3]);
+        }
+        index += n;
+        weight += n;
+        dest += C;
+    }
+}
+
+// Compute the output rows between firstRow and lastRow, combining first the
+// input rows (contiguous in memory), and then the columns.
+template <typename T, typename Acc, size_t C>
+void resampleRows(const Image& inImg, Image& outImg,
+                  const Taps& horz, const std::vector<Acc>& horzWeights,
+                  const Taps& vert, const std::vector<Acc>& vertWeights,
+                  size_t firstRow, size_t lastRow)
+{
+    const size_t n = vert.count;
+    std::vector<const T*> rows(n);
+    std::vector<Acc> combined(inImg.width() * C);
+    for (size_t y = firstRow; y < lastRow; y++) {
+        for (size_t k = 0; k < n; k++) {
+            rows[k] = reinterpret_cast<const T*>(inImg.getRow(vert.index[y * n + k]));
+        }
+        combineRows(rows.data(), vertWeights.data() + y * n, n, combined.data(), combined.size());
+        resampleRow<T, Acc, C>(combined.data(), reinterpret_cast<T*>(outImg.getRow(y)), horz, horzWeights, outImg.width());
+    }
+}
+
+template <typename T, typename Acc, size_t C>
+bool resampleImage(const Image& inImg, Image& outImg, const Taps& horz, const Taps& vert, size_t threads)
+{
+    std::vector<Acc> horzWeights;
+    std::vector<Acc> vertWeights;
+    convertWeights(horz, horzWeights);
+    convertWeights(vert, vertWeights);
+    impl::forEachRowBand(outImg.height(), threads, [&](size_t first, size_t last) {
+        resampleRows<T, Acc, C>(inImg, outImg, horz, horzWeights, vert, vertWeights, first, last);
+    });
     return true;
 }
+
+template <size_t N>
+void copyNearest(const unsigned char* src, unsigned char* dest, const std::vector<size_t>& offsets)
+{
+    for (size_t x = 0; x < offsets.size(); x++) {
+        memcpy(dest + x * N, src + offsets[x], N);
+    }
+}
+
+void copyNearest(const unsigned char* src, unsigned char* dest, const std::vector<size_t>& offsets, size_t pixelSize)
+{
+    for (size_t x = 0; x < offsets.size(); x++) {
+        memcpy(dest + x * pixelSize, src + offsets[x], pixelSize);
+    }
+}
+
+void resampleNearest(const Image& inImg, Image& outImg, size_t threads)
+{
+    // Same sampling of Image::copy(alt, w, h)
+    const size_t pixelSize = inImg.getPixelSize();
+    const float dx = static_cast<float>(inImg.width()) / outImg.width();
+    const float dy = static_cast<float>(inImg.height()) / outImg.height();
+    std::vector<size_t> offsets(outImg.width());
+    for (size_t x = 0; x < offsets.size(); x++) {
+        offsets[x] = static_cast<size_t>(dx * x) * pixelSize;
+    }
+    impl::forEachRowBand(outImg.height(), threads, [&](size_t first, size_t last) {
+        for (size_t y = first; y < last; y++) {
+            const unsigned char* src = inImg.getRow(static_cast<size_t>(dy * y));
+            unsigned char* dest = outImg.getRow(y);
+            switch (pixelSize) {
+            case 1: copyNearest<1>(src, dest, offsets); break;
+            case 2: copyNearest<2>(src, dest, offsets); break;
+            case 3: copyNearest<3>(src, dest, offsets); break;
+            case 4: copyNearest<4>(src, dest, offsets); break;
+            default: copyNearest(src, dest, offsets, pixelSize); break;
+            }
+        }
+    });
+}
+
+} // namespace
+
+bool utils::resample(const Image& inImg, Image& outImg, size_t width, size_t height, ResampleMethod method, size_t threads)
+{
+    if (&inImg == &outImg || inImg.getPixelCode() != outImg.getPixelCode()) {
+        return false;
+    }
+    const size_t inWidth = inImg.width();
+    const size_t inHeight = inImg.height();
+    if (width == 0 || height == 0 || inWidth == 0 || inHeight == 0) {
+        return false;
+    }
+    if (method == ResampleMethod::Box &&
+        (inWidth % width != 0 || inHeight % height != 0 || inWidth / width != inHeight / height)) {
+        return false;
+    }
+
+    outImg.resize(width, height);
+
+    if (method == ResampleMethod::Nearest) {
+        resampleNearest(inImg, outImg, threads);
+        return true;
+    }
+
+    Taps horz;
+    Taps vert;
+    switch (method) {
+    case ResampleMethod::Bilinear:
+        horz = bilinearTaps(inWidth, width);
+        vert = bilinearTaps(inHeight, height);
+        break;
+    case ResampleMethod::Box:
+        horz = boxTaps(inWidth / width, width);
+        vert = boxTaps(inHeight / height, height);
+        break;
+    default:
+        horz = areaTaps(inWidth, width);
+        vert = areaTaps(inHeight, height);
+        break;
+    }
+
+    switch (inImg.getPixelCode()) {
+    case VOCAB_PIXEL_MONO:
+        return resampleImage<unsigned char, std::int32_t, 1>(inImg, outImg, horz, vert, threads);
+    case VOCAB_PIXEL_RGB:
+    case VOCAB_PIXEL_BGR:
+    case VOCAB_PIXEL_HSV:
+        return resampleImage<unsigned char, std::int32_t, 3>(inImg, outImg, horz, vert, threads);
+    case VOCAB_PIXEL_RGBA:
+    case VOCAB_PIXEL_BGRA:
+        return resampleImage<unsigned char, std::int32_t, 4>(inImg, outImg, horz, vert, threads);
+    case VOCAB_PIXEL_MONO16:
+        return resampleImage<std::uint16_t, float, 1>(inImg, outImg, horz, vert, threads);
+    case VOCAB_PIXEL_MONO_FLOAT:
+        return resampleImage<float, float, 1>(inImg, outImg, horz, vert, threads);
+    case VOCAB_PIXEL_RGB_FLOAT:
+    case VOCAB_PIXEL_HSV_FLOAT:
+        return resampleImage<float, float, 3>(inImg, outImg, horz, vert, threads);
+    default:
+        return false;
+    }
+}
@@ -9,8 +9,10 @@
 #ifndef YARP_SIG_IMAGEUTILS_H
 #define YARP_SIG_IMAGEUTILS_H
 
+#include <cstddef>
 #include <utility> // std::pair
 #include <yarp/sig/Image.h>
+#include <yarp/sig/ImageView.h>
 
 namespace yarp {
 namespace sig{
@@ -32,6 +34,16 @@ namespace utils
  */
 bool YARP_sig_API vertSplit(const yarp::sig::Image& inImg, yarp::sig::Image& outImgL, yarp::sig::Image& outImgR);
 
+/**
+ * @brief Split vertically an image in two views of the same size, without copying the pixels.
+ * @param[in] inImg image to be vertically split.
+ * @param[out] outImgL view of the left half of inImg.
+ * @param[out] outImgR view of the right half of inImg.
+ * @note The views refer to the memory of inImg, that must not be resized or destroyed while they are used.
+ * @return true on success, false otherwise.
+ */
+bool YARP_sig_API vertSplit(const yarp::sig::Image& inImg, yarp::sig::ImageView& outImgL, yarp::sig::ImageView& outImgR);
+
 /**
  * @brief Split horizontally an image in two images of the same size.
  * @param[in] inImg image to be horizontally split.
@@ -42,6 +54,16 @@ bool YARP_sig_API vertSplit(const yarp::sig::Image& inImg, yarp::sig::Image& out
  */
 bool YARP_sig_API horzSplit(const yarp::sig::Image& inImg, yarp::sig::Image& outImgUp, yarp::sig::Image& outImgDown);
 
+/**
+ * @brief Split horizontally an image in two views of the same size, without copying the pixels.
+ * @param[in] inImg image to be horizontally split.
+ * @param[out] outImgUp view of the top half of inImg.
+ * @param[out] outImgDown view of the bottom half of inImg.
+ * @note The views refer to the memory of inImg, that must not be resized or destroyed while they are used.
+ * @return true on success, false otherwise.
+ */
+bool YARP_sig_API horzSplit(const yarp::sig::Image& inImg, yarp::sig::ImageView& outImgUp, yarp::sig::ImageView& outImgDown);
+
 /**
  * @brief Concatenate horizontally two images of the same size in one with double width.
  * @param[in] inImgL input left image.
@@ -78,6 +100,80 @@ bool YARP_sig_API cropRect(const yarp::sig::Image& inImg,
                            const std::pair<unsigned int, unsigned int>& vertex1,
                            const std::pair<unsigned int, unsigned int>& vertex2,
                            yarp::sig::Image& outImg);
+
+/**
+ * @brief View of a rectangle area of an image given two opposite vertices, without copying the pixels.
+ * @param[in] inImg input image.
+ * @param[in] vertex1 first vertex of the crop rectangle area.
+ * @param[in] vertex2 second vertex of the crop rectangle area.
+ * @param[out] outImg view of the crop rectangle area of the input image.
+ * @note The crop area must lay within the input image. The view refers to the memory of inImg, that must not be
+ * resized or destroyed while it is used.
+ * @return true on success, false otherwise.
+ */
+bool YARP_sig_API cropRect(const yarp::sig::Image& inImg,
+                           const std::pair<unsigned int, unsigned int>& vertex1,
+                           const std::pair<unsigned int, unsigned int>& vertex2,
+                           yarp::sig::ImageView& outImg);
+
+/**
+ * @brief Method used to compute the pixels of a resampled image.
+ */
+enum class ResampleMethod
+{
+    Nearest,  /**< Nearest pixel, as Image::copy(alt, w, h). Fastest, works with any pixel type. */
+    Bilinear, /**< Bilinear interpolation. Suited for upscaling and small scale factors. */
+    Area,     /**< Average of the input pixels covered by each output pixel. Suited for downscaling. */
+    Box       /**< Average of blocks of NxN input pixels. Downscaling by integer factors only (e.g. 2x, 4x). */
+};
+
+/**
+ * @brief Resample an image to a different size.
+ * @param[in] inImg input image.
+ * @param[out] outImg result of resampling the input image. It is resized to the requested dimensions.
+ * @param[in] width width of the output image.
+ * @param[in] height height of the output image.
+ * @param[in] method how the output pixels are computed.
+ * @param[in] threads number of threads computing the rows of the output image (0 uses one thread for each core).
+ * @note Input and output images must be different and have same pixel type. Except for ResampleMethod::Nearest, the
+ * pixel type must have 8 bit, 16 bit or floating point channels (mono, rgb, bgr, rgba, bgra, hsv, mono16, float, rgb
+ * float, hsv float). ResampleMethod::Box requires the dimensions of the input image to be multiples of the dimensions
+ * of the output image, by the same factor.
+ * @return true on success, false otherwise.
+ */
+bool YARP_sig_API resample(const yarp::sig::Image& inImg,
+                           yarp::sig::Image& outImg,
+                           size_t width,
+                           size_t height,
+                           ResampleMethod method = ResampleMethod::Area,
+                           size_t threads = 1);
+
+/**
+ * @brief Method used to interpolate the colors missing in each pixel of a Bayer image.
+ */
+enum class DemosaicMethod
+{
+    Bilinear,      /**< Average of the nearest pixels with the same color. */
+    MalvarHeCutler /**< Bilinear interpolation corrected by the gradient of the color measured in the pixel (Malvar,
+                        He, Cutler, 2004). Sharper edges, fewer color artifacts. */
+};
+
+/**
+ * @brief Convert a raw Bayer image to a color image.
+ * @param[in] inImg raw image, with 8 bit (mono) or 16 bit (mono16) pixels.
+ * @param[in] bayerCode Bayer pattern and depth of the raw image (VOCAB_PIXEL_ENCODING_BAYER_GRBG8, ...).
+ * @param[out] outImg rgb, bgr, rgba or bgra image. It is resized to match the raw image.
+ * @param[in] method how the missing colors are interpolated.
+ * @param[in] threads number of threads computing the rows of the output image (0 uses one thread for each core).
+ * @note 16 bit pixels are scaled to 8 bit. The borders are interpolated mirroring the image, the image must be at least
+ * 3x3 pixels.
+ * @return true on success, false otherwise.
+ */
+bool YARP_sig_API deBayer(const yarp::sig::Image& inImg,
+                          int bayerCode,
+                          yarp::sig::Image& outImg,
+                          DemosaicMethod method = DemosaicMethod::Bilinear,
+                          size_t threads = 1);
 } // namespace utils
 } // namespace sig
 } // namespace yarp
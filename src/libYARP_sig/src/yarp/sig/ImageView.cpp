@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/ImageView.h>
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/sig/ImageNetworkHeader.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace yarp::sig;
+
+namespace {
+YARP_LOG_COMPONENT(IMAGEVIEW, "yarp.sig.ImageView")
+
+// Source of the padding bytes of the rows
+const char zeros[64] = {};
+
+size_t paddedRowSize(size_t rowSize, size_t quantum)
+{
+    return rowSize + PAD_BYTES(rowSize, std::max<size_t>(quantum, 1));
+}
+} // namespace
+
+
+ImageView::ImageView(const Image& image) :
+        ImageView(image, 0, 0, image.width(), image.height())
+{
+}
+
+ImageView::ImageView(const Image& image, size_t x, size_t y, size_t w, size_t h)
+{
+    if (w == 0 || h == 0 || x + w > image.width() || y + h > image.height()) {
+        return;
+    }
+    m_data = image.getPixelAddress(x, y);
+    m_pixelCode = image.getPixelCode();
+    m_pixelSize = image.getPixelSize();
+    m_width = w;
+    m_height = h;
+    // the rows of the image are stored bottom up if topIsLowIndex() is false
+    m_rowStride = (image.height() > 1) ? image.getRow(1) - image.getRow(0) : static_cast<std::ptrdiff_t>(image.getRowSize());
+    m_quantum = std::max<size_t>(image.getQuantum(), 1);
+}
+
+ImageView::ImageView(unsigned char* data,
+                     int pixelCode,
+                     size_t pixelSize,
+                     size_t w,
+                     size_t h,
+                     std::ptrdiff_t rowStride,
+                     size_t quantum) :
+        m_data(data),
+        m_pixelCode(pixelCode),
+        m_pixelSize(pixelSize),
+        m_width(w),
+        m_height(h),
+        m_rowStride(rowStride),
+        m_quantum(std::max<size_t>(quantum, 1))
+{
+}
+
+ImageView ImageView::subView(size_t x, size_t y, size_t w, size_t h) const
+{
+    if (w == 0 || h == 0 || x + w > m_width || y + h > m_height) {
+        return ImageView();
+    }
+    ImageView view(*this);
+    view.m_data = getPixelAddress(x, y);
+    view.m_width = w;
+    view.m_height = h;
+    return view;
+}
+
+bool ImageView::read(yarp::os::ConnectionReader& connection)
+{
+    connection.convertTextMode();
+
+    ImageNetworkHeader header;
+    if (!connection.expectBlock(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    if (header.width == 0 || header.height == 0) {
+        // as Image::read()
+        return !connection.isError();
+    }
+
+    // the view cannot be resized, nor converted to other pixel types
+    if (static_cast<size_t>(header.width) != m_width || static_cast<size_t>(header.height) != m_height || header.id != m_pixelCode || static_cast<size_t>(header.depth) != m_pixelSize || header.quantum <= 0) {
+        yCError(IMAGEVIEW, "Received a %dx%d image (code %d), cannot be read by a %zux%zu view (code %d)",
+                static_cast<int>(header.width),
+                static_cast<int>(header.height),
+                static_cast<int>(header.id),
+                m_width,
+                m_height,
+                m_pixelCode);
+        return false;
+    }
+    const size_t rowSize = m_width * m_pixelSize;
+    const size_t padding = paddedRowSize(rowSize, header.quantum) - rowSize;
+    if (static_cast<size_t>(header.imgSize) != (rowSize + padding) * m_height) {
+        yCError(IMAGEVIEW, "Received an image with an invalid size");
+        return false;
+    }
+
+    char skipped[sizeof(zeros)];
+    for (size_t r = 0; r < m_height; r++) {
+        if (!connection.expectBlock(reinterpret_cast<char*>(getRow(r)), rowSize)) {
+            return false;
+        }
+        for (size_t left = padding; left > 0;) {
+            const size_t len = std::min(left, sizeof(skipped));
+            if (!connection.expectBlock(skipped, len)) {
+                return false;
+            }
+            left -= len;
+        }
+    }
+    return !connection.isError();
+}
+
+bool ImageView::write(yarp::os::ConnectionWriter& connection) const
+{
+    const size_t rowSize = m_width * m_pixelSize;
+    const size_t paddedSize = paddedRowSize(rowSize, m_quantum);
+
+    // the header of an image
+    ImageNetworkHeader header;
+    header.listTag = BOTTLE_TAG_LIST;
+    header.listLen = 4;
+    header.paramNameTag = BOTTLE_TAG_VOCAB32;
+    header.paramName = yarp::os::createVocab('m', 'a', 't');
+    header.paramIdTag = BOTTLE_TAG_VOCAB32;
+    header.id = m_pixelCode;
+    header.paramListTag = BOTTLE_TAG_LIST + BOTTLE_TAG_INT32;
+    header.paramListLen = 5;
+    header.depth = static_cast<std::int32_t>(m_pixelSize);
+    header.imgSize = static_cast<std::int32_t>(paddedSize * m_height);
+    header.quantum = static_cast<std::int32_t>(m_quantum);
+    header.width = static_cast<std::int32_t>(m_width);
+    header.height = static_cast<std::int32_t>(m_height);
+    header.paramBlobTag = BOTTLE_TAG_BLOB;
+    header.paramBlobLen = header.imgSize;
+    connection.appendBlock(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (m_width != 0 && m_height != 0) {
+        // Note use of external blocks, as in Image::write().
+        const size_t padding = paddedSize - rowSize;
+        auto appendPadding = [&connection](size_t left) {
+            for (; left > 0; left -= std::min(left, sizeof(zeros))) {
+                connection.appendExternalBlock(zeros, std::min(left, sizeof(zeros)));
+            }
+        };
+        if (m_rowStride == static_cast<std::ptrdiff_t>(paddedSize)) {
+            // the rows are contiguous in memory (e.g. a horizontal band of an image)
+            connection.appendExternalBlock(reinterpret_cast<const char*>(m_data), paddedSize * (m_height - 1) + rowSize);
+            appendPadding(padding);
+        } else {
+            for (size_t r = 0; r < m_height; r++) {
+                connection.appendExternalBlock(reinterpret_cast<const char*>(getRow(r)), rowSize);
+                appendPadding(padding);
+            }
+        }
+    }
+
+    // if someone is foolish enough to connect in text mode,
+    // let them see something readable.
+    connection.convertTextMode();
+
+    return !connection.isError();
+}
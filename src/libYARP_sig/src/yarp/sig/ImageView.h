@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMAGEVIEW_H
+#define YARP_SIG_IMAGEVIEW_H
+
+#include <yarp/os/Portable.h>
+#include <yarp/os/Type.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+
+/**
+ * \ingroup sig_class
+ *
+ * A rectangle of the pixels of an image, without a copy of the pixels.
+ *
+ * The view refers to the memory of the image (or of any buffer of pixels),
+ * with the address of its first pixel and the distance in bytes between its
+ * rows.  It does not own the memory: the image must not be resized or
+ * destroyed while the view is used.
+ *
+ * A view is written to a connection as an Image of the same size and pixel
+ * type, the pixels are sent directly from the memory of the image, one row at
+ * a time, and can be read by any Image.  When written through a
+ * BufferedPort, the image must not be modified until the view has been sent.
+ * A view can also read an image of its same size and pixel type, storing the
+ * pixels directly in the memory of the view.
+ */
+class YARP_sig_API ImageView : public yarp::os::Portable
+{
+public:
+    /**
+     * Default constructor, an empty view.
+     */
+    ImageView() = default;
+
+    /**
+     * View of all the pixels of an image.
+     *
+     * @param image the image
+     */
+    ImageView(const Image& image);
+
+    /**
+     * View of a rectangle of the pixels of an image.
+     *
+     * @param image the image
+     * @param x column of the top left pixel of the rectangle
+     * @param y row of the top left pixel of the rectangle
+     * @param w width of the rectangle
+     * @param h height of the rectangle
+     * @note if the rectangle is not inside the image, the view is empty.
+     */
+    ImageView(const Image& image, size_t x, size_t y, size_t w, size_t h);
+
+    /**
+     * View of a buffer of pixels.
+     *
+     * @param data address of the top left pixel
+     * @param pixelCode type of the pixels (VOCAB_PIXEL_RGB, ...)
+     * @param pixelSize size of the pixels in bytes
+     * @param w width of the view
+     * @param h height of the view
+     * @param rowStride distance in bytes between the first pixels of two
+     *        consecutive rows, negative for images stored bottom up
+     * @param quantum the rows of the images written by the view are padded
+     *        to a multiple of this number of bytes
+     */
+    ImageView(unsigned char* data,
+              int pixelCode,
+              size_t pixelSize,
+              size_t w,
+              size_t h,
+              std::ptrdiff_t rowStride,
+              size_t quantum = 1);
+
+    /**
+     * View of a rectangle of the pixels of this view.
+     *
+     * @param x column of the top left pixel of the rectangle
+     * @param y row of the top left pixel of the rectangle
+     * @param w width of the rectangle
+     * @param h height of the rectangle
+     * @return the view, empty if the rectangle is not inside this view.
+     */
+    ImageView subView(size_t x, size_t y, size_t w, size_t h) const;
+
+    /**
+     * @return the width of the view in pixels.
+     */
+    inline size_t width() const { return m_width; }
+
+    /**
+     * @return the height of the view in pixels.
+     */
+    inline size_t height() const { return m_height; }
+
+    /**
+     * @return true if the view contains no pixels.
+     */
+    inline bool empty() const { return m_width == 0 || m_height == 0; }
+
+    /**
+     * @return the type of the pixels.
+     */
+    inline int getPixelCode() const { return m_pixelCode; }
+
+    /**
+     * @return the size of the pixels in bytes.
+     */
+    inline size_t getPixelSize() const { return m_pixelSize; }
+
+    /**
+     * @return the distance in bytes between the first pixels of two
+     *         consecutive rows.
+     */
+    inline std::ptrdiff_t getRowStride() const { return m_rowStride; }
+
+    /**
+     * @return the quantum of the rows of the images written by the view.
+     */
+    inline size_t getQuantum() const { return m_quantum; }
+
+    /**
+     * Get the address of the first pixel of a row.
+     * @param r row number (starting from 0)
+     * @return address of the r-th row
+     */
+    inline unsigned char* getRow(size_t r) const
+    {
+        return m_data + static_cast<std::ptrdiff_t>(r) * m_rowStride;
+    }
+
+    /**
+     * Get the address of a pixel.
+     * @param x x coordinate
+     * @param y y coordinate
+     * @return address of the pixel
+     */
+    inline unsigned char* getPixelAddress(size_t x, size_t y) const
+    {
+        return getRow(y) + x * m_pixelSize;
+    }
+
+    /**
+     * Check whether a coordinate lies within the view.
+     * @param x x coordinate
+     * @param y y coordinate
+     * @return true iff there is a pixel at the given coordinate
+     */
+    inline bool isPixel(size_t x, size_t y) const
+    {
+        return (x < m_width && y < m_height);
+    }
+
+    /**
+     * Read an image of the same size and pixel type of the view, into the
+     * pixels of the view.
+     * @return true iff the image was read correctly
+     */
+    bool read(yarp::os::ConnectionReader& connection) override;
+
+    /**
+     * Write the pixels of the view as an image.
+     * @return true iff the view was written correctly
+     */
+    bool write(yarp::os::ConnectionWriter& connection) const override;
+
+    yarp::os::Type getReadType() const override
+    {
+        return yarp::os::Type::byName("yarp/image");
+    }
+
+private:
+    unsigned char* m_data {nullptr};
+    int m_pixelCode {0};
+    size_t m_pixelSize {0};
+    size_t m_width {0};
+    size_t m_height {0};
+    std::ptrdiff_t m_rowStride {0};
+    size_t m_quantum {1};
+};
+
+
+/**
+ * \ingroup sig_class
+ *
+ * Typed view of a rectangle of the pixels of an image, see ImageView.
+ *
+ * It can be used, as an ImageOf, by the functions in yarp::sig::draw.
+ */
+template <class T>
+class ImageViewOf : public ImageView
+{
+public:
+    /**
+     * Default constructor, an empty view.
+     */
+    ImageViewOf() = default;
+
+    /**
+     * View of all the pixels of an image.
+     *
+     * @param image the image
+     */
+    ImageViewOf(const ImageOf<T>& image) :
+            ImageView(image)
+    {
+    }
+
+    /**
+     * View of a rectangle of the pixels of an image.
+     *
+     * @param image the image
+     * @param x column of the top left pixel of the rectangle
+     * @param y row of the top left pixel of the rectangle
+     * @param w width of the rectangle
+     * @param h height of the rectangle
+     * @note if the rectangle is not inside the image, the view is empty.
+     */
+    ImageViewOf(const ImageOf<T>& image, size_t x, size_t y, size_t w, size_t h) :
+            ImageView(image, x, y, w, h)
+    {
+    }
+
+    /**
+     * View of a rectangle of the pixels of this view.
+     *
+     * @return the view, empty if the rectangle is not inside this view.
+     */
+    ImageViewOf subView(size_t x, size_t y, size_t w, size_t h) const
+    {
+        return ImageViewOf(ImageView::subView(x, y, w, h));
+    }
+
+    inline T& pixel(size_t x, size_t y) const
+    {
+        return *(reinterpret_cast<T*>(getPixelAddress(x, y)));
+    }
+
+    inline T& operator()(size_t x, size_t y) const
+    {
+        return pixel(x, y);
+    }
+
+    inline T& safePixel(size_t x, size_t y)
+    {
+        if (!isPixel(x, y)) { return nullPixel; }
+        return pixel(x, y);
+    }
+
+    inline const T& safePixel(size_t x, size_t y) const
+    {
+        if (!isPixel(x, y)) { return nullPixel; }
+        return pixel(x, y);
+    }
+
+private:
+    explicit ImageViewOf(const ImageView& view) :
+            ImageView(view)
+    {
+    }
+
+    T nullPixel {};
+};
+
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMAGEVIEW_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_KDTREE_H
+#define YARP_SIG_KDTREE_H
+
+#include <yarp/sig/PointCloud.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace yarp {
+namespace sig {
+namespace utils {
+
+/**
+ * \ingroup sig_class
+ *
+ * k-d tree of the points of a PointCloud, for searching the points close to
+ * a position, without visiting all the points.
+ *
+ * The tree is stored in a single array, containing a copy of the coordinates
+ * of the points: the root of each subtree is the median of its range of the
+ * array, the points of the left subtree come before it, the points of the
+ * right subtree after it.  Small subtrees are scanned sequentially.
+ *
+ * The searches return the indices of the points in the point cloud.  The
+ * points with NaN or infinite coordinates are not added to the tree.
+ *
+ * T is any point type with x, y, z coordinates (DataXYZ, DataXYZRGBA,
+ * DataXYZNormal, DataXYZNormalRGBA).
+ */
+template <typename T>
+class KdTree
+{
+public:
+    /**
+     * Default constructor, an empty tree.
+     */
+    KdTree() = default;
+
+    /**
+     * Build the tree of the points of a cloud.
+     *
+     * @param cloud the point cloud
+     */
+    explicit KdTree(const yarp::sig::PointCloud<T>& cloud)
+    {
+        setInputCloud(cloud);
+    }
+
+    /**
+     * Build the tree of the points of a cloud, replacing the previous points.
+     *
+     * @param cloud the point cloud
+     */
+    void setInputCloud(const yarp::sig::PointCloud<T>& cloud)
+    {
+        m_nodes.clear();
+        m_nodes.reserve(cloud.size());
+        for (size_t i = 0; i < cloud.size(); ++i) {
+            const T& point = cloud(i);
+            if (std::isfinite(point.x) && std::isfinite(point.y) && std::isfinite(point.z)) {
+                m_nodes.push_back({{point.x, point.y, point.z}, static_cast<uint32_t>(i), 0});
+            }
+        }
+        build(0, m_nodes.size());
+    }
+
+    /**
+     * @return the number of points in the tree.
+     */
+    size_t size() const
+    {
+        return m_nodes.size();
+    }
+
+    /**
+     * Search the points within a distance from a position.
+     *
+     * @param x the x coordinate of the position
+     * @param y the y coordinate of the position
+     * @param z the z coordinate of the position
+     * @param radius the maximum distance from the position (included)
+     * @param[out] indices the indices of the points found, in no particular
+     *             order
+     * @param[out] sqDistances the squared distances of the points found
+     * @return the number of points found
+     */
+    size_t radiusSearch(float x,
+                        float y,
+                        float z,
+                        float radius,
+                        std::vector<size_t>& indices,
+                        std::vector<float>& sqDistances) const
+    {
+        indices.clear();
+        sqDistances.clear();
+        if (radius >= 0) {
+            const float query[3] = {x, y, z};
+            searchRadius(query, radius * radius, 0, m_nodes.size(), indices, sqDistances);
+        }
+        return indices.size();
+    }
+
+    /**
+     * Search the points closest to a position.
+     *
+     * @param x the x coordinate of the position
+     * @param y the y coordinate of the position
+     * @param z the z coordinate of the position
+     * @param k the number of points to search
+     * @param[out] indices the indices of the points found, from the closest
+     * @param[out] sqDistances the squared distances of the points found
+     * @return the number of points found, k unless the tree contains less
+     *         points
+     */
+    size_t nearestKSearch(float x,
+                          float y,
+                          float z,
+                          size_t k,
+                          std::vector<size_t>& indices,
+                          std::vector<float>& sqDistances) const
+    {
+        indices.clear();
+        sqDistances.clear();
+        if (k == 0) {
+            return 0;
+        }
+        const float query[3] = {x, y, z};
+        std::vector<Neighbor> heap;
+        heap.reserve(std::min(k, m_nodes.size()));
+        searchNearest(query, k, 0, m_nodes.size(), heap);
+        std::sort_heap(heap.begin(), heap.end());
+        for (const auto& neighbor : heap) {
+            sqDistances.push_back(neighbor.first);
+            indices.push_back(neighbor.second);
+        }
+        return indices.size();
+    }
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    // Ranges with at most this number of points are not split
+    static constexpr size_t leafSize = 8;
+
+    struct Node
+    {
+        float p[3];
+        uint32_t index;
+        uint32_t axis;
+    };
+
+    // squared distance and index of a point
+    using Neighbor = std::pair<float, size_t>;
+
+    static float sqDistance(const float* query, const Node& node)
+    {
+        const float dx = query[0] - node.p[0];
+        const float dy = query[1] - node.p[1];
+        const float dz = query[2] - node.p[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    void build(size_t first, size_t last)
+    {
+        if (last - first <= leafSize) {
+            return;
+        }
+        // split along the axis with the largest extent
+        float min[3] = {m_nodes[first].p[0], m_nodes[first].p[1], m_nodes[first].p[2]};
+        float max[3] = {min[0], min[1], min[2]};
+        for (size_t i = first + 1; i < last; ++i) {
+            for (size_t a = 0; a < 3; ++a) {
+                min[a] = std::min(min[a], m_nodes[i].p[a]);
+                max[a] = std::max(max[a], m_nodes[i].p[a]);
+            }
+        }
+        uint32_t axis = 0;
+        for (uint32_t a = 1; a < 3; ++a) {
+            if (max[a] - min[a] > max[axis] - min[axis]) {
+                axis = a;
+            }
+        }
+        const size_t mid = first + (last - first) / 2;
+        std::nth_element(m_nodes.begin() + first,
+                         m_nodes.begin() + mid,
+                         m_nodes.begin() + last,
+                         [axis](const Node& a, const Node& b) { return a.p[axis] < b.p[axis]; });
+        m_nodes[mid].axis = axis;
+        build(first, mid);
+        build(mid + 1, last);
+    }
+
+    void searchRadius(const float* query,
+                      float sqRadius,
+                      size_t first,
+                      size_t last,
+                      std::vector<size_t>& indices,
+                      std::vector<float>& sqDistances) const
+    {
+        if (last - first <= leafSize) {
+            for (size_t i = first; i < last; ++i) {
+                const float d = sqDistance(query, m_nodes[i]);
+                if (d <= sqRadius) {
+                    indices.push_back(m_nodes[i].index);
+                    sqDistances.push_back(d);
+                }
+            }
+            return;
+        }
+        const size_t mid = first + (last - first) / 2;
+        const Node& node = m_nodes[mid];
+        const float d = sqDistance(query, node);
+        if (d <= sqRadius) {
+            indices.push_back(node.index);
+            sqDistances.push_back(d);
+        }
+        const float diff = query[node.axis] - node.p[node.axis];
+        if (diff <= 0 || diff * diff <= sqRadius) {
+            searchRadius(query, sqRadius, first, mid, indices, sqDistances);
+        }
+        if (diff >= 0 || diff * diff <= sqRadius) {
+            searchRadius(query, sqRadius, mid + 1, last, indices, sqDistances);
+        }
+    }
+
+    static void addNeighbor(size_t k, float d, size_t index, std::vector<Neighbor>& heap)
+    {
+        if (heap.size() < k) {
+            heap.emplace_back(d, index);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (d < heap.front().first) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = {d, index};
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    void searchNearest(const float* query,
+                       size_t k,
+                       size_t first,
+                       size_t last,
+                       std::vector<Neighbor>& heap) const
+    {
+        if (last - first <= leafSize) {
+            for (size_t i = first; i < last; ++i) {
+                addNeighbor(k, sqDistance(query, m_nodes[i]), m_nodes[i].index, heap);
+            }
+            return;
+        }
+        const size_t mid = first + (last - first) / 2;
+        const Node& node = m_nodes[mid];
+        addNeighbor(k, sqDistance(query, node), node.index, heap);
+        // the side of the query first, it likely contains the closest points
+        const float diff = query[node.axis] - node.p[node.axis];
+        if (diff < 0) {
+            searchNearest(query, k, first, mid, heap);
+        } else {
+            searchNearest(query, k, mid + 1, last, heap);
+        }
+        if (heap.size() < k || diff * diff < heap.front().first) {
+            if (diff < 0) {
+                searchNearest(query, k, mid + 1, last, heap);
+            } else {
+                searchNearest(query, k, first, mid, heap);
+            }
+        }
+    }
+
+    std::vector<Node> m_nodes;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace utils
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_KDTREE_H
@@ -281,6 +281,20 @@ public:
         header.width = _header.width;
         header.isDense = _header.isDense;
 
+        if (_header.pointType & PC_ENCODING_COMPACT) {
+            const int type = _header.pointType & ~(PC_ENCODING_COMPACT | PC_ENCODING_COMPRESSED);
+            if (header.pointType == type) {
+                return readCompact(connection, _header, reinterpret_cast<char*>(m_storage.data()));
+            }
+            std::vector<char> received(m_storage.size() * pointType2Size(type), 0);
+            if (!readCompact(connection, _header, received.data())) {
+                return false;
+            }
+            std::vector<int> recipe = getComposition(type);
+            copyFromRawData(getRawData(), received.data(), recipe);
+            return true;
+        }
+
         if (header.pointType == _header.pointType) {
             return m_storage.read(connection);
         }
@@ -315,6 +329,9 @@ public:
 
     bool write(yarp::os::ConnectionWriter& writer) const override
     {
+        if (encoding != Encoding::Raw && (header.pointType & PC_XYZ_DATA)) {
+            return writeCompact(writer, encoding == Encoding::CompactCompressed);
+        }
         writer.appendBlock((char*)&header, sizeof(PointCloudNetworkHeader));
         return m_storage.write(writer);
     }
@@ -7,13 +7,36 @@
  */
 
 #include <yarp/sig/PointCloudBase.h>
+#include <yarp/os/NetFloat32.h>
+#include <yarp/os/NetInt32.h>
 #include <yarp/os/Type.h>
+#include <yarp/sig/impl/LZ4Block.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 using namespace yarp::sig;
 
 namespace {
 YARP_LOG_COMPONENT(POINTCLOUDBASE, "yarp.sig.PointCloudBase")
-}
+
+YARP_BEGIN_PACK
+// Follows the PointCloudNetworkHeader in the compact encoding
+struct CompactHeader
+{
+    yarp::os::NetFloat32 offset[3];    // coordinates of the quantized value 0
+    yarp::os::NetFloat32 scale[3];     // coordinates of the quantization step
+    yarp::os::NetInt32 validPoints {0};
+    yarp::os::NetInt32 dataSize {0};    // bytes following this header
+    yarp::os::NetInt32 rawDataSize {0}; // bytes before the compression
+};
+YARP_END_PACK
+
+constexpr int encodingFlags = PC_ENCODING_COMPACT | PC_ENCODING_COMPRESSED;
+constexpr double maxQuantized = 65535.0;
+} // namespace
 
 // Map that contains the offset of the basic types respect the origin of the struct
 // representing the composite types.
@@ -173,3 +196,304 @@ size_t PointCloudBase::getOffset(int type_composite, int type_basic) const
     }
     return offset;
 }
+
+void PointCloudBase::setEncoding(Encoding encoding)
+{
+    this->encoding = encoding;
+}
+
+PointCloudBase::Encoding PointCloudBase::getEncoding() const
+{
+    return encoding;
+}
+
+
+/*
+ * Compact encoding, after the CompactHeader:
+ *  - if some points are not valid, a bit for each point (1 = valid), the
+ *    lowest bit of each byte first
+ *  - for each coordinate, the quantized values of the valid points: the
+ *    difference from the previous point, zigzag encoded (small negative
+ *    differences become small positive numbers), high bytes first, then the
+ *    low bytes.  In organized clouds the neighboring points are close,
+ *    therefore the high bytes are mostly zero and the data is compressible.
+ *  - for each other field of the points (color, normal...), the field of the
+ *    valid points
+ * The padding is not sent.
+ */
+namespace {
+
+struct Field
+{
+    size_t offset;
+    size_t size;
+};
+
+// The fields of the points sent after the coordinates
+std::vector<Field> otherFields(int type)
+{
+    std::vector<Field> fields;
+    auto composition = compositionMap.find(type);
+    if (composition == compositionMap.end()) {
+        return fields;
+    }
+    size_t offset = 0;
+    for (int basic : composition->second) {
+        const size_t size = sizeMap.at(basic);
+        if (basic != PC_XYZ_DATA && basic != PC_PADDING2 && basic != PC_PADDING3) {
+            auto it = offsetMap.find(std::make_pair(type, basic));
+            fields.push_back({it != offsetMap.end() ? it->second : offset, size});
+        }
+        offset += size;
+    }
+    return fields;
+}
+
+size_t compactDataSize(size_t points, size_t validPoints, const std::vector<Field>& fields)
+{
+    size_t size = (validPoints < points) ? (points + 7) / 8 : 0;
+    size += validPoints * 3 * sizeof(uint16_t);
+    for (const auto& field : fields) {
+        size += validPoints * field.size;
+    }
+    return size;
+}
+
+inline bool readCoordinates(const char* point, float* xyz)
+{
+    std::memcpy(xyz, point, 3 * sizeof(float));
+    return std::isfinite(xyz[0]) && std::isfinite(xyz[1]) && std::isfinite(xyz[2]);
+}
+
+// Most of the fields are 4 or 16 bytes, the copies of fixed size are inlined
+inline void copyField(void* dest, const void* src, size_t size)
+{
+    switch (size) {
+    case 4:
+        std::memcpy(dest, src, 4);
+        break;
+    case 16:
+        std::memcpy(dest, src, 16);
+        break;
+    default:
+        std::memcpy(dest, src, size);
+    }
+}
+
+inline uint16_t zigzag(uint16_t delta)
+{
+    return static_cast<uint16_t>((delta << 1) ^ ((delta & 0x8000) ? 0xFFFF : 0));
+}
+
+inline uint16_t unzigzag(uint16_t value)
+{
+    return static_cast<uint16_t>((value >> 1) ^ ((value & 1) ? 0xFFFF : 0));
+}
+
+} // namespace
+
+bool PointCloudBase::writeCompact(yarp::os::ConnectionWriter& writer, bool compress) const
+{
+    const int type = header.pointType;
+    const size_t pointSize = pointType2Size(type);
+    const size_t points = width() * height();
+    const char* data = getRawData();
+    const std::vector<Field> fields = otherFields(type);
+
+    // bounding box of the valid points
+    std::vector<unsigned char> mask((points + 7) / 8, 0);
+    size_t validPoints = 0;
+    float min[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float max[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    float xyz[3];
+    for (size_t i = 0; i < points; ++i) {
+        if (readCoordinates(data + i * pointSize, xyz)) {
+            mask[i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+            validPoints++;
+            for (size_t a = 0; a < 3; ++a) {
+                min[a] = std::min(min[a], xyz[a]);
+                max[a] = std::max(max[a], xyz[a]);
+            }
+        }
+    }
+
+    CompactHeader compactHeader;
+    float scale[3] = {0.0F, 0.0F, 0.0F};
+    for (size_t a = 0; a < 3; ++a) {
+        if (validPoints == 0) {
+            min[a] = 0.0F;
+        } else {
+            scale[a] = static_cast<float>((static_cast<double>(max[a]) - min[a]) / maxQuantized);
+        }
+        compactHeader.offset[a] = min[a];
+        compactHeader.scale[a] = scale[a];
+    }
+    compactHeader.validPoints = static_cast<std::int32_t>(validPoints);
+
+    const size_t rawSize = compactDataSize(points, validPoints, fields);
+    std::vector<char> raw(rawSize);
+    char* out = raw.data();
+    if (validPoints < points) {
+        std::memcpy(out, mask.data(), mask.size());
+        out += mask.size();
+    }
+    char* planes[3][2];
+    for (size_t a = 0; a < 3; ++a) {
+        planes[a][0] = out + 2 * a * validPoints; // high bytes
+        planes[a][1] = planes[a][0] + validPoints; // low bytes
+    }
+    // the values of each field are stored one after the other
+    std::vector<char*> fieldValues;
+    char* values = out + 6 * validPoints;
+    for (const auto& field : fields) {
+        fieldValues.push_back(values);
+        values += validPoints * field.size;
+    }
+    float step[3];
+    for (size_t a = 0; a < 3; ++a) {
+        step[a] = (scale[a] > 0.0F) ? 1.0F / scale[a] : 0.0F;
+    }
+    uint16_t previous[3] = {0, 0, 0};
+    size_t k = 0;
+    for (size_t i = 0; i < points; ++i) {
+        const char* point = data + i * pointSize;
+        if (!(mask[i / 8] & (1 << (i % 8)))) {
+            continue;
+        }
+        readCoordinates(point, xyz);
+        for (size_t a = 0; a < 3; ++a) {
+            const float q = std::min((xyz[a] - min[a]) * step[a] + 0.5F, static_cast<float>(maxQuantized));
+            const auto quantized = static_cast<uint16_t>(std::max(q, 0.0F));
+            const uint16_t value = zigzag(static_cast<uint16_t>(quantized - previous[a]));
+            previous[a] = quantized;
+            planes[a][0][k] = static_cast<char>(value >> 8);
+            planes[a][1][k] = static_cast<char>(value & 0xFF);
+        }
+        for (size_t f = 0; f < fields.size(); ++f) {
+            copyField(fieldValues[f] + k * fields[f].size, point + fields[f].offset, fields[f].size);
+        }
+        k++;
+    }
+
+    PointCloudNetworkHeader compactNetworkHeader = header;
+    compactNetworkHeader.pointType = type | PC_ENCODING_COMPACT;
+    const char* sent = raw.data();
+    size_t sentSize = rawSize;
+    std::vector<char> compressed;
+    if (compress) {
+        compressed.resize(yarp::sig::impl::lz4CompressBound(rawSize));
+        const size_t compressedSize = yarp::sig::impl::lz4Compress(raw.data(), rawSize, compressed.data());
+        if (compressedSize < rawSize) {
+            compactNetworkHeader.pointType = compactNetworkHeader.pointType | PC_ENCODING_COMPRESSED;
+            sent = compressed.data();
+            sentSize = compressedSize;
+        }
+    }
+    compactHeader.dataSize = static_cast<std::int32_t>(sentSize);
+    compactHeader.rawDataSize = static_cast<std::int32_t>(rawSize);
+
+    writer.appendBlock(reinterpret_cast<const char*>(&compactNetworkHeader), sizeof(compactNetworkHeader));
+    writer.appendBlock(reinterpret_cast<const char*>(&compactHeader), sizeof(compactHeader));
+    writer.appendBlock(sent, sentSize);
+    return !writer.isError();
+}
+
+bool PointCloudBase::readCompact(yarp::os::ConnectionReader& connection, const PointCloudNetworkHeader& received, char* points) const
+{
+    const int type = received.pointType & ~encodingFlags;
+    const size_t pointSize = pointType2Size(type);
+    if (received.width < 0 || received.height < 0 || pointSize == 0 || (type & PC_XYZ_DATA) == 0) {
+        yCError(POINTCLOUDBASE, "Invalid point cloud received with the compact encoding");
+        return false;
+    }
+    const size_t count = static_cast<size_t>(received.width) * static_cast<size_t>(received.height);
+    const std::vector<Field> fields = otherFields(type);
+
+    CompactHeader compactHeader;
+    if (!connection.expectBlock(reinterpret_cast<char*>(&compactHeader), sizeof(compactHeader))) {
+        return false;
+    }
+    const size_t validPoints = static_cast<size_t>(std::max<std::int32_t>(compactHeader.validPoints, 0));
+    const size_t rawSize = compactDataSize(count, validPoints, fields);
+    const bool compressed = (received.pointType & PC_ENCODING_COMPRESSED) != 0;
+    const auto dataSize = static_cast<size_t>(std::max<std::int32_t>(compactHeader.dataSize, 0));
+    if (validPoints > count
+        || static_cast<size_t>(compactHeader.rawDataSize) != rawSize
+        || (compressed ? dataSize > yarp::sig::impl::lz4CompressBound(rawSize) : dataSize != rawSize)) {
+        yCError(POINTCLOUDBASE, "Invalid point cloud received with the compact encoding");
+        return false;
+    }
+
+    std::vector<char> data(dataSize);
+    if (!connection.expectBlock(data.data(), dataSize)) {
+        return false;
+    }
+    if (compressed) {
+        std::vector<char> raw(rawSize);
+        if (!yarp::sig::impl::lz4Decompress(data.data(), dataSize, raw.data(), rawSize)) {
+            yCError(POINTCLOUDBASE, "Invalid compressed point cloud received");
+            return false;
+        }
+        data.swap(raw);
+    }
+
+    // indices of the valid points
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data.data());
+    std::vector<size_t> valid;
+    valid.reserve(validPoints);
+    if (validPoints < count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (in[i / 8] & (1 << (i % 8))) {
+                valid.push_back(i);
+            }
+        }
+        in += (count + 7) / 8;
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            valid.push_back(i);
+        }
+    }
+    if (valid.size() != validPoints) {
+        yCError(POINTCLOUDBASE, "Invalid point cloud received with the compact encoding");
+        return false;
+    }
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float invalid[3] = {nan, nan, nan};
+    if (validPoints < count) {
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(points + i * pointSize, invalid, sizeof(invalid));
+        }
+    }
+    const unsigned char* planes[3][2];
+    for (size_t a = 0; a < 3; ++a) {
+        planes[a][0] = in + 2 * a * validPoints;
+        planes[a][1] = planes[a][0] + validPoints;
+    }
+    std::vector<const unsigned char*> fieldValues;
+    const unsigned char* values = in + 6 * validPoints;
+    for (const auto& field : fields) {
+        fieldValues.push_back(values);
+        values += validPoints * field.size;
+    }
+    float offset[3];
+    float scale[3];
+    for (size_t a = 0; a < 3; ++a) {
+        offset[a] = compactHeader.offset[a];
+        scale[a] = compactHeader.scale[a];
+    }
+    uint16_t quantized[3] = {0, 0, 0};
+    float xyz[3];
+    for (size_t k = 0; k < validPoints; ++k) {
+        char* point = points + valid[k] * pointSize;
+        for (size_t a = 0; a < 3; ++a) {
+            quantized[a] = static_cast<uint16_t>(quantized[a] + unzigzag(static_cast<uint16_t>((planes[a][0][k] << 8) | planes[a][1][k])));
+            xyz[a] = offset[a] + quantized[a] * scale[a];
+        }
+        std::memcpy(point, xyz, sizeof(xyz));
+        for (size_t f = 0; f < fields.size(); ++f) {
+            copyField(point + fields[f].offset, fieldValues[f] + k * fields[f].size, fields[f].size);
+        }
+    }
+    return true;
+}
@@ -11,6 +11,10 @@
 
 #include <yarp/sig/PointCloudNetworkHeader.h>
 
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/Portable.h>
+
 #include <cstring>
 #include <map>
 #include <vector>
@@ -28,6 +32,17 @@ namespace sig {
 class YARP_sig_API PointCloudBase : public yarp::os::Portable
 {
 public:
+    /**
+     * @brief Encoding of the points sent through the network.
+     */
+    enum class Encoding
+    {
+        Raw,              /**< The points as they are stored in memory. */
+        Compact,          /**< The coordinates quantized to 16 bits in the bounding box of the cloud, only the points
+                               with valid coordinates (no NaN or Inf). Used only by the point types with x, y, z. */
+        CompactCompressed /**< Compact, and compressed in the LZ4 block format. */
+    };
+
     virtual ~PointCloudBase() = default;
 
     /**
@@ -92,6 +107,19 @@ public:
         return header.isDense != 0;
     }
 
+    /**
+     * @brief Set the encoding of the points sent by write().
+     * The receivers built with an older YARP, not knowing the compact
+     * encodings, can decode them with the pointcloud_compression portmonitor.
+     * @param encoding the encoding, Encoding::Raw by default.
+     */
+    void setEncoding(Encoding encoding);
+
+    /**
+     * @return the encoding of the points sent by write().
+     */
+    Encoding getEncoding() const;
+
 protected:
     PointCloudBase() = default;
 
@@ -103,7 +131,26 @@ protected:
 
     virtual size_t getOffset(int type_composite, int type_basic) const;
 
+    /**
+     * @brief Write the header and the points with the compact encoding.
+     * @param writer the connection.
+     * @param compress whether the compact points are compressed.
+     * @return true on success.
+     */
+    bool writeCompact(yarp::os::ConnectionWriter& writer, bool compress) const;
+
+    /**
+     * @brief Read the points with the compact encoding, following the header.
+     * @param connection the connection.
+     * @param received the header read from the connection.
+     * @param[out] points the buffer receiving the points, with the layout of the type in the received header.
+     * The points with invalid coordinates are set to NaN, their other fields are not written.
+     * @return true on success.
+     */
+    bool readCompact(yarp::os::ConnectionReader& connection, const PointCloudNetworkHeader& received, char* points) const;
+
     yarp::sig::PointCloudNetworkHeader header;
+    Encoding encoding {Encoding::Raw};
 };
 
 
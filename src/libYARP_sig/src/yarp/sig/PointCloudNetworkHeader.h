@@ -18,6 +18,16 @@
 namespace yarp {
 namespace sig {
 
+/**
+ * @brief Bits added to the point type in the PointCloudNetworkHeader, when
+ * the points are not sent as they are stored in memory.
+ */
+enum PointCloudEncodingFlags
+{
+    PC_ENCODING_COMPACT    = (1 << 30), ///< coordinates quantized to 16 bits, only the points with valid coordinates
+    PC_ENCODING_COMPRESSED = (1 << 29)  ///< compact points compressed (LZ4 block)
+};
+
 YARP_BEGIN_PACK
 /**
  * @brief The yarp::sig::PointCloudNetworkHeader class
@@ -9,90 +9,196 @@
 #ifndef YARP_SIG_POINTCLOUDUTILS_INL_H
 #define YARP_SIG_POINTCLOUDUTILS_INL_H
 
-#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
+namespace yarp {
+namespace sig {
+namespace utils {
+namespace impl {
 
-namespace {
-
-template<typename T1,
-         typename T2,
-         std::enable_if_t<std::is_same<T1, yarp::sig::DataXYZRGBA>::value &&
-                          (std::is_same<T2, yarp::sig::PixelRgb>::value ||
-                           std::is_same<T2, yarp::sig::PixelBgr>::value), int> = 0
->
-inline void copyColorData(yarp::sig::PointCloud<T1>& pointCloud,
-                          const yarp::sig::ImageOf<T2>& color,
-                          const size_t u,
-                          const size_t v)
+template<typename T>
+inline bool isFinitePoint(const T& point)
 {
-    pointCloud(u,v).r = color.pixel(u,v).r;
-    pointCloud(u,v).g = color.pixel(u,v).g;
-    pointCloud(u,v).b = color.pixel(u,v).b;
+    return std::isfinite(point.x) && std::isfinite(point.y) && std::isfinite(point.z);
 }
 
-template<typename T1,
-         typename T2,
-         std::enable_if_t<std::is_same<T1, yarp::sig::DataXYZRGBA>::value &&
-                          (std::is_same<T2, yarp::sig::PixelRgba>::value ||
-                           std::is_same<T2, yarp::sig::PixelBgra>::value), int> = 0
->
-inline void copyColorData(yarp::sig::PointCloud<T1>& pointCloud,
-                          const yarp::sig::ImageOf<T2>& color,
-                          const size_t u,
-                          const size_t v)
+template<typename T>
+inline float coordinate(const T& point, Axis axis)
 {
-    pointCloud(u,v).r = color.pixel(u,v).r;
-    pointCloud(u,v).g = color.pixel(u,v).g;
-    pointCloud(u,v).b = color.pixel(u,v).b;
-    pointCloud(u,v).a = color.pixel(u,v).a;
+    switch (axis) {
+    case Axis::X:
+        return point.x;
+    case Axis::Y:
+        return point.y;
+    default:
+        return point.z;
+    }
 }
 
-template<typename T1,
-         typename T2,
-         std::enable_if_t<!std::is_same<T1, yarp::sig::DataXYZRGBA>::value ||
-                          (!std::is_same<T2, yarp::sig::PixelRgb>::value &&
-                           !std::is_same<T2, yarp::sig::PixelBgr>::value &&
-                           !std::is_same<T2, yarp::sig::PixelRgba>::value &&
-                           !std::is_same<T2, yarp::sig::PixelBgra>::value), int> = 0
->
-inline void copyColorData(yarp::sig::PointCloud<T1>& pointCloud,
-                          const yarp::sig::ImageOf<T2>& color,
-                          size_t u,
-                          size_t v)
+// Points selected by the predicate, as an unorganized point cloud
+template<typename T, typename F>
+yarp::sig::PointCloud<T> selectPoints(const yarp::sig::PointCloud<T>& cloud, const F& isSelected)
 {
+    yarp::sig::PointCloud<T> selected;
+    selected.resize(cloud.size());
+    size_t count = 0;
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        if (isFinitePoint(cloud(i)) && isSelected(cloud(i))) {
+            selected(count++) = cloud(i);
+        }
+    }
+    selected.resize(count);
+    return selected;
 }
 
-} // namespace
+} // namespace impl
+} // namespace utils
+} // namespace sig
+} // namespace yarp
 
 template<typename T1, typename T2>
 yarp::sig::PointCloud<T1> yarp::sig::utils::depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
                                                          const yarp::sig::ImageOf<T2>& color,
-                                                         const yarp::sig::IntrinsicParams& intrinsic)
+                                                         const yarp::sig::IntrinsicParams& intrinsic,
+                                                         const yarp::sig::utils::PCL_ROI& roi,
+                                                         size_t step_x,
+                                                         size_t step_y,
+                                                         OrganizationType organization,
+                                                         size_t threads)
 {
-    yAssert(depth.width()  != 0);
-    yAssert(depth.height() != 0);
     yAssert(depth.width()  == color.width());
     yAssert(depth.height() == color.height());
-    size_t w = depth.width();
-    size_t h = depth.height();
+
+    // The color of these points is not copied, only the coordinates are
+    // computed (the specializations for DataXYZRGBA copy the color)
+    auto xyz = depthToPC(depth, intrinsic, roi, step_x, step_y, organization, threads);
     yarp::sig::PointCloud<T1> pointCloud;
-    pointCloud.resize(w, h);
-
-    for (size_t u = 0; u < w; ++u) {
-        for (size_t v = 0; v < h; ++v) {
-            // Depth
-            // De-projection equation (pinhole model):
-            //                          x = (u - ppx)/ fx * z
-            //                          y = (v - ppy)/ fy * z
-            //                          z = z
-            pointCloud(u,v).x = (u - intrinsic.principalPointX)/intrinsic.focalLengthX*depth.pixel(u,v);
-            pointCloud(u,v).y = (v - intrinsic.principalPointY)/intrinsic.focalLengthY*depth.pixel(u,v);
-            pointCloud(u,v).z = depth.pixel(u,v);
-
-            copyColorData(pointCloud, color, u, v);
-        }
+    pointCloud.resize(xyz.width(), xyz.height());
+    for (size_t i = 0; i < xyz.size(); ++i) {
+        pointCloud(i).x = xyz(i).x;
+        pointCloud(i).y = xyz(i).y;
+        pointCloud(i).z = xyz(i).z;
     }
     return pointCloud;
 }
 
+template<typename T>
+yarp::sig::PointCloud<T> yarp::sig::utils::passThrough(const yarp::sig::PointCloud<T>& cloud,
+                                                       Axis axis,
+                                                       float min,
+                                                       float max,
+                                                       bool negative)
+{
+    return impl::selectPoints(cloud, [&](const T& point) {
+        const float c = impl::coordinate(point, axis);
+        return (c >= min && c <= max) != negative;
+    });
+}
+
+template<typename T>
+yarp::sig::PointCloud<T> yarp::sig::utils::cropBox(const yarp::sig::PointCloud<T>& cloud,
+                                                   const yarp::sig::utils::PCL_BOX& box,
+                                                   bool negative)
+{
+    return impl::selectPoints(cloud, [&](const T& point) {
+        const bool inside = point.x >= box.min_x && point.x <= box.max_x &&
+                            point.y >= box.min_y && point.y <= box.max_y &&
+                            point.z >= box.min_z && point.z <= box.max_z;
+        return inside != negative;
+    });
+}
+
+template<typename T>
+yarp::sig::PointCloud<T> yarp::sig::utils::voxelGridDownsample(const yarp::sig::PointCloud<T>& cloud,
+                                                               float leafSize)
+{
+    yAssert(leafSize > 0);
+
+    struct Voxel
+    {
+        int64_t x;
+        int64_t y;
+        int64_t z;
+        size_t index;
+
+        bool operator<(const Voxel& rhs) const
+        {
+            if (x != rhs.x) {
+                return x < rhs.x;
+            }
+            if (y != rhs.y) {
+                return y < rhs.y;
+            }
+            if (z != rhs.z) {
+                return z < rhs.z;
+            }
+            return index < rhs.index;
+        }
+
+        bool sameVoxel(const Voxel& rhs) const
+        {
+            return x == rhs.x && y == rhs.y && z == rhs.z;
+        }
+    };
+
+    // Sorting the points by voxel puts the points of each voxel next to each
+    // other, and does not depend on the extent of the cloud (a hash map or a
+    // dense grid would)
+    const double scale = 1.0 / leafSize;
+    std::vector<Voxel> voxels;
+    voxels.reserve(cloud.size());
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        const T& point = cloud(i);
+        if (impl::isFinitePoint(point)) {
+            voxels.push_back({static_cast<int64_t>(std::floor(point.x * scale)),
+                              static_cast<int64_t>(std::floor(point.y * scale)),
+                              static_cast<int64_t>(std::floor(point.z * scale)),
+                              i});
+        }
+    }
+    std::sort(voxels.begin(), voxels.end());
+
+    yarp::sig::PointCloud<T> downsampled;
+    downsampled.resize(voxels.size());
+    size_t count = 0;
+    for (size_t first = 0, last = 0; first < voxels.size(); first = last) {
+        double x = 0;
+        double y = 0;
+        double z = 0;
+        for (last = first; last < voxels.size() && voxels[last].sameVoxel(voxels[first]); ++last) {
+            const T& point = cloud(voxels[last].index);
+            x += point.x;
+            y += point.y;
+            z += point.z;
+        }
+        const double n = static_cast<double>(last - first);
+        x /= n;
+        y /= n;
+        z /= n;
+
+        size_t closest = voxels[first].index;
+        double closestDistance = std::numeric_limits<double>::infinity();
+        for (size_t i = first; i < last; ++i) {
+            const T& point = cloud(voxels[i].index);
+            const double distance = (point.x - x) * (point.x - x) + (point.y - y) * (point.y - y) + (point.z - z) * (point.z - z);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closest = voxels[i].index;
+            }
+        }
+
+        T& point = downsampled(count++);
+        point = cloud(closest);
+        point.x = static_cast<float>(x);
+        point.y = static_cast<float>(y);
+        point.z = static_cast<float>(z);
+    }
+    downsampled.resize(count);
+    return downsampled;
+}
+
 #endif // YARP_SIG_POINTCLOUDUTILS_INL_H
@@ -7,71 +7,349 @@
  */
 
 #include <yarp/sig/PointCloudUtils.h>
+#include <yarp/sig/impl/ParallelRows.h>
 #include <algorithm>
 #include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define YARP_SIG_POINTCLOUDUTILS_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#  define YARP_SIG_POINTCLOUDUTILS_NEON
+#  include <arm_neon.h>
+#endif
 
 using namespace yarp::sig;
+using yarp::sig::utils::OrganizationType;
+using yarp::sig::utils::PCL_ROI;
 
 namespace {
 YARP_LOG_COMPONENT(POINTCLOUDUTILS, "yarp.sig.PointCloudUtils")
+
+// Offset of the color in DataXYZRGBA
+constexpr size_t colorOffset = 4 * sizeof(float);
+
+// Pixels of the depth image converted to points
+struct Grid
+{
+    size_t min_x;
+    size_t min_y;
+    size_t step_x;
+    size_t step_y;
+    size_t cols;
+    size_t rows;
+};
+
+Grid makeGrid(const ImageOf<PixelFloat>& depth, const PCL_ROI& roi, size_t step_x, size_t step_y)
+{
+    size_t max_x = roi.max_x == 0 ? depth.width()  : std::min(roi.max_x, depth.width());
+    size_t max_y = roi.max_y == 0 ? depth.height() : std::min(roi.max_y, depth.height());
+    size_t min_x = std::min(roi.min_x, max_x);
+    size_t min_y = std::min(roi.min_y, max_y);
+    // avoid step larger than ROI and division by zero
+    step_x = std::max<size_t>(std::min(step_x, max_x - min_x), 1);
+    step_y = std::max<size_t>(std::min(step_y, max_y - min_y), 1);
+    return {min_x, min_y, step_x, step_y, (max_x - min_x) / step_x, (max_y - min_y) / step_y};
 }
 
-PointCloud<DataXYZ> utils::depthToPC(const yarp::sig::ImageOf<PixelFloat> &depth,
-                                     const yarp::sig::IntrinsicParams &intrinsic)
+/*
+ * Color of the points, copied from the pixels of an image to the b, g, r, a
+ * bytes of DataXYZRGBA.  Images without alpha give a = 0.
+ */
+struct NoColor
+{
+    static constexpr size_t pixelSize = 0;
+    static void copy(const unsigned char*, unsigned char*) {}
+};
+
+template <size_t R, size_t G, size_t B, size_t A, size_t PixelSize>
+struct Color
 {
-    yCAssert(POINTCLOUDUTILS, depth.width()  != 0);
+    static constexpr size_t pixelSize = PixelSize;
+    static void copy(const unsigned char* pixel, unsigned char* point)
+    {
+        point[0] = pixel[B];
+        point[1] = pixel[G];
+        point[2] = pixel[R];
+        point[3] = (A < PixelSize) ? pixel[A] : 0;
+    }
+};
+
+using ColorRgb = Color<0, 1, 2, 3, 3>;
+using ColorBgr = Color<2, 1, 0, 3, 3>;
+using ColorRgba = Color<0, 1, 2, 3, 4>;
+using ColorBgra = Color<2, 1, 0, 3, 4>;
+
+inline bool isValid(float z)
+{
+    // false for NaN
+    return z > 0.0F && z < std::numeric_limits<float>::infinity();
+}
+
+/*
+ * De-projection equation (pinhole model):
+ *                          x = (u - ppx)/ fx * z
+ *                          y = (v - ppy)/ fy * z
+ *                          z = z
+ * (u - ppx)/ fx depends only on the column, (v - ppy)/ fy only on the row,
+ * therefore the rays are computed once for each column and once for each row.
+ *
+ * Converts a row of the grid, returning the number of points written at out.
+ * The pixels without a valid depth give a point in the origin, or no point
+ * if the cloud is not organized.
+ */
+template <typename ColorT>
+size_t projectRow(const float* depth,
+                  const unsigned char* color,
+                  const float* rayX,
+                  float rayY,
+                  size_t cols,
+                  size_t step_x,
+                  bool organized,
+                  unsigned char* out,
+                  size_t pointSize)
+{
+    unsigned char* const begin = out;
+    size_t i = 0;
+
+#if defined(YARP_SIG_POINTCLOUDUTILS_SSE2) || defined(YARP_SIG_POINTCLOUDUTILS_NEON)
+    if (step_x == 1) {
+        // 4 points at a time, each stored as x, y, z, 0
+#  if defined(YARP_SIG_POINTCLOUDUTILS_SSE2)
+        const __m128 ry = _mm_set1_ps(rayY);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+#  else
+        const float32x4_t ry = vdupq_n_f32(rayY);
+        const float32x4_t zero = vdupq_n_f32(0.0F);
+        const float32x4_t inf = vdupq_n_f32(std::numeric_limits<float>::infinity());
+#  endif
+        for (; i + 4 <= cols; i += 4) {
+#  if defined(YARP_SIG_POINTCLOUDUTILS_SSE2)
+            __m128 z = _mm_loadu_ps(depth + i);
+            const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(z, zero), _mm_cmplt_ps(z, inf));
+            z = _mm_and_ps(z, valid);
+            __m128 p0 = _mm_mul_ps(_mm_loadu_ps(rayX + i), z);
+            __m128 p1 = _mm_mul_ps(ry, z);
+            __m128 p2 = z;
+            __m128 p3 = zero;
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            const int mask = _mm_movemask_ps(valid);
+            const __m128 points[4] = {p0, p1, p2, p3};
+#  else
+            float32x4_t z = vld1q_f32(depth + i);
+            const uint32x4_t valid = vandq_u32(vcgtq_f32(z, zero), vcltq_f32(z, inf));
+            z = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(z), valid));
+            float32x4x4_t xyz0;
+            xyz0.val[0] = vmulq_f32(vld1q_f32(rayX + i), z);
+            xyz0.val[1] = vmulq_f32(ry, z);
+            xyz0.val[2] = z;
+            xyz0.val[3] = zero;
+            // transpose through the stack, vst4q interleaves the coordinates
+            alignas(16) float points[4][4];
+            vst4q_f32(&points[0][0], xyz0);
+            const int mask = static_cast<int>((vgetq_lane_u32(valid, 0) & 1) | (vgetq_lane_u32(valid, 1) & 2)
+                                              | (vgetq_lane_u32(valid, 2) & 4) | (vgetq_lane_u32(valid, 3) & 8));
+#  endif
+            for (size_t k = 0; k < 4; ++k) {
+#  if defined(YARP_SIG_POINTCLOUDUTILS_SSE2)
+                _mm_storeu_ps(reinterpret_cast<float*>(out), points[k]);
+#  else
+                vst1q_f32(reinterpret_cast<float*>(out), vld1q_f32(points[k]));
+#  endif
+                ColorT::copy(color + (i + k) * ColorT::pixelSize, out + colorOffset);
+                // branchless, the next point overwrites the invalid one
+                out += (organized || ((mask >> k) & 1)) ? pointSize : 0;
+            }
+        }
+    }
+#endif
+
+    for (; i < cols; ++i) {
+        float z = depth[i * step_x];
+        if (!isValid(z)) {
+            if (!organized) {
+                continue;
+            }
+            z = 0.0F;
+        }
+        auto* point = reinterpret_cast<float*>(out);
+        point[0] = rayX[i] * z;
+        point[1] = rayY * z;
+        point[2] = z;
+        point[3] = 0.0F;
+        ColorT::copy(color + i * step_x * ColorT::pixelSize, out + colorOffset);
+        out += pointSize;
+    }
+    return static_cast<size_t>(out - begin) / pointSize;
+}
+
+template <typename T, typename ColorT>
+PointCloud<T> project(const ImageOf<PixelFloat>& depth,
+                      const Image* color,
+                      const IntrinsicParams& intrinsic,
+                      const PCL_ROI& roi,
+                      size_t step_x,
+                      size_t step_y,
+                      OrganizationType organization,
+                      size_t threads)
+{
+    yCAssert(POINTCLOUDUTILS, depth.width() != 0);
     yCAssert(POINTCLOUDUTILS, depth.height() != 0);
-    size_t w = depth.width();
-    size_t h = depth.height();
-    PointCloud<DataXYZ> pointCloud;
-    pointCloud.resize(w, h);
-
-    for (size_t u = 0; u < w; ++u) {
-        for (size_t v = 0; v < h; ++v) {
-            // De-projection equation (pinhole model):
-            //                          x = (u - ppx)/ fx * z
-            //                          y = (v - ppy)/ fy * z
-            //                          z = z
-            pointCloud(u,v).x = (u - intrinsic.principalPointX)/intrinsic.focalLengthX*depth.pixel(u,v);
-            pointCloud(u,v).y = (v - intrinsic.principalPointY)/intrinsic.focalLengthY*depth.pixel(u,v);
-            pointCloud(u,v).z = depth.pixel(u,v);
+
+    const Grid grid = makeGrid(depth, roi, step_x, step_y);
+    const bool organized = (organization == OrganizationType::Organized);
+
+    std::vector<float> rayX(grid.cols);
+    std::vector<float> rayY(grid.rows);
+    for (size_t i = 0; i < grid.cols; ++i) {
+        const size_t u = grid.min_x + i * grid.step_x;
+        rayX[i] = static_cast<float>((u - intrinsic.principalPointX) / intrinsic.focalLengthX);
+    }
+    for (size_t j = 0; j < grid.rows; ++j) {
+        const size_t v = grid.min_y + j * grid.step_y;
+        rayY[j] = static_cast<float>((v - intrinsic.principalPointY) / intrinsic.focalLengthY);
+    }
+
+    PointCloud<T> pointCloud;
+    pointCloud.resize(grid.cols, grid.rows);
+    if (pointCloud.size() == 0) {
+        if (!organized) {
+            pointCloud.resize(0);
         }
+        return pointCloud;
+    }
+    auto* points = reinterpret_cast<unsigned char*>(&pointCloud(0));
+    constexpr size_t pointSize = sizeof(T);
+
+    // Each band of rows writes its points starting from its first row, the
+    // number of points written is stored at the index of the first row
+    std::vector<size_t> bandPoints(grid.rows, 0);
+    yarp::sig::impl::forEachRowBand(grid.rows, threads, [&](size_t first, size_t last) {
+        unsigned char* out = points + first * grid.cols * pointSize;
+        size_t count = 0;
+        for (size_t j = first; j < last; ++j) {
+            const size_t v = grid.min_y + j * grid.step_y;
+            const auto* depthRow = reinterpret_cast<const float*>(depth.getRow(v)) + grid.min_x;
+            const unsigned char* colorRow = nullptr;
+            if (color != nullptr) {
+                colorRow = color->getRow(v) + grid.min_x * ColorT::pixelSize;
+            }
+            count += projectRow<ColorT>(depthRow,
+                                        colorRow,
+                                        rayX.data(),
+                                        rayY[j],
+                                        grid.cols,
+                                        grid.step_x,
+                                        organized,
+                                        out + count * pointSize,
+                                        pointSize);
+        }
+        bandPoints[first] = count;
+    });
+
+    if (!organized) {
+        // Move the points of the bands next to each other
+        size_t size = 0;
+        for (size_t first = 0; first < grid.rows; first++) {
+            const size_t count = bandPoints[first];
+            if (count == 0) {
+                continue;
+            }
+            if (size != first * grid.cols) {
+                std::memmove(points + size * pointSize, points + first * grid.cols * pointSize, count * pointSize);
+            }
+            size += count;
+        }
+        pointCloud.resize(size);
     }
     return pointCloud;
 }
 
+template <typename ColorT, typename T2>
+PointCloud<DataXYZRGBA> projectColor(const ImageOf<PixelFloat>& depth,
+                                     const ImageOf<T2>& color,
+                                     const IntrinsicParams& intrinsic,
+                                     const PCL_ROI& roi,
+                                     size_t step_x,
+                                     size_t step_y,
+                                     OrganizationType organization,
+                                     size_t threads)
+{
+    yCAssert(POINTCLOUDUTILS, depth.width() == color.width());
+    yCAssert(POINTCLOUDUTILS, depth.height() == color.height());
+    return project<DataXYZRGBA, ColorT>(depth, &color, intrinsic, roi, step_x, step_y, organization, threads);
+}
+
+} // namespace
+
+PointCloud<DataXYZ> utils::depthToPC(const yarp::sig::ImageOf<PixelFloat> &depth,
+                                     const yarp::sig::IntrinsicParams &intrinsic)
+{
+    return depthToPC(depth, intrinsic, PCL_ROI(), 1, 1);
+}
+
 PointCloud<DataXYZ> utils::depthToPC(const yarp::sig::ImageOf<PixelFloat>& depth,
                                      const yarp::sig::IntrinsicParams& intrinsic,
                                      const PCL_ROI& roi,
                                      size_t step_x,
-                                     size_t step_y)
+                                     size_t step_y,
+                                     OrganizationType organization,
+                                     size_t threads)
 {
-    yCAssert(POINTCLOUDUTILS, depth.width() != 0);
-    yCAssert(POINTCLOUDUTILS, depth.height() != 0);
+    return project<DataXYZ, NoColor>(depth, nullptr, intrinsic, roi, step_x, step_y, organization, threads);
+}
 
-    size_t max_x = roi.max_x == 0 ? depth.width()  : std::min(roi.max_x, depth.width());
-    size_t max_y = roi.max_y == 0 ? depth.height() : std::min(roi.max_y, depth.height());
-    size_t min_x = std::min(roi.min_x, max_x);
-    size_t min_y = std::min(roi.min_y, max_y);
-    // avoid step larger than ROI and division by zero
-    step_x = std::max<size_t>(std::min(step_x, max_x - min_x), 1);
-    step_y = std::max<size_t>(std::min(step_y, max_y - min_y), 1);
+template<>
+PointCloud<DataXYZRGBA> utils::depthRgbToPC(const yarp::sig::ImageOf<PixelFloat>& depth,
+                                            const yarp::sig::ImageOf<PixelRgb>& color,
+                                            const yarp::sig::IntrinsicParams& intrinsic,
+                                            const PCL_ROI& roi,
+                                            size_t step_x,
+                                            size_t step_y,
+                                            OrganizationType organization,
+                                            size_t threads)
+{
+    return projectColor<ColorRgb>(depth, color, intrinsic, roi, step_x, step_y, organization, threads);
+}
 
-    PointCloud<DataXYZ> pointCloud;
-    size_t size_x = (max_x - min_x) / step_x;
-    size_t size_y = (max_y - min_y) / step_y;
-    pointCloud.resize(size_x, size_y);
-
-    for (size_t i = 0, u = min_x; u < max_x; i++, u += step_x) {
-        for (size_t j = 0, v = min_y; v < max_y; j++, v += step_y) {
-            // De-projection equation (pinhole model):
-            //                          x = (u - ppx)/ fx * z
-            //                          y = (v - ppy)/ fy * z
-            //                          z = z
-            pointCloud(i, j).x = (u - intrinsic.principalPointX) / intrinsic.focalLengthX * depth.pixel(u, v);
-            pointCloud(i, j).y = (v - intrinsic.principalPointY) / intrinsic.focalLengthY * depth.pixel(u, v);
-            pointCloud(i, j).z = depth.pixel(u, v);
-        }
-    }
-    return pointCloud;
+template<>
+PointCloud<DataXYZRGBA> utils::depthRgbToPC(const yarp::sig::ImageOf<PixelFloat>& depth,
+                                            const yarp::sig::ImageOf<PixelBgr>& color,
+                                            const yarp::sig::IntrinsicParams& intrinsic,
+                                            const PCL_ROI& roi,
+                                            size_t step_x,
+                                            size_t step_y,
+                                            OrganizationType organization,
+                                            size_t threads)
+{
+    return projectColor<ColorBgr>(depth, color, intrinsic, roi, step_x, step_y, organization, threads);
+}
+
+template<>
+PointCloud<DataXYZRGBA> utils::depthRgbToPC(const yarp::sig::ImageOf<PixelFloat>& depth,
+                                            const yarp::sig::ImageOf<PixelRgba>& color,
+                                            const yarp::sig::IntrinsicParams& intrinsic,
+                                            const PCL_ROI& roi,
+                                            size_t step_x,
+                                            size_t step_y,
+                                            OrganizationType organization,
+                                            size_t threads)
+{
+    return projectColor<ColorRgba>(depth, color, intrinsic, roi, step_x, step_y, organization, threads);
+}
+
+template<>
+PointCloud<DataXYZRGBA> utils::depthRgbToPC(const yarp::sig::ImageOf<PixelFloat>& depth,
+                                            const yarp::sig::ImageOf<PixelBgra>& color,
+                                            const yarp::sig::IntrinsicParams& intrinsic,
+                                            const PCL_ROI& roi,
+                                            size_t step_x,
+                                            size_t step_y,
+                                            OrganizationType organization,
+                                            size_t threads)
+{
+    return projectColor<ColorBgra>(depth, color, intrinsic, roi, step_x, step_y, organization, threads);
 }
@@ -31,6 +31,16 @@ struct PCL_ROI
     size_t max_y {0};
 };
 
+/**
+ * @brief Points generated for the pixels of the depth image.
+ */
+enum class OrganizationType
+{
+    Organized,  /**< One point for each pixel. The pixels without a valid depth (zero, negative, NaN or infinite)
+                     give a point in the origin. */
+    Unorganized /**< Only the pixels with a valid depth. The point cloud has height 1. */
+};
+
 /**
  * @brief depthToPC, compute the PointCloud given depth image and the intrinsic parameters of the camera.
  * @param[in] depth, the input depth image.
@@ -49,6 +59,8 @@ YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZ> depthToPC(const yarp::sig
  * @param[in] roi, the Region Of Interest intrinsic of the depth image that we want to convert.
  * @param[in] step_x, the depth image size can be decimated, by selecting a column every step_x;
  * @param[in] step_t, the depth image size can be decimated, by selecting a row every step_y;
+ * @param[in] organization, whether the pixels without a valid depth give a point.
+ * @param[in] threads, number of threads computing the points (0 uses one thread for each core).
  * @note the intrinsic parameters are the one of the depth sensor if the depth frame IS NOT aligned with the
  * colored one. On the other hand use the intrinsic parameters of the RGB camera if the frames are aligned.
  * @return the pointcloud obtained by the de-projection.
@@ -57,7 +69,9 @@ YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZ> depthToPC(const yarp::sig
                                                                  const yarp::sig::IntrinsicParams& intrinsic,
                                                                  const yarp::sig::utils::PCL_ROI& roi,
                                                                  size_t step_x,
-                                                                 size_t step_y);
+                                                                 size_t step_y,
+                                                                 OrganizationType organization = OrganizationType::Organized,
+                                                                 size_t threads = 1);
 
 /**
  * @brief depthRgbToPC, compute the colored PointCloud given depth image, color image and the intrinsic
@@ -65,14 +79,133 @@ YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZ> depthToPC(const yarp::sig
  * @param[in] depth, the input depth image.
  * @param[in] color, the input color image.
  * @param[in] intrinsic, intrinsic parameter of the camera.
+ * @param[in] roi, the Region Of Interest intrinsic of the depth image that we want to convert.
+ * @param[in] step_x, the depth image size can be decimated, by selecting a column every step_x;
+ * @param[in] step_t, the depth image size can be decimated, by selecting a row every step_y;
+ * @param[in] organization, whether the pixels without a valid depth give a point.
+ * @param[in] threads, number of threads computing the points (0 uses one thread for each core).
  * @note the intrinsic parameters are the one of the depth sensor if the depth frame IS NOT aligned with the
  * colored one. On the other hand use the intrinsic parameters of the RGB camera if the frames are aligned.
+ * @note the color is copied only to DataXYZRGBA points, from rgb, bgr, rgba and bgra images.
  * @return the pointcloud obtained by the de-projection.
  */
 template<typename T1, typename T2>
 yarp::sig::PointCloud<T1> depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
                                        const yarp::sig::ImageOf<T2>& color,
-                                       const yarp::sig::IntrinsicParams& intrinsic);
+                                       const yarp::sig::IntrinsicParams& intrinsic,
+                                       const yarp::sig::utils::PCL_ROI& roi = PCL_ROI(),
+                                       size_t step_x = 1,
+                                       size_t step_y = 1,
+                                       OrganizationType organization = OrganizationType::Organized,
+                                       size_t threads = 1);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template<>
+YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZRGBA> depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
+                                                                        const yarp::sig::ImageOf<yarp::sig::PixelRgb>& color,
+                                                                        const yarp::sig::IntrinsicParams& intrinsic,
+                                                                        const yarp::sig::utils::PCL_ROI& roi,
+                                                                        size_t step_x,
+                                                                        size_t step_y,
+                                                                        OrganizationType organization,
+                                                                        size_t threads);
+
+template<>
+YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZRGBA> depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
+                                                                        const yarp::sig::ImageOf<yarp::sig::PixelBgr>& color,
+                                                                        const yarp::sig::IntrinsicParams& intrinsic,
+                                                                        const yarp::sig::utils::PCL_ROI& roi,
+                                                                        size_t step_x,
+                                                                        size_t step_y,
+                                                                        OrganizationType organization,
+                                                                        size_t threads);
+
+template<>
+YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZRGBA> depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
+                                                                        const yarp::sig::ImageOf<yarp::sig::PixelRgba>& color,
+                                                                        const yarp::sig::IntrinsicParams& intrinsic,
+                                                                        const yarp::sig::utils::PCL_ROI& roi,
+                                                                        size_t step_x,
+                                                                        size_t step_y,
+                                                                        OrganizationType organization,
+                                                                        size_t threads);
+
+template<>
+YARP_sig_API yarp::sig::PointCloud<yarp::sig::DataXYZRGBA> depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
+                                                                        const yarp::sig::ImageOf<yarp::sig::PixelBgra>& color,
+                                                                        const yarp::sig::IntrinsicParams& intrinsic,
+                                                                        const yarp::sig::utils::PCL_ROI& roi,
+                                                                        size_t step_x,
+                                                                        size_t step_y,
+                                                                        OrganizationType organization,
+                                                                        size_t threads);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Coordinate of the points.
+ */
+enum class Axis
+{
+    X,
+    Y,
+    Z
+};
+
+/**
+ * @brief Box aligned to the axes, bounds included.
+ */
+struct PCL_BOX
+{
+    float min_x {0};
+    float max_x {0};
+    float min_y {0};
+    float max_y {0};
+    float min_z {0};
+    float max_z {0};
+};
+
+/**
+ * @brief passThrough, select the points with a coordinate within a range.
+ * @param[in] cloud, the input point cloud, with points having x, y, z coordinates.
+ * @param[in] axis, the coordinate compared with the range.
+ * @param[in] min, minimum of the range (included).
+ * @param[in] max, maximum of the range (included).
+ * @param[in] negative, select the points outside the range instead.
+ * @note the points with NaN or infinite coordinates are discarded.
+ * @return the selected points, in the same order, as an unorganized point cloud (height 1).
+ */
+template<typename T>
+yarp::sig::PointCloud<T> passThrough(const yarp::sig::PointCloud<T>& cloud,
+                                     Axis axis,
+                                     float min,
+                                     float max,
+                                     bool negative = false);
+
+/**
+ * @brief cropBox, select the points within a box.
+ * @param[in] cloud, the input point cloud, with points having x, y, z coordinates.
+ * @param[in] box, the box.
+ * @param[in] negative, select the points outside the box instead.
+ * @note the points with NaN or infinite coordinates are discarded.
+ * @return the selected points, in the same order, as an unorganized point cloud (height 1).
+ */
+template<typename T>
+yarp::sig::PointCloud<T> cropBox(const yarp::sig::PointCloud<T>& cloud,
+                                 const yarp::sig::utils::PCL_BOX& box,
+                                 bool negative = false);
+
+/**
+ * @brief voxelGridDownsample, reduce the number of points by replacing the points within each cube of a grid
+ * (voxel) with their centroid.
+ * @param[in] cloud, the input point cloud, with points having x, y, z coordinates.
+ * @param[in] leafSize, the side of the voxels, greater than zero.
+ * @note the other fields of each point (color, normal...) are copied from the input point closest to the centroid.
+ * The points with NaN or infinite coordinates are discarded.
+ * @return one point for each voxel containing points, as an unorganized point cloud (height 1).
+ */
+template<typename T>
+yarp::sig::PointCloud<T> voxelGridDownsample(const yarp::sig::PointCloud<T>& cloud,
+                                             float leafSize);
 } // namespace utils
 } // namespace sig
 } // namespace yarp
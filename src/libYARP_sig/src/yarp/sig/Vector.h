@@ -10,9 +10,11 @@
 #ifndef YARP_SIG_VECTOR_H
 #define YARP_SIG_VECTOR_H
 
+#include <algorithm>
 #include <cstring>
 #include <cstddef> //defines size_t
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -116,27 +118,125 @@ inline int BottleTagMap <int> () {
 * that do not allocate internal memory). Template instantiation needs to
 * be checked to avoid unresolved externals. Network communication assumes
 * same data representation (endianness) between machines.
+*
+* Short vectors (up to inlineCapacity elements, 128 bytes) are stored in the
+* object itself, without allocating memory.  The memory allocated for longer
+* vectors is kept when the vector is resized, cleared or assigned, and when a
+* vector of the same size is read from a connection.
 */
 template<class T>
 class yarp::sig::VectorOf : public VectorBase
 {
+public:
+    using iterator       =  T*;
+    using const_iterator =  const T*;
+
+    /**
+     * Number of elements stored in the object itself.
+     */
+    static constexpr size_t inlineCapacity = 128 / sizeof(T);
+
 private:
-    std::vector<T> bytes;
+    T* m_data {inlineData()};
+    size_t m_size {0};
+    size_t m_capacity {inlineCapacity};
+    alignas(T) unsigned char m_inline[inlineCapacity > 0 ? inlineCapacity * sizeof(T) : 1];
 
-public:
-    using iterator       =  typename std::vector<T>::iterator;
-    using const_iterator =  typename std::vector<T>::const_iterator;
+    T* inlineData() { return reinterpret_cast<T*>(m_inline); }
+    bool isInline() const { return m_data == reinterpret_cast<const T*>(m_inline); }
+
+    // Move the elements to a buffer of newCapacity elements (at least size())
+    void reallocate(size_t newCapacity)
+    {
+        T* newData = (newCapacity <= inlineCapacity) ? inlineData() : static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+        if (newData != m_data) {
+            for (size_t i = 0; i < m_size; i++) {
+                new (newData + i) T(std::move(m_data[i]));
+                m_data[i].~T();
+            }
+            if (!isInline()) {
+                ::operator delete(m_data);
+            }
+            m_data = newData;
+        }
+        m_capacity = (newCapacity <= inlineCapacity) ? inlineCapacity : newCapacity;
+    }
+
+    void grow(size_t size)
+    {
+        if (size > m_capacity) {
+            reallocate(std::max(size, 2 * m_capacity));
+        }
+    }
+
+    void destroy(size_t first)
+    {
+        for (size_t i = first; i < m_size; i++) {
+            m_data[i].~T();
+        }
+        m_size = std::min(m_size, first);
+    }
+
+    template <typename... _Args>
+    T& append(_Args&&... args)
+    {
+        if (m_size == m_capacity) {
+            // args could refer to an element of the vector
+            T elem(std::forward<_Args>(args)...);
+            grow(m_size + 1);
+            new (m_data + m_size) T(std::move(elem));
+        } else {
+            new (m_data + m_size) T(std::forward<_Args>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
+    void moveFrom(VectorOf<T>& other) noexcept
+    {
+        if (other.isInline()) {
+            for (size_t i = 0; i < other.m_size; i++) {
+                new (m_data + i) T(std::move(other.m_data[i]));
+            }
+            m_size = other.m_size;
+            other.clear();
+        } else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inlineData();
+            other.m_size = 0;
+            other.m_capacity = inlineCapacity;
+        }
+    }
 
+    void release()
+    {
+        clear();
+        if (!isInline()) {
+            ::operator delete(m_data);
+            m_data = inlineData();
+            m_capacity = inlineCapacity;
+        }
+    }
+
+public:
     VectorOf() = default;
 
-    VectorOf(size_t size) : bytes(size) {
+    VectorOf(size_t size)
+    {
+        this->resize(size);
     }
 
     /**
      * @brief Initializer list constructor.
      * @param[in] values, list of values with which initialize the Vector.
      */
-    VectorOf(std::initializer_list<T> values) : bytes(values) {
+    VectorOf(std::initializer_list<T> values)
+    {
+        reserve(values.size());
+        for (const T& value : values) {
+            append(value);
+        }
     }
 
     /**
@@ -144,7 +244,12 @@ public:
     * @param s the size
     * @param def a default value used to fill the vector
     */
-    VectorOf(size_t s, const T& def) : bytes(s, def) {
+    VectorOf(size_t s, const T& def)
+    {
+        reserve(s);
+        for (size_t i = 0; i < s; i++) {
+            append(def);
+        }
     }
 
     /**
@@ -159,11 +264,50 @@ public:
         memcpy(this->data(), p, sizeof(T)*s);
     }
 
-    VectorOf(const VectorOf& r) = default;
-    VectorOf<T> &operator=(const VectorOf<T>& r) = default;
-    VectorOf(VectorOf<T>&& other) noexcept = default;
-    VectorOf& operator=(VectorOf<T>&& other) noexcept = default;
-    ~VectorOf() override = default;
+    VectorOf(const VectorOf& r) :
+            VectorBase(r)
+    {
+        reserve(r.m_size);
+        for (size_t i = 0; i < r.m_size; i++) {
+            append(r.m_data[i]);
+        }
+    }
+
+    /**
+    * Copy the elements of r, reusing the memory of this vector if it is
+    * large enough.
+    */
+    VectorOf<T> &operator=(const VectorOf<T>& r)
+    {
+        if (this != &r) {
+            clear();
+            reserve(r.m_size);
+            for (size_t i = 0; i < r.m_size; i++) {
+                append(r.m_data[i]);
+            }
+        }
+        return *this;
+    }
+
+    VectorOf(VectorOf<T>&& other) noexcept :
+            VectorBase(std::move(other))
+    {
+        moveFrom(other);
+    }
+
+    VectorOf& operator=(VectorOf<T>&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~VectorOf() override
+    {
+        release();
+    }
 
     size_t getElementSize() const override {
         return sizeof(T);
@@ -175,7 +319,7 @@ public:
 
     size_t getListSize() const override
     {
-        return bytes.size();
+        return m_size;
     }
 
     const char* getMemoryBlock() const override
@@ -208,7 +352,7 @@ public:
     * @return a pointer to double (or nullptr if the vector is of zero length)
     */
     inline T *data()
-    { return bytes.empty() ? nullptr : &(bytes.at(0)); }
+    { return (m_size == 0) ? nullptr : m_data; }
 
     /**
     * Return a pointer to the first element of the vector,
@@ -216,15 +360,24 @@ public:
     * @return a (const) pointer to double (or nullptr if the vector is of zero length)
     */
     inline const T *data() const
-    { return bytes.empty() ? nullptr : &(bytes.at(0)); }
+    { return (m_size == 0) ? nullptr : m_data; }
 
     /**
-    * Resize the vector.
+    * Resize the vector, the new elements are value initialized.
+    * Memory is allocated only if the new size is greater than capacity().
     * @param s the new size
     */
     void resize(size_t size) override
     {
-        bytes.resize(size);
+        if (size < m_size) {
+            destroy(size);
+            return;
+        }
+        grow(size);
+        for (size_t i = m_size; i < size; i++) {
+            new (m_data + i) T();
+        }
+        m_size = size;
     }
 
     /**
@@ -235,7 +388,7 @@ public:
     void resize(size_t size, const T&def)
     {
         this->resize(size);
-        std::fill(bytes.begin(), bytes.end(), def);
+        std::fill(begin(), end(), def);
     }
 
     /**
@@ -244,7 +397,9 @@ public:
      * @param size, new size of the vector.
      */
     void reserve(size_t size) {
-        bytes.reserve(size);
+        if (size > m_capacity) {
+            reallocate(size);
+        }
     }
 
     /**
@@ -252,7 +407,7 @@ public:
     */
     inline void push_back (const T &elem)
     {
-        bytes.push_back(elem);
+        append(elem);
     }
 
     /**
@@ -261,7 +416,7 @@ public:
      */
     inline void push_back (T&& elem)
     {
-        bytes.push_back(std::move(elem));
+        append(std::move(elem));
     }
 
     /**
@@ -272,7 +427,7 @@ public:
     template<typename... _Args>
     inline T& emplace_back(_Args&&... args)
     {
-        bytes.emplace_back(std::forward<_Args>(args)...);
+        return append(std::forward<_Args>(args)...);
     }
 
     /**
@@ -280,7 +435,7 @@ public:
     */
     inline void pop_back()
     {
-        bytes.pop_back();
+        destroy(m_size - 1);
     }
 
     /**
@@ -290,7 +445,7 @@ public:
     */
     inline T &operator[](size_t i)
     {
-        return bytes[i];
+        return m_data[i];
     }
 
     /**
@@ -300,7 +455,7 @@ public:
     */
     inline const T &operator[](size_t i) const
     {
-        return bytes[i];
+        return m_data[i];
     }
 
     /**
@@ -310,7 +465,7 @@ public:
     */
     inline T &operator()(size_t i)
     {
-        return this->data()[i];
+        return m_data[i];
     }
 
     /**
@@ -320,11 +475,11 @@ public:
     */
     inline const T &operator()(size_t i) const
     {
-        return this->data()[i];
+        return m_data[i];
     }
 
     inline size_t size() const {
-        return bytes.size();
+        return m_size;
     }
 
     /**
@@ -339,7 +494,7 @@ public:
      * @return the number of elements that the container has currently allocated space for.
      */
     inline size_t capacity() const {
-        return bytes.capacity();
+        return m_capacity;
     }
 
     /**
@@ -347,7 +502,7 @@ public:
     */
     void zero()
     {
-        std::fill(bytes.begin(), bytes.end(), 0);
+        std::fill(begin(), end(), 0);
     }
 
     /**
@@ -436,7 +591,7 @@ public:
     */
     const VectorOf<T> &operator=(T v)
     {
-        std::fill(bytes.begin(), bytes.end(), v);
+        std::fill(begin(), end(), v);
         return *this;
     }
 
@@ -445,52 +600,56 @@ public:
     */
     bool operator==(const VectorOf<T> &r) const
     {
-        return bytes == r.bytes;
+        return m_size == r.m_size && std::equal(begin(), end(), r.begin());
     }
 
     /**
      * @brief Returns an iterator to the beginning of the VectorOf
      */
     iterator begin() noexcept {
-        return bytes.begin();
+        return m_data;
     }
 
     /**
      * @brief Returns an iterator to the end of the VectorOf
      */
     iterator end() noexcept {
-        return bytes.end();
+        return m_data + m_size;
     }
 
     /**
      * @brief Returns a const iterator to the beginning of the VectorOf
      */
     const_iterator begin() const noexcept {
-        return bytes.begin();
+        return m_data;
     }
 
     /**
      * @brief Returns a const iterator to the end of the VectorOf.
      */
     const_iterator end() const noexcept {
-        return bytes.end();
+        return m_data + m_size;
     }
 
     /**
      * @brief Returns a const iterator to the beginning of the VectorOf
      */
     const_iterator cbegin() const noexcept {
-        return bytes.cbegin();
+        return m_data;
     }
 
     /**
      * @brief Returns a const iterator to the end of the VectorOf.
      */
     const_iterator cend() const noexcept {
-        return bytes.cend();
+        return m_data + m_size;
     }
+
+    /**
+    * Remove all the elements, the memory allocated is kept.
+    */
     void clear() {
-        bytes.clear();
+        destroy(0);
     }
 
     yarp::os::Type getType() const override {
@@ -498,6 +657,9 @@ public:
     }
 };
 
+template<class T>
+constexpr size_t yarp::sig::VectorOf<T>::inlineCapacity;
+
 
 #ifdef _MSC_VER
 /*YARP_sig_EXTERN*/ template class YARP_sig_API yarp::sig::VectorOf<double>;
@@ -15,6 +15,7 @@
 #include <yarp/sig/ImageDraw.h>
 #include <yarp/sig/ImageFile.h>
 #include <yarp/sig/Image.h>
+#include <yarp/sig/ImageView.h>
 #include <yarp/sig/Sound.h>
 #include <yarp/sig/SoundFile.h>
 #include <yarp/sig/Vector.h>
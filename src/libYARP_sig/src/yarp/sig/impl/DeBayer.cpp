@@ -7,160 +7,474 @@
  */
 
 #include <yarp/sig/impl/DeBayer.h>
-#include <yarp/os/Log.h>
+#include <yarp/sig/ImageUtils.h>
+#include <yarp/sig/impl/ParallelRows.h>
 
-bool deBayer_GRBG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define YARP_SIG_DEBAYER_SSE2 1
+#  include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(__ARM_BIG_ENDIAN)
+#  define YARP_SIG_DEBAYER_NEON 1
+#  include <arm_neon.h>
+#endif
+
+using namespace yarp::sig;
+using yarp::sig::utils::DemosaicMethod;
+
+namespace {
+
+/*
+ * The raw rows are converted to float and padded with 2 pixels on each side,
+ * mirroring the image without repeating the border pixel.  Mirroring keeps
+ * the Bayer pattern, therefore the borders are interpolated with the same
+ * formulas used inside the image.
+ */
+constexpr size_t padding = 2;
+
+// Pattern colors of the pixels (0,0), (1,0), (0,1) and (1,1)
+const char* bayerPattern(int bayerCode)
 {
-    yAssert(((pixelSize == 3) && (dest.getPixelCode() == VOCAB_PIXEL_BGR)) ||
-        ((pixelSize == 4 && dest.getPixelCode() == VOCAB_PIXEL_BGRA)))
+    switch (bayerCode) {
+    case VOCAB_PIXEL_ENCODING_BAYER_GRBG8:
+    case VOCAB_PIXEL_ENCODING_BAYER_GRBG16:
+        return "grbg";
+    case VOCAB_PIXEL_ENCODING_BAYER_BGGR8:
+    case VOCAB_PIXEL_ENCODING_BAYER_BGGR16:
+        return "bggr";
+    case VOCAB_PIXEL_ENCODING_BAYER_GBRG8:
+    case VOCAB_PIXEL_ENCODING_BAYER_GBRG16:
+        return "gbrg";
+    case VOCAB_PIXEL_ENCODING_BAYER_RGGB8:
+    case VOCAB_PIXEL_ENCODING_BAYER_RGGB16:
+        return "rggb";
+    default:
+        return nullptr;
+    }
+}
 
-        dest.resize(source.width(), source.height());
-    // perform conversion, skip borders
-    for (size_t r = 0; r < source.height() - 2; r += 2)
-    {
-        unsigned char *destRow = dest.getRow(r);
-        unsigned char *sourceRowCurrent = source.getRow(r);
-        unsigned char *sourceRowNext = source.getRow(r + 1);
-
-        //row i GRGRGR...
-        for (size_t c = 0; c < dest.width() - 2; c += 2)
-        {
-            //source is on G pixel
-            destRow[0] = sourceRowNext[0];       //blue
-            destRow[1] = sourceRowCurrent[0];    //green
-            destRow[2] = sourceRowCurrent[1];    //red
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on R pixel
-            destRow[0] = sourceRowNext[0];         //blue
-            destRow[1] = sourceRowCurrent[1];     //green
-            destRow[2] = sourceRowCurrent[0];     //red
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-        }
+size_t mirror(long i, size_t size)
+{
+    if (i < 0) {
+        return static_cast<size_t>(-i);
+    }
+    if (static_cast<size_t>(i) >= size) {
+        return 2 * (size - 1) - static_cast<size_t>(i);
+    }
+    return static_cast<size_t>(i);
+}
 
-        destRow = dest.getRow(r + 1);
-        sourceRowCurrent = source.getRow(r + 1);
-        sourceRowNext = source.getRow(r + 2);
-
-        //row is now BGBGBG...
-        for (size_t c = 0; c < dest.width() - 2; c += 2)
-        {
-            //source is on B pixel
-            destRow[0] = sourceRowCurrent[0];   //blue
-            destRow[1] = sourceRowCurrent[1];   //green
-            destRow[2] = sourceRowNext[1];;     //red
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on G pixel
-            destRow[0] = sourceRowCurrent[1];    //blue
-            destRow[1] = sourceRowCurrent[0];    //green
-            destRow[2] = sourceRowNext[0];       //red
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-        }
+void toFloat(const unsigned char* src, size_t n, float* dest)
+{
+    size_t i = 0;
+#if defined(YARP_SIG_DEBAYER_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_ps(dest + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_ps(dest + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+    }
+#elif defined(YARP_SIG_DEBAYER_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vmovl_u8(vld1_u8(src + i));
+        vst1q_f32(dest + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))));
+        vst1q_f32(dest + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+    }
+#endif
+    for (; i < n; i++) {
+        dest[i] = src[i];
     }
-    return true;
 }
 
-bool deBayer_GRBG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+void toFloat(const uint16_t* src, size_t n, float* dest)
 {
-    yAssert(((pixelSize == 3) && (dest.getPixelCode() == VOCAB_PIXEL_RGB)) ||
-    ((pixelSize == 4 && dest.getPixelCode() == VOCAB_PIXEL_RGBA)))
+    size_t i = 0;
+#if defined(YARP_SIG_DEBAYER_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)));
+    }
+#elif defined(YARP_SIG_DEBAYER_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        vst1q_f32(dest + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))));
+        vst1q_f32(dest + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+    }
+#endif
+    for (; i < n; i++) {
+        dest[i] = src[i];
+    }
+}
 
-    dest.resize(source.width(), source.height());
-    // perform conversion, skip borders
-    for (size_t r = 0; r < source.height() - 2; r += 2)
+/*
+ * The last 5 rows read from the raw image, enough for the 5x5 neighbourhood
+ * of the Malvar-He-Cutler filters.
+ */
+class RowCache
+{
+public:
+    RowCache(const Image& img, bool is16bit) :
+            img(img),
+            is16bit(is16bit),
+            stride(img.width() + 2 * padding),
+            data(5 * stride)
     {
-        unsigned char *destRow = dest.getRow(r);
-        unsigned char *sourceRowCurrent = source.getRow(r);
-        unsigned char *sourceRowNext = source.getRow(r + 1);
-
-        //row i GRGRGR...
-        for (size_t c = 0; c < source.width() - 2; c += 2)
-        {
-            //source is on G pixel
-            destRow[0] = sourceRowCurrent[1];    //red
-            destRow[1] = sourceRowCurrent[0];    //green
-            destRow[2] = sourceRowNext[0];;     //blue
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on R pixel
-            destRow[0] = sourceRowCurrent[0];     //red
-            destRow[1] = sourceRowCurrent[1];     //green
-            destRow[2] = sourceRowNext[0];        //red
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
+        // no row is above -padding
+        std::fill(std::begin(rows), std::end(rows), -3L);
+    }
+
+    const float* row(long y)
+    {
+        size_t slot = static_cast<size_t>(y + 2) % 5;
+        float* dest = data.data() + slot * stride + padding;
+        if (rows[slot] != y) {
+            rows[slot] = y;
+            load(mirror(y, img.height()), dest);
         }
+        return dest;
+    }
 
-        destRow = dest.getRow(r + 1);
-        sourceRowCurrent = source.getRow(r + 1);
-        sourceRowNext = source.getRow(r + 2);
-
-        //row is now BGBGBG...
-        for (size_t c = 0; c < dest.width() - 2; c += 2)
-        {
-            //source is on B pixel
-            destRow[0] = sourceRowNext[1];      //red
-            destRow[1] = sourceRowCurrent[1];   //green
-            destRow[2] = sourceRowCurrent[0];   //blue
-
-            //jump a pixel in destination
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
-
-            //source is now on G pixel
-            destRow[0] = sourceRowNext[0];     //red
-            destRow[1] = sourceRowCurrent[0];  //green
-            destRow[2] = sourceRowCurrent[1];  //blue
-
-            destRow += pixelSize;
-            sourceRowCurrent++;
-            sourceRowNext++;
+private:
+    void load(size_t y, float* dest) const
+    {
+        const size_t w = img.width();
+        if (is16bit) {
+            toFloat(reinterpret_cast<const uint16_t*>(img.getRow(y)), w, dest);
+        } else {
+            toFloat(img.getRow(y), w, dest);
         }
+        dest[-1] = dest[1];
+        dest[-2] = dest[2];
+        dest[w] = dest[w - 2];
+        dest[w + 1] = dest[w - 3];
     }
-    return true;
+
+    const Image& img;
+    bool is16bit;
+    size_t stride;
+    std::vector<float> data;
+    long rows[5];
+};
+
+float load(const float* p, float)
+{
+    return *p;
 }
 
-bool deBayer_BGGR8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+void store(float* p, float v)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_BGGR8_TO_RGB\n");
-    return false;
+    *p = v;
 }
 
-bool deBayer_RGGB8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+float select(bool mask, float a, float b)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_RGGB8_TO_RGB\n");
-    return false;
+    return mask ? a : b;
 }
 
-bool deBayer_BGGR8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+#if defined(YARP_SIG_DEBAYER_SSE2)
+
+struct Float4
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_BGGR8_TO_BGR\n");
-    return false;
+    __m128 v;
+};
+
+inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, float k) { return {_mm_mul_ps(a.v, _mm_set1_ps(k))}; }
+
+inline Float4 load(const float* p, Float4)
+{
+    return {_mm_loadu_ps(p)};
 }
 
-bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize)
+inline void store(float* p, Float4 v)
 {
-    YARP_FIXME_NOTIMPLEMENTED("convert_RGGB8_TO_BGR\n");
-    return false;
+    _mm_storeu_ps(p, v.v);
+}
+
+inline Float4 select(Float4 mask, Float4 a, Float4 b)
+{
+    return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+}
+
+// Mask of the green pixels in 4 pixels starting from an even column
+inline Float4 greenMask(bool greenOdd)
+{
+    return {_mm_castsi128_ps(greenOdd ? _mm_set_epi32(-1, 0, -1, 0) : _mm_set_epi32(0, -1, 0, -1))};
+}
+
+#elif defined(YARP_SIG_DEBAYER_NEON)
+
+struct Float4
+{
+    float32x4_t v;
+};
+
+inline Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, float k) { return {vmulq_n_f32(a.v, k)}; }
+
+inline Float4 load(const float* p, Float4)
+{
+    return {vld1q_f32(p)};
+}
+
+inline void store(float* p, Float4 v)
+{
+    vst1q_f32(p, v.v);
+}
+
+inline Float4 select(Float4 mask, Float4 a, Float4 b)
+{
+    return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+}
+
+inline Float4 greenMask(bool greenOdd)
+{
+    static const uint32_t even[4] = {0xFFFFFFFF, 0, 0xFFFFFFFF, 0};
+    static const uint32_t odd[4] = {0, 0xFFFFFFFF, 0, 0xFFFFFFFF};
+    return {vreinterpretq_f32_u32(vld1q_u32(greenOdd ? odd : even))};
+}
+
+#endif
+
+/*
+ * Interpolate the pixels starting from x of the row r[2], given the rows
+ * r[0]..r[4] around it.  The colors are written in the order: color of the
+ * non-green pixels of the row, green, color of the non-green pixels of the
+ * adjacent rows.
+ *
+ * All the intermediate values are integers small enough to be exact in a
+ * float, therefore the vectorized and scalar versions give the same result.
+ */
+template <DemosaicMethod method, typename V, typename Mask>
+inline void demosaic(const float* const* r, size_t x, Mask green, float* rowColor, float* g, float* colColor)
+{
+    const float* n2 = r[0] + x;
+    const float* n = r[1] + x;
+    const float* c = r[2] + x;
+    const float* s = r[3] + x;
+    const float* s2 = r[4] + x;
+    const V tag{};
+
+    const V center = load(c, tag);
+    const V cross = load(n, tag) + load(s, tag) + load(c - 1, tag) + load(c + 1, tag);
+    const V diag = load(n - 1, tag) + load(n + 1, tag) + load(s - 1, tag) + load(s + 1, tag);
+
+    V rowAtGreen;
+    V colAtGreen;
+    V greenAtOther;
+    V colAtOther;
+    if (method == DemosaicMethod::Bilinear) {
+        rowAtGreen = (load(c - 1, tag) + load(c + 1, tag)) * 0.5F;
+        colAtGreen = (load(n, tag) + load(s, tag)) * 0.5F;
+        greenAtOther = cross * 0.25F;
+        colAtOther = diag * 0.25F;
+    } else {
+        const V vert2 = load(n2, tag) + load(s2, tag);
+        const V horz2 = load(c - 2, tag) + load(c + 2, tag);
+        const V vert = load(n, tag) + load(s, tag);
+        const V horz = load(c - 1, tag) + load(c + 1, tag);
+        rowAtGreen = (center * 10.0F - (horz2 + diag) * 2.0F + vert2 + horz * 8.0F) * 0.0625F;
+        colAtGreen = (center * 10.0F - (vert2 + diag) * 2.0F + horz2 + vert * 8.0F) * 0.0625F;
+        greenAtOther = (center * 8.0F - (vert2 + horz2) * 2.0F + cross * 4.0F) * 0.0625F;
+        colAtOther = (center * 12.0F - (vert2 + horz2) * 3.0F + diag * 4.0F) * 0.0625F;
+    }
+
+    store(rowColor + x, select(green, rowAtGreen, center));
+    store(g + x, select(green, center, greenAtOther));
+    store(colColor + x, select(green, colAtGreen, colAtOther));
+}
+
+template <DemosaicMethod method>
+void demosaicRow(const float* const* r, size_t w, bool greenOdd, float* rowColor, float* g, float* colColor)
+{
+    size_t x = 0;
+#if defined(YARP_SIG_DEBAYER_SSE2) || defined(YARP_SIG_DEBAYER_NEON)
+    const Float4 mask = greenMask(greenOdd);
+    for (; x + 4 <= w; x += 4) {
+        demosaic<method, Float4>(r, x, mask, rowColor, g, colColor);
+    }
+#endif
+    for (; x < w; x++) {
+        demosaic<method, float>(r, x, ((x & 1) != 0) == greenOdd, rowColor, g, colColor);
+    }
+}
+
+// Scale, saturate and round the colors to 8 bit
+void toBytes(const float* src, size_t n, float scale, unsigned char* dest)
+{
+    size_t i = 0;
+#if defined(YARP_SIG_DEBAYER_SSE2)
+    // the packing instructions saturate the values
+    const __m128 k = _mm_set1_ps(scale);
+    const __m128 half = _mm_set1_ps(0.5F);
+    auto convert = [&](const float* p) {
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p), k), half));
+    };
+    for (; i + 16 <= n; i += 16) {
+        __m128i lo = _mm_packs_epi32(convert(src + i), convert(src + i + 4));
+        __m128i hi = _mm_packs_epi32(convert(src + i + 8), convert(src + i + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(YARP_SIG_DEBAYER_NEON)
+    // the conversion and the narrowing instructions saturate the values
+    const float32x4_t half = vdupq_n_f32(0.5F);
+    auto convert = [&](const float* p) {
+        return vqmovn_u32(vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(vld1q_f32(p), scale), half)));
+    };
+    for (; i + 8 <= n; i += 8) {
+        vst1_u8(dest + i, vqmovn_u16(vcombine_u16(convert(src + i), convert(src + i + 4))));
+    }
+#endif
+    for (; i < n; i++) {
+        dest[i] = static_cast<unsigned char>(std::min(std::max(src[i] * scale, 0.0F), 255.0F) + 0.5F);
+    }
+}
+
+// Interleave the channels of a row, adding an opaque alpha channel if pixelSize is 4
+template <size_t pixelSize>
+void interleave(const unsigned char* c0, const unsigned char* c1, const unsigned char* c2, size_t w, unsigned char* dest)
+{
+    size_t x = 0;
+#if defined(YARP_SIG_DEBAYER_SSE2)
+    const __m128i alpha = _mm_set1_epi8(-1);
+    // with 3 channels each pixel is stored with 4 bytes, the last pixel
+    // must not be written by the vectorized loop
+    for (; x + 16 + (pixelSize == 3 ? 1 : 0) <= w; x += 16) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c0 + x));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c1 + x));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c2 + x));
+        __m128i lo01 = _mm_unpacklo_epi8(v0, v1);
+        __m128i hi01 = _mm_unpackhi_epi8(v0, v1);
+        __m128i lo2a = _mm_unpacklo_epi8(v2, alpha);
+        __m128i hi2a = _mm_unpackhi_epi8(v2, alpha);
+        const __m128i pixels[4] = {_mm_unpacklo_epi16(lo01, lo2a),
+                                   _mm_unpackhi_epi16(lo01, lo2a),
+                                   _mm_unpacklo_epi16(hi01, hi2a),
+                                   _mm_unpackhi_epi16(hi01, hi2a)};
+        for (size_t i = 0; i < 4; i++) {
+            if (pixelSize == 4) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16 * i), pixels[i]);
+            } else {
+                __m128i p = pixels[i];
+                for (size_t j = 0; j < 4; j++) {
+                    int32_t pixel = _mm_cvtsi128_si32(p);
+                    std::memcpy(dest + 3 * (4 * i + j), &pixel, sizeof(pixel));
+                    p = _mm_srli_si128(p, 4);
+                }
+            }
+        }
+        dest += 16 * pixelSize;
+    }
+#elif defined(YARP_SIG_DEBAYER_NEON)
+    for (; x + 16 <= w; x += 16) {
+        if (pixelSize == 4) {
+            uint8x16x4_t pixels = {{vld1q_u8(c0 + x), vld1q_u8(c1 + x), vld1q_u8(c2 + x), vdupq_n_u8(255)}};
+            vst4q_u8(dest, pixels);
+        } else {
+            uint8x16x3_t pixels = {{vld1q_u8(c0 + x), vld1q_u8(c1 + x), vld1q_u8(c2 + x)}};
+            vst3q_u8(dest, pixels);
+        }
+        dest += 16 * pixelSize;
+    }
+#endif
+    for (; x < w; x++, dest += pixelSize) {
+        dest[0] = c0[x];
+        dest[1] = c1[x];
+        dest[2] = c2[x];
+        if (pixelSize == 4) {
+            dest[3] = 255;
+        }
+    }
+}
+
+} // namespace
+
+
+bool utils::deBayer(const Image& inImg, int bayerCode, Image& outImg, DemosaicMethod method, size_t threads)
+{
+    const char* pattern = bayerPattern(bayerCode);
+    const bool is16bit = isBayer16(bayerCode);
+    if (pattern == nullptr || &inImg == &outImg || inImg.getPixelSize() != (is16bit ? 2U : 1U)) {
+        return false;
+    }
+    const size_t w = inImg.width();
+    const size_t h = inImg.height();
+    if (w < 3 || h < 3) {
+        return false;
+    }
+
+    bool redFirst;
+    switch (outImg.getPixelCode()) {
+    case VOCAB_PIXEL_RGB:
+    case VOCAB_PIXEL_RGBA:
+        redFirst = true;
+        break;
+    case VOCAB_PIXEL_BGR:
+    case VOCAB_PIXEL_BGRA:
+        redFirst = false;
+        break;
+    default:
+        return false;
+    }
+    const size_t pixelSize = outImg.getPixelSize();
+    const float scale = is16bit ? 1.0F / 256.0F : 1.0F;
+    // resize() would reallocate an image wrapping external memory
+    if (outImg.width() != w || outImg.height() != h) {
+        outImg.resize(w, h);
+    }
+
+    impl::forEachRowBand(h, threads, [&](size_t first, size_t last) {
+        RowCache cache(inImg, is16bit);
+        std::vector<float> colors(3 * w);
+        float* rowColor = colors.data();
+        float* g = rowColor + w;
+        float* colColor = g + w;
+        std::vector<unsigned char> bytes(3 * w);
+        for (size_t y = first; y < last; y++) {
+            const auto yy = static_cast<long>(y);
+            const float* r[5];
+            for (long i = 0; i < 5; i++) {
+                r[i] = cache.row(yy + i - 2);
+            }
+
+            // Colors of the pixels (0,y) and (1,y)
+            const char left = pattern[2 * (y & 1)];
+            const char right = pattern[2 * (y & 1) + 1];
+            const bool greenOdd = (right == 'g');
+            const bool redRow = ((greenOdd ? left : right) == 'r');
+
+            if (method == DemosaicMethod::MalvarHeCutler) {
+                demosaicRow<DemosaicMethod::MalvarHeCutler>(r, w, greenOdd, rowColor, g, colColor);
+            } else {
+                demosaicRow<DemosaicMethod::Bilinear>(r, w, greenOdd, rowColor, g, colColor);
+            }
+
+            toBytes(rowColor, 3 * w, scale, bytes.data());
+            const unsigned char* red = redRow ? bytes.data() : bytes.data() + 2 * w;
+            const unsigned char* green = bytes.data() + w;
+            const unsigned char* blue = redRow ? bytes.data() + 2 * w : bytes.data();
+            if (!redFirst) {
+                std::swap(red, blue);
+            }
+            if (pixelSize == 4) {
+                interleave<4>(red, green, blue, w, outImg.getRow(y));
+            } else {
+                interleave<3>(red, green, blue, w, outImg.getRow(y));
+            }
+        }
+    });
+    return true;
 }
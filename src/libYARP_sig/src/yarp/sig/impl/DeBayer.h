@@ -8,10 +8,8 @@
  */
 
 /**
- * Basic implementations of debayering functions. Used to convert Bayer images received
- * in a YARP port. Prototype implementation, in the future we should replace these functions
- * with better implementations, like the ones in the Bayer Carrier. If we decide to implement
- * debayering by chaining carriers this code could be removed completely.
+ * Helpers for the Bayer encodings. The conversion of Bayer images is
+ * implemented by yarp::sig::utils::deBayer().
  */
 
 #ifndef YARP_SIG_IMPL_DEBAYER_H
@@ -41,22 +39,4 @@ inline bool isBayer16(int v)
         return false;
 }
 
-/*
- * Nearest neighbor debayer implementation (warning: skip borders)
- */
-bool deBayer_GRBG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
-
-bool deBayer_BGGR8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
-
-bool deBayer_RGGB8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
-
-/*
- * Nearest neighbor debayer implementation (warning: skip borders)
- */
-bool deBayer_GRBG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
-
-bool deBayer_BGGR8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
-
-inline bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
-
 #endif // YARP_SIG_IMPL_DEBAYER_H
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/LZ4Block.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/*
+ * The LZ4 block is a sequence of:
+ *  - a token: number of literals (4 high bits) and length of the match - 4
+ *    (4 low bits), 15 means that the length continues in the next bytes
+ *  - the rest of the number of literals, in bytes of 255 and a last byte
+ *    smaller than 255
+ *  - the literals
+ *  - the offset of the match, 2 bytes little endian
+ *  - the rest of the length of the match
+ * The last sequence has only the literals, the last 5 bytes are always
+ * literals and the last match starts at least 12 bytes before the end.
+ */
+constexpr size_t minMatch = 4;
+constexpr size_t lastLiterals = 5;
+constexpr size_t matchFindLimit = 12;
+constexpr size_t maxOffset = 65535;
+constexpr unsigned int hashBits = 14;
+
+inline uint32_t read32(const unsigned char* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - hashBits);
+}
+
+inline unsigned char* writeLength(unsigned char* op, size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        *op++ = 255;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+}
+
+inline unsigned char* writeSequence(unsigned char* op, const unsigned char* literals, size_t literalsLength, size_t offset, size_t matchLength)
+{
+    unsigned char* token = op++;
+    *token = static_cast<unsigned char>(std::min<size_t>(literalsLength, 15) << 4);
+    if (literalsLength >= 15) {
+        op = writeLength(op, literalsLength - 15);
+    }
+    if (literalsLength > 0) {
+        std::memcpy(op, literals, literalsLength);
+        op += literalsLength;
+    }
+    if (matchLength == 0) {
+        return op;
+    }
+    *op++ = static_cast<unsigned char>(offset & 0xFF);
+    *op++ = static_cast<unsigned char>(offset >> 8);
+    matchLength -= minMatch;
+    *token |= static_cast<unsigned char>(std::min<size_t>(matchLength, 15));
+    if (matchLength >= 15) {
+        op = writeLength(op, matchLength - 15);
+    }
+    return op;
+}
+
+inline bool readLength(const unsigned char*& ip, const unsigned char* end, size_t& length)
+{
+    unsigned char b;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+size_t yarp::sig::impl::lz4CompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t yarp::sig::impl::lz4Compress(const char* src, size_t size, char* dest)
+{
+    const auto* in = reinterpret_cast<const unsigned char*>(src);
+    auto* op = reinterpret_cast<unsigned char*>(dest);
+    size_t anchor = 0;
+
+    if (size > matchFindLimit) {
+        // positions + 1 of the last sequences with each hash, 0 if none
+        std::vector<uint32_t> table(size_t{1} << hashBits, 0);
+        const size_t limit = size - matchFindLimit;
+        const size_t matchLimit = size - lastLiterals;
+        size_t ip = 0;
+        while (ip < limit) {
+            const uint32_t sequence = read32(in + ip);
+            uint32_t& entry = table[hash(sequence)];
+            const size_t ref = entry;
+            entry = static_cast<uint32_t>(ip + 1);
+            if (ref == 0 || ip + 1 - ref > maxOffset || read32(in + ref - 1) != sequence) {
+                ip++;
+                continue;
+            }
+            const size_t match = ref - 1;
+            size_t length = minMatch;
+            while (ip + length < matchLimit && in[match + length] == in[ip + length]) {
+                length++;
+            }
+            op = writeSequence(op, in + anchor, ip - anchor, ip - match, length);
+            ip += length;
+            anchor = ip;
+        }
+    }
+    op = writeSequence(op, in + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(op - reinterpret_cast<unsigned char*>(dest));
+}
+
+bool yarp::sig::impl::lz4Decompress(const char* src, size_t size, char* dest, size_t destSize)
+{
+    const auto* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* const end = ip + size;
+    auto* out = reinterpret_cast<unsigned char*>(dest);
+    size_t op = 0;
+
+    while (ip < end) {
+        const unsigned char token = *ip++;
+        size_t literalsLength = token >> 4;
+        if (literalsLength == 15 && !readLength(ip, end, literalsLength)) {
+            return false;
+        }
+        if (literalsLength > static_cast<size_t>(end - ip) || literalsLength > destSize - op) {
+            return false;
+        }
+        if (literalsLength > 0) {
+            std::memcpy(out + op, ip, literalsLength);
+            ip += literalsLength;
+            op += literalsLength;
+        }
+        if (ip == end) {
+            break; // last sequence
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return false;
+        }
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, end, matchLength)) {
+            return false;
+        }
+        matchLength += minMatch;
+        if (matchLength > destSize - op) {
+            return false;
+        }
+        // the match can overlap the output, it is copied byte by byte
+        const unsigned char* match = out + op - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out[op + i] = match[i];
+        }
+        op += matchLength;
+    }
+    return op == destSize;
+}
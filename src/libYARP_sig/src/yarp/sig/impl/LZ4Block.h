@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_LZ4BLOCK_H
+#define YARP_SIG_IMPL_LZ4BLOCK_H
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Compression of a block of data in the LZ4 block format (without the frame
+ * of the LZ4 files), readable by any LZ4 decoder.
+ *
+ * The compressor is greedy and fast, it is meant for data streamed through
+ * the network, not for the best compression ratio.
+ */
+
+/**
+ * @return the size of the buffer needed by lz4Compress() for the worst case.
+ */
+size_t lz4CompressBound(size_t size);
+
+/**
+ * Compress a block of data.
+ *
+ * @param src the data
+ * @param size the size of the data
+ * @param dest the output buffer, at least lz4CompressBound(size) bytes
+ * @return the size of the compressed data
+ */
+size_t lz4Compress(const char* src, size_t size, char* dest);
+
+/**
+ * Decompress a block of data.
+ *
+ * @param src the compressed data
+ * @param size the size of the compressed data
+ * @param dest the output buffer
+ * @param destSize the size of the data before compression
+ * @return false if the compressed data is not valid, or does not give
+ *         exactly destSize bytes
+ */
+bool lz4Decompress(const char* src, size_t size, char* dest, size_t destSize);
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_LZ4BLOCK_H
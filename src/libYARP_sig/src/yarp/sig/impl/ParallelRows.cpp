@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/ParallelRows.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+class RowBandPool
+{
+public:
+    struct Job
+    {
+        const std::function<void(size_t)>* task;
+        size_t bands;
+        size_t next; // first band not taken yet
+        size_t done; // bands done, besides the first one
+    };
+
+    static RowBandPool& getInstance()
+    {
+        // Never deleted: the threads of the pool may still be waiting while
+        // static objects are being destroyed.
+        static auto* instance = new RowBandPool;
+        return *instance;
+    }
+
+    void run(Job& job)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_threads < job.bands - 1) {
+            std::thread(&RowBandPool::workLoop, this).detach();
+            m_threads++;
+        }
+        m_jobs.push_back(&job);
+        lock.unlock();
+        m_workCv.notify_all();
+
+        (*job.task)(0);
+
+        // Run the bands that are still waiting for a thread
+        lock.lock();
+        while (job.next < job.bands) {
+            runBand(job, lock);
+        }
+        m_doneCv.wait(lock, [&]() { return job.done == job.bands - 1; });
+    }
+
+private:
+    RowBandPool() = default;
+
+    // Called with m_mutex locked, releases it while the task runs
+    void runBand(Job& job, std::unique_lock<std::mutex>& lock)
+    {
+        size_t band = job.next++;
+        if (job.next == job.bands) {
+            m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), &job));
+        }
+        lock.unlock();
+        (*job.task)(band);
+        lock.lock();
+        job.done++;
+        if (job.done == job.bands - 1) {
+            m_doneCv.notify_all();
+        }
+    }
+
+    void workLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_workCv.wait(lock, [&]() { return !m_jobs.empty(); });
+            runBand(*m_jobs.front(), lock);
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_workCv;
+    std::condition_variable m_doneCv;
+    std::deque<Job*> m_jobs;
+    size_t m_threads {0};
+};
+
+} // namespace
+
+void yarp::sig::impl::runRowBands(size_t bands, const std::function<void(size_t)>& task)
+{
+    if (bands <= 1) {
+        if (bands == 1) {
+            task(0);
+        }
+        return;
+    }
+    RowBandPool::Job job {&task, bands, 1, 0};
+    RowBandPool::getInstance().run(job);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_PARALLELROWS_H
+#define YARP_SIG_IMPL_PARALLELROWS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Run task(0) ... task(bands - 1), task(0) in the calling thread and the
+ * others in a pool of threads shared by the whole process.  The threads of
+ * the pool are started the first time they are needed and are kept
+ * waiting afterwards, so that the cost of a call does not include starting
+ * and joining threads.  The calling thread runs the bands that no thread
+ * of the pool took yet, and returns once all of them are done.
+ *
+ * @param bands number of bands
+ * @param task function called as task(band) for each band
+ */
+void runRowBands(size_t bands, const std::function<void(size_t)>& task);
+
+/**
+ * Split the rows of an image in bands of consecutive rows, and process each
+ * band in a different thread.
+ *
+ * @param rows number of rows of the image
+ * @param threads number of threads (0 uses one thread for each core); the
+ *                calling thread processes the first band
+ * @param f function called as f(firstRow, lastRow) for each band, with
+ *          lastRow excluded
+ */
+template <typename F>
+void forEachRowBand(size_t rows, size_t threads, const F& f)
+{
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    threads = std::min(threads, rows);
+    if (threads <= 1) {
+        f(0, rows);
+        return;
+    }
+    const size_t band = (rows + threads - 1) / threads;
+    const size_t bands = (rows + band - 1) / band;
+    runRowBands(bands, [&](size_t i) {
+        f(i * band, std::min((i + 1) * band, rows));
+    });
+}
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_PARALLELROWS_H
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/PixelConversion.h>
+
+#include <yarp/conf/environment.h>
+#include <yarp/sig/Image.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define YARP_SIG_PIXEL_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define YARP_SIG_PIXEL_TARGET(x)
+#  else
+#    define YARP_SIG_PIXEL_TARGET(x) __attribute__((target(x)))
+#  endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(__ARM_BIG_ENDIAN)
+#  define YARP_SIG_PIXEL_NEON 1
+#  include <arm_neon.h>
+#endif
+
+using namespace yarp::sig;
+using namespace yarp::sig::impl;
+
+namespace {
+
+enum class InstructionSet
+{
+    None,
+    Sse41,
+    Avx2,
+    Neon
+};
+
+struct ConverterEntry
+{
+    int srcPixelCode;
+    int destPixelCode;
+    PixelConverter converter;
+};
+
+/******************************************************************************/
+// Generic code, used for the pixels left at the end of the rows.
+
+inline void swapRgb(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    for (size_t i = 0; i < width; i++) {
+        const unsigned char c0 = src[0];
+        dest[1] = src[1];
+        dest[0] = src[2];
+        dest[2] = c0;
+        src += 3;
+        dest += 3;
+    }
+}
+
+inline void swapRgba(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    for (size_t i = 0; i < width; i++) {
+        const unsigned char c0 = src[0];
+        dest[1] = src[1];
+        dest[0] = src[2];
+        dest[2] = c0;
+        dest[3] = src[3];
+        src += 4;
+        dest += 4;
+    }
+}
+
+inline void rgbToMono(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    for (size_t i = 0; i < width; i++) {
+        dest[i] = static_cast<unsigned char>((src[0] + src[1] + src[2]) / 3);
+        src += 3;
+    }
+}
+
+inline void mono16ToFloat(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    for (size_t i = 0; i < width; i++) {
+        std::uint16_t value;
+        std::memcpy(&value, src + i * sizeof(value), sizeof(value));
+        const float converted = static_cast<float>(value);
+        std::memcpy(dest + i * sizeof(converted), &converted, sizeof(converted));
+    }
+}
+
+/******************************************************************************/
+#if defined(YARP_SIG_PIXEL_X86)
+
+// The sum of the three channels (at most 765) is divided by 3 as
+// (sum * 43691) >> 17, that gives exactly the same result.
+constexpr short divideBy3Factor = static_cast<short>(43691);
+
+YARP_SIG_PIXEL_TARGET("sse4.1")
+void swapRgbSse41(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    // 5 pixels for each 16 bytes, the last byte is written again by the next
+    // iteration, therefore at least 6 pixels are needed.
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 6 <= width; i += 5) {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 3), _mm_shuffle_epi8(px, mask));
+    }
+    swapRgb(src + i * 3, dest + i * 3, width - i);
+}
+
+YARP_SIG_PIXEL_TARGET("sse4.1")
+void swapRgbaSse41(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 4 <= width; i += 4) {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), _mm_shuffle_epi8(px, mask));
+    }
+    swapRgba(src + i * 4, dest + i * 4, width - i);
+}
+
+YARP_SIG_PIXEL_TARGET("avx2")
+void swapRgbaAvx2(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= width; i += 8) {
+        const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 4), _mm256_shuffle_epi8(px, mask));
+    }
+    swapRgba(src + i * 4, dest + i * 4, width - i);
+}
+
+YARP_SIG_PIXEL_TARGET("sse4.1")
+void rgbToMonoSse41(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    // Split 16 pixels in the three channels (the order of the channels does
+    // not matter, therefore the same code is used for BGR)
+    const __m128i c0a = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i c0b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i c0c = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i c1a = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i c1b = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i c1c = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i c2a = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i c2b = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i c2c = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i factor = _mm_set1_epi16(divideBy3Factor);
+
+    size_t i = 0;
+    for (; i + 16 <= width; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 32));
+        const __m128i ch0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, c0a), _mm_shuffle_epi8(b, c0b)), _mm_shuffle_epi8(c, c0c));
+        const __m128i ch1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, c1a), _mm_shuffle_epi8(b, c1b)), _mm_shuffle_epi8(c, c1c));
+        const __m128i ch2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, c2a), _mm_shuffle_epi8(b, c2b)), _mm_shuffle_epi8(c, c2c));
+
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(ch0, zero), _mm_unpacklo_epi8(ch1, zero)), _mm_unpacklo_epi8(ch2, zero));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(ch0, zero), _mm_unpackhi_epi8(ch1, zero)), _mm_unpackhi_epi8(ch2, zero));
+        lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, factor), 1);
+        hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, factor), 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(lo, hi));
+    }
+    rgbToMono(src + i * 3, dest + i, width - i);
+}
+
+YARP_SIG_PIXEL_TARGET("sse4.1")
+void mono16ToFloatSse41(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    size_t i = 0;
+    for (; i + 8 <= width; i += 8) {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        const __m128 lo = _mm_cvtepi32_ps(_mm_cvtepu16_epi32(px));
+        const __m128 hi = _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_srli_si128(px, 8)));
+        _mm_storeu_ps(reinterpret_cast<float*>(dest + i * 4), lo);
+        _mm_storeu_ps(reinterpret_cast<float*>(dest + i * 4 + 16), hi);
+    }
+    mono16ToFloat(src + i * 2, dest + i * 4, width - i);
+}
+
+YARP_SIG_PIXEL_TARGET("avx2")
+void mono16ToFloatAvx2(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    size_t i = 0;
+    for (; i + 16 <= width; i += 16) {
+        const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
+        const __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(px)));
+        const __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(px, 1)));
+        _mm256_storeu_ps(reinterpret_cast<float*>(dest + i * 4), lo);
+        _mm256_storeu_ps(reinterpret_cast<float*>(dest + i * 4 + 32), hi);
+    }
+    mono16ToFloat(src + i * 2, dest + i * 4, width - i);
+}
+
+// The RGB kernels work on 16 bytes at a time, the AVX2 registers would
+// only help for the formats with 4 bytes per pixel.
+const ConverterEntry sse41Converters[] = {
+    {VOCAB_PIXEL_RGB, VOCAB_PIXEL_BGR, {3, 3, swapRgbSse41}},
+    {VOCAB_PIXEL_BGR, VOCAB_PIXEL_RGB, {3, 3, swapRgbSse41}},
+    {VOCAB_PIXEL_RGBA, VOCAB_PIXEL_BGRA, {4, 4, swapRgbaSse41}},
+    {VOCAB_PIXEL_BGRA, VOCAB_PIXEL_RGBA, {4, 4, swapRgbaSse41}},
+    {VOCAB_PIXEL_RGB, VOCAB_PIXEL_MONO, {3, 1, rgbToMonoSse41}},
+    {VOCAB_PIXEL_BGR, VOCAB_PIXEL_MONO, {3, 1, rgbToMonoSse41}},
+    {VOCAB_PIXEL_MONO16, VOCAB_PIXEL_MONO_FLOAT, {2, 4, mono16ToFloatSse41}},
+};
+
+const ConverterEntry avx2Converters[] = {
+    {VOCAB_PIXEL_RGB, VOCAB_PIXEL_BGR, {3, 3, swapRgbSse41}},
+    {VOCAB_PIXEL_BGR, VOCAB_PIXEL_RGB, {3, 3, swapRgbSse41}},
+    {VOCAB_PIXEL_RGBA, VOCAB_PIXEL_BGRA, {4, 4, swapRgbaAvx2}},
+    {VOCAB_PIXEL_BGRA, VOCAB_PIXEL_RGBA, {4, 4, swapRgbaAvx2}},
+    {VOCAB_PIXEL_RGB, VOCAB_PIXEL_MONO, {3, 1, rgbToMonoSse41}},
+    {VOCAB_PIXEL_BGR, VOCAB_PIXEL_MONO, {3, 1, rgbToMonoSse41}},
+    {VOCAB_PIXEL_MONO16, VOCAB_PIXEL_MONO_FLOAT, {2, 4, mono16ToFloatAvx2}},
+};
+
+InstructionSet detectInstructionSet()
+{
+#  if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    if (avx2) {
+        return InstructionSet::Avx2;
+    }
+    if (sse41) {
+        return InstructionSet::Sse41;
+    }
+#  else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::Sse41;
+    }
+#  endif
+    return InstructionSet::None;
+}
+
+#endif // YARP_SIG_PIXEL_X86
+
+/******************************************************************************/
+#if defined(YARP_SIG_PIXEL_NEON)
+
+void swapRgbNeon(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    size_t i = 0;
+    for (; i + 16 <= width; i += 16) {
+        uint8x16x3_t px = vld3q_u8(src + i * 3);
+        const uint8x16_t c0 = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = c0;
+        vst3q_u8(dest + i * 3, px);
+    }
+    swapRgb(src + i * 3, dest + i * 3, width - i);
+}
+
+void swapRgbaNeon(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    size_t i = 0;
+    for (; i + 16 <= width; i += 16) {
+        uint8x16x4_t px = vld4q_u8(src + i * 4);
+        const uint8x16_t c0 = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = c0;
+        vst4q_u8(dest + i * 4, px);
+    }
+    swapRgba(src + i * 4, dest + i * 4, width - i);
+}
+
+void rgbToMonoNeon(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    // See rgbToMonoSse41 for the division by 3
+    const uint16x4_t factor = vdup_n_u16(43691);
+    size_t i = 0;
+    for (; i + 16 <= width; i += 16) {
+        const uint8x16x3_t px = vld3q_u8(src + i * 3);
+        uint16x8_t lo = vaddw_u8(vaddl_u8(vget_low_u8(px.val[0]), vget_low_u8(px.val[1])), vget_low_u8(px.val[2]));
+        uint16x8_t hi = vaddw_u8(vaddl_u8(vget_high_u8(px.val[0]), vget_high_u8(px.val[1])), vget_high_u8(px.val[2]));
+        lo = vshrq_n_u16(vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(lo), factor), 16),
+                                      vshrn_n_u32(vmull_u16(vget_high_u16(lo), factor), 16)), 1);
+        hi = vshrq_n_u16(vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(hi), factor), 16),
+                                      vshrn_n_u32(vmull_u16(vget_high_u16(hi), factor), 16)), 1);
+        vst1q_u8(dest + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+    rgbToMono(src + i * 3, dest + i, width - i);
+}
+
+void mono16ToFloatNeon(const unsigned char* src, unsigned char* dest, size_t width)
+{
+    size_t i = 0;
+    for (; i + 8 <= width; i += 8) {
+        const uint16x8_t px = vreinterpretq_u16_u8(vld1q_u8(src + i * 2));
+        const float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(px)));
+        const float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(px)));
+        vst1q_u8(dest + i * 4, vreinterpretq_u8_f32(lo));
+        vst1q_u8(dest + i * 4 + 16, vreinterpretq_u8_f32(hi));
+    }
+    mono16ToFloat(src + i * 2, dest + i * 4, width - i);
+}
+
+const ConverterEntry neonConverters[] = {
+    {VOCAB_PIXEL_RGB, VOCAB_PIXEL_BGR, {3, 3, swapRgbNeon}},
+    {VOCAB_PIXEL_BGR, VOCAB_PIXEL_RGB, {3, 3, swapRgbNeon}},
+    {VOCAB_PIXEL_RGBA, VOCAB_PIXEL_BGRA, {4, 4, swapRgbaNeon}},
+    {VOCAB_PIXEL_BGRA, VOCAB_PIXEL_RGBA, {4, 4, swapRgbaNeon}},
+    {VOCAB_PIXEL_RGB, VOCAB_PIXEL_MONO, {3, 1, rgbToMonoNeon}},
+    {VOCAB_PIXEL_BGR, VOCAB_PIXEL_MONO, {3, 1, rgbToMonoNeon}},
+    {VOCAB_PIXEL_MONO16, VOCAB_PIXEL_MONO_FLOAT, {2, 4, mono16ToFloatNeon}},
+};
+
+#endif // YARP_SIG_PIXEL_NEON
+
+/******************************************************************************/
+
+InstructionSet availableInstructionSet()
+{
+#if defined(YARP_SIG_PIXEL_X86)
+    return detectInstructionSet();
+#elif defined(YARP_SIG_PIXEL_NEON)
+    return InstructionSet::Neon;
+#else
+    return InstructionSet::None;
+#endif
+}
+
+bool parseInstructionSet(const std::string& name, InstructionSet& set)
+{
+    if (name == "none") {
+        set = InstructionSet::None;
+    } else if (name == "sse4.1") {
+        set = InstructionSet::Sse41;
+    } else if (name == "avx2") {
+        set = InstructionSet::Avx2;
+    } else if (name == "neon") {
+        set = InstructionSet::Neon;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// AVX2 implies SSE4.1, and the generic code is always available
+bool isSupported(InstructionSet set, InstructionSet available)
+{
+    return set == InstructionSet::None
+        || set == available
+        || (set == InstructionSet::Sse41 && available == InstructionSet::Avx2);
+}
+
+// The instruction set in use, -1 until the first converter is requested
+std::atomic<int> selected {-1};
+
+InstructionSet instructionSet()
+{
+    int set = selected.load(std::memory_order_relaxed);
+    if (set < 0) {
+        const InstructionSet available = availableInstructionSet();
+        InstructionSet requested;
+        if (!parseInstructionSet(yarp::conf::environment::get_string("YARP_SIG_SIMD"), requested)
+            || !isSupported(requested, available)) {
+            requested = available;
+        }
+        set = static_cast<int>(requested);
+        selected.store(set, std::memory_order_relaxed);
+    }
+    return static_cast<InstructionSet>(set);
+}
+
+template <size_t N>
+const PixelConverter* findConverter(const ConverterEntry (&converters)[N], int srcPixelCode, int destPixelCode)
+{
+    for (const auto& entry : converters) {
+        if (entry.srcPixelCode == srcPixelCode && entry.destPixelCode == destPixelCode) {
+            return &entry.converter;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+
+const PixelConverter* yarp::sig::impl::getPixelConverter(int srcPixelCode, int destPixelCode)
+{
+    switch (instructionSet()) {
+#if defined(YARP_SIG_PIXEL_X86)
+    case InstructionSet::Avx2:
+        return findConverter(avx2Converters, srcPixelCode, destPixelCode);
+    case InstructionSet::Sse41:
+        return findConverter(sse41Converters, srcPixelCode, destPixelCode);
+#endif
+#if defined(YARP_SIG_PIXEL_NEON)
+    case InstructionSet::Neon:
+        return findConverter(neonConverters, srcPixelCode, destPixelCode);
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+bool yarp::sig::impl::setPixelConversionInstructionSet(const char* name)
+{
+    InstructionSet set;
+    if (name == nullptr || !parseInstructionSet(name, set) || !isSupported(set, availableInstructionSet())) {
+        return false;
+    }
+    selected.store(static_cast<int>(set), std::memory_order_relaxed);
+    return true;
+}
+
+const char* yarp::sig::impl::getPixelConversionInstructionSet()
+{
+    switch (instructionSet()) {
+    case InstructionSet::Avx2:
+        return "avx2";
+    case InstructionSet::Sse41:
+        return "sse4.1";
+    case InstructionSet::Neon:
+        return "neon";
+    default:
+        return "none";
+    }
+}
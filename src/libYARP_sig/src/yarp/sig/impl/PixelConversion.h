@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_PIXELCONVERSION_H
+#define YARP_SIG_IMPL_PIXELCONVERSION_H
+
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Optimized conversion of rows of pixels, used by Image::copy() for the
+ * most common pairs of pixel codes (RGB <-> BGR, RGB/BGR -> mono,
+ * RGBA <-> BGRA, mono16 -> float).
+ *
+ * The fastest instruction set available on the machine running the code is
+ * selected the first time a converter is requested: AVX2 or SSE4.1 on x86
+ * processors, NEON on ARM processors.  Without any of them, the generic
+ * conversion of the pixels is used.  The environment variable YARP_SIG_SIMD
+ * ("avx2", "sse4.1", "neon" or "none") can be used to restrict the choice.
+ * All the instruction sets give exactly the same result as the generic
+ * conversion.
+ */
+struct PixelConverter
+{
+    size_t srcPixelSize;
+    size_t destPixelSize;
+    void (*convertRow)(const unsigned char* src, unsigned char* dest, size_t width);
+};
+
+/**
+ * Get the optimized converter between two pixel codes.
+ *
+ * @return the converter, or nullptr if there is none for these codes
+ */
+YARP_sig_API const PixelConverter* getPixelConverter(int srcPixelCode, int destPixelCode);
+
+/**
+ * Get the name of the instruction set used by the converters ("avx2",
+ * "sse4.1", "neon" or "none").
+ */
+YARP_sig_API const char* getPixelConversionInstructionSet();
+
+/**
+ * Select the instruction set used by the converters, overriding the
+ * YARP_SIG_SIMD environment variable.  This is meant for the tests, that
+ * compare each instruction set with the generic conversion.
+ *
+ * @param name the name of the instruction set (see
+ *             getPixelConversionInstructionSet())
+ * @return false if the instruction set is unknown or not available on this
+ *         machine, in which case the selection is unchanged
+ */
+YARP_sig_API bool setPixelConversionInstructionSet(const char* name);
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_PIXELCONVERSION_H
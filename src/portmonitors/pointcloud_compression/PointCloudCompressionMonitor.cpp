@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "PointCloudCompressionMonitor.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/NetInt32.h>
+
+#include <string>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+namespace {
+YARP_LOG_COMPONENT(POINTCLOUDCOMPRESSIONMONITOR,
+                   "yarp.carrier.portmonitor.pointcloud_compression",
+                   yarp::os::Log::minimumPrintLevel(),
+                   yarp::os::Log::LogTypeReserved,
+                   yarp::os::Log::printCallback(),
+                   nullptr)
+
+YARP_BEGIN_PACK
+// Header of the VectorOf containing the points in the usual encoding
+struct VectorHeader
+{
+    yarp::os::NetInt32 listTag {0};
+    yarp::os::NetInt32 listLen {0};
+};
+YARP_END_PACK
+} // namespace
+
+
+void CompactPointCloud::setSource(const PointCloudBase& cloud, bool compress)
+{
+    header.width = static_cast<std::int32_t>(cloud.width());
+    header.height = static_cast<std::int32_t>(cloud.height());
+    header.pointType = cloud.getPointType();
+    header.isDense = cloud.isDense() ? 1 : 0;
+    m_source = cloud.getRawData();
+    m_compress = compress;
+}
+
+size_t CompactPointCloud::wireSizeBytes() const
+{
+    return sizeof(header) + dataSizeBytes();
+}
+
+size_t CompactPointCloud::dataSizeBytes() const
+{
+    return size() * pointType2Size(header.pointType);
+}
+
+size_t CompactPointCloud::size() const
+{
+    return width() * height();
+}
+
+const char* CompactPointCloud::getRawData() const
+{
+    return (m_source != nullptr) ? m_source : m_points.data();
+}
+
+int CompactPointCloud::getBottleTag() const
+{
+    // as all the PointCloud types
+    return BOTTLE_TAG_FLOAT64;
+}
+
+bool CompactPointCloud::read(ConnectionReader& connection)
+{
+    m_source = nullptr;
+    PointCloudNetworkHeader received;
+    if (!connection.expectBlock(reinterpret_cast<char*>(&received), sizeof(received))) {
+        return false;
+    }
+    if (received.width < 0 || received.height < 0) {
+        return false;
+    }
+    const int type = received.pointType & ~(PC_ENCODING_COMPACT | PC_ENCODING_COMPRESSED);
+    header.width = received.width;
+    header.height = received.height;
+    header.pointType = type;
+    header.isDense = received.isDense;
+    m_points.assign(dataSizeBytes(), 0);
+
+    if (received.pointType & PC_ENCODING_COMPACT) {
+        return readCompact(connection, received, m_points.data());
+    }
+
+    VectorHeader vectorHeader;
+    if (!connection.expectBlock(reinterpret_cast<char*>(&vectorHeader), sizeof(vectorHeader))) {
+        return false;
+    }
+    if (static_cast<size_t>(vectorHeader.listLen) != size()) {
+        yCError(POINTCLOUDCOMPRESSIONMONITOR, "Invalid point cloud received");
+        return false;
+    }
+    return connection.expectBlock(m_points.data(), m_points.size());
+}
+
+bool CompactPointCloud::write(ConnectionWriter& writer) const
+{
+    if (m_source != nullptr && (header.pointType & PC_XYZ_DATA)) {
+        return writeCompact(writer, m_compress);
+    }
+    writer.appendBlock(reinterpret_cast<const char*>(&header), sizeof(header));
+    VectorHeader vectorHeader;
+    vectorHeader.listTag = BOTTLE_TAG_LIST | getBottleTag();
+    vectorHeader.listLen = static_cast<std::int32_t>(size());
+    writer.appendBlock(reinterpret_cast<const char*>(&vectorHeader), sizeof(vectorHeader));
+    writer.appendExternalBlock(getRawData(), dataSizeBytes());
+    return !writer.isError();
+}
+
+
+bool PointCloudCompressionMonitor::create(const yarp::os::Property& options)
+{
+    m_senderSide = options.find("sender_side").asBool();
+    // e.g. tcp+send.portmonitor+file.pointcloud_compression+compression.none
+    std::string carrier = options.find("carrier").asString();
+    m_compress = (carrier.find("+compression.none") == std::string::npos);
+    return true;
+}
+
+void PointCloudCompressionMonitor::destroy()
+{
+}
+
+bool PointCloudCompressionMonitor::setparam(const yarp::os::Property& params)
+{
+    return false;
+}
+
+bool PointCloudCompressionMonitor::getparam(yarp::os::Property& params)
+{
+    return false;
+}
+
+bool PointCloudCompressionMonitor::accept(yarp::os::Things& thing)
+{
+    if (m_senderSide) {
+        if (dynamic_cast<PointCloudBase*>(thing.getPortWriter()) == nullptr) {
+            yCError(POINTCLOUDCOMPRESSIONMONITOR, "Expected a PointCloud in sender side, but got wrong data type!");
+            return false;
+        }
+    } else {
+        if (thing.cast_as<CompactPointCloud>() == nullptr) {
+            yCError(POINTCLOUDCOMPRESSIONMONITOR, "Expected a PointCloud in receiver side, but got wrong data type!");
+            return false;
+        }
+    }
+    return true;
+}
+
+yarp::os::Things& PointCloudCompressionMonitor::update(yarp::os::Things& thing)
+{
+    if (m_senderSide) {
+        // it receives a point cloud, it sends the compact encoding
+        m_cloud.setSource(*dynamic_cast<PointCloudBase*>(thing.getPortWriter()), m_compress);
+        m_th.setPortWriter(&m_cloud);
+    } else {
+        // it receives any encoding, it passes the usual one to the reader
+        m_th.setPortWriter(thing.cast_as<CompactPointCloud>());
+    }
+    return m_th;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_POINTCLOUD_COMPRESSION_MONITOR_H
+#define YARP_POINTCLOUD_COMPRESSION_MONITOR_H
+
+#include <yarp/os/MonitorObject.h>
+#include <yarp/os/Things.h>
+#include <yarp/sig/PointCloudBase.h>
+
+#include <vector>
+
+/**
+ * A point cloud of any point type, stored as raw bytes, with the compact
+ * encoding or the usual one.
+ */
+class CompactPointCloud : public yarp::sig::PointCloudBase
+{
+public:
+    // Encode the points of another point cloud (not copied)
+    void setSource(const yarp::sig::PointCloudBase& cloud, bool compress);
+
+    size_t wireSizeBytes() const override;
+    size_t dataSizeBytes() const override;
+    size_t size() const override;
+    const char* getRawData() const override;
+    int getBottleTag() const override;
+
+    // Read any encoding
+    bool read(yarp::os::ConnectionReader& connection) override;
+    // Write the compact encoding, if there is a source, otherwise the usual encoding
+    bool write(yarp::os::ConnectionWriter& writer) const override;
+
+private:
+    const char* m_source {nullptr};
+    bool m_compress {true};
+    std::vector<char> m_points;
+};
+
+
+class PointCloudCompressionMonitor : public yarp::os::MonitorObject
+{
+public:
+    bool create(const yarp::os::Property& options) override;
+    void destroy() override;
+
+    bool setparam(const yarp::os::Property& params) override;
+    bool getparam(yarp::os::Property& params) override;
+
+    bool accept(yarp::os::Things& thing) override;
+    yarp::os::Things& update(yarp::os::Things& thing) override;
+
+private:
+    bool m_senderSide {false};
+    bool m_compress {true};
+    yarp::os::Things m_th;
+    CompactPointCloud m_cloud;
+};
+
+#endif // YARP_POINTCLOUD_COMPRESSION_MONITOR_H
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/Semaphore.h>
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+
+namespace {
+
+// Blocks after the first message, until it is released
+class BlockingReader : public PortReader
+{
+public:
+    Semaphore first {0};
+    Semaphore resume {0};
+    Semaphore last {0};
+    std::vector<std::string> received;
+
+    bool read(ConnectionReader& connection) override
+    {
+        Bottle b;
+        if (!b.read(connection)) {
+            return false;
+        }
+        received.push_back(b.get(0).asString());
+        if (received.size() == 1) {
+            first.post();
+            resume.wait();
+        } else if (received.size() == 3) {
+            last.post();
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+TEST_CASE("carriers::shm", "[carriers]")
+{
+    YARP_REQUIRE_PLUGIN("shm", "carrier");
+
+    Network::setLocalMode(true);
+
+    SECTION("test messages and replies through the segment")
+    {
+        Port in;
+        Port out;
+        REQUIRE(in.open("/shm/in"));
+        REQUIRE(out.open("/shm/out"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shm"));
+
+        std::thread replier([&]() {
+            for (int i = 0; i < 3; i++) {
+                Bottle b;
+                Bottle r;
+                in.read(b, true);
+                r.addString("re");
+                r.append(b);
+                in.reply(r);
+            }
+        });
+
+        for (int i = 0; i < 3; i++) {
+            Bottle b;
+            Bottle r;
+            b.addInt32(i);
+            b.addString(std::string(i * 1000, 'x'));
+            REQUIRE(out.write(b, r));
+            CHECK(r.size() == 3);
+            CHECK(r.get(0).asString() == "re");
+            CHECK(r.get(1).asInt32() == i);
+            CHECK(r.get(2).asString() == b.get(1).asString());
+        }
+        replier.join();
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("test messages larger than the ring")
+    {
+        BufferedPort<Bottle> in;
+        BufferedPort<Bottle> out;
+        REQUIRE(in.open("/shm/in"));
+        REQUIRE(out.open("/shm/out"));
+        in.setStrict();
+        // Messages are split over several slots, the ring wraps around
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shm+slots.2+slot_size.1024"));
+
+        const int count = 50;
+        bool ok = true;
+        std::thread reader([&]() {
+            for (int i = 0; i < count && ok; i++) {
+                Bottle* b = in.read();
+                ok = (b != nullptr && b->get(0).asInt32() == i && b->get(1).asString() == std::string(100 * i, 'a' + i % 26));
+            }
+        });
+        for (int i = 0; i < count; i++) {
+            Bottle& b = out.prepare();
+            b.clear();
+            b.addInt32(i);
+            b.addString(std::string(100 * i, 'a' + i % 26));
+            out.writeStrict();
+        }
+        out.waitForWrite();
+        reader.join();
+        CHECK(ok);
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("test invalid sizes")
+    {
+        Port in;
+        Port out;
+        REQUIRE(in.open("/shm/in"));
+        REQUIRE(out.open("/shm/out"));
+
+        CHECK_FALSE(Network::connect(out.getName(), in.getName(), "shm+slots.0"));
+        CHECK_FALSE(Network::connect(out.getName(), in.getName(), "shm+slot_size.0"));
+        CHECK_FALSE(Network::connect(out.getName(), in.getName(), "shm+broadcast.1+pool_slots.0"));
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("test broadcast to several readers")
+    {
+        BufferedPort<Bottle> in1;
+        BufferedPort<Bottle> in2;
+        BufferedPort<Bottle> out;
+        REQUIRE(in1.open("/shm/in1"));
+        REQUIRE(in2.open("/shm/in2"));
+        REQUIRE(out.open("/shm/out"));
+        in1.setStrict();
+        in2.setStrict();
+        REQUIRE(Network::connect(out.getName(), in1.getName(), "shm+broadcast.1+pool_slots.2"));
+        REQUIRE(Network::connect(out.getName(), in2.getName(), "shm+broadcast.1+pool_slots.2"));
+
+        const int count = 20;
+        bool ok1 = true;
+        bool ok2 = true;
+        auto readAll = [&](BufferedPort<Bottle>& in, bool& ok) {
+            for (int i = 0; i < count && ok; i++) {
+                Bottle* b = in.read();
+                ok = (b != nullptr && b->get(0).asInt32() == i && b->get(1).asString() == std::string(64 * 1024, 'a' + i % 26));
+            }
+        };
+        std::thread reader1(readAll, std::ref(in1), std::ref(ok1));
+        std::thread reader2(readAll, std::ref(in2), std::ref(ok2));
+        for (int i = 0; i < count; i++) {
+            Bottle& b = out.prepare();
+            b.clear();
+            b.addInt32(i);
+            b.addString(std::string(64 * 1024, 'a' + i % 26));
+            out.writeStrict();
+        }
+        out.waitForWrite();
+        reader1.join();
+        reader2.join();
+        CHECK(ok1);
+        CHECK(ok2);
+
+        out.close();
+        in2.close();
+        in1.close();
+    }
+
+    SECTION("test broadcast with a full pool")
+    {
+        BlockingReader reader;
+        Port in;
+        BufferedPort<Bottle> out;
+        in.setReader(reader);
+        REQUIRE(in.open("/shm/in"));
+        REQUIRE(out.open("/shm/out"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shm+broadcast.1+pool_slots.1"));
+
+        auto send = [&](char c) {
+            Bottle& b = out.prepare();
+            b.clear();
+            b.addString(std::string(64 * 1024, c));
+            out.writeStrict();
+            out.waitForWrite();
+        };
+
+        send('a');
+        reader.first.wait();
+        // The second message takes the only slot of the pool until it is
+        // read, the third one is copied in the ring of the connection
+        send('b');
+        send('c');
+        reader.resume.post();
+        CHECK(reader.last.waitWithTimeout(5.0));
+
+        out.close();
+        in.close();
+        REQUIRE(reader.received.size() == 3);
+        CHECK(reader.received[0] == std::string(64 * 1024, 'a'));
+        CHECK(reader.received[1] == std::string(64 * 1024, 'b'));
+        CHECK(reader.received[2] == std::string(64 * 1024, 'c'));
+    }
+
+    Network::setLocalMode(false);
+}
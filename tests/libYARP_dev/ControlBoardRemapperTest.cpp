@@ -145,6 +145,50 @@ static void checkRemapper(yarp::dev::PolyDriver & ddRemapper, int rand, size_t n
     {
         CHECK(setPosition[i] == readedEncoders[i]); // Setted position and readed encoders match
     }
+
+    // Read the same state with a single call
+    IFullJointState *fullState = nullptr;
+    REQUIRE(ddRemapper.view(fullState)); // full joint state interface correctly opened
+
+    std::vector<double> fullStatePosition(nrOfRemappedAxes,-40),
+                        fullStateTimestamp(nrOfRemappedAxes,-50);
+    std::vector<int>    fullStateControlMode(nrOfRemappedAxes,VOCAB_CM_POSITION);
+    FullJointState state;
+    state.jointPosition = fullStatePosition.data();
+    state.jointTimestamp = fullStateTimestamp.data();
+    state.controlMode = fullStateControlMode.data();
+    CHECK(fullState->getFullJointState(state)); // getFullJointState correctly called
+    CHECK(state.jointPosition_isValid);
+    CHECK(state.controlMode_isValid);
+    CHECK_FALSE(state.torque_isValid); // not requested
+
+    // Request all the arrays, the subdevices fill all their axes, also the
+    // ones that are not remapped
+    std::vector<double> allDoubles(9 * nrOfRemappedAxes, -60);
+    std::vector<int>    allInts(2 * nrOfRemappedAxes, -70);
+    FullJointState allState;
+    double* doubles = allDoubles.data();
+    allState.jointPosition = doubles;
+    allState.jointVelocity = doubles + 1 * nrOfRemappedAxes;
+    allState.jointAcceleration = doubles + 2 * nrOfRemappedAxes;
+    allState.motorPosition = doubles + 3 * nrOfRemappedAxes;
+    allState.motorVelocity = doubles + 4 * nrOfRemappedAxes;
+    allState.motorAcceleration = doubles + 5 * nrOfRemappedAxes;
+    allState.torque = doubles + 6 * nrOfRemappedAxes;
+    allState.pwmDutycycle = doubles + 7 * nrOfRemappedAxes;
+    allState.current = doubles + 8 * nrOfRemappedAxes;
+    allState.controlMode = allInts.data();
+    allState.interactionMode = allInts.data() + nrOfRemappedAxes;
+    CHECK(fullState->getFullJointState(allState)); // getFullJointState of all the arrays correctly called
+    CHECK(allState.jointPosition_isValid);
+    CHECK(allState.interactionMode_isValid);
+    CHECK(allState.current_isValid);
+
+    for(size_t i=0; i < nrOfRemappedAxes; i++)
+    {
+        CHECK(setPosition[i] == fullStatePosition[i]); // Setted position and full state position match
+        CHECK(settedControlMode[i] == fullStateControlMode[i]); // Setted control mode and full state control mode match
+    }
 }
 
 
@@ -279,6 +323,42 @@ TEST_CASE("dev::ControlBoardRemapperTest", "[yarp::dev]")
         // Test the controlboardremapper
         checkRemapper(ddRemapper,200,nrOfRemappedAxes);
 
+        // Open the controlboardremapper calling the controlboards in parallel
+        PolyDriver ddParallelRemapper;
+        Property pParallelRemapper = pRemapper;
+        pParallelRemapper.put("subdevicesThreads",2);
+
+        REQUIRE(ddParallelRemapper.open(pParallelRemapper)); // parallel controlboardremapper open reported successful
+
+        yarp::dev::IMultipleWrapper *imultwrapParallel = nullptr;
+        REQUIRE(ddParallelRemapper.view(imultwrapParallel)); // interface for multiple wrapper correctly opened
+
+        CHECK(imultwrapParallel->attachAll(fmcList)); // attachAll for parallel controlboardremapper successful
+
+        // Test the parallel controlboardremapper
+        checkRemapper(ddParallelRemapper,300,nrOfRemappedAxes);
+
+        // Open a controlboardremapper using only some of the axes of each
+        // controlboard
+        PolyDriver ddPartialRemapper;
+        Property pPartialRemapper;
+        pPartialRemapper.put("device","controlboardremapper");
+        pPartialRemapper.addGroup("axesNames");
+        Bottle & partialAxesList = pPartialRemapper.findGroup("axesNames").addList();
+        partialAxesList.addString("axisC2");
+        partialAxesList.addString("axisB1");
+        size_t nrOfPartialRemappedAxes = 2;
+
+        REQUIRE(ddPartialRemapper.open(pPartialRemapper)); // partial controlboardremapper open reported successful
+
+        yarp::dev::IMultipleWrapper *imultwrapPartial = nullptr;
+        REQUIRE(ddPartialRemapper.view(imultwrapPartial)); // interface for multiple wrapper correctly opened
+
+        CHECK(imultwrapPartial->attachAll(fmcList)); // attachAll for partial controlboardremapper successful
+
+        // Test the partial controlboardremapper
+        checkRemapper(ddPartialRemapper,400,nrOfPartialRemappedAxes);
+
         // Open the remotecontrolboardremapper
         PolyDriver ddRemoteRemapper;
         Property pRemoteRemapper;
@@ -300,6 +380,7 @@ TEST_CASE("dev::ControlBoardRemapperTest", "[yarp::dev]")
         pRemoteRemapper.put("remoteControlBoards",remoteControlBoards.get(0));
 
         pRemoteRemapper.put("localPortPrefix","/test/remoteControlBoardRemapper");
+        pRemoteRemapper.put("subdevicesThreads",2);
 
         Property & opts = pRemoteRemapper.addGroup("REMOTE_CONTROLBOARD_OPTIONS");
         opts.put("writeStrict","on");
@@ -312,6 +393,10 @@ TEST_CASE("dev::ControlBoardRemapperTest", "[yarp::dev]")
         // Close devices
         imultwrap->detachAll();
         ddRemapper.close();
+        imultwrapParallel->detachAll();
+        ddParallelRemapper.close();
+        imultwrapPartial->detachAll();
+        ddPartialRemapper.close();
         ddRemoteRemapper.close();
 
         for(int i=0; i < 3; i++)
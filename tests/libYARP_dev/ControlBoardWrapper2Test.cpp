@@ -10,10 +10,12 @@
 #include <yarp/dev/PolyDriver.h>
 
 #include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/IMultipleWrapper.h>
 
 #include <string>
+#include <vector>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -68,4 +70,58 @@ TEST_CASE("dev::ControlBoardWrapper2", "[yarp::dev]")
         CHECK(dd.close()); // close dd reported successful
         CHECK(dd2.close()); // close dd2 reported successful
     }
+
+    SECTION("test streaming only the fields requested by the client")
+    {
+        PolyDriver dd;
+        Property p;
+        p.put("device","controlboardwrapper2");
+        p.put("subdevice","fakeMotionControl");
+        p.put("name","/motor");
+        auto& pg = p.addGroup("GENERAL");
+        pg.put("Joints", 4);
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+
+        PolyDriver dd2;
+        Property p2;
+        p2.fromString("(stateExtFields (jointPosition controlMode))");
+        p2.put("device","remote_controlboard");
+        p2.put("remote","/motor");
+        p2.put("local","/motor/client");
+        p2.put("carrier","tcp");
+        p2.put("stateExtDelta","true");
+        REQUIRE(dd2.open(p2)); // remote_controlboard open reported successful
+
+        IEncoders *encs = nullptr;
+        IControlMode *ctrlmode = nullptr;
+        REQUIRE(dd2.view(encs));
+        REQUIRE(dd2.view(ctrlmode));
+
+        std::vector<double> positions(4), speeds(4);
+        std::vector<int> modes(4, VOCAB_CM_POSITION_DIRECT);
+        std::vector<int> readModes(4);
+
+        // Wait for the first messages with the profile requested
+        bool ok = false;
+        for (int wait = 0; wait < 50 && !ok; wait++) {
+            yarp::os::Time::delay(0.02);
+            ok = encs->getEncoders(positions.data()) && !encs->getEncoderSpeeds(speeds.data());
+        }
+        CHECK(ok); // positions streamed, velocities not streamed
+
+        // The modes are sent only when they change, and kept by the client
+        CHECK(ctrlmode->setControlModes(modes.data()));
+        ok = false;
+        for (int wait = 0; wait < 50 && !ok; wait++) {
+            yarp::os::Time::delay(0.02);
+            ok = ctrlmode->getControlModes(readModes.data()) && readModes == modes;
+        }
+        CHECK(ok); // modes received
+        yarp::os::Time::delay(0.2);
+        CHECK(ctrlmode->getControlModes(readModes.data())); // modes still valid
+        CHECK(readModes == modes); // modes still received
+
+        CHECK(dd2.close()); // close dd2 reported successful
+        CHECK(dd.close()); // close dd reported successful
+    }
 }
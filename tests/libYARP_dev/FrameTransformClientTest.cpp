@@ -213,6 +213,26 @@ TEST_CASE("dev::FrameTransformClientTest", "[yarp::dev]")
             INFO("Precision error: " + (mti - yarp::math::SE3inv(m3)).toString());
         }
 
+        //test 5bis (all the transforms from a frame)
+        {
+            std::vector<std::string> all_ids;
+            std::vector<yarp::sig::Matrix> all_transforms;
+            CHECK(itf->getAllTransforms("frame1", all_ids, all_transforms));
+            REQUIRE(all_ids.size() == 5); // frame11 and frame10 are not connected to frame1
+            REQUIRE(all_transforms.size() == all_ids.size());
+            for (size_t i = 0; i < all_ids.size(); i++)
+            {
+                yarp::sig::Matrix single;
+                CHECK(itf->getTransform(all_ids[i], "frame1", single));
+                CHECK(isEqual(all_transforms[i], single, precision));
+                if (all_ids[i] == "frame3")
+                {
+                    CHECK(isEqual(all_transforms[i], m3, precision)); // getAllTransforms ok
+                }
+            }
+            CHECK_FALSE(itf->getAllTransforms("frame_err", all_ids, all_transforms));
+        }
+
         //test 6
         yarp::sig::Vector in_point1(3), out_point1(3), verPoint1(4);
         yarp::sig::Vector in_pose1(6),  out_pose1(6),  verPose(6);
@@ -10,6 +10,8 @@
 #define _USE_MATH_DEFINES
 
 #include <yarp/math/Math.h>
+#include <yarp/math/FixedMatrix.h>
+#include <yarp/math/FrameTransform.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/math/Rand.h>
 #include <yarp/math/SVD.h>
@@ -756,4 +758,128 @@ TEST_CASE("math::MathTest", "[yarp::math]")
         f[4] = 5.0;
         CHECK_EQUAL(cat(1.0, 2.0, 3.0, 4.0, 5.0), f); // cat(n1, n2, n3, n4, n5) = [n1, n2, n3, n4, n5]
     }
+
+    SECTION("check in-place operations.")
+    {
+        Vector x(3);
+        x[0] = 1.0; x[1] = -2.0; x[2] = 3.0;
+        Vector y(3);
+        y[0] = 0.5; y[1] = 1.5; y[2] = -1.0;
+        Matrix A(3, 2);
+        A(0, 0) = 1.0; A(0, 1) = 2.0;
+        A(1, 0) = -1.0; A(1, 1) = 0.5;
+        A(2, 0) = 3.0; A(2, 1) = -2.0;
+        Matrix B(2, 3);
+        B(0, 0) = 0.5; B(0, 1) = 1.0; B(0, 2) = -1.0;
+        B(1, 0) = 2.0; B(1, 1) = -3.0; B(1, 2) = 1.5;
+
+        Vector z(y);
+        axpy(2.0, x, z);
+        checkEqual(z, y + 2.0 * x); // check axpy
+
+        Vector w(2);
+        w[0] = 1.0; w[1] = -1.0;
+        Vector r;
+        gemv(2.0, A, w, 0.0, r);
+        checkEqual(r, 2.0 * (A * w)); // check gemv, y resized
+        r = y;
+        const double* rData = r.data();
+        gemv(1.0, A, w, 0.5, r);
+        checkEqual(r, A * w + 0.5 * y); // check gemv with beta
+        CHECK(r.data() == rData); // check gemv does not reallocate
+        Vector s(2, 1.0);
+        gemv(1.0, A, x, 1.0, s, true);
+        checkEqual(s, A.transposed() * x + Vector(2, 1.0)); // check gemv with transposed matrix
+
+        Matrix C;
+        gemm(1.0, A, B, 0.0, C);
+        checkEqual(C, A * B); // check gemm, C resized
+        Matrix D(C);
+        gemm(-1.0, A, B, 2.0, D);
+        checkEqual(D, A * B); // check gemm with beta
+        Matrix E;
+        gemm(1.0, B, A, 0.0, E, true, true);
+        checkEqual(E, (A * B).transposed()); // check gemm with transposed matrices
+        gemm(1.0, A, A, 0.0, E, true);
+        checkEqual(E, A.transposed() * A); // check gemm with first matrix transposed
+        gemm(1.0, A, A, 0.0, E, false, true);
+        checkEqual(E, A * A.transposed()); // check gemm with second matrix transposed
+    }
+
+    SECTION("check fixed size vectors and matrices.")
+    {
+        FixedVector3 a {1.0, 2.0, 3.0};
+        FixedVector3 b {-1.0, 0.5, 2.0};
+        Vector va = a.toVector();
+        Vector vb = b.toVector();
+
+        checkEqual((a + b).toVector(), va + vb);
+        checkEqual((a - b).toVector(), va - vb);
+        checkEqual((2.0 * a).toVector(), 2.0 * va);
+        checkEqual((a / 2.0).toVector(), va / 2.0);
+        checkEqual((-a).toVector(), -1.0 * va);
+        CHECK(dot(a, b) == Approx(dot(va, vb)));
+        CHECK(norm(a) == Approx(yarp::math::norm(va)));
+        checkEqual(cross(a, b).toVector(), cross(va, vb));
+        checkEqual(FixedVector3(va).toVector(), va);
+
+        Vector rot(4);
+        rot[0] = 0.0; rot[1] = 0.6; rot[2] = 0.8; rot[3] = M_PI / 3;
+        Matrix H = axis2dcm(rot);
+        H(0, 3) = 0.1; H(1, 3) = -0.2; H(2, 3) = 0.3;
+        rot[0] = 1.0; rot[1] = 0.0; rot[2] = 0.0; rot[3] = 1.0;
+        Matrix K = axis2dcm(rot);
+        K(2, 3) = 1.0;
+        FixedMatrix4x4 fH(H);
+        FixedMatrix4x4 fK(K);
+
+        checkEqual((fH * fK).toMatrix(), H * K);
+        checkEqual((fH + fK).toMatrix(), H + K);
+        checkEqual(fH.transposed().toMatrix(), H.transposed());
+        checkEqual(SE3inv(fH).toMatrix(), SE3inv(H));
+        checkEqual((fH * SE3inv(fH)).toMatrix(), eye(4, 4));
+        checkEqual(FixedMatrix4x4::identity().toMatrix(), eye(4, 4));
+
+        FixedVector4 p {1.0, 2.0, 3.0, 1.0};
+        checkEqual((fH * p).toVector(), H * p.toVector());
+
+        Matrix m(2, 2);
+        FixedMatrix<2, 2> {1.0, 2.0, 3.0, 4.0}.toMatrix(m);
+        CHECK(m(1, 0) == 3.0);
+    }
+
+    SECTION("check fixed size Quaternion and FrameTransform conversions.")
+    {
+        double angles[3] = {0.3, -1.2, 2.5};
+        Matrix R = euler2dcm(Vector(3, angles));
+        FixedMatrix4x4 fR(R);
+        FixedMatrix3x3 fR3(R.submatrix(0, 2, 0, 2));
+
+        Quaternion q1;
+        Quaternion q2;
+        Quaternion q3;
+        q1.fromRotationMatrix(R);
+        q2.fromRotationMatrix(fR);
+        q3.fromRotationMatrix(fR3);
+        checkEqual(q2.toVector(), q1.toVector());
+        checkEqual(q3.toVector(), q1.toVector());
+
+        FixedMatrix4x4 fR4;
+        q1.toRotationMatrix4x4(fR4);
+        checkEqual(fR4.toMatrix(), q1.toRotationMatrix4x4());
+        FixedMatrix3x3 fR33;
+        q1.toRotationMatrix3x3(fR33);
+        checkEqual(fR33.toMatrix(), q1.toRotationMatrix3x3());
+
+        yarp::math::FrameTransform t;
+        t.translation.set(0.1, 0.2, 0.3);
+        t.rotation = q1;
+        FixedMatrix4x4 fT;
+        t.toMatrix(fT);
+        checkEqual(fT.toMatrix(), t.toMatrix());
+
+        yarp::math::FrameTransform t2;
+        t2.fromMatrix(fT);
+        checkEqual(t2.toMatrix(), t.toMatrix());
+    }
 }
@@ -259,6 +259,111 @@ TEST_CASE("os::BottleTest", "[yarp::os]")
 
     }
 
+    SECTION("testing reread reuses items")
+    {
+        Bottle bot("1 \"hello\" (2.5 (3 \"four\") \"there\")");
+        Bottle bot2;
+        bot2.read(bot);
+        Value* item = &bot2.get(1);
+        Value* list = &bot2.get(2);
+        Value* nested = &bot2.get(2).asList()->get(1).asList()->get(0);
+
+        bot.fromString("5 \"hello world\" (7.5 (8 \"nine\") \"again\")");
+        bot2.read(bot);
+        CHECK(bot.toString() == bot2.toString()); // content check
+        CHECK(&bot2.get(1) == item); // item reused
+        CHECK(&bot2.get(2) == list); // list reused
+        CHECK(&bot2.get(2).asList()->get(1).asList()->get(0) == nested); // nested item reused
+
+        bot.fromString("(10 20) 30 [ok] {1 2}");
+        bot2.read(bot);
+        CHECK(bot.toString() == bot2.toString()); // different types
+        CHECK(bot2.get(0).asList()->get(1).asInt32() == 20);
+        CHECK(bot2.get(2).isVocab());
+        CHECK(bot2.get(3).isBlob());
+
+        bot.fromString("10 20 30");
+        bot2.read(bot);
+        CHECK(bot.toString() == bot2.toString()); // specialized list
+
+        bot.fromString("1 \"hello\" 2.5");
+        bot2.read(bot);
+        Value* second = &bot2.get(1);
+        Value* third = &bot2.get(2);
+        bot.fromString("\"one\" \"hello\" 3.5");
+        bot2.read(bot);
+        CHECK(bot.toString() == bot2.toString()); // different first item
+        CHECK(&bot2.get(1) == second); // items matched by position
+        CHECK(&bot2.get(2) == third);
+        bot2.clear();
+        CHECK(bot2.size() == 0);
+    }
+
+    SECTION("testing packed lists")
+    {
+        Bottle bot;
+        for (int i = 0; i < 100; i++) {
+            bot.addFloat64(i * 0.5);
+        }
+        Bottle bot2;
+        bot2.read(bot);
+        CHECK(bot2.size() == 100);
+        CHECK(bot2.getInt32Array() == nullptr); // wrong type
+        const yarp::conf::float64_t* items = bot2.getFloat64Array();
+        REQUIRE(items != nullptr);
+        CHECK(items[0] == 0.0);
+        CHECK(items[99] == 49.5);
+        CHECK(bot2.toString() == bot.toString()); // content check
+
+        Bottle bot3;
+        bot3.read(bot2);
+        REQUIRE(bot3.getFloat64Array() != nullptr); // round trip
+        CHECK(bot3.getFloat64Array()[10] == 5.0);
+        Bottle bot4 = bot3;
+        REQUIRE(bot4.getFloat64Array() != nullptr); // copy
+        CHECK(bot4 == bot);
+        bot4.copy(bot3, 10, 5);
+        CHECK(bot4.size() == 5);
+        CHECK(bot4.toString() == "5.0 5.5 6.0 6.5 7.0");
+
+        CHECK(bot3.get(99).asFloat64() == 49.5); // items can still be accessed one by one
+        bot3.addFloat64(50.0);
+        CHECK(bot3.size() == 101);
+        REQUIRE(bot3.getFloat64Array() != nullptr);
+        CHECK(bot3.getFloat64Array()[100] == 50.0);
+        bot3.hasChanged();
+        CHECK(bot3.getFloat64Array() == nullptr); // modified in place
+        CHECK(bot.getFloat64Array() == nullptr); // not received
+        bot3.addString("hello");
+        CHECK(bot3.getFloat64Array() == nullptr); // mixed types
+
+        bot.fromString("(1 2 3) (4 5 6) \"hello\"");
+        bot2.read(bot);
+        Bottle* lst = bot2.get(1).asList();
+        REQUIRE(lst != nullptr);
+        REQUIRE(lst->getInt32Array() != nullptr); // nested list
+        CHECK(lst->getInt32Array()[2] == 6);
+        CHECK(bot2.toString() == bot.toString());
+        Bottle bot5;
+        bot5.read(bot2);
+        CHECK(bot5.toString() == bot.toString()); // nested round trip
+
+        Bottle edited;
+        edited.read(bot4);
+        REQUIRE(edited.getFloat64Array() != nullptr);
+        edited.get(0) = Value(1.5);
+        bot5.read(edited);
+        CHECK(bot5.toString() == "1.5 5.5 6.0 6.5 7.0"); // assigned in place
+        bot2.read(bot);
+        bot2.get(1).asList()->get(1) = Value(50);
+        bot5.read(bot2);
+        CHECK(bot5.toString() == "(1 2 3) (4 50 6) hello"); // nested, assigned in place
+
+        Bottle empty;
+        CHECK(empty.getFloat64Array() == nullptr);
+        CHECK(Bottle::getNullBottle().getInt8Array() == nullptr);
+    }
+
 
     SECTION("testing white space behavior")
     {
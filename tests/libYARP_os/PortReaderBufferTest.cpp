@@ -12,6 +12,9 @@
 #include <yarp/os/BufferedPort.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/Type.h>
+
+#include <thread>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -36,6 +39,15 @@ public:
     }
 };
 
+class PortReaderBufferTestNamedBottle : public Bottle
+{
+public:
+    Type getReadType() const override
+    {
+        return Type::byName("test/named");
+    }
+};
+
 TEST_CASE("os::PortReaderBufferTest", "[yarp::os]")
 {
 #if defined(DISABLE_FAILING_TESTS)
@@ -147,6 +159,147 @@ TEST_CASE("os::PortReaderBufferTest", "[yarp::os]")
         CHECK(in.count == 5); // got message #3
     }
 
+    SECTION("checking lock-free buffer")
+    {
+        Bottle data[4];
+        for (int i = 0; i < 4; i++) {
+            data[i].addInt32(i);
+        }
+
+        PortReaderBuffer<Bottle> buffer(2);
+        buffer.setLockFree();
+        buffer.setStrict();
+        buffer.acceptObject(&data[0], nullptr);
+        buffer.acceptObject(&data[1], nullptr);
+        CHECK(buffer.getPendingReads() == 2); // strict, nothing is dropped
+        Bottle* bot = buffer.read();
+        REQUIRE(bot != nullptr);
+        CHECK(bot->get(0).asInt32() == 0); // first in, first out
+        bot = buffer.read();
+        REQUIRE(bot != nullptr);
+        CHECK(bot->get(0).asInt32() == 1);
+        CHECK(buffer.read(false) == nullptr); // nothing left
+
+        buffer.setStrict(false);
+        for (int i = 0; i < 4; i++) {
+            buffer.acceptObject(&data[i], nullptr);
+        }
+        CHECK(buffer.getPendingReads() == 1); // not strict, old data is dropped
+        bot = buffer.read();
+        REQUIRE(bot != nullptr);
+        CHECK(bot->get(0).asInt32() == 3); // most recent
+
+        buffer.interrupt();
+        CHECK(buffer.read() == nullptr); // interrupted
+    }
+
+    SECTION("checking lock-free buffered port")
+    {
+        BufferedPort<Bottle> out;
+        BufferedPort<Bottle> in;
+        in.setLockFree();
+        in.setStrict();
+        out.open("/out");
+        in.open("/in");
+        Network::connect("/out", "/in");
+        Network::sync("/out");
+        Network::sync("/in");
+        for (int i = 0; i < 10; i++) {
+            out.prepare().fromString(std::to_string(i));
+            out.write(true);
+        }
+        for (int i = 0; i < 10; i++) {
+            Bottle* bot = in.read();
+            REQUIRE(bot != nullptr);
+            CHECK(bot->get(0).asInt32() == i); // strict, all messages received
+        }
+        out.close();
+        in.close();
+    }
+
+    SECTION("checking closing a full lock-free buffered port")
+    {
+        BufferedPort<Bottle> out;
+        BufferedPort<Bottle> in;
+        in.setLockFree();
+        in.setStrict();
+        out.open("/out");
+        in.open("/in");
+        Network::connect("/out", "/in");
+        Network::sync("/out");
+        Network::sync("/in");
+        std::thread writer([&]() {
+            for (int i = 0; i < 200; i++) {
+                out.prepare().fromString(std::to_string(i));
+                out.write(true);
+            }
+        });
+        // nobody reads, the input thread waits for some space
+        int rep = 0;
+        while (in.getPendingReads() < 128 && rep < 100) {
+            Time::delay(0.1);
+            rep++;
+        }
+        CHECK(in.getPendingReads() == 128);
+        in.close(); // must not hang
+        out.close();
+        writer.join();
+    }
+
+    SECTION("checking local carrier sharing")
+    {
+        BufferedPort<PortReaderBufferTestNamedBottle> out;
+        BufferedPort<PortReaderBufferTestNamedBottle> in;
+        BufferedPort<Bottle> typed;
+        Port plain;
+        typed.promiseType(Type::byName("test/other"));
+        out.open("/out");
+        in.open("/in");
+        typed.open("/typed");
+        plain.open("/plain");
+        Network::connect("/out", "/in", "local");
+        Network::connect("/out", "/typed", "local");
+        Network::connect("/out", "/plain", "local");
+        Network::sync("/out");
+        Network::sync("/in");
+        Network::sync("/typed");
+        Network::sync("/plain");
+
+        Bottle& first = out.prepare();
+        first.fromString("1 2 3");
+        out.write(true);
+        Bottle* bot = in.read();
+        REQUIRE(bot != nullptr);
+        CHECK(bot == &first); // handed over, not copied
+        Bottle* copy = typed.read();
+        REQUIRE(copy != nullptr);
+        CHECK(copy != &first); // type mismatch, copied
+        CHECK(copy->toString() == "1 2 3");
+        Bottle received;
+        CHECK(plain.read(received)); // the reader does not use references
+        CHECK(received.toString() == "1 2 3");
+
+        // The reader still uses the first buffer, it is not modified
+        Bottle& second = out.prepare();
+        CHECK(&second != &first);
+        second.fromString("4 5");
+        out.write(true);
+        CHECK(bot->toString() == "1 2 3");
+        bot = in.read();
+        REQUIRE(bot != nullptr);
+        CHECK(bot->toString() == "4 5");
+        copy = typed.read();
+        REQUIRE(copy != nullptr);
+        CHECK(copy->toString() == "4 5");
+        CHECK(plain.read(received));
+        CHECK(received.toString() == "4 5");
+
+        out.close();
+        in.close();
+        typed.close();
+        plain.close();
+    }
+
     SECTION("checking callback part without open")
     {
         {
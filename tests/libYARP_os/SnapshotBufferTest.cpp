@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/SnapshotBuffer.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+
+TEST_CASE("os::SnapshotBufferTest", "[yarp::os]")
+{
+    SECTION("check write, update and read")
+    {
+        SnapshotBuffer<std::vector<int>> buffer;
+        CHECK(buffer.get().empty());
+
+        buffer.write({1, 2, 3});
+        CHECK(buffer.get() == std::vector<int>({1, 2, 3}));
+
+        // update modifies a copy of the latest value
+        for (int i = 0; i < 20; i++) {
+            buffer.update([&](std::vector<int>& value) { value.push_back(4 + i); });
+        }
+        CHECK(buffer.get().size() == 23);
+        CHECK(buffer.read([](const std::vector<int>& value) { return value[22]; }) == 23);
+    }
+
+    SECTION("check that the value is not modified while it is read")
+    {
+        SnapshotBuffer<std::vector<int>, 3> buffer;
+        buffer.write({1});
+
+        buffer.read([&](const std::vector<int>& value) {
+            buffer.write({2});
+            buffer.write({3});
+            buffer.write({4});
+            CHECK(value == std::vector<int>({1}));
+        });
+        CHECK(buffer.get() == std::vector<int>({4}));
+    }
+
+    SECTION("check that the readers see consistent values")
+    {
+        // Each value published has all the elements equal
+        SnapshotBuffer<std::vector<int>> buffer;
+        buffer.write(std::vector<int>(64, 0));
+
+        std::atomic<bool> done {false};
+        std::atomic<int> inconsistent {0};
+        std::atomic<int> reads {0};
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; r++) {
+            readers.emplace_back([&]() {
+                int last = 0;
+                while (!done) {
+                    bool ok = buffer.read([&](const std::vector<int>& value) {
+                        bool ok = value.size() == 64 && value.front() >= last;
+                        for (auto x : value) {
+                            ok = ok && x == value.front();
+                        }
+                        last = value.front();
+                        return ok;
+                    });
+                    if (!ok) {
+                        inconsistent++;
+                    }
+                    reads++;
+                }
+            });
+        }
+
+        for (int i = 1; i <= 20000; i++) {
+            buffer.update([&](std::vector<int>& value) {
+                for (auto& x : value) {
+                    x = i;
+                }
+            });
+        }
+        done = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        CHECK(reads > 0);
+        CHECK(inconsistent == 0);
+        CHECK(buffer.get() == std::vector<int>(64, 20000));
+    }
+}
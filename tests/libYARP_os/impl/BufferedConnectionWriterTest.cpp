@@ -26,6 +26,22 @@ typedef PortablePair<PortablePair<PortablePair<Bottle, ImageOf<PixelRgb> >,
                                   PortablePair<ImageOf<PixelRgb>, Stamp> >,
                      Bottle> Monster;
 
+class BlockOutputStream : public StringOutputStream
+{
+public:
+    size_t calls {0};
+    std::vector<const char*> blocks;
+
+    void writeBlocks(const Bytes* b, size_t count) override
+    {
+        calls++;
+        for (size_t i = 0; i < count; i++) {
+            blocks.push_back(b[i].get());
+        }
+        StringOutputStream::writeBlocks(b, count);
+    }
+};
+
 TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]")
 {
 
@@ -40,6 +56,26 @@ TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]"
         CHECK(sos.toString() == "Hello\r\nGreetings\r\n"); // "two line writes"
     }
 
+    SECTION("testing scatter-gather writing")
+    {
+        ImageOf<PixelRgb> img;
+        img.resize(32, 24);
+        img.zero();
+        BufferedConnectionWriter bbr;
+        bbr.reset(false);
+        img.write(bbr);
+
+        BlockOutputStream bos;
+        bbr.write(bos);
+        CHECK(bos.calls == 1); // all the blocks are written at once
+        CHECK(bos.toString().length() == bbr.dataSize());
+        bool external = false;
+        for (const auto* block : bos.blocks) {
+            external = external || (block == reinterpret_cast<const char*>(img.getRawImage()));
+        }
+        CHECK(external); // the image buffer is not copied
+    }
+
     SECTION("test restarting writer without reallocating memory...")
     {
 
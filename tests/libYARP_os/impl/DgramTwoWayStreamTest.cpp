@@ -8,8 +8,11 @@
  */
 
 #include <yarp/os/impl/DgramTwoWayStream.h>
+#include <yarp/os/NetType.h>
+#include <yarp/os/Time.h>
 
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include <catch.hpp>
@@ -251,4 +254,200 @@ TEST_CASE("os::impl::DgramTwoWayStreamTest", "[yarp::os][yarp::os::impl]")
             }
         }
     }
+
+    SECTION("Test fragmented Dgram")
+    {
+        out.openMonitor(sz, sz);
+        out.setFragmentation(true, 2);
+        in.openMonitor(sz, sz);
+        in.setFragmentation(true);
+        for (size_t i=0; i<msg.length(); i++) {
+            msg.get()[i] = i%128;
+        }
+
+        auto send = [&]() {
+            // a new message, the reader drops repeated ones
+            out.beginPacket();
+            out.write(msg.bytes());
+            out.flush();
+            out.endPacket();
+        };
+        auto receive = [&]() {
+            for (size_t i=0; i<recv.length(); i++) {
+                recv.get()[i] = 0;
+            }
+            in.beginPacket();
+            int len = in.readFull(recv.bytes());
+            in.endPacket();
+            if (len != (int)msg.length()) {
+                return false;
+            }
+            for (size_t i=0; i<recv.length(); i++) {
+                if (recv.get()[i]!=msg.get()[i]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        INFO("checking that messages are split in fragments");
+        send();
+        CHECK(5 == out.size()); // 3 fragments, 1 parity fragment every 2 fragments
+
+        INFO("checking that fragments are reassembled into messages");
+        in.copyMonitor(out);
+        CHECK(receive());
+        CHECK_FALSE(receive()); // nothing left
+
+        INFO("checking that a lost fragment is rebuilt");
+        out.clear();
+        send();
+        in.clear();
+        in.copyMonitor(out);
+        in.corruptDrop(1);
+        CHECK(receive());
+
+        INFO("checking that a corrupted fragment is rebuilt");
+        out.clear();
+        send();
+        in.clear();
+        in.copyMonitor(out);
+        in.corrupt(3, 30);
+        CHECK(receive());
+
+        INFO("checking that fragments can be received in any order");
+        out.clear();
+        send();
+        in.clear();
+        in.copyMonitor(out);
+        in.corruptSwap(0, 4);
+        CHECK(receive());
+
+        INFO("checking that messages that cannot be rebuilt are dropped");
+        out.clear();
+        send();
+        send();
+        in.clear();
+        in.copyMonitor(out);
+        in.corruptDrop(0);
+        in.corruptDrop(0);
+        CHECK(receive()); // the second message
+        CHECK_FALSE(receive()); // nothing left
+
+        INFO("checking that messages older than the last one received are dropped");
+        out.clear();
+        send();
+        send();
+        in.clear();
+        in.copyMonitor(out);
+        for (int i=0; i<5; i++) {
+            in.corruptSwap(i, i+5);
+        }
+        CHECK(receive()); // the second message
+        CHECK_FALSE(receive()); // the first one is dropped
+
+        INFO("checking the counters");
+        DgramTwoWayStream::Statistics stats = in.getStatistics();
+        CHECK(stats.crcErrors == 1); // corrupted fragment
+        CHECK(stats.recoveredPackets == 4); // lost, corrupted and late fragments
+        CHECK(stats.droppedMessages == 1); // message that cannot be rebuilt
+        CHECK(stats.droppedPackets == 6); // corrupted fragment, fragments of the old message
+        stats = out.getStatistics();
+        CHECK(stats.sentPackets == 40);
+        CHECK(stats.sendCalls == 40);
+    }
+
+    SECTION("Test malformed fragmented Dgram")
+    {
+        out.openMonitor(sz, sz);
+        out.setFragmentation(true, 1, 1);
+        in.openMonitor(sz, sz);
+        in.setFragmentation(true);
+
+        INFO("checking that messages that need too many fragments are dropped");
+        ManagedBytes big(40000);
+        out.beginPacket();
+        out.write(big.bytes());
+        out.flush();
+        out.endPacket();
+        CHECK(0 == out.size()); // 40000 fragments and 40000 parity fragments
+
+        INFO("checking that fragments with a wrong message length are dropped");
+        out.clear();
+        out.setFragmentation(true, 2);
+        for (size_t i=0; i<msg.length(); i++) {
+            msg.get()[i] = i%128;
+        }
+        out.beginPacket();
+        out.write(msg.bytes());
+        out.flush();
+        out.endPacket();
+        in.copyMonitor(out);
+        for (int i=0; i<in.size(); i++) {
+            // a length that still needs 3 fragments, with a valid crc
+            Bytes b = in.get(i);
+            Bytes length(b.get() + 8, 4);
+            NetType::netInt((NetInt32)(msg.length() - 1), length);
+            NetInt32 crc = (NetInt32)NetType::getCrc(b.get() + 4, b.length() - 4);
+            memcpy(b.get(), &crc, sizeof(crc));
+        }
+        in.beginPacket();
+        CHECK(in.readFull(recv.bytes()) <= 0);
+        in.endPacket();
+        DgramTwoWayStream::Statistics stats = in.getStatistics();
+        CHECK(stats.recoveredPackets == 0);
+        CHECK(stats.droppedPackets == 2); // last fragment, and its rebuilt copy
+
+        INFO("checking that messages longer than the maximum are dropped");
+        out.clear();
+        out.beginPacket();
+        out.write(msg.bytes());
+        out.flush();
+        out.endPacket();
+        in.clear();
+        in.copyMonitor(out);
+        in.setMaxMessageSize(msg.length() - 1);
+        in.beginPacket();
+        CHECK(in.readFull(recv.bytes()) <= 0);
+        in.endPacket();
+        stats = in.getStatistics();
+        CHECK(stats.droppedPackets == 2 + (size_t)out.size()); // all the fragments
+        in.setMaxMessageSize(0);
+        CHECK(in.getMaxMessageSize() == 32 * 1024 * 1024); // default value
+    }
+
+    SECTION("Test partial fragmented Dgram")
+    {
+        out.openMonitor(sz, sz);
+        out.setFragmentation(true, 2);
+        in.openMonitor(sz, sz);
+        in.setFragmentation(true);
+
+        auto receiveFirst = [&]() {
+            // only the first fragment of the next message arrives
+            out.clear();
+            out.beginPacket();
+            out.write(msg.bytes());
+            out.flush();
+            out.endPacket();
+            in.clear();
+            in.copyMonitor(out);
+            while (in.size() > 1) {
+                in.corruptDrop(1);
+            }
+            in.beginPacket();
+            CHECK(in.readFull(recv.bytes()) <= 0);
+            in.endPacket();
+        };
+
+        INFO("checking that partial messages are kept for a while");
+        receiveFirst();
+        receiveFirst();
+        CHECK(in.getStatistics().droppedMessages == 0);
+
+        INFO("checking that partial messages time out");
+        Time::delay(1.2);
+        receiveFirst();
+        CHECK(in.getStatistics().droppedMessages == 2);
+    }
 }
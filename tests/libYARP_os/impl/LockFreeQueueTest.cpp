@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/LockFreeQueue.h>
+
+#include <yarp/os/Time.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+TEST_CASE("os::impl::LockFreeQueueTest", "[yarp::os][yarp::os::impl]")
+{
+    SECTION("push and pop")
+    {
+        LockFreeQueue queue(3);
+        CHECK(queue.capacity() == 4); // rounded up to a power of two
+        CHECK(queue.size() == 0);
+        CHECK(queue.pop() == nullptr);
+
+        int items[5];
+        for (int i = 0; i < 4; i++) {
+            CHECK(queue.push(&items[i]));
+        }
+        CHECK_FALSE(queue.push(&items[4])); // full
+        CHECK(queue.size() == 4);
+
+        CHECK(queue.pop() == &items[0]); // first in, first out
+        CHECK(queue.push(&items[4]));
+        for (int i = 1; i < 5; i++) {
+            CHECK(queue.pop() == &items[i]);
+        }
+        CHECK(queue.pop() == nullptr);
+    }
+
+    SECTION("waiting and interrupting")
+    {
+        LockFreeQueue queue(2);
+        CHECK_FALSE(queue.waitForItem(0.01)); // timeout
+        CHECK(queue.waitForSpace(0.01));
+
+        queue.interrupt();
+        CHECK(queue.waitForItem()); // returns immediately
+        CHECK(queue.checkInterrupt());
+        CHECK_FALSE(queue.checkInterrupt());
+        queue.resume();
+
+        int item = 0;
+        std::thread producer([&]() {
+            Time::delay(0.1);
+            queue.push(&item);
+        });
+        CHECK(queue.waitForItem(10.0));
+        CHECK(queue.pop() == &item);
+        producer.join();
+
+        queue.push(&item);
+        queue.push(&item);
+        std::thread consumer([&]() {
+            Time::delay(0.1);
+            queue.pop();
+        });
+        CHECK(queue.waitForSpace(10.0));
+        consumer.join();
+
+        queue.push(&item);
+        std::thread interrupter([&]() {
+            Time::delay(0.1);
+            queue.interrupt();
+        });
+        CHECK_FALSE(queue.waitForSpace()); // interrupted while full
+        interrupter.join();
+        CHECK_FALSE(queue.waitForSpace()); // returns immediately
+        queue.resume();
+        CHECK_FALSE(queue.waitForSpace(0.01)); // timeout
+    }
+
+    SECTION("several producers and consumers")
+    {
+        constexpr int producers = 4;
+        constexpr int consumers = 2;
+        constexpr int itemsPerProducer = 10000;
+
+        LockFreeQueue queue(16);
+        std::vector<int> items(producers * itemsPerProducer, 0);
+        std::atomic<int> received {0};
+        std::atomic<long> sum {0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p]() {
+                for (int i = 0; i < itemsPerProducer; i++) {
+                    int* item = &items[p * itemsPerProducer + i];
+                    *item = i;
+                    while (!queue.push(item)) {
+                        queue.waitForSpace(0.01);
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < consumers; c++) {
+            threads.emplace_back([&]() {
+                while (received.load() < producers * itemsPerProducer) {
+                    auto* item = static_cast<int*>(queue.pop());
+                    if (item == nullptr) {
+                        queue.waitForItem(0.01);
+                        continue;
+                    }
+                    sum += *item;
+                    received++;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(received.load() == producers * itemsPerProducer);
+        CHECK(sum.load() == static_cast<long>(producers) * itemsPerProducer * (itemsPerProducer - 1) / 2);
+        CHECK(queue.size() == 0);
+    }
+}
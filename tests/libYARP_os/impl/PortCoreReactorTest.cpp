@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2006-2021 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCoreReactor.h>
+
+#include <yarp/conf/environment.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Time.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#    include <dirent.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+#if defined(__linux__)
+namespace {
+size_t countThreads()
+{
+    size_t count = 0;
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+        return 0;
+    }
+    while (struct dirent* d = readdir(dir)) {
+        if (d->d_name[0] != '.') {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+} // namespace
+#endif
+
+TEST_CASE("os::impl::PortCoreReactorTest", "[yarp::os][yarp::os::impl]")
+{
+#if !defined(__linux__)
+    YARP_SKIP_TEST("The port reactor is available only on Linux")
+#else
+    SECTION("triggered handlers")
+    {
+        PortCoreReactor reactor(2);
+        REQUIRE(reactor.isValid());
+        CHECK(reactor.getWorkerCount() == 2);
+
+        std::atomic<int> hits {0};
+        long id = reactor.add([&]() { hits++; });
+        REQUIRE(id >= 0);
+        CHECK(reactor.getHandlerCount() == 1);
+
+        for (int i = 0; i < 10; ++i) {
+            reactor.trigger(id);
+            for (int j = 0; j < 100 && hits <= i; ++j) {
+                Time::delay(0.001);
+            }
+        }
+        CHECK(hits == 10);
+
+        reactor.remove(id);
+        CHECK(reactor.getHandlerCount() == 0);
+        CHECK_FALSE(reactor.trigger(id));
+    }
+
+    SECTION("blocked workers")
+    {
+        PortCoreReactor reactor(1);
+        REQUIRE(reactor.isValid());
+
+        // A blocked handler does not keep the others waiting
+        std::atomic<bool> release {false};
+        std::atomic<int> hits {0};
+        long blocking = reactor.add([&]() {
+            while (!release) {
+                Time::delay(0.001);
+            }
+        });
+        long other = reactor.add([&]() { hits++; });
+        reactor.trigger(blocking);
+        Time::delay(0.01);
+        reactor.trigger(other);
+        for (int j = 0; j < 1000 && hits == 0; ++j) {
+            Time::delay(0.001);
+        }
+        CHECK(hits == 1);
+        CHECK(reactor.getWorkerCount() == 2);
+
+        // The workers started meanwhile stop once idle
+        release = true;
+        for (int j = 0; j < 100 && reactor.getWorkerCount() > 1; ++j) {
+            Time::delay(PortCoreReactor::idleTimeout / 20);
+        }
+        CHECK(reactor.getWorkerCount() == 1);
+
+        reactor.remove(blocking);
+        reactor.remove(other);
+    }
+
+    SECTION("capped workers")
+    {
+        PortCoreReactor reactor(1, 2);
+        REQUIRE(reactor.isValid());
+
+        // Once all the workers are blocked, the other handlers wait
+        std::atomic<bool> release {false};
+        std::atomic<int> hits {0};
+        auto block = [&]() {
+            while (!release) {
+                Time::delay(0.001);
+            }
+        };
+        long blocking1 = reactor.add(block);
+        long blocking2 = reactor.add(block);
+        long other = reactor.add([&]() { hits++; });
+        reactor.trigger(blocking1);
+        reactor.trigger(blocking2);
+        Time::delay(0.01);
+        reactor.trigger(other);
+        Time::delay(0.1);
+        CHECK(hits == 0);
+        CHECK(reactor.getWorkerCount() == 2);
+
+        release = true;
+        for (int j = 0; j < 1000 && hits == 0; ++j) {
+            Time::delay(0.001);
+        }
+        CHECK(hits == 1);
+        CHECK(reactor.getWorkerCount() == 2);
+
+        reactor.remove(blocking1);
+        reactor.remove(blocking2);
+        reactor.remove(other);
+    }
+
+    SECTION("watched sockets")
+    {
+        PortCoreReactor reactor(1);
+        REQUIRE(reactor.isValid());
+
+        int sv[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+        std::atomic<int> received {0};
+        long id = -1;
+        id = reactor.add([&]() {
+            char c;
+            if (::read(sv[0], &c, 1) == 1) {
+                received++;
+                reactor.arm(id, sv[0]);
+            }
+        });
+        REQUIRE(reactor.arm(id, sv[0]));
+
+        const int messages = 50;
+        for (int i = 0; i < messages; ++i) {
+            char c = 'x';
+            REQUIRE(::write(sv[1], &c, 1) == 1);
+        }
+        for (int j = 0; j < 1000 && received < messages; ++j) {
+            Time::delay(0.001);
+        }
+        CHECK(received == messages);
+
+        // Once removed, the handler is never called again
+        reactor.remove(id);
+        char c = 'x';
+        REQUIRE(::write(sv[1], &c, 1) == 1);
+        Time::delay(0.05);
+        CHECK(received == messages);
+
+        ::close(sv[0]);
+        ::close(sv[1]);
+    }
+#endif
+}
+
+TEST_CASE("os::impl::PortCoreReactorTest::inputConnections", "[yarp::os][yarp::os::impl]")
+{
+#if !defined(__linux__)
+    YARP_SKIP_TEST("The port reactor is available only on Linux")
+#else
+    // The reactor is enabled when the first connection is created, this
+    // test therefore needs a process on its own (as run by ctest)
+    yarp::conf::environment::set_string("YARP_PORT_REACTOR", "2");
+    if (PortCoreReactor::getInstance() == nullptr) {
+        YARP_SKIP_TEST("The port reactor was disabled before this test started")
+    }
+
+    NetworkBase::setLocalMode(true);
+
+    BufferedPort<Bottle> in;
+    in.setStrict();
+    REQUIRE(in.open("/reactor/in"));
+
+    const int connections = 16;
+    std::vector<std::unique_ptr<Port>> outs;
+    for (int i = 0; i < connections; ++i) {
+        outs.emplace_back(new Port);
+        REQUIRE(outs.back()->open("/reactor/out" + std::to_string(i)));
+    }
+
+    Time::delay(0.1);
+    size_t before = countThreads();
+    for (auto& out : outs) {
+        REQUIRE(NetworkBase::connect(out->getName(), in.getName()));
+    }
+    Time::delay(0.1);
+    size_t after = countThreads();
+
+    // Without the reactor, each input connection has its own thread
+    INFO("threads before connecting: " << before << ", after: " << after);
+    CHECK(after < before + connections / 2);
+
+    for (int i = 0; i < connections; ++i) {
+        Bottle b;
+        b.addInt32(i);
+        outs[i]->write(b);
+    }
+    int received = 0;
+    for (int j = 0; j < 1000 && received < connections; ++j) {
+        if (in.read(false) != nullptr) {
+            received++;
+        } else {
+            Time::delay(0.001);
+        }
+    }
+    CHECK(received == connections);
+
+    for (auto& out : outs) {
+        out->close();
+    }
+    in.close();
+
+    NetworkBase::setLocalMode(false);
+#endif
+}
@@ -10,8 +10,11 @@
 #include <yarp/os/NetType.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/sig/Image.h>
+#include <yarp/sig/ImageBufferPool.h>
 #include <yarp/sig/ImageDraw.h>
 #include <yarp/sig/ImageUtils.h>
+#include <yarp/sig/ImageView.h>
+#include <yarp/sig/impl/PixelConversion.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/PortReaderBuffer.h>
 #include <yarp/os/Port.h>
@@ -20,6 +23,11 @@
 #include <yarp/os/Log.h>
 #include <yarp/os/PeriodicThread.h>
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -501,6 +509,88 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
         CHECK(img2(4,2).r == 10); // r level copied
     }
 
+    SECTION("check pixel conversions.")
+    {
+        // odd width, to check the end of the rows and the padding
+        const size_t w = 37;
+        const size_t h = 5;
+        ImageOf<PixelRgb> rgb;
+        ImageOf<PixelRgba> rgba;
+        ImageOf<PixelMono16> mono16;
+        rgb.resize(w, h);
+        rgba.resize(w, h);
+        mono16.resize(w, h);
+        unsigned int seed = 42;
+        auto next = [&seed]() {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 8) & 0xffff;
+        };
+        for (size_t y = 0; y < h; y++) {
+            for (size_t x = 0; x < w; x++) {
+                rgb(x, y) = PixelRgb(next() & 0xff, next() & 0xff, next() & 0xff);
+                rgba(x, y) = PixelRgba(next() & 0xff, next() & 0xff, next() & 0xff, next() & 0xff);
+                mono16(x, y) = static_cast<PixelMono16>(next());
+            }
+        }
+        rgb(0, 0) = PixelRgb(255, 255, 255);
+
+        // Every instruction set available gives the generic result
+        const std::string selected = yarp::sig::impl::getPixelConversionInstructionSet();
+        for (const char* set : {"none", "sse4.1", "avx2", "neon"}) {
+            if (!yarp::sig::impl::setPixelConversionInstructionSet(set)) {
+                continue;
+            }
+            INFO("instruction set " << set);
+            CHECK(std::string(yarp::sig::impl::getPixelConversionInstructionSet()) == set);
+            ImageOf<PixelBgr> bgr;
+            ImageOf<PixelBgra> bgra;
+            ImageOf<PixelMono> mono;
+            ImageOf<PixelMono> monoFromBgr;
+            ImageOf<PixelFloat> monoFloat;
+            ImageOf<PixelRgb> flipped;
+            bgr.copy(rgb);
+            bgra.copy(rgba);
+            mono.copy(rgb);
+            monoFromBgr.copy(bgr);
+            monoFloat.copy(mono16);
+            flipped.setTopIsLowIndex(false);
+            flipped.copy(bgr);
+
+            size_t mismatch = 0;
+            for (size_t y = 0; y < h; y++) {
+                for (size_t x = 0; x < w; x++) {
+                    const PixelRgb& p = rgb(x, y);
+                    const PixelRgba& q = rgba(x, y);
+                    const auto m = static_cast<unsigned char>((p.r + p.g + p.b) / 3);
+                    mismatch += (bgr(x, y).r != p.r || bgr(x, y).g != p.g || bgr(x, y).b != p.b);
+                    mismatch += (bgra(x, y).r != q.r || bgra(x, y).g != q.g || bgra(x, y).b != q.b || bgra(x, y).a != q.a);
+                    mismatch += (mono(x, y) != m || monoFromBgr(x, y) != m);
+                    mismatch += (monoFloat(x, y) != static_cast<float>(mono16(x, y)));
+                    mismatch += (flipped(x, y).r != p.r || flipped(x, y).g != p.g || flipped(x, y).b != p.b);
+                }
+            }
+            CHECK(mismatch == 0);
+            CHECK(mono(0, 0) == 255);
+        }
+        yarp::sig::impl::setPixelConversionInstructionSet(selected.c_str());
+
+        INFO("check rgb to hsv.");
+        ImageOf<PixelRgb> colors;
+        ImageOf<PixelHsv> hsv;
+        colors.resize(5, 1);
+        colors(0, 0) = PixelRgb(255, 0, 0);
+        colors(1, 0) = PixelRgb(0, 255, 0);
+        colors(2, 0) = PixelRgb(0, 0, 200);
+        colors(3, 0) = PixelRgb(100, 100, 100);
+        colors(4, 0) = PixelRgb(200, 0, 100);
+        hsv.copy(colors);
+        CHECK((hsv(0, 0).h == 0 && hsv(0, 0).s == 255 && hsv(0, 0).v == 255));
+        CHECK((hsv(1, 0).h == 85 && hsv(1, 0).s == 255 && hsv(1, 0).v == 255));
+        CHECK((hsv(2, 0).h == 171 && hsv(2, 0).s == 255 && hsv(2, 0).v == 200));
+        CHECK((hsv(3, 0).h == 0 && hsv(3, 0).s == 0 && hsv(3, 0).v == 100));
+        CHECK((hsv(4, 0).h == 235 && hsv(4, 0).s == 255 && hsv(4, 0).v == 200));
+    }
+
     SECTION("check origin.")
     {
 
@@ -779,5 +869,310 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
         CHECK(ok);
     }
 
+    SECTION("test image resampling.")
+    {
+        INFO("check area averaging.");
+        ImageOf<PixelMono> row;
+        ImageOf<PixelMono> out;
+        row.resize(3, 1);
+        row(0, 0) = 0;
+        row(1, 0) = 90;
+        row(2, 0) = 180;
+        CHECK(utils::resample(row, out, 2, 1, utils::ResampleMethod::Area));
+        CHECK(out.width() == 2);
+        CHECK(out(0, 0) == 30);
+        CHECK(out(1, 0) == 150);
+
+        INFO("check bilinear interpolation.");
+        row.resize(2, 1);
+        row(0, 0) = 0;
+        row(1, 0) = 100;
+        CHECK(utils::resample(row, out, 4, 1, utils::ResampleMethod::Bilinear));
+        CHECK(out(0, 0) == 0);
+        CHECK(out(1, 0) == 25);
+        CHECK(out(2, 0) == 75);
+        CHECK(out(3, 0) == 100);
+
+        INFO("check box decimation.");
+        ImageOf<PixelRgb> rgb;
+        ImageOf<PixelRgb> rgbOut;
+        rgb.resize(4, 2);
+        for (size_t x = 0; x < 4; x++) {
+            rgb(x, 0) = PixelRgb(10 * x, 255, 0);
+            rgb(x, 1) = PixelRgb(10 * x + 1, 0, 0);
+        }
+        CHECK(utils::resample(rgb, rgbOut, 2, 1, utils::ResampleMethod::Box));
+        CHECK((rgbOut(0, 0).r == 6 && rgbOut(0, 0).g == 128 && rgbOut(0, 0).b == 0));
+        CHECK((rgbOut(1, 0).r == 26 && rgbOut(1, 0).g == 128 && rgbOut(1, 0).b == 0));
+        CHECK_FALSE(utils::resample(rgb, rgbOut, 3, 1, utils::ResampleMethod::Box));
+        CHECK_FALSE(utils::resample(rgb, out, 2, 1, utils::ResampleMethod::Box));
+
+        INFO("check that uniform images stay uniform.");
+        rgb.resize(101, 67);
+        for (size_t x = 0; x < rgb.width(); x++) {
+            for (size_t y = 0; y < rgb.height(); y++) {
+                rgb(x, y) = PixelRgb(10, 200, 255);
+            }
+        }
+        ImageOf<PixelFloat> depth;
+        ImageOf<PixelFloat> depthOut;
+        depth.resize(101, 67);
+        for (size_t x = 0; x < depth.width(); x++) {
+            for (size_t y = 0; y < depth.height(); y++) {
+                depth(x, y) = 1.5F;
+            }
+        }
+        bool uniform = true;
+        for (auto method : {utils::ResampleMethod::Bilinear, utils::ResampleMethod::Area}) {
+            for (size_t w : {31, 150}) {
+                CHECK(utils::resample(rgb, rgbOut, w, 23, method));
+                CHECK(utils::resample(depth, depthOut, w, 23, method));
+                for (size_t x = 0; x < rgbOut.width(); x++) {
+                    for (size_t y = 0; y < rgbOut.height(); y++) {
+                        uniform &= (rgbOut(x, y).r == 10 && rgbOut(x, y).g == 200 && rgbOut(x, y).b == 255);
+                        uniform &= std::abs(depthOut(x, y) - 1.5F) < 1e-5F;
+                    }
+                }
+            }
+        }
+        CHECK(uniform);
+
+        INFO("check that the result does not depend on the threads.");
+        for (size_t x = 0; x < rgb.width(); x++) {
+            for (size_t y = 0; y < rgb.height(); y++) {
+                rgb(x, y) = PixelRgb(x, y, x * y);
+            }
+        }
+        ImageOf<PixelRgb> rgbOut2;
+        ImageOf<PixelRgb> nearest;
+        for (auto method : {utils::ResampleMethod::Nearest, utils::ResampleMethod::Bilinear, utils::ResampleMethod::Area}) {
+            CHECK(utils::resample(rgb, rgbOut, 40, 30, method, 1));
+            CHECK(utils::resample(rgb, rgbOut2, 40, 30, method, 4));
+            CHECK(memcmp(rgbOut.getRawImage(), rgbOut2.getRawImage(), rgbOut.getRawImageSize()) == 0);
+        }
+        INFO("check that the nearest pixel is the same of the scaled copy.");
+        nearest.copy(rgb, 40, 30);
+        CHECK(utils::resample(rgb, rgbOut, 40, 30, utils::ResampleMethod::Nearest));
+        CHECK(memcmp(rgbOut.getRawImage(), nearest.getRawImage(), rgbOut.getRawImageSize()) == 0);
+    }
+
+    SECTION("test image demosaicing.")
+    {
+        INFO("check that linear gradients are reconstructed for all the patterns.");
+        ImageOf<PixelRgb> rgb;
+        rgb.resize(20, 16);
+        for (size_t x = 0; x < rgb.width(); x++) {
+            for (size_t y = 0; y < rgb.height(); y++) {
+                rgb(x, y) = PixelRgb(4 * x + 10, 3 * y + 20, 2 * (x + y) + 5);
+            }
+        }
+        struct Pattern
+        {
+            int code;
+            const char* colors;
+        };
+        const Pattern patterns[] = {{VOCAB_PIXEL_ENCODING_BAYER_GRBG8, "grbg"},
+                                    {VOCAB_PIXEL_ENCODING_BAYER_BGGR8, "bggr"},
+                                    {VOCAB_PIXEL_ENCODING_BAYER_GBRG8, "gbrg"},
+                                    {VOCAB_PIXEL_ENCODING_BAYER_RGGB8, "rggb"}};
+        ImageOf<PixelMono> raw;
+        ImageOf<PixelBgra> bgra;
+        raw.resize(rgb.width(), rgb.height());
+        for (const auto& pattern : patterns) {
+            for (size_t x = 0; x < raw.width(); x++) {
+                for (size_t y = 0; y < raw.height(); y++) {
+                    char color = pattern.colors[(x & 1) + 2 * (y & 1)];
+                    raw(x, y) = (color == 'r') ? rgb(x, y).r : (color == 'g') ? rgb(x, y).g : rgb(x, y).b;
+                }
+            }
+            for (auto method : {utils::DemosaicMethod::Bilinear, utils::DemosaicMethod::MalvarHeCutler}) {
+                CHECK(utils::deBayer(raw, pattern.code, bgra, method));
+                CHECK(bgra.width() == raw.width());
+                CHECK(bgra.height() == raw.height());
+                bool exact = true;
+                for (size_t x = 2; x < raw.width() - 2; x++) {
+                    for (size_t y = 2; y < raw.height() - 2; y++) {
+                        const PixelBgra& p = bgra(x, y);
+                        exact &= (p.r == rgb(x, y).r && p.g == rgb(x, y).g && p.b == rgb(x, y).b && p.a == 255);
+                    }
+                }
+                CHECK(exact);
+            }
+        }
+
+        INFO("check 16 bit images.");
+        ImageOf<PixelMono16> raw16;
+        ImageOf<PixelRgb> out;
+        raw16.resize(7, 5);
+        for (size_t x = 0; x < raw16.width(); x++) {
+            for (size_t y = 0; y < raw16.height(); y++) {
+                raw16(x, y) = 100 * 256;
+            }
+        }
+        CHECK(utils::deBayer(raw16, VOCAB_PIXEL_ENCODING_BAYER_RGGB16, out, utils::DemosaicMethod::MalvarHeCutler));
+        bool uniform = true;
+        for (size_t x = 0; x < out.width(); x++) {
+            for (size_t y = 0; y < out.height(); y++) {
+                uniform &= (out(x, y).r == 100 && out(x, y).g == 100 && out(x, y).b == 100);
+            }
+        }
+        CHECK(uniform);
+        CHECK_FALSE(utils::deBayer(raw16, VOCAB_PIXEL_ENCODING_BAYER_RGGB8, out));
+        CHECK_FALSE(utils::deBayer(raw, VOCAB_PIXEL_ENCODING_BAYER_RGGB16, out));
+        CHECK_FALSE(utils::deBayer(raw, VOCAB_PIXEL_MONO, out));
+        CHECK_FALSE(utils::deBayer(raw, VOCAB_PIXEL_ENCODING_BAYER_RGGB8, raw16));
+
+        INFO("check that the result does not depend on the threads.");
+        raw.resize(101, 67);
+        for (size_t x = 0; x < raw.width(); x++) {
+            for (size_t y = 0; y < raw.height(); y++) {
+                raw(x, y) = static_cast<unsigned char>(x * y + 7 * x);
+            }
+        }
+        ImageOf<PixelRgb> out2;
+        for (auto method : {utils::DemosaicMethod::Bilinear, utils::DemosaicMethod::MalvarHeCutler}) {
+            CHECK(utils::deBayer(raw, VOCAB_PIXEL_ENCODING_BAYER_GBRG8, out, method, 1));
+            CHECK(utils::deBayer(raw, VOCAB_PIXEL_ENCODING_BAYER_GBRG8, out2, method, 4));
+            bool same = true;
+            for (size_t y = 0; y < out.height(); y++) {
+                same &= (memcmp(out.getRow(y), out2.getRow(y), out.width() * sizeof(PixelRgb)) == 0);
+            }
+            CHECK(same);
+        }
+
+        INFO("check reading a bayer image.");
+        FlexImage bayer;
+        bayer.setPixelCode(VOCAB_PIXEL_ENCODING_BAYER_GRBG16);
+        bayer.resize(raw16);
+        memcpy(bayer.getRawImage(), raw16.getRawImage(), raw16.getRawImageSize());
+        CHECK(yarp::os::Portable::copyPortable(bayer, out2));
+        CHECK(utils::deBayer(raw16, VOCAB_PIXEL_ENCODING_BAYER_GRBG16, out));
+        CHECK(out2.width() == out.width());
+        bool same = true;
+        for (size_t y = 0; y < out.height(); y++) {
+            same &= (memcmp(out.getRow(y), out2.getRow(y), out.width() * sizeof(PixelRgb)) == 0);
+        }
+        CHECK(same);
+    }
+
+    SECTION("test image views.")
+    {
+        auto samePixels = [](const ImageOf<PixelRgb>& a, const ImageOf<PixelRgb>& b) {
+            bool same = a.width() == b.width() && a.height() == b.height();
+            for (size_t y = 0; same && y < a.height(); y++) {
+                same = memcmp(a.getRow(y), b.getRow(y), a.width() * sizeof(PixelRgb)) == 0;
+            }
+            return same;
+        };
+
+        // odd width, the rows of the halves are padded
+        ImageOf<PixelRgb> img;
+        img.resize(10, 6);
+        for (size_t x = 0; x < img.width(); x++) {
+            for (size_t y = 0; y < img.height(); y++) {
+                img.pixel(x, y) = PixelRgb{static_cast<unsigned char>(x), static_cast<unsigned char>(y), 42};
+            }
+        }
+
+        INFO("check the views of the split image.");
+        ImageOf<PixelRgb> left, right;
+        ImageView viewL, viewR;
+        CHECK(utils::vertSplit(img, left, right));
+        CHECK(utils::vertSplit(img, viewL, viewR));
+        CHECK(viewR.width() == 5);
+        CHECK(viewR.height() == 6);
+        CHECK(viewR.getPixelCode() == VOCAB_PIXEL_RGB);
+        CHECK(viewR.getPixelAddress(0, 0) == img.getPixelAddress(5, 0));
+
+        INFO("check that a view is written as an image.");
+        ImageOf<PixelRgb> received;
+        CHECK(Portable::copyPortable(viewR, received));
+        CHECK(samePixels(received, right));
+        CHECK(right.pixel(0, 5).r == 5);
+        CHECK(right.pixel(4, 5).r == 9);
+        ImageView viewUp, viewDown;
+        ImageOf<PixelRgb> up, down;
+        CHECK(utils::horzSplit(img, up, down));
+        CHECK(utils::horzSplit(img, viewUp, viewDown));
+        CHECK(Portable::copyPortable(viewDown, received));
+        CHECK(samePixels(received, down));
+
+        INFO("check the copy and the conversion of a view.");
+        ImageOf<PixelRgb> copied;
+        copied.copy(viewR);
+        CHECK(samePixels(copied, right));
+        ImageOf<PixelBgr> converted;
+        converted.copy(viewR);
+        CHECK(converted.pixel(4, 5).r == 9);
+        CHECK(converted.pixel(4, 5).g == 5);
+        CHECK(converted.pixel(4, 5).b == 42);
+        ImageView crop;
+        CHECK(utils::cropRect(img, {3, 4}, {1, 2}, crop));
+        CHECK(crop.width() == 3);
+        CHECK(crop.height() == 3);
+        copied.copy(crop.subView(1, 1, 2, 2));
+        CHECK(copied.width() == 2);
+        CHECK(copied.pixel(0, 0).r == 2);
+        CHECK(copied.pixel(0, 0).g == 3);
+        img.copy(ImageView(img, 2, 0, 8, 6));
+        CHECK(img.width() == 8);
+        CHECK(img.pixel(0, 0).r == 2);
+        CHECK(img.pixel(7, 5).r == 9);
+
+        INFO("check that an image is read into a view.");
+        ImageOf<PixelRgb> stereo;
+        stereo.resize(10, 6);
+        stereo.zero();
+        CHECK(utils::vertSplit(stereo, viewL, viewR));
+        CHECK(Portable::copyPortable(right, viewR));
+        CHECK(stereo.pixel(9, 5).r == 9);
+        CHECK(stereo.pixel(5, 0).r == 5);
+        CHECK(stereo.pixel(4, 0).r == 0);
+        CHECK_FALSE(Portable::copyPortable(converted, viewL));
+
+        INFO("check drawing on a view.");
+        ImageViewOf<PixelRgb> drawn(stereo, 0, 0, 5, 6);
+        addRectangle(drawn, PixelRgb{255, 255, 255}, 2, 2, 10, 10);
+        CHECK(stereo.pixel(4, 5).r == 255);
+        CHECK(stereo.pixel(5, 5).r == 5);
+    }
+
+    SECTION("check image buffer pool.")
+    {
+        ImageBufferPool& pool = ImageBufferPool::getInstance();
+        const size_t limit = pool.getStatistics().limitBytes;
+        pool.setLimit(64 * 1024 * 1024);
+
+        INFO("check that the buffers are reused.");
+        ImageOf<PixelRgb> img;
+        img.resize(640, 480);
+        img.resize(320, 240);
+        img.resize(640, 480);
+        ImageBufferPool::Statistics before = pool.getStatistics();
+        for (int i = 0; i < 10; i++) {
+            img.resize(320, 240);
+            img.resize(640, 480);
+        }
+        ImageBufferPool::Statistics after = pool.getStatistics();
+        CHECK(after.allocations == before.allocations);
+        CHECK(after.reuses - before.reuses == 20);
+        CHECK(reinterpret_cast<uintptr_t>(img.getRawImage()) % 4096 == 0);
+
+        INFO("check that the unused buffers are limited.");
+        pool.setLimit(1024 * 1024);
+        CHECK(pool.getStatistics().pooledBytes <= 1024 * 1024);
+        for (size_t w = 100; w < 1000; w += 100) {
+            ImageOf<PixelRgb> tmp;
+            tmp.resize(w, w / 2);
+        }
+        CHECK(pool.getStatistics().pooledBytes <= 1024 * 1024);
+        pool.setLimit(0);
+        CHECK(pool.getStatistics().pooledBytes == 0);
+        img.resize(100, 100);
+        CHECK(pool.getStatistics().pooledBytes == 0);
+
+        pool.setLimit(limit);
+    }
+
     NetworkBase::setLocalMode(false);
 }
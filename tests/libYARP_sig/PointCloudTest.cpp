@@ -8,6 +8,7 @@
 
 #include <yarp/sig/PointCloud.h>
 #include <yarp/sig/PointCloudUtils.h>
+#include <yarp/sig/KdTree.h>
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
@@ -16,13 +17,22 @@
 #include <yarp/os/Port.h>
 #include <yarp/os/PortReaderBuffer.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/sig/Image.h>
 
 #include <catch.hpp>
 #include <harness.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
 using namespace yarp::sig;
 using namespace yarp::os;
+using yarp::os::impl::BufferedConnectionWriter;
 
 float acceptedDiff = 1e-6f;
 
@@ -912,6 +922,77 @@ TEST_CASE("sig::PointCloudTest", "[yarp::sig]")
         }
     }
 
+    SECTION("check compact encoding.")
+    {
+        PointCloud<DataXYZRGBA> testPC;
+        size_t width = 160;
+        size_t height = 120;
+        testPC.resize(width, height);
+        for (size_t v = 0; v < height; v++) {
+            for (size_t u = 0; u < width; u++) {
+                auto& p = testPC(u, v);
+                p.x = -2.0f + 0.025f * u;
+                p.y = -1.5f + 0.025f * v;
+                p.z = 3.0f + 0.001f * ((u * v) % 100);
+                p.r = static_cast<unsigned char>(u);
+                p.g = static_cast<unsigned char>(v);
+                p.b = 10;
+                p.a = 255;
+                if ((u + v * 7) % 13 == 0) {
+                    p.z = std::numeric_limits<float>::quiet_NaN();
+                }
+            }
+        }
+        const float tolerance[3] = {4.0f / 65535, 3.0f / 65535, 0.1f / 65535};
+
+        BufferedConnectionWriter rawWriter;
+        testPC.write(rawWriter);
+
+        for (auto encoding : {PointCloudBase::Encoding::Compact, PointCloudBase::Encoding::CompactCompressed}) {
+            testPC.setEncoding(encoding);
+            CHECK(testPC.getEncoding() == encoding);
+            BufferedConnectionWriter writer;
+            testPC.write(writer);
+            CHECK(writer.dataSize() * 3 < rawWriter.dataSize()); // 10 bytes per point instead of 32
+
+            PointCloud<DataXYZRGBA> inCloud;
+            REQUIRE(yarp::os::Portable::copyPortable(testPC, inCloud));
+            REQUIRE(inCloud.width() == width);
+            REQUIRE(inCloud.height() == height);
+            CHECK(inCloud.isDense() == testPC.isDense());
+            PointCloud<DataXYZ> inCloudXYZ;
+            REQUIRE(yarp::os::Portable::copyPortable(testPC, inCloudXYZ));
+            REQUIRE(inCloudXYZ.size() == testPC.size());
+
+            bool ok = true;
+            for (size_t i = 0; i < testPC.size(); i++) {
+                if (std::isnan(testPC(i).z)) {
+                    ok &= std::isnan(inCloud(i).x) && std::isnan(inCloud(i).z) && std::isnan(inCloudXYZ(i).y);
+                    continue;
+                }
+                for (size_t a = 0; a < 3; a++) {
+                    ok &= std::fabs(inCloud(i)._xyz[a] - testPC(i)._xyz[a]) <= tolerance[a];
+                    ok &= inCloudXYZ(i)._xyz[a] == inCloud(i)._xyz[a];
+                }
+                ok &= inCloud(i).rgba == testPC(i).rgba;
+            }
+            CHECK(ok); // Checking the quantized points
+        }
+
+        INFO("Clouds without valid points");
+        PointCloud<DataXYZ> emptyPC;
+        emptyPC.setEncoding(PointCloudBase::Encoding::CompactCompressed);
+        PointCloud<DataXYZ> inEmpty;
+        CHECK(yarp::os::Portable::copyPortable(emptyPC, inEmpty));
+        CHECK(inEmpty.size() == 0);
+        emptyPC.resize(3, 2);
+        emptyPC(1).x = std::numeric_limits<float>::infinity();
+        CHECK(yarp::os::Portable::copyPortable(emptyPC, inEmpty));
+        CHECK(inEmpty.size() == 6);
+        CHECK(inEmpty(0).z == 0);
+        CHECK(std::isnan(inEmpty(1).x));
+    }
+
     SECTION("Testing depthToPC BGRA")
     {
         ImageOf<PixelFloat> depth;
@@ -966,6 +1047,178 @@ TEST_CASE("sig::PointCloudTest", "[yarp::sig]")
         CHECK(pc.height() == (roi.max_y - roi.min_y) / step_y); // Checking PC height
     }
 
+    SECTION("Testing depthToPC values")
+    {
+        ImageOf<PixelFloat> depth;
+        ImageOf<PixelRgba> color;
+        size_t width{37};
+        size_t height{23};
+        depth.resize(width, height);
+        color.resize(width, height);
+        size_t valid = 0;
+        for (size_t v = 0; v < height; v++) {
+            for (size_t u = 0; u < width; u++) {
+                float z = 0.5f + 0.01f * (u + v);
+                switch ((u * 7 + v * 3) % 11) {
+                case 0: z = 0.0f; break;
+                case 1: z = std::numeric_limits<float>::quiet_NaN(); break;
+                case 2: z = -1.0f; break;
+                case 3: z = std::numeric_limits<float>::infinity(); break;
+                default: valid++;
+                }
+                depth.pixel(u, v) = z;
+                color.pixel(u, v) = PixelRgba(u, v, u + v, 255 - u);
+            }
+        }
+        IntrinsicParams intp;
+        intp.principalPointX = 18.3;
+        intp.principalPointY = 11.7;
+        intp.focalLengthX = 40.0;
+        intp.focalLengthY = 42.0;
+
+        auto pc = utils::depthRgbToPC<DataXYZRGBA, PixelRgba>(depth, color, intp);
+        REQUIRE(pc.width() == width);
+        REQUIRE(pc.height() == height);
+        bool ok = true;
+        for (size_t v = 0; v < height; v++) {
+            for (size_t u = 0; u < width; u++) {
+                double z = depth.pixel(u, v);
+                if (!(z > 0 && z < std::numeric_limits<double>::infinity())) {
+                    z = 0; // invalid depth, point in the origin
+                }
+                ok &= std::fabs(pc(u, v).x - (u - intp.principalPointX) / intp.focalLengthX * z) < acceptedDiff;
+                ok &= std::fabs(pc(u, v).y - (v - intp.principalPointY) / intp.focalLengthY * z) < acceptedDiff;
+                ok &= pc(u, v).z == static_cast<float>(z);
+                ok &= pc(u, v).r == color.pixel(u, v).r && pc(u, v).g == color.pixel(u, v).g;
+                ok &= pc(u, v).b == color.pixel(u, v).b && pc(u, v).a == color.pixel(u, v).a;
+            }
+        }
+        CHECK(ok); // Checking organized point cloud
+
+        INFO("Unorganized point cloud, with ROI and steps not dividing it");
+        utils::PCL_ROI roi {3, 30, 2, 20}; // {min_x, max_x, min_y, max_y}
+        for (size_t step_x : {1, 4}) {
+            auto pcOrg = utils::depthToPC(depth, intp, roi, step_x, 3);
+            CHECK(pcOrg.width() == 27 / step_x);
+            CHECK(pcOrg.height() == 6);
+            for (size_t threads : {1, 3}) {
+                auto pcUnorg = utils::depthToPC(depth, intp, roi, step_x, 3, utils::OrganizationType::Unorganized, threads);
+                CHECK(pcUnorg.height() == 1);
+                size_t n = 0;
+                ok = true;
+                for (size_t i = 0; i < pcOrg.size(); i++) {
+                    if (pcOrg(i).z != 0) {
+                        ok &= n < pcUnorg.size() && std::memcmp(&pcOrg(i), &pcUnorg(n), sizeof(DataXYZ)) == 0;
+                        n++;
+                    }
+                }
+                CHECK(ok); // Checking the valid points
+                CHECK(pcUnorg.size() == n);
+            }
+        }
+
+        auto pcAll = utils::depthToPC(depth, intp, utils::PCL_ROI(), 1, 1, utils::OrganizationType::Unorganized, 0);
+        CHECK(pcAll.size() == valid);
+    }
+
+    SECTION("Testing pass-through, crop box and voxel grid")
+    {
+        PointCloud<DataXYZRGBA> pc;
+        pc.resize(10, 10);
+        for (size_t v = 0; v < 10; v++) {
+            for (size_t u = 0; u < 10; u++) {
+                pc(u, v).x = 0.1f * u + 0.05f;
+                pc(u, v).y = 0.1f * v + 0.05f;
+                pc(u, v).z = 1.0f;
+                pc(u, v).r = static_cast<unsigned char>(u);
+                pc(u, v).g = static_cast<unsigned char>(v);
+            }
+        }
+        pc(0, 0).z = std::numeric_limits<float>::quiet_NaN();
+
+        auto pt = utils::passThrough(pc, utils::Axis::X, 0.2f, 0.5f);
+        CHECK(pt.height() == 1);
+        CHECK(pt.size() == 30);
+        auto ptNeg = utils::passThrough(pc, utils::Axis::X, 0.2f, 0.5f, true);
+        CHECK(ptNeg.size() == 69); // NaN point discarded
+
+        utils::PCL_BOX box {0.0f, 0.3f, 0.0f, 0.3f, 0.5f, 1.5f}; // {min_x, max_x, min_y, max_y, min_z, max_z}
+        auto crop = utils::cropBox(pc, box);
+        CHECK(crop.size() == 8);
+        bool ok = true;
+        for (size_t i = 0; i < crop.size(); i++) {
+            ok &= crop(i).x <= 0.3f && crop(i).y <= 0.3f && crop(i).r < 3 && crop(i).g < 3;
+        }
+        CHECK(ok); // Checking the points and their color
+
+        auto voxels = utils::voxelGridDownsample(pc, 0.5f);
+        CHECK(voxels.height() == 1);
+        REQUIRE(voxels.size() == 4);
+        // voxel with x and y in [0.5, 1.0): 25 points
+        ok = false;
+        for (size_t i = 0; i < voxels.size(); i++) {
+            if (voxels(i).x > 0.5f && voxels(i).y > 0.5f) {
+                ok = std::fabs(voxels(i).x - 0.75f) < 1e-5f && std::fabs(voxels(i).y - 0.75f) < 1e-5f;
+                ok &= (voxels(i).r == 7 || voxels(i).r == 8) && (voxels(i).g == 7 || voxels(i).g == 8);
+            }
+        }
+        CHECK(ok); // Checking the centroid
+    }
+
+    SECTION("Testing k-d tree")
+    {
+        PointCloud<DataXYZ> pc;
+        pc.resize(1000);
+        unsigned int seed = 1;
+        auto random = [&seed]() {
+            seed = seed * 1103515245 + 12345;
+            return static_cast<float>((seed >> 8) % 10000) / 1000.0f;
+        };
+        for (size_t i = 0; i < pc.size(); i++) {
+            pc(i).x = random();
+            pc(i).y = random();
+            pc(i).z = random();
+        }
+        pc(5).x = std::numeric_limits<float>::infinity();
+
+        utils::KdTree<DataXYZ> tree(pc);
+        CHECK(tree.size() == 999);
+
+        bool ok = true;
+        std::vector<size_t> indices;
+        std::vector<float> sqDistances;
+        for (size_t q = 0; q < 50; q++) {
+            const float x = random();
+            const float y = random();
+            const float z = random();
+            std::vector<std::pair<float, size_t>> expected;
+            for (size_t i = 0; i < pc.size(); i++) {
+                const float d = (pc(i).x - x) * (pc(i).x - x) + (pc(i).y - y) * (pc(i).y - y) + (pc(i).z - z) * (pc(i).z - z);
+                if (i != 5) {
+                    expected.emplace_back(d, i);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+
+            ok &= tree.nearestKSearch(x, y, z, 10, indices, sqDistances) == 10;
+            for (size_t k = 0; k < 10 && k < indices.size(); k++) {
+                ok &= indices[k] == expected[k].second && sqDistances[k] == expected[k].first;
+            }
+
+            tree.radiusSearch(x, y, z, 1.5f, indices, sqDistances);
+            std::sort(indices.begin(), indices.end());
+            std::vector<size_t> inRadius;
+            for (const auto& e : expected) {
+                if (e.first <= 1.5f * 1.5f) {
+                    inRadius.push_back(e.second);
+                }
+            }
+            std::sort(inRadius.begin(), inRadius.end());
+            ok &= indices == inRadius;
+        }
+        CHECK(ok); // Checking the results against a linear search
+    }
+
     SECTION("Testing move semantics")
     {
         INFO("Testing the copy constructor with PC of the same type");
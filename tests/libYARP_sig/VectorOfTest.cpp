@@ -195,11 +195,11 @@ TEST_CASE("sig::VectorOfTest", "[yarp::sig]")
     {
         VectorOf<int> v(0);
         CHECK(v.size() == (size_t) 0); // Checking size() after constructor
-        CHECK(v.capacity() == (size_t) 0); // Checking memory allocated after constructor
+        CHECK(v.capacity() == VectorOf<int>::inlineCapacity); // Checking the storage in the object after constructor
         v.push_back(1);
         CHECK(v[0] == 1); // Checking data consistency
         CHECK(v.size() == (size_t) 1); // Checking size() after push_back
-        CHECK(v.capacity() == (size_t) 1); // Checking capacity() after push_back
+        CHECK(v.capacity() == VectorOf<int>::inlineCapacity); // Checking capacity() after push_back
         v.reserve(10);
         CHECK(v[0] == 1); // Checking data consistency
         CHECK(v.size() == (size_t) 1); // The memory has been allocated but the vector is empty
@@ -220,5 +220,51 @@ TEST_CASE("sig::VectorOfTest", "[yarp::sig]")
         CHECK(v.capacity() >= (size_t) 11); // Checking capacity() after push_back
     }
 
+    SECTION("Checking the storage of short and long vectors")
+    {
+        const size_t n = VectorOf<double>::inlineCapacity;
+        VectorOf<double> a(n);
+        for (size_t i = 0; i < n; i++) {
+            a[i] = static_cast<double>(i);
+        }
+        CHECK(a.capacity() == n); // Checking short vectors are stored in the object
+
+        VectorOf<double> b(a);
+        CHECK(b == a); // Checking copy of a short vector
+        VectorOf<double> c(std::move(b));
+        CHECK(c == a); // Checking move of a short vector
+        CHECK(b.size() == (size_t) 0); // Checking the moved vector is empty
+
+        a.push_back(static_cast<double>(n));
+        CHECK(a.size() == n + 1); // Checking size() after growing out of the object
+        CHECK(a.capacity() >= n + 1); // Checking capacity() after growing out of the object
+        for (size_t i = 0; i <= n; i++) {
+            CHECK(a[i] == static_cast<double>(i)); // Checking data consistency
+        }
+        a.push_back(a[0]); // Checking push_back() of an element of the vector
+        CHECK(a[n + 1] == 0.0);
+
+        const double* data = a.data();
+        VectorOf<double> d(std::move(a));
+        CHECK(d.data() == data); // Checking move of a long vector does not copy
+        c = d;
+        CHECK(c == d); // Checking copy of a long vector into a short one
+        data = c.data();
+        c = d;
+        CHECK(c.data() == data); // Checking the memory is reused when copying
+        c.clear();
+        CHECK(c.capacity() >= n + 2); // Checking clear() keeps the memory
+    }
+
+    SECTION("Checking read() reuses the memory of the vector")
+    {
+        VectorOf<double> src(40, 1.5);
+        VectorOf<double> dest(40, 0.0);
+        const double* data = dest.data();
+        CHECK(Portable::copyPortable(src, dest)); // Checking read of a vector of the same size
+        CHECK(dest == src); // Checking data consistency
+        CHECK(dest.data() == data); // Checking the memory is not reallocated
+    }
+
     NetworkBase::setLocalMode(false);
 }